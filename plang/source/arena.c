@@ -0,0 +1,223 @@
+/*------------------------------------------------------------------------------
+ * File: arena.c
+ * Created: October 18, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Arenor som allokeringar tas ur i tur och ordning, se arena.h.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "arena.h"
+#include "common.h"
+#include "string.h"
+#include "timing.h"
+
+#include <stdlib.h>
+#include <string.h> // memcpy()
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: ALIGNMENT
+ *
+ * Description:
+ *   Alla allokeringar brjar p en adress som r delbar med detta, s att
+ *   de kan innehlla vilken typ som helst.
+ *------------------------------------*/
+#define ALIGNMENT 16
+
+/*--------------------------------------
+ * Constant: MAX_BLOCK_SIZE
+ *
+ * Description:
+ *   Den strsta storleken p ett block. Allokeringar strre n en fjrdedel
+ *   av detta fr ett eget block, s att det nuvarande blocket inte lmnas
+ *   halvfullt.
+ *------------------------------------*/
+#define MAX_BLOCK_SIZE (1024*1024)
+
+/*--------------------------------------
+ * Constant: MIN_BLOCK_SIZE
+ *
+ * Description:
+ *   Storleken p det frsta blocket. Varje nytt block blir dubbelt s stort
+ *   som det frra, upp till MAX_BLOCK_SIZE, s att sm program inte behver
+ *   mycket minne och stora inte behver mnga block.
+ *------------------------------------*/
+#define MIN_BLOCK_SIZE (4*1024)
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Arena_Block
+ *
+ * Description:
+ *   Ett block i en arena. data pekar p minnet som allokeringar tas ur, som
+ *   ligger efter structen och brjar p en adress som r delbar med
+ *   ALIGNMENT. malloc() garanterar inte det (p Win32 bara 8 byte), och
+ *   structens storlek varierar mellan plattformar, s blocket har plats fr
+ *   att flytta fram data till nsta sdan adress, se BlockBytes().
+ *------------------------------------*/
+typedef struct Arena_Block {
+    struct Arena_Block* next;
+           char*        data;
+           size_t       size;
+           size_t       used;
+} Arena_Block;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: BlockBytes()
+ * Parameters:
+ *   size  Antalet byte som ska rymmas i blocket.
+ *
+ * Description:
+ *   Returnerar antalet byte som ett block tar, inklusive structen och
+ *   platsen fr att justera minnet efter den.
+ *------------------------------------*/
+static size_t BlockBytes(size_t size) {
+    return sizeof(Arena_Block) + (ALIGNMENT - 1) + size;
+}
+
+/*--------------------------------------
+ * Function: NewBlock()
+ * Parameters:
+ *   size  Antalet byte som ska rymmas i blocket.
+ *
+ * Description:
+ *   Allokerar ett tomt block.
+ *------------------------------------*/
+static Arena_Block* NewBlock(size_t size) {
+    Arena_Block* block = malloc(BlockBytes(size));
+    Timing_CountAlloc(BlockBytes(size));
+
+    // Minnet brjar p frsta adressen efter structen som r delbar med
+    // ALIGNMENT.
+    size_t data = ((size_t)(block + 1) + ALIGNMENT - 1)
+                & ~(size_t)(ALIGNMENT - 1);
+
+    block->next = NULL;
+    block->data = (char*)data;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+/*--------------------------------------
+ * Function: Arena_Alloc()
+ * Parameters:
+ *   arena      Arenan som minnet ska tas ur.
+ *   num_bytes  Antalet byte som ska allokeras.
+ *
+ * Description:
+ *   Allokerar minne ur arenan och returnerar en pekare till det. Minnet r
+ *   justerat fr alla typer, och finns kvar tills Arena_Free() anropas.
+ *------------------------------------*/
+void* Arena_Alloc(Arena* arena, size_t num_bytes) {
+    Arena_Block* block = arena->blocks;
+
+    num_bytes = (num_bytes + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+
+    if (!block || block->used + num_bytes > block->size) {
+        if (block && num_bytes > MAX_BLOCK_SIZE/4) {
+            // Stora allokeringar lggs i ett eget block bakom det nuvarande,
+            // som fortstter att anvndas fr sm allokeringar.
+            Arena_Block* big_block = NewBlock(num_bytes);
+
+            big_block->used = num_bytes;
+            big_block->next = block->next;
+            block->next     = big_block;
+
+            return big_block->data;
+        }
+
+        size_t size = arena->next_size;
+        if (size < num_bytes)
+            size = num_bytes;
+
+        if (arena->next_size < MAX_BLOCK_SIZE)
+            arena->next_size *= 2;
+
+        block         = NewBlock(size);
+        block->next   = arena->blocks;
+        arena->blocks = block;
+    }
+
+    void* p = block->data + block->used;
+    block->used += num_bytes;
+
+    return p;
+}
+
+/*--------------------------------------
+ * Function: Arena_Duplicate()
+ * Parameters:
+ *   arena  Arenan som kopian ska allokeras ur.
+ *   s      En strng.
+ *
+ * Description:
+ *   Som Str_Duplicate(), men kopian allokeras ur arenan och ska inte slppas
+ *   med free().
+ *------------------------------------*/
+char* Arena_Duplicate(Arena* arena, const char* s) {
+    int   len = Str_Length(s);
+    char* s2  = Arena_Alloc(arena, (size_t)len+1);
+
+    memcpy(s2, s, (size_t)len+1);
+
+    return s2;
+}
+
+/*--------------------------------------
+ * Function: Arena_Free()
+ * Parameters:
+ *   arena  Arenan som ska slppas.
+ *
+ * Description:
+ *   Slpper allt minne som allokerats ur arenan. Arenan r sedan tom och kan
+ *   anvndas igen.
+ *------------------------------------*/
+void Arena_Free(Arena* arena) {
+    Arena_Block* block = arena->blocks;
+
+    while (block) {
+        Arena_Block* next = block->next;
+
+        Timing_CountFree(BlockBytes(block->size));
+        free(block);
+
+        block = next;
+    }
+
+    Arena_Init(arena);
+}
+
+/*--------------------------------------
+ * Function: Arena_Init()
+ * Parameters:
+ *   arena  Arenan som ska initieras.
+ *
+ * Description:
+ *   Initierar en tom arena. Inget minne allokeras frrn det behvs.
+ *------------------------------------*/
+void Arena_Init(Arena* arena) {
+    arena->blocks    = NULL;
+    arena->next_size = MIN_BLOCK_SIZE;
+}
@@ -0,0 +1,99 @@
+/*------------------------------------------------------------------------------
+ * File: arena.h
+ * Created: October 18, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   En arena r ett minnesomrde som allokeringar tas ur i tur och ordning,
+ *   och som sedan slpps i ett enda anrop. Syntax-trdet och felmeddelandena
+ *   frn en kompilering allokeras ur samma arena, s att de inte behver en
+ *   egen malloc() per nod och inte kan glmmas bort nr kompileringen r
+ *   klar.
+ *
+ *   Minne i en arena kan inte slppas fr sig. En array i en arena lmnar
+ *   drfr sitt gamla minne kvar nr den vxer, se Array_InitSized().
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+#include <stddef.h>
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Arena
+ *
+ * Description:
+ *   En arena. blocks r det block som allokeringar just nu tas ur, och det
+ *   pekar vidare p de tidigare blocken. next_size r storleken p nsta
+ *   block.
+ *------------------------------------*/
+typedef struct Arena {
+    struct Arena_Block* blocks;
+           size_t       next_size;
+} Arena;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Arena_Alloc()
+ * Parameters:
+ *   arena      Arenan som minnet ska tas ur.
+ *   num_bytes  Antalet byte som ska allokeras.
+ *
+ * Description:
+ *   Allokerar minne ur arenan och returnerar en pekare till det. Minnet r
+ *   justerat fr alla typer, och finns kvar tills Arena_Free() anropas.
+ *------------------------------------*/
+void* Arena_Alloc(Arena* arena, size_t num_bytes);
+
+/*--------------------------------------
+ * Function: Arena_Duplicate()
+ * Parameters:
+ *   arena  Arenan som kopian ska allokeras ur.
+ *   s      En strng.
+ *
+ * Description:
+ *   Som Str_Duplicate(), men kopian allokeras ur arenan och ska inte slppas
+ *   med free().
+ *------------------------------------*/
+char* Arena_Duplicate(Arena* arena, const char* s);
+
+/*--------------------------------------
+ * Function: Arena_Free()
+ * Parameters:
+ *   arena  Arenan som ska slppas.
+ *
+ * Description:
+ *   Slpper allt minne som allokerats ur arenan. Arenan r sedan tom och kan
+ *   anvndas igen.
+ *------------------------------------*/
+void Arena_Free(Arena* arena);
+
+/*--------------------------------------
+ * Function: Arena_Init()
+ * Parameters:
+ *   arena  Arenan som ska initieras.
+ *
+ * Description:
+ *   Initierar en tom arena. Inget minne allokeras frrn det behvs.
+ *------------------------------------*/
+void Arena_Init(Arena* arena);
+
+#endif // ARENA_H_
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: array.c
  * Created: January 2, 2015
- * Last changed: January 9, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -10,7 +10,11 @@
  *   lggs in.
  *
  * Changes:
- *
+ *   * Lade till Array_RemoveElem().
+ *   * Externa definitioner av inline-funktionerna i array.h.
+ *   * Lade till Array_Reserve().
+ *   * Allokeringarna rknas av timing.h.
+ *   * Arrayer kan allokeras ur en arena, se Array_InitSized().
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
@@ -19,9 +23,10 @@
 
 #include "array.h"
 #include "debug.h"
+#include "timing.h"
 
 #include <stdlib.h>
-#include <string.h> // memcpy()
+#include <string.h> // memcpy(), memmove()
 
 /*------------------------------------------------
  * CONSTANTS
@@ -39,6 +44,47 @@
  * FUNCTIONS
  *----------------------------------------------*/
 
+// Inline-funktionerna i array.h mste ha en extern definition i precis en fil,
+// annars gr de inte att lnka nr kompilatorn inte lgger dem inline.
+extern void* Array_GetElemPtr(const Array* array, int i);
+extern int Array_Length(const Array* array);
+
+/*--------------------------------------
+ * Function: AllocElems()
+ * Parameters:
+ *   array      Arrayen som minnet ska allokeras till.
+ *   max_elems  Antalet element som minnet ska rymma.
+ *
+ * Description:
+ *   Allokerar minne fr elementen, ur arrayens arena om den har ngon.
+ *------------------------------------*/
+static void* AllocElems(const Array* array, int max_elems) {
+    size_t num_bytes = max_elems * array->elem_size;
+
+    if (array->arena)
+        return Arena_Alloc(array->arena, num_bytes);
+
+    Timing_CountAlloc(num_bytes);
+    return malloc(num_bytes);
+}
+
+/*--------------------------------------
+ * Function: FreeElems()
+ * Parameters:
+ *   array  Arrayen vars minne ska slppas.
+ *
+ * Description:
+ *   Slpper elementens minne. Minne i en arena slpps inte frrn arenan
+ *   slpps.
+ *------------------------------------*/
+static void FreeElems(const Array* array) {
+    if (array->arena)
+        return;
+
+    free(array->elems);
+    Timing_CountFree(array->max_elems * array->elem_size);
+}
+
 /*--------------------------------------
  * Function: Array_AddElem()
  * Parameters:
@@ -53,15 +99,18 @@ void* Array_AddElem(Array* array, const void* elem) {
     if (array->num_elems >= array->max_elems) {
         // Arrayen r full, s vi dubblar kapaciteten och kopierar ver de gamla
         // elementen till den nya minnesplatsen, sen slpper vi den gamla
-        // arrayen ur minnet.
+        // arrayen ur minnet. En tom array fr den vanliga kapaciteten.
+
+        int   max_elems = (array->max_elems > 0) ? 2*array->max_elems
+                                                 : INITIAL_MAX_ELEMS;
+        void* elems     = AllocElems(array, max_elems);
 
-        void* old_elems     = array->elems;
-        int   old_max_elems = array->max_elems;
+        if (array->num_elems > 0)
+            memcpy(elems, array->elems, array->num_elems * array->elem_size);
+        FreeElems(array);
 
-        array->max_elems *= 2;
-        array->elems = malloc(array->max_elems * array->elem_size);
-        memcpy(array->elems, old_elems, old_max_elems * array->elem_size);
-        free(old_elems);
+        array->elems     = elems;
+        array->max_elems = max_elems;
     }
 
     void* dest = (char*)array->elems + (array->num_elems * array->elem_size);
@@ -80,14 +129,17 @@ void* Array_AddElem(Array* array, const void* elem) {
  *   Slpper en array ur minnet.
  *------------------------------------*/
 void Array_Free(Array* array) {
-    ASSERT(array->elems != NULL);
+    // elem_size r noll om arrayen redan har slppts. elems kan dremot vara
+    // NULL om inget element ngonsin lagts till, se Array_InitSized().
+    ASSERT(array->elem_size != 0);
 
-    free(array->elems);
+    FreeElems(array);
 
     array->elems     = NULL;
     array->num_elems = 0;
     array->max_elems = 0;
     array->elem_size = 0;
+    array->arena     = NULL;
 }
 
 /*--------------------------------------
@@ -99,9 +151,77 @@ void Array_Free(Array* array) {
  *   Initialiserar och allokerar en array.
  *------------------------------------*/
 void Array_Init(Array* array, size_t elem_size) {
+    Array_InitSized(array, elem_size, INITIAL_MAX_ELEMS, NULL);
+}
+
+/*--------------------------------------
+ * Function: Array_InitSized()
+ * Parameters:
+ *   array      Den array som ska initieras.
+ *   elem_size  Storleken p ett element.
+ *   max_elems  Antalet element som arrayen ska rymma frn brjan. Om det r
+ *              noll allokeras inget minne frrn det frsta elementet lggs
+ *              till.
+ *   arena      Arenan som elementen ska allokeras ur, eller NULL fr
+ *              malloc().
+ *
+ * Description:
+ *   Initialiserar en array som rymmer precis max_elems element. En array i
+ *   en arena lmnar sitt gamla minne kvar i arenan nr den vxer.
+ *------------------------------------*/
+void Array_InitSized(Array* array, size_t elem_size, int max_elems,
+                     Arena* arena)
+{
     array->num_elems = 0;
-    array->max_elems = INITIAL_MAX_ELEMS;
+    array->max_elems = max_elems;
     array->elem_size = elem_size;
+    array->arena     = arena;
+    array->elems     = NULL;
+
+    if (max_elems > 0)
+        array->elems = AllocElems(array, max_elems);
+}
+
+/*--------------------------------------
+ * Function: Array_RemoveElem()
+ * Parameters:
+ *   array  Den array frn vilken vi ska ta bort ett element.
+ *   i      Index p elementet som ska tas bort.
+ *
+ * Description:
+ *   Tar bort det specificerade elementet ur arrayen. Alla element efter det
+ *   borttagna flyttas ett steg bakt.
+ *------------------------------------*/
+void Array_RemoveElem(Array* array, int i) {
+    ASSERT(0 <= i && i < array->num_elems);
+
+    char* dest = (char*)array->elems + (i * array->elem_size);
+    memmove(dest, dest + array->elem_size,
+            (array->num_elems - i - 1) * array->elem_size);
+
+    array->num_elems--;
+}
+
+/*--------------------------------------
+ * Function: Array_Reserve()
+ * Parameters:
+ *   array      Den array som ska rymma elementen.
+ *   num_elems  Antalet element som arrayen ska rymma.
+ *
+ * Description:
+ *   Ser till att arrayen rymmer minst num_elems element utan att behva
+ *   vxa, s att element kan lggas till med en enda allokering.
+ *------------------------------------*/
+void Array_Reserve(Array* array, int num_elems) {
+    if (num_elems <= array->max_elems)
+        return;
+
+    void* elems = AllocElems(array, num_elems);
+
+    if (array->num_elems > 0)
+        memcpy(elems, array->elems, array->num_elems * array->elem_size);
+    FreeElems(array);
 
-    array->elems = malloc(array->max_elems * array->elem_size);
+    array->elems     = elems;
+    array->max_elems = num_elems;
 }
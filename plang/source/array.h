@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: array.h
  * Created: January 2, 2015
- * Last changed: February 19, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -10,7 +10,10 @@
  *   lggs in.
  *
  * Changes:
- *
+ *   * Lade till Array_RemoveElem().
+ *   * Lade till Array_Reserve().
+ *   * Lade till Array_InitSized(), fr arrayer i en arena eller med en
+ *     annan kapacitet n den vanliga.
  *----------------------------------------------------------------------------*/
 
 #ifndef ARRAY_H_
@@ -20,6 +23,7 @@
  * INCLUDES
  *----------------------------------------------*/
 
+#include "arena.h"
 #include "common.h"
 #include "debug.h"
 
@@ -33,13 +37,15 @@
  * Type: Array
  *
  * Description:
- *   Representerar en dynamisk array med objekt i.
+ *   Representerar en dynamisk array med objekt i. Om arena inte r NULL tas
+ *   elementens minne ur den, se Array_InitSized().
  *------------------------------------*/
 typedef struct {
     void*  elems;
     int    num_elems;
     int    max_elems;
     size_t elem_size;
+    Arena* arena;
 } Array;
 
 /*------------------------------------------------
@@ -64,7 +70,8 @@ void* Array_AddElem(Array* array, const void* elem);
  *   array  Den array som ska avallokeras.
  *
  * Description:
- *   Slpper en array ur minnet.
+ *   Slpper en array ur minnet. En array i en arena slpps frst av
+ *   Arena_Free().
  *------------------------------------*/
 void Array_Free(Array* array);
 
@@ -94,6 +101,24 @@ void* Array_GetElemPtr(const Array* array, int i) {
  *------------------------------------*/
 void Array_Init(Array* array, size_t elem_size);
 
+/*--------------------------------------
+ * Function: Array_InitSized()
+ * Parameters:
+ *   array      Den array som ska initieras.
+ *   elem_size  Storleken p ett element.
+ *   max_elems  Antalet element som arrayen ska rymma frn brjan. Om det r
+ *              noll allokeras inget minne frrn det frsta elementet lggs
+ *              till.
+ *   arena      Arenan som elementen ska allokeras ur, eller NULL fr
+ *              malloc().
+ *
+ * Description:
+ *   Initialiserar en array som rymmer precis max_elems element. En array i
+ *   en arena lmnar sitt gamla minne kvar i arenan nr den vxer.
+ *------------------------------------*/
+void Array_InitSized(Array* array, size_t elem_size, int max_elems,
+                     Arena* arena);
+
 /*--------------------------------------
  * Function: Array_Length()
  * Parameters:
@@ -107,4 +132,28 @@ int Array_Length(const Array* array) {
     return array->num_elems;
 }
 
+/*--------------------------------------
+ * Function: Array_RemoveElem()
+ * Parameters:
+ *   array  Den array frn vilken vi ska ta bort ett element.
+ *   i      Index p elementet som ska tas bort.
+ *
+ * Description:
+ *   Tar bort det specificerade elementet ur arrayen. Alla element efter det
+ *   borttagna flyttas ett steg bakt.
+ *------------------------------------*/
+void Array_RemoveElem(Array* array, int i);
+
+/*--------------------------------------
+ * Function: Array_Reserve()
+ * Parameters:
+ *   array      Den array som ska rymma elementen.
+ *   num_elems  Antalet element som arrayen ska rymma.
+ *
+ * Description:
+ *   Ser till att arrayen rymmer minst num_elems element utan att behva
+ *   vxa, s att element kan lggas till med en enda allokering.
+ *------------------------------------*/
+void Array_Reserve(Array* array, int num_elems);
+
 #endif // ARRAY_H_
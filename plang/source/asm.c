@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: asm.c
  * Created: January 5, 2015
- * Last changed: February 19, 2015
+ * Last changed: October 17, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -13,13 +13,15 @@
  * Changes:
  *   * Lade in std fr optimeringar. Numer skrivs bara mov ebx, _Vars+offs ut
  *     som kod om EBX-registret inte redan pekar mot samma adress.
- *
+ *   * Kodgenerering fr AST_ADD_CLEAR- och AST_COPY-noder.
+ *   * _Vars har bara plats fr de variabler som programmet anvnder.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
  * INCLUDES
  *----------------------------------------------*/
 
+#include "array.h"
 #include "asm.h"
 #include "ast.h"
 #include "common.h"
@@ -40,9 +42,10 @@
  *   vid kodgenerering.
  *------------------------------------*/
 typedef struct {
-    Bool enable_optimizations;
-    Bool enable_source_comments;
-    int  label_counter;
+          Bool enable_optimizations;
+          Bool enable_source_comments;
+          int  label_counter;
+    const int* var_names;
 } Code_Info;
 
 /*------------------------------------------------
@@ -75,7 +78,7 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
                         "  call InputBox"        "\n"
                         "  mov ebx, _Vars+%d"    "\n"
                         "  mov [ebx], eax"       "\n",
-                        var, var*sizeof(int));
+                        ci->var_names[var], var*sizeof(int));
         }
 
         // Nr vi optimerar koden frlitar vi oss p att EDX-registret r noll.
@@ -91,6 +94,54 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
         break;
     }
 
+    /*----------------------------------------------------
+     * X<src> * faktor lggs till andra variabler, X<src> := 0
+     *--------------------------------------------------*/
+    case AST_ADD_CLEAR: {
+        int src = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (ci->enable_source_comments)
+            fprintf(fp, "; WHILE X%d != 0 DO ... END (optimized)\n",
+                    ci->var_names[src]);
+
+        fprintf(fp, "  mov ebx, _Vars+%d"    "\n"
+                    "  mov ecx, [ebx]"       "\n",
+                    src*sizeof(int));
+
+        int num_values = Array_Length(&node->values);
+        for (int i = 1; i < num_values; i += 2) {
+            int var    = *(int*)Array_GetElemPtr(&node->values, i);
+            int factor = *(int*)Array_GetElemPtr(&node->values, i+1);
+            int abs_factor = (factor < 0) ? -factor : factor;
+
+            fprintf(fp, "  mov ebx, _Vars+%d"    "\n"
+                        "  mov eax, ecx"         "\n",
+                        var*sizeof(int));
+
+            if (abs_factor != 1)
+                fprintf(fp, "  imul eax, eax, %d"    "\n", abs_factor);
+
+            if (factor > 0) {
+                fprintf(fp, "  add [ebx], eax"    "\n");
+            }
+            else {
+                // Precis som PRED fr resultatet inte bli negativt.
+                int label_num = ci->label_counter++;
+                fprintf(fp, "  sub [ebx], eax"                  "\n"
+                            "  jns .__Var_Not_Negative_%d__"    "\n"
+                            "  mov [ebx], dword 0"              "\n"
+                            ".__Var_Not_Negative_%d__:"         "\n",
+                            label_num, label_num);
+            }
+        }
+
+        fprintf(fp, "  mov ebx, _Vars+%d"      "\n"
+                    "  mov [ebx], dword 0"     "\n",
+                    src*sizeof(int));
+
+        break;
+    }
+
     /*----------------------------------------------------
      * <variabel> := <naturligt-tal>
      *--------------------------------------------------*/
@@ -99,7 +150,7 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
         int val = *(int*)Array_GetElemPtr(&node->values, 1);
 
         if (ci->enable_source_comments)
-            fprintf(fp, "; X%d := %d\n", var, val);
+            fprintf(fp, "; X%d := %d\n", ci->var_names[var], val);
 
         fprintf(fp, "  mov ebx, _Vars+%d"      "\n"
                     "  mov [ebx], dword %d"    "\n",
@@ -108,6 +159,26 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
         break;
     }
 
+    /*----------------------------------------------------
+     * X<dst> := X<src>
+     *--------------------------------------------------*/
+    case AST_COPY: {
+        int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+        int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (ci->enable_source_comments)
+            fprintf(fp, "; X%d := X%d (optimized)\n", ci->var_names[var0],
+                    ci->var_names[var1]);
+
+        fprintf(fp, "  mov ebx, _Vars+%d"    "\n"
+                    "  mov eax, [ebx]"       "\n"
+                    "  mov ebx, _Vars+%d"    "\n"
+                    "  mov [ebx], eax"       "\n",
+                    var1*sizeof(int), var0*sizeof(int));
+
+        break;
+    }
+
     /*----------------------------------------------------
      * <variabel> := PRED(<variabel>)
      *--------------------------------------------------*/
@@ -116,7 +187,8 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
         int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
 
         if (ci->enable_source_comments)
-            fprintf(fp, "; X%d := PRED(X%d)\n", var0, var1);
+            fprintf(fp, "; X%d := PRED(X%d)\n", ci->var_names[var0],
+                    ci->var_names[var1]);
 
         int label_num = ci->label_counter++;
         if (var0 == var1 && ci->enable_optimizations) {
@@ -155,7 +227,8 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
         int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
 
         if (ci->enable_source_comments)
-            fprintf(fp, "; X%d := SUCC(X%d)\n", var0, var1);
+            fprintf(fp, "; X%d := SUCC(X%d)\n", ci->var_names[var0],
+                    ci->var_names[var1]);
 
         if (var0 == var1 && ci->enable_optimizations) {
             fprintf(fp, "  mov ebx, _Vars+%d"    "\n"
@@ -181,7 +254,7 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
 
         if (ci->enable_source_comments)
-            fprintf(fp, "; WHILE X%d != 0 DO\n", var);
+            fprintf(fp, "; WHILE X%d != 0 DO\n", ci->var_names[var]);
 
         int label_num = ci->label_counter++;
         fprintf(fp, "__While__%d_%d_Do:"         "\n"
@@ -213,7 +286,7 @@ static void GenerateCode(const AST_Node* node, Code_Info* ci, FILE* fp) {
     case AST_RESULT: {
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
         if (ci->enable_source_comments)
-            fprintf(fp, "; RESULT (X%d)\n", var);
+            fprintf(fp, "; RESULT (X%d)\n", ci->var_names[var]);
 
         fprintf(fp, "  mov ebx, _Vars+%d"         "\n"
                     "  mov eax, [ebx]"            "\n"
@@ -589,12 +662,13 @@ static void WriteSectIdata(FILE* fp) {
 /*--------------------------------------
  * Function: WriteSectData()
  * Parameters:
- *   fp  Filen som koden ska skrivas till.
+ *   fp        Filen som koden ska skrivas till.
+ *   num_vars  Antalet variabler som programmet anvnder.
  *
  * Description:
  *   Skriver sektionen '.data' till den specificerade filen.
  *------------------------------------*/
-static void WriteSectData(FILE* fp) {
+static void WriteSectData(FILE* fp, int num_vars) {
     fprintf(fp, "section '.data' data readable writeable"    "\n"
                 ""                                           "\n"
                 "  _Vars             rd %d"                  "\n"
@@ -611,7 +685,7 @@ static void WriteSectData(FILE* fp) {
                 "  _szStaticTextInt rb 8"                    "\n"
                 ""                                           "\n"
                 ""                                           "\n",
-                PLANG_NUM_VARS);
+                num_vars);
 }
 
 /*--------------------------------------
@@ -647,14 +721,16 @@ static void WriteSectText(FILE* fp) {
  * Function: Asm_GenerateCode()
  * Parameters:
  *   root       Root-noden i det AST som ska kompileras till assembly-kod.
+ *   var_names  Variabelnamnen frn AST_ResolveVars().
  *   file_name  Namnet p filen som koden ska skrivas ut till.
  *   optimize   Huruvida den genererade koden ska optimeras eller inte.
  *
  * Description:
  *   Genererar assembly-kod fr ett AST och skriver ut det till en fil.
+ *   Variablerna i trdet mste ha numrerats om med AST_ResolveVars().
  *------------------------------------*/
-Bool Asm_GenerateCode(const AST_Node* root, const char* file_name,
-                      Bool optimize)
+Bool Asm_GenerateCode(const AST_Node* root, const Array* var_names,
+                      const char* file_name, Bool optimize)
 {
     FILE* fp = fopen(file_name, "w");
 
@@ -665,6 +741,7 @@ Bool Asm_GenerateCode(const AST_Node* root, const char* file_name,
     
     ci.enable_optimizations = optimize;
     ci.label_counter        = 0;
+    ci.var_names            = var_names->elems;
 #ifdef DEBUG
     ci.enable_source_comments = TRUE;
 #else
@@ -677,7 +754,7 @@ Bool Asm_GenerateCode(const AST_Node* root, const char* file_name,
     GenerateCode(root, &ci, fp);
 
     WriteProcs(fp);
-    WriteSectData (fp);
+    WriteSectData (fp, Array_Length(var_names));
     WriteSectIdata(fp);
     WriteSectReloc(fp);
 
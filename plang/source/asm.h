@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: asm.h
  * Created: January 5, 2015
- * Last changed: January 5, 2015
+ * Last changed: October 17, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -11,7 +11,7 @@
  *   flat assembler (fasm).
  *
  * Changes:
- *
+ *   * Asm_GenerateCode() tar variabelnamnen frn AST_ResolveVars().
  *----------------------------------------------------------------------------*/
 
 #ifndef ASM_H_
@@ -21,6 +21,7 @@
  * INCLUDES
  *----------------------------------------------*/
 
+#include "array.h"
 #include "ast.h"
 #include "common.h"
 
@@ -32,13 +33,15 @@
  * Function: Asm_GenerateCode()
  * Parameters:
  *   root       Root-noden i det AST som ska kompileras till assembly-kod.
+ *   var_names  Variabelnamnen frn AST_ResolveVars().
  *   file_name  Namnet p filen som koden ska skrivas ut till.
  *   optimize   Huruvida den genererade koden ska optimeras eller inte.
  *
  * Description:
  *   Genererar assembly-kod fr ett AST och skriver ut det till en fil.
+ *   Variablerna i trdet mste ha numrerats om med AST_ResolveVars().
  *------------------------------------*/
-Bool Asm_GenerateCode(const AST_Node* root, const char* file_name,
-                      Bool optimize);
+Bool Asm_GenerateCode(const AST_Node* root, const Array* var_names,
+                      const char* file_name, Bool optimize);
 
 #endif // ASM_H_
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: ast.c
  * Created: January 2, 2015
- * Last changed: January 12, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -11,227 +11,269 @@
  * Changes:
  *   * Tilldelning av andra vrden n noll r nu mjligt.
  *   * Tilldelar parent ett vrde.
+ *   * AST_IsLastNode() (tidigare IsLastNode() i vm.c).
+ *   * AST_FreeNode(), samt utskrift av AST_ADD_CLEAR- och AST_COPY-noder.
+ *   * AST_FreeNode() slpper ven loop-sammanfattningar.
+ *   * Externa definitioner av inline-funktionerna i ast.h.
+ *   * AST_ResolveVars() numrerar om variablerna till en tt variabel-array.
+ *   * Noderna fr raden och kolumnen fr sin frsta token.
+ *   * AST_FreeNode() slpper ven brytpunkter och profileringsrknare.
+ *   * Anvnder de variabelnummer och heltal som Tok_Tokenize() avkodat.
+ *   * AST_GenerateTree() lser kllkoden en token i taget med Tok_Next().
+ *   * Tog bort AST_GenerateTree(), syntax-trdet byggs nu av Syn_Parse().
+ *   * AST_CreateNode() allokerar noderna ur en arena, med arrayer som inte
+ *     r strre n de behver vara.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
  * INCLUDES
  *----------------------------------------------*/
 
+#include "arena.h"
 #include "array.h"
 #include "ast.h"
+#include "breakpoint.h"
 #include "common.h"
 #include "debug.h"
-#include "tokenizer.h"
+#include "summary.h"
+
+#include <stdlib.h>
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Var_Use
+ *
+ * Description:
+ *   Antalet frekomster av en variabel, se AST_ResolveVars().
+ *------------------------------------*/
+typedef struct {
+    int var;
+    int count;
+} Var_Use;
 
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
+// Inline-funktionerna i ast.h mste ha en extern definition i precis en fil,
+// annars gr de inte att lnka nr kompilatorn inte lgger dem inline.
+extern void* AST_AddChild(AST_Node* parent, AST_Node* child);
+extern void AST_AddValue(AST_Node* node, int value);
+extern AST_Node* AST_FindRoot(AST_Node* node);
+
 /*--------------------------------------
- * Function: ParseTokens()
+ * Function: IsVarValue()
  * Parameters:
- *   node    Noden till vilken barn-noder ska lggas.
- *   tokens  En array som innehller de tokens som ska lsas av.
- *   i       Det index i token-arrayen som avlsningen ska brja p.
+ *   node  Noden vars vrde ska underskas.
+ *   i     Index i nodens values-array.
  *
  * Description:
- *   Lser av tokens och bygger ett AST.
+ *   Returnerar sant om det angivna vrdet i noden r en variabel, och inte
+ *   ex. ett heltal eller en faktor.
  *------------------------------------*/
-static int ParseTokens(AST_Node* node, const Array* tokens, int i) {
-    while (TRUE) {
-        P_Token* tok = Array_GetElemPtr(tokens, i++);
-
-        switch (tok->type) {
-        /*----------------------------------------------------
-         * <variabel> := <naturligt-tal>
-         * <variabel> := PRED(<variabel>)
-         * <variabel> := SUCC(<variabel>)
-         *--------------------------------------------------*/
-        case PTOK_IDENT: {
-            P_Token* assign_tok        = Array_GetElemPtr(tokens, i++);
-            P_Token* int_pred_succ_tok = Array_GetElemPtr(tokens, i++);
-
-            ASSERT(assign_tok->type == PTOK_ASSIGN);
-
-            if (int_pred_succ_tok->type == PTOK_INT) {
-                // <variabel> := <naturligt-tal>
-
-                AST_Node  assign_node     = AST_CreateNode(AST_ASSIGN);
-                AST_Node* assign_node_ptr = AST_AddChild(node, &assign_node);
-
-                // Vi lgger in variabelindex och tilldelningsvrde.
-                AST_AddValue(assign_node_ptr, atoi(tok->value+1));
-                AST_AddValue(assign_node_ptr, atoi(int_pred_succ_tok->value));
-            }
-            else if (int_pred_succ_tok->type == PTOK_PRED
-                  || int_pred_succ_tok->type == PTOK_SUCC)
-            {
-                // <variabel> := PRED(<variabel>)
-                // <variabel> := SUCC(<variabel>)
-
-                P_Token* lparen_tok = Array_GetElemPtr(tokens, i++);
-                P_Token* ident_tok  = Array_GetElemPtr(tokens, i++);
-                P_Token* rparen_tok = Array_GetElemPtr(tokens, i++);
-
-                ASSERT(lparen_tok->type == PTOK_L_PAREN);
-                ASSERT(ident_tok ->type == PTOK_IDENT  );
-                ASSERT(rparen_tok->type == PTOK_R_PAREN);
-
-                AST_Node pred_succ_node;
-
-                if (int_pred_succ_tok->type == PTOK_PRED)
-                    pred_succ_node = AST_CreateNode(AST_PRED);
-                else
-                    pred_succ_node = AST_CreateNode(AST_SUCC);
-                
-                AST_Node* pred_succ_node_ptr =
-                    AST_AddChild(node, &pred_succ_node);
-                
-                // Vi lgger in variabelindexen fr de tv variablerna i
-                // operationen.
-                AST_AddValue(pred_succ_node_ptr, atoi(tok->value+1));
-                AST_AddValue(pred_succ_node_ptr, atoi(ident_tok->value+1));
-            }
-            else {
-                // Detta ska aldrig kunna ske efter verifierad syntax.
-                FAIL();
-            }
-
-            break;
-        }
+static Bool IsVarValue(const AST_Node* node, int i) {
+    switch (node->type) {
+    case AST_ADD_CLEAR: return (i == 0 || (i % 2) == 1);
+    case AST_ASSIGN:    return (i == 0);
+    default:            return TRUE;
+    }
+}
 
-        /*----------------------------------------------------
-         * WHILE <variabel> != 0 DO ... END
-         *--------------------------------------------------*/
-        case PTOK_WHILE: {
-            P_Token* ident_tok   = Array_GetElemPtr(tokens, i++);
-            P_Token* eq_test_tok = Array_GetElemPtr(tokens, i++);
-            P_Token* int_tok     = Array_GetElemPtr(tokens, i++);
-            P_Token* do_tok      = Array_GetElemPtr(tokens, i++);
-            P_Token* end_tok     = Array_GetElemPtr(tokens, i++);
-
-            ASSERT(ident_tok  ->type == PTOK_IDENT  );
-            ASSERT(eq_test_tok->type == PTOK_EQ_TEST);
-            ASSERT(int_tok    ->type == PTOK_INT    );
-            ASSERT(do_tok     ->type == PTOK_DO     );
-
-            AST_Node  while_node     = AST_CreateNode(AST_WHILE);
-            AST_Node* while_node_ptr = AST_AddChild(node, &while_node);
-
-            AST_AddValue(while_node_ptr, atoi(ident_tok->value+1));
-
-            // Om det inte r en tom loop s gr vi in i loopen och hanterar
-            // alla tokens dr.
-            if (end_tok->type != PTOK_END)
-                i = ParseTokens(while_node_ptr, tokens, i-1);
-            
-            break;
-        }
+/*--------------------------------------
+ * Function: CountVarUses()
+ * Parameters:
+ *   node    Noden varifrn variabler ska rknas.
+ *   counts  Array med PLANG_NUM_VARS element dr antalet frekomster av varje
+ *           variabel ska rknas upp.
+ *
+ * Description:
+ *   Rknar hur mnga gnger varje variabel frekommer i trdet.
+ *------------------------------------*/
+static void CountVarUses(const AST_Node* node, int* counts) {
+    int num_values = Array_Length(&node->values);
+    for (int i = 0; i < num_values; i++) {
+        int var = *(int*)Array_GetElemPtr(&node->values, i);
+        if (IsVarValue(node, i) && var >= 0 && var < PLANG_NUM_VARS)
+            counts[var]++;
+    }
 
-        /*----------------------------------------------------
-         * END
-         *--------------------------------------------------*/
-        case PTOK_END: {
-            // Vi har ntt det syntaktiska slutet av en while-loop.
-            return i;
-        }
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        CountVarUses(child, counts);
+    }
+}
 
-        /*----------------------------------------------------
-         * RESULT (<variabel>)
-         *--------------------------------------------------*/
-        case PTOK_RESULT: {
-            P_Token* lparen_tok = Array_GetElemPtr(tokens, i++);
-            P_Token* ident_tok  = Array_GetElemPtr(tokens, i++);
-            P_Token* rparen_tok = Array_GetElemPtr(tokens, i++);
-            P_Token* eof_tok    = Array_GetElemPtr(tokens, i);
-
-            ASSERT(lparen_tok->type == PTOK_L_PAREN);
-            ASSERT(ident_tok ->type == PTOK_IDENT  );
-            ASSERT(rparen_tok->type == PTOK_R_PAREN);
-            ASSERT(eof_tok   ->type == PTOK_EOF    );
-
-            AST_Node  result_node     = AST_CreateNode(AST_RESULT);
-            AST_Node* result_node_ptr = AST_AddChild(node, &result_node);
-
-            // Vi lgger in index p den variabel som ska vara output.
-            AST_AddValue(result_node_ptr, atoi(ident_tok->value+1));
-            return i;
-        }
+/*--------------------------------------
+ * Function: CompareVarUses()
+ * Parameters:
+ *   a  Pekare till det frsta Var_Use-elementet.
+ *   b  Pekare till det andra Var_Use-elementet.
+ *
+ * Description:
+ *   Jmfrelsefunktion fr qsort() som sorterar variabler efter antal
+ *   frekomster, de vanligaste frst. Lika vanliga variabler sorteras efter
+ *   nummer s att ordningen alltid blir densamma.
+ *------------------------------------*/
+static int CompareVarUses(const void* a, const void* b) {
+    const Var_Use* u1 = a;
+    const Var_Use* u2 = b;
 
-        default:
-            // Detta ska aldrig kunna ske efter verifierad syntax.
-            FAIL();
-        }
+    if (u1->count != u2->count)
+        return (u1->count > u2->count) ? -1 : 1;
+
+    return u1->var - u2->var;
+}
+
+/*--------------------------------------
+ * Function: NumValues()
+ * Parameters:
+ *   type  Nodtypen.
+ *
+ * Description:
+ *   Returnerar antalet vrden som en nod av den angivna typen har, eller
+ *   noll om det varierar. AST_ADD_CLEAR- och AST_PROGRAM-noder har olika
+ *   mnga vrden beroende p programmet.
+ *------------------------------------*/
+static int NumValues(AST_Node_Type type) {
+    switch (type) {
+    case AST_ASSIGN:
+    case AST_COPY:
+    case AST_PRED:
+    case AST_SUCC:
+        return 2;
+
+    case AST_RESULT:
+    case AST_WHILE:
+        return 1;
+
+    default:
+        return 0;
     }
+}
+
+/*--------------------------------------
+ * Function: RenumberVars()
+ * Parameters:
+ *   node   Noden varifrn variabler ska numreras om.
+ *   slots  Array med PLANG_NUM_VARS element med den nya platsen fr varje
+ *          variabel.
+ *
+ * Description:
+ *   Erstter alla variabler i trdet, och i eventuella loop-sammanfattningar,
+ *   med deras nya platser. Ogiltiga variabler erstts med -1 s att de
+ *   fortfarande ger fel nr de anvnds.
+ *------------------------------------*/
+static void RenumberVars(AST_Node* node, const int* slots) {
+    int num_values = Array_Length(&node->values);
+    for (int i = 0; i < num_values; i++) {
+        int* var = Array_GetElemPtr(&node->values, i);
+        if (IsVarValue(node, i))
+            *var = (*var >= 0 && *var < PLANG_NUM_VARS) ? slots[*var] : -1;
+    }
+
+    if (node->summary != NULL)
+        Sum_Renumber(node->summary, slots);
 
-    // Hit kommer vi aldrig.
-    FAIL();
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        RenumberVars(child, slots);
+    }
 }
 
 /*--------------------------------------
  * Function: AST_CreateNode()
  * Parameters:
- *   type  Typen av noden som ska skapas.
+ *   type   Typen av noden som ska skapas.
+ *   arena  Arenan som nodens barn och vrden ska allokeras ur, eller NULL
+ *          fr malloc().
  *
  * Description:
- *   Den hr funktionen skapar en AST-nod.
+ *   Den hr funktionen skapar en AST-nod. Vrde-arrayen rymmer precis s
+ *   mnga vrden som nodtypen har, och barn-arrayen allokeras frst nr det
+ *   frsta barnet lggs till, s att lv-noder inte tar mer minne n de
+ *   behver.
  *------------------------------------*/
-AST_Node AST_CreateNode(AST_Node_Type type) {
+AST_Node AST_CreateNode(AST_Node_Type type, Arena* arena) {
     AST_Node node;
     
-    node.type   = type;
-    node.parent = NULL;
+    node.type        = type;
+    node.parent      = NULL;
+    node.row         = 0;
+    node.col         = 0;
+    node.summary     = NULL;
+    node.breakpoints = NULL;
+    node.profile     = NULL;
 
-    Array_Init(&node.children, sizeof(AST_Node));
-    Array_Init(&node.values  , sizeof(int));
+    Array_InitSized(&node.children, sizeof(AST_Node), 0              , arena);
+    Array_InitSized(&node.values  , sizeof(int)     , NumValues(type), arena);
 
     return node;
 }
 
 /*--------------------------------------
- * Function: AST_GenerateTree()
+ * Function: AST_FreeNode()
  * Parameters:
- *   tokens  En array innehllande s.k. tokens, frslagsvis genererade av
- *           funktionen Tok_Tokenize() i modulen tokenizer.c.
+ *   node  Noden som ska slppas ur minnet.
  *
  * Description:
- *   Den hr funktionen genererar ett abstrakt syntax-trd frn en array av
- *   tokens.
+ *   Slpper den specificerade noden, och rekursivt alla dess barn, ur minnet.
+ *   Sjlva AST_Node-structen slpps inte eftersom den normalt ligger i en
+ *   annan nods barn-array.
  *------------------------------------*/
-AST_Node AST_GenerateTree(const Array* tokens) {
-    int i = 0;
-
-    P_Token* program_tok = Array_GetElemPtr(tokens, i++);
-    P_Token* lparen_tok  = Array_GetElemPtr(tokens, i++);
-
-    ASSERT(program_tok->type == PTOK_PROGRAM);
-    ASSERT(lparen_tok ->type == PTOK_L_PAREN);
-
-    AST_Node program_node = AST_CreateNode(AST_PROGRAM);
-
-    while (TRUE) {
-        P_Token* ident_tok = Array_GetElemPtr(tokens, i++);
-        P_Token* comma_tok = Array_GetElemPtr(tokens, i++);
-
-        ASSERT(ident_tok->type == PTOK_IDENT);
+void AST_FreeNode(AST_Node* node) {
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        AST_FreeNode(child);
+    }
 
-        // Vi lgger till variabelindexet som input-vrde.
-        AST_AddValue(&program_node, atoi(ident_tok->value+1));
+    Array_Free(&node->children);
+    Array_Free(&node->values);
 
-        // Om det inte r ett komma s finns inga fler variabler i input-listan.
-        if (comma_tok->type != PTOK_COMMA) {
-            i--;
-            break;
-        }
+    if (node->summary != NULL) {
+        Sum_Free(node->summary);
+        node->summary = NULL;
     }
 
-    P_Token* rparen_tok = Array_GetElemPtr(tokens, i++);
+    Break_Free(node->breakpoints);
+    node->breakpoints = NULL;
 
-    ASSERT(rparen_tok->type == PTOK_R_PAREN);
+    free(node->profile);
+    node->profile = NULL;
+}
 
-    ParseTokens(&program_node, tokens, i);
+/*--------------------------------------
+ * Function: AST_IsLastNode()
+ * Parameters:
+ *   node  Noden som ska kontrolleras.
+ *
+ * Description:
+ *   Kontrollerar om den specificerade noden r den sista i sitt trd.
+ *------------------------------------*/
+Bool AST_IsLastNode(const AST_Node* node) {
+    // Om den angivna noden har ngra barn kan vi g en niv nedt, varfr den
+    // omjligt kan vara den sista i trdet.
+    int num_children = Array_Length(&node->children);
+    if (num_children > 0)
+        return FALSE;
+
+    AST_Node* parent = node->parent;
+    if (parent) {
+        int       num_siblings = Array_Length(&parent->children);
+        AST_Node* last_sibling = Array_GetElemPtr(&parent->children, num_siblings-1);
+
+        // Om den specificerade noden inte r den sista i syskonskaran s r det
+        // inte heller den sista noden i sitt trd.
+        if (node != last_sibling)
+            return FALSE;
+    }
 
-    return program_node;
+    return TRUE;
 }
 
 /*--------------------------------------
@@ -248,6 +290,21 @@ void AST_PrintNode(const AST_Node* node, int indent) {
     // visualisera syntax-trd.
 
     switch (node->type) {
+    case AST_ADD_CLEAR: {
+        int src = *(int*)Array_GetElemPtr(&node->values, 0);
+        printf("add_clear x%d", src);
+
+        int num_values = Array_Length(&node->values);
+        for (int i = 1; i < num_values; i += 2) {
+            int var    = *(int*)Array_GetElemPtr(&node->values, i);
+            int factor = *(int*)Array_GetElemPtr(&node->values, i+1);
+            printf(" x%d*%d", var, factor);
+        }
+
+        printf("\n");
+        break;
+    }
+
     case AST_ASSIGN: {
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
         int val = *(int*)Array_GetElemPtr(&node->values, 1);
@@ -255,6 +312,13 @@ void AST_PrintNode(const AST_Node* node, int indent) {
         break;
     }
 
+    case AST_COPY: {
+        int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+        int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+        printf("copy x%d x%d\n", var0, var1);
+        break;
+    }
+
     case AST_PRED: {
         int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
         int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
@@ -351,3 +415,54 @@ void AST_Repair(AST_Node* node) {
         AST_Repair(child);
     }
 }
+
+
+/*--------------------------------------
+ * Function: AST_ResolveVars()
+ * Parameters:
+ *   root   Root-noden i det AST vars variabler ska numreras om.
+ *   names  Array som initieras av funktionen och fylls med det ursprungliga
+ *          variabelnumret fr varje plats.
+ *
+ * Description:
+ *   Numrerar om alla variabler i trdet till tta platser 0, 1, 2 osv, s att
+ *   variabel-arrayen bara behver vara lika stor som antalet anvnda
+ *   variabler. De variabler som frekommer flest gnger i kllkoden fr de
+ *   lgsta platserna och hamnar drmed nra varandra i minnet. Plats i
+ *   motsvarar variabeln X<names[i]>. Glm inte anropa Array_Free()!
+ *------------------------------------*/
+void AST_ResolveVars(AST_Node* root, Array* names) {
+    ASSERT(root->type == AST_PROGRAM);
+
+    Var_Use* uses   = malloc(PLANG_NUM_VARS * sizeof(Var_Use));
+    int*     counts = calloc(PLANG_NUM_VARS, sizeof(int));
+    int*     slots  = malloc(PLANG_NUM_VARS * sizeof(int));
+
+    CountVarUses(root, counts);
+
+    int num_used = 0;
+    for (int i = 0; i < PLANG_NUM_VARS; i++) {
+        if (counts[i] > 0) {
+            uses[num_used].var   = i;
+            uses[num_used].count = counts[i];
+            num_used++;
+        }
+    }
+
+    qsort(uses, num_used, sizeof(Var_Use), CompareVarUses);
+
+    for (int i = 0; i < PLANG_NUM_VARS; i++)
+        slots[i] = -1;
+
+    Array_Init(names, sizeof(int));
+    for (int i = 0; i < num_used; i++) {
+        slots[uses[i].var] = i;
+        Array_AddElem(names, &uses[i].var);
+    }
+
+    RenumberVars(root, slots);
+
+    free(uses);
+    free(counts);
+    free(slots);
+}
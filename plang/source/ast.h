@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: ast.h
  * Created: January 3, 2015
- * Last changed: January 13, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -11,6 +11,16 @@
  *
  * Changes:
  *   Lade till parent-fltet i AST_Node-structen.
+ *   * Flyttade IsLastNode() frn vm.c hit som AST_IsLastNode().
+ *   * Nya nodtyper fr optimerade idiom: AST_ADD_CLEAR och AST_COPY.
+ *   * Lade till AST_FreeNode().
+ *   * Lade till summary-fltet i AST_Node-structen.
+ *   * Lade till AST_ResolveVars().
+ *   * Lade till row-, col- och breakpoints-flten i AST_Node-structen.
+ *   * Lade till profile-fltet i AST_Node-structen.
+ *   * AST_GenerateTree() tar kllkoden istllet fr en token-array.
+ *   * Tog bort AST_GenerateTree(), syntax-trdet byggs nu av Syn_Parse().
+ *   * AST_CreateNode() tar en arena som noden allokeras ur.
  *
  *----------------------------------------------------------------------------*/
 
@@ -21,9 +31,9 @@
  * INCLUDES
  *----------------------------------------------*/
 
+#include "arena.h"
 #include "array.h"
 #include "common.h"
-#include "tokenizer.h"
 
 /*------------------------------------------------
  * TYPES
@@ -36,7 +46,9 @@
  *   Den hr enum-typen beskriver de olika slags AST-noder som finns.
  *------------------------------------*/
 typedef enum {
+    AST_ADD_CLEAR, // Skapas av Opt_OptimizeTree(), se optimize.h.
     AST_ASSIGN,
+    AST_COPY,      // Skapas av Opt_OptimizeTree(), se optimize.h.
     AST_PRED,
     AST_PROGRAM,
     AST_RESULT,
@@ -49,12 +61,22 @@ typedef enum {
  *
  * Description:
  *   Den hr typen representerar en enskild nod i ett abstrakt syntax-trd.
+ *   row och col r positionen fr nodens frsta token i kllkoden, eller
+ *   noll fr root-noden.
  *------------------------------------*/
 typedef struct AST_Node {
            AST_Node_Type type;
     struct AST_Node*     parent;
            Array         children;
            Array         values;
+           int           row;
+           int           col;
+    struct Sum_Loop*     summary;     // Skapas av Sum_SummarizeTree(), se
+                                      // summary.h.
+    struct Break_Point*  breakpoints; // Skapas av Break_Add(), se
+                                      // breakpoint.h.
+    struct Prof_Node*    profile;     // Skapas av Prof_Start(), se
+                                      // profile.h.
 } AST_Node;
 
 /*------------------------------------------------
@@ -95,12 +117,17 @@ void AST_AddValue(AST_Node* node, int value) {
 /*--------------------------------------
  * Function: AST_CreateNode()
  * Parameters:
- *   type  Typen av noden som ska skapas.
+ *   type   Typen av noden som ska skapas.
+ *   arena  Arenan som nodens barn och vrden ska allokeras ur, eller NULL
+ *          fr malloc().
  *
  * Description:
- *   Den hr funktionen skapar en AST-nod.
+ *   Den hr funktionen skapar en AST-nod. Vrde-arrayen rymmer precis s
+ *   mnga vrden som nodtypen har, och barn-arrayen allokeras frst nr det
+ *   frsta barnet lggs till, s att lv-noder inte tar mer minne n de
+ *   behver.
  *------------------------------------*/
-AST_Node AST_CreateNode(AST_Node_Type type);
+AST_Node AST_CreateNode(AST_Node_Type type, Arena* arena);
 
 /*--------------------------------------
  * Function: AST_FindRoot()
@@ -121,6 +148,16 @@ AST_Node* AST_FindRoot(AST_Node* node) {
     return node;
 }
 
+/*--------------------------------------
+ * Function: AST_IsLastNode()
+ * Parameters:
+ *   node  Noden som ska kontrolleras.
+ *
+ * Description:
+ *   Kontrollerar om den specificerade noden r den sista i sitt trd.
+ *------------------------------------*/
+Bool AST_IsLastNode(const AST_Node* node);
+
 /*--------------------------------------
  * Function: AST_Repair()
  * Parameters:
@@ -133,16 +170,32 @@ AST_Node* AST_FindRoot(AST_Node* node) {
 void AST_Repair(AST_Node* node);
 
 /*--------------------------------------
- * Function: AST_GenerateTree()
+ * Function: AST_ResolveVars()
+ * Parameters:
+ *   root   Root-noden i det AST vars variabler ska numreras om.
+ *   names  Array som initieras av funktionen och fylls med det ursprungliga
+ *          variabelnumret fr varje plats.
+ *
+ * Description:
+ *   Numrerar om alla variabler i trdet till tta platser 0, 1, 2 osv, s att
+ *   variabel-arrayen bara behver vara lika stor som antalet anvnda
+ *   variabler. De variabler som frekommer flest gnger i kllkoden fr de
+ *   lgsta platserna och hamnar drmed nra varandra i minnet. Plats i
+ *   motsvarar variabeln X<names[i]>. Glm inte anropa Array_Free()!
+ *------------------------------------*/
+void AST_ResolveVars(AST_Node* root, Array* names);
+
+/*--------------------------------------
+ * Function: AST_FreeNode()
  * Parameters:
- *   tokens  En array innehllande s.k. tokens, frslagsvis genererade av
- *           funktionen Tok_Tokenize() i modulen tokenizer.c.
+ *   node  Noden som ska slppas ur minnet.
  *
  * Description:
- *   Den hr funktionen genererar ett abstrakt syntax-trd frn en array av
- *   tokens.
+ *   Slpper den specificerade noden, och rekursivt alla dess barn, ur minnet.
+ *   Sjlva AST_Node-structen slpps inte eftersom den normalt ligger i en
+ *   annan nods barn-array.
  *------------------------------------*/
-AST_Node AST_GenerateTree(const Array* tokens);
+void AST_FreeNode(AST_Node* node);
 
 /*--------------------------------------
  * Function: AST_PrintNode()
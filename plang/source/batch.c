@@ -0,0 +1,541 @@
+/*------------------------------------------------------------------------------
+ * File: batch.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Kr ett program med mnga uppsttningar input-vrden frn en CSV-fil,
+ *   frdelade ver flera trdar.
+ *
+ *   Filen lses in BATCH_CHUNK_ROWS rader t gngen. Trdarna plockar rader
+ *   ur blocket tills det r slut, och nr alla trdar r klara skrivs
+ *   resultaten ut i samma ordning som raderna innan nsta block lses in.
+ *   Bytekoden delas av alla trdar, men varje trd har en egen VM_Config.
+ *
+ * Changes:
+ *   * Raderna krs VM_LANES t gngen med VM_ExecLanes() om use_lanes r
+ *     sant.
+ *   * Grnser fr antalet loop-varv och krtiden fr varje rad.
+ *   * Ondliga loopar kan upptckas med detect_loops.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "batch.h"
+#include "bytecode.h"
+#include "common.h"
+#include "thread.h"
+#include "vm.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: BATCH_CHUNK_ROWS
+ *
+ * Description:
+ *   Antalet rader som lses in och krs t gngen.
+ *------------------------------------*/
+#define BATCH_CHUNK_ROWS 4096
+
+/*--------------------------------------
+ * Constant: BATCH_GRAB_ROWS
+ *
+ * Description:
+ *   Antalet rader som en trd plockar t gngen, s att trdarna inte
+ *   behver ta lset fr varje rad.
+ *------------------------------------*/
+#define BATCH_GRAB_ROWS 16
+
+/*--------------------------------------
+ * Constant: ROW_EOF
+ *
+ * Description:
+ *   Returneras av ReadRow() nr filen tagit slut.
+ *------------------------------------*/
+#define ROW_EOF 0
+
+/*--------------------------------------
+ * Constant: ROW_INVALID
+ *
+ * Description:
+ *   Returneras av ReadRow() om raden inte innehll rtt antal giltiga
+ *   vrden. Anvnds ven som resultat fr sdana rader.
+ *------------------------------------*/
+#define ROW_INVALID INT_MIN
+
+/*--------------------------------------
+ * Constant: ROW_OK
+ *
+ * Description:
+ *   Returneras av ReadRow() om raden lstes in.
+ *------------------------------------*/
+#define ROW_OK 1
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Batch
+ *
+ * Description:
+ *   Det som delas mellan trdarna. Allt under lock fr bara lsas eller
+ *   ndras av den som hller lset. Raderna i inputs och results som en trd
+ *   plockat tillhr dremot trden tills blocket r klart.
+ *------------------------------------*/
+typedef struct {
+    const BC_Program* prog;
+    const int*        input_vars;
+    int               num_inputs;
+    int               num_vars;
+    Bool              use_lanes;
+    long long         max_steps;
+    double            timeout_ms;
+    Bool              detect_loops;
+
+    int* inputs;  // num_inputs vrden per rad.
+    int* results; // Ett resultat per rad.
+
+    Mutex lock;
+    Cond  chunk_ready;  // Vcks nr ett nytt block finns att kra.
+    Cond  chunk_done;   // Vcks nr sista trden r klar med blocket.
+    int   chunk;        // Rknas upp fr varje nytt block.
+    int   num_rows;     // Antalet rader i blocket.
+    int   next_row;     // Nsta rad som ingen trd plockat.
+    int   num_working;  // Antalet trdar som inte r klara med blocket.
+    Bool  is_done;      // Sant nr alla block r krda.
+} Batch;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: ReadRow()
+ * Parameters:
+ *   fp          Filen som raden ska lsas frn.
+ *   values      Array som vrdena ska lagras i.
+ *   num_values  Antalet vrden som raden ska innehlla.
+ *   line        Pekare till radnumret, som rknas upp fr varje rad som
+ *               lses, ven tomma.
+ *
+ * Description:
+ *   Lser in nsta rad som inte r tom. Returnerar ROW_OK, ROW_INVALID eller
+ *   ROW_EOF.
+ *------------------------------------*/
+static int ReadRow(FILE* fp, int* values, int num_values, int* line) {
+    int c = getc(fp);
+
+    while (c == '\r' || c == '\n') {
+        if (c == '\n')
+            (*line)++;
+        c = getc(fp);
+    }
+
+    if (c == EOF)
+        return ROW_EOF;
+
+    (*line)++;
+
+    Bool is_valid = TRUE;
+    int  n        = 0;
+
+    while (TRUE) {
+        while (c == ' ' || c == '\t')
+            c = getc(fp);
+
+        long long val        = 0;
+        int       num_digits = 0;
+        while (c >= '0' && c <= '9') {
+            // Vi slutar rkna nr vrdet inte lngre ryms i en int, men lser
+            // resten av siffrorna nd.
+            if (val <= INT_MAX)
+                val = 10*val + (c - '0');
+            num_digits++;
+            c = getc(fp);
+        }
+
+        while (c == ' ' || c == '\t')
+            c = getc(fp);
+
+        if (num_digits == 0 || val > INT_MAX)
+            is_valid = FALSE;
+
+        if (n < num_values)
+            values[n] = (int)val;
+        n++;
+
+        if (c != ',')
+            break;
+
+        c = getc(fp);
+    }
+
+    if (c != '\r' && c != '\n' && c != EOF)
+        is_valid = FALSE;
+
+    while (c != '\n' && c != EOF)
+        c = getc(fp);
+
+    return (is_valid && n == num_values) ? ROW_OK : ROW_INVALID;
+}
+
+/*--------------------------------------
+ * Function: RunLanes()
+ * Parameters:
+ *   batch  Batch-krningen.
+ *   conf   Trdens egen konfiguration, med plats fr VM_LANES banor.
+ *   first  Den frsta raden i blocket som ska kras.
+ *   last   Raden efter den sista som ska kras.
+ *
+ * Description:
+ *   Kr programmet fr raderna first till last, VM_LANES rader t gngen.
+ *   Banorna krs i takt, s varje grupp tar lika lng tid som sin
+ *   lngsammaste rad. En bana som blir klar kan inte f en ny rad frrn
+ *   hela gruppen r klar, eftersom alla banor delar samma instruktion.
+ *------------------------------------*/
+static void RunLanes(Batch* batch, VM_Config* conf, int first, int last) {
+    int rows   [VM_LANES];
+    int results[VM_LANES];
+
+    int row = first;
+    while (row < last) {
+        // Ogiltiga rader krs inte, s de fr ingen bana.
+        int num_lanes = 0;
+        while (row < last && num_lanes < VM_LANES) {
+            if (batch->results[row] != ROW_INVALID)
+                rows[num_lanes++] = row;
+            row++;
+        }
+
+        if (num_lanes == 0)
+            break;
+
+        for (int i = 0; i < batch->num_vars * VM_LANES; i++)
+            conf->vars[i] = 0;
+
+        for (int j = 0; j < num_lanes; j++) {
+            const int* inputs = &batch->inputs[rows[j] * batch->num_inputs];
+            for (int i = 0; i < batch->num_inputs; i++)
+                conf->vars[batch->input_vars[i]*VM_LANES + j] = inputs[i];
+        }
+
+        VM_ExecLanes(batch->prog, conf, num_lanes, results);
+
+        for (int j = 0; j < num_lanes; j++)
+            batch->results[rows[j]] = results[j];
+    }
+}
+
+/*--------------------------------------
+ * Function: RunRow()
+ * Parameters:
+ *   batch  Batch-krningen.
+ *   conf   Trdens egen konfiguration.
+ *   row    Raden i blocket som ska kras.
+ *
+ * Description:
+ *   Kr programmet med input-vrdena p den angivna raden.
+ *------------------------------------*/
+static void RunRow(Batch* batch, VM_Config* conf, int row) {
+    if (batch->results[row] == ROW_INVALID)
+        return;
+
+    // Alla variabler brjar p noll, utom input-variablerna.
+    for (int i = 0; i < batch->num_vars; i++)
+        conf->vars[i] = 0;
+
+    const int* inputs = &batch->inputs[row * batch->num_inputs];
+    for (int i = 0; i < batch->num_inputs; i++)
+        conf->vars[batch->input_vars[i]] = inputs[i];
+
+    batch->results[row] = VM_ExecBytecode(batch->prog, conf);
+}
+
+/*--------------------------------------
+ * Function: RunRows()
+ * Parameters:
+ *   batch  Batch-krningen.
+ *   conf   Trdens egen konfiguration.
+ *   first  Den frsta raden i blocket som ska kras.
+ *   last   Raden efter den sista som ska kras.
+ *
+ * Description:
+ *   Kr programmet fr raderna first till last, med eller utan banor.
+ *------------------------------------*/
+static void RunRows(Batch* batch, VM_Config* conf, int first, int last) {
+    if (batch->use_lanes) {
+        RunLanes(batch, conf, first, last);
+        return;
+    }
+
+    for (int i = first; i < last; i++)
+        RunRow(batch, conf, i);
+}
+
+/*--------------------------------------
+ * Function: Worker()
+ * Parameters:
+ *   arg  Pekare till batch-krningen.
+ *
+ * Description:
+ *   Trdarnas huvudfunktion. Vntar p block och kr dess rader tills
+ *   alla block r krda.
+ *------------------------------------*/
+static void Worker(void* arg) {
+    Batch* batch = arg;
+    int    chunk = 0;
+
+    VM_Config conf;
+    conf.vars         = malloc(batch->num_vars * VM_LANES * sizeof(int) + 1);
+    conf.vars64       = NULL;
+    conf.big_vars     = NULL;
+    conf.num_vars     = batch->num_vars;
+    conf.var_names    = NULL;
+    conf.enable_debug = FALSE;
+    conf.single_step  = FALSE;
+    conf.max_steps    = batch->max_steps;
+    conf.timeout_ms   = batch->timeout_ms;
+    conf.detect_loops = batch->detect_loops;
+    conf.progress     = NULL;
+
+    Mutex_Lock(&batch->lock);
+
+    while (TRUE) {
+        while (batch->chunk == chunk && !batch->is_done)
+            Cond_Wait(&batch->chunk_ready, &batch->lock);
+
+        if (batch->chunk == chunk)
+            break; // Inga fler block.
+
+        chunk = batch->chunk;
+
+        while (batch->next_row < batch->num_rows) {
+            int first = batch->next_row;
+            int last  = first + BATCH_GRAB_ROWS;
+            if (last > batch->num_rows)
+                last = batch->num_rows;
+
+            batch->next_row = last;
+
+            // Raderna tillhr nu den hr trden, s vi kan slppa lset
+            // medan vi kr dem.
+            Mutex_Unlock(&batch->lock);
+            RunRows(batch, &conf, first, last);
+            Mutex_Lock(&batch->lock);
+        }
+
+        batch->num_working--;
+        if (batch->num_working == 0)
+            Cond_Broadcast(&batch->chunk_done);
+    }
+
+    Mutex_Unlock(&batch->lock);
+
+    free(conf.vars);
+}
+
+/*--------------------------------------
+ * Function: PrintResult()
+ * Parameters:
+ *   line    Radnumret i CSV-filen.
+ *   result  Resultatet, eller en felkod.
+ *
+ * Description:
+ *   Skriver ut resultatet fr en rad p formen rad,status,resultat.
+ *------------------------------------*/
+static void PrintResult(int line, int result) {
+    switch (result) {
+    case ROW_INVALID:
+        printf("%d,invalid input,\n", line);
+        break;
+    case VM_ERR_INF_LOOP:
+        printf("%d,infinite loop,\n", line);
+        break;
+    case VM_ERR_INVALID_VAR:
+        printf("%d,invalid variable,\n", line);
+        break;
+    case VM_ERR_LIMIT:
+        printf("%d,limit reached,\n", line);
+        break;
+    case VM_ERR_OVERFLOW:
+        printf("%d,overflow,\n", line);
+        break;
+    case VM_ERR_PREMATURE_RESULT:
+        printf("%d,premature result,\n", line);
+        break;
+    default:
+        printf("%d,ok,%d\n", line, result);
+        break;
+    }
+}
+
+/*--------------------------------------
+ * Function: Batch_Run()
+ * Parameters:
+ *   prog          Det bytekodsprogram som ska kras.
+ *   root          Root-noden i programmets AST, vars vrden anger
+ *                 input-variablerna.
+ *   num_vars      Antalet variabler, se AST_ResolveVars().
+ *   file_name     CSV-filen med input-vrden. Varje rad innehller ett
+ *                 kommaseparerat vrde fr varje input-variabel, i samma
+ *                 ordning som i PROGRAM-raden.
+ *   num_threads   Antalet trdar, eller noll fr en trd per processor.
+ *   use_lanes     Sant om raderna ska kras VM_LANES t gngen, se
+ *                 VM_ExecLanes(). Det gr bara fortare om raderna tar
+ *                 ungefr lika lng tid.
+ *   max_steps     Grnsen fr antalet loop-varv fr varje rad, se VM_Config.
+ *   timeout_ms    Tidsgrnsen fr varje rad, se VM_Config.
+ *   detect_loops  Sant om ondliga loopar ska upptckas, se VM_Config.
+ *
+ * Description:
+ *   Kr programmet en gng fr varje rad i filen och skriver ut resultaten i
+ *   samma ordning som raderna, fljt av den totala genomstrmningen. Filen
+ *   lses in block fr block, s den kan vara hur stor som helst. Returnerar
+ *   falskt om filen inte gick att ppna.
+ *------------------------------------*/
+Bool Batch_Run(const BC_Program* prog, const AST_Node* root, int num_vars,
+               const char* file_name, int num_threads, Bool use_lanes,
+               long long max_steps, double timeout_ms, Bool detect_loops)
+{
+    FILE* fp = fopen(file_name, "rb");
+    if (!fp)
+        return FALSE;
+
+    if (num_threads <= 0)
+        num_threads = Thread_NumCPUs();
+
+    Batch batch;
+    batch.prog         = prog;
+    batch.input_vars   = root->values.elems;
+    batch.num_inputs   = Array_Length(&root->values);
+    batch.num_vars     = num_vars;
+    batch.use_lanes    = use_lanes;
+    batch.max_steps    = max_steps;
+    batch.timeout_ms   = timeout_ms;
+    batch.detect_loops = detect_loops;
+    batch.inputs       = malloc(BATCH_CHUNK_ROWS * batch.num_inputs
+                                * sizeof(int) + 1);
+    batch.results      = malloc(BATCH_CHUNK_ROWS * sizeof(int));
+    batch.chunk        = 0;
+    batch.num_rows     = 0;
+    batch.next_row     = 0;
+    batch.num_working  = 0;
+    batch.is_done      = FALSE;
+
+    Mutex_Init(&batch.lock);
+    Cond_Init(&batch.chunk_ready);
+    Cond_Init(&batch.chunk_done);
+
+    Thread* threads = malloc(num_threads * sizeof(Thread));
+    for (int i = 0; i < num_threads; i++) {
+        if (!Thread_Create(&threads[i], Worker, &batch)) {
+            num_threads = i;
+            break;
+        }
+    }
+
+    // Om inga trdar gick att starta kr vi raderna sjlva.
+    VM_Config conf;
+    conf.vars         = malloc(num_vars * VM_LANES * sizeof(int) + 1);
+    conf.vars64       = NULL;
+    conf.big_vars     = NULL;
+    conf.num_vars     = num_vars;
+    conf.var_names    = NULL;
+    conf.enable_debug = FALSE;
+    conf.single_step  = FALSE;
+    conf.max_steps    = max_steps;
+    conf.timeout_ms   = timeout_ms;
+    conf.detect_loops = detect_loops;
+    conf.progress     = NULL;
+
+    int*   lines      = malloc(BATCH_CHUNK_ROWS * sizeof(int));
+    int    line       = 0;
+    int    num_rows   = 0;
+    int    num_failed = 0;
+    double start      = Thread_WallTimeMs();
+
+    printf("line,status,result\n");
+
+    while (TRUE) {
+        int n = 0;
+        while (n < BATCH_CHUNK_ROWS) {
+            int* values = &batch.inputs[n * batch.num_inputs];
+            int  status = ReadRow(fp, values, batch.num_inputs, &line);
+            if (status == ROW_EOF)
+                break;
+
+            batch.results[n] = (status == ROW_OK) ? 0 : ROW_INVALID;
+            lines[n++]       = line;
+        }
+
+        if (n == 0)
+            break;
+
+        if (num_threads > 0) {
+            Mutex_Lock(&batch.lock);
+            batch.num_rows    = n;
+            batch.next_row    = 0;
+            batch.num_working = num_threads;
+            batch.chunk++;
+            Cond_Broadcast(&batch.chunk_ready);
+
+            while (batch.num_working > 0)
+                Cond_Wait(&batch.chunk_done, &batch.lock);
+            Mutex_Unlock(&batch.lock);
+        }
+        else {
+            RunRows(&batch, &conf, 0, n);
+        }
+
+        for (int i = 0; i < n; i++) {
+            int result = batch.results[i];
+            if (result < 0 && result != VM_NO_RESULT)
+                num_failed++;
+
+            PrintResult(lines[i], result);
+        }
+
+        num_rows += n;
+    }
+
+    double time_ms = Thread_WallTimeMs() - start;
+
+    Mutex_Lock(&batch.lock);
+    batch.is_done      = TRUE;
+    Cond_Broadcast(&batch.chunk_ready);
+    Mutex_Unlock(&batch.lock);
+
+    for (int i = 0; i < num_threads; i++)
+        Thread_Join(&threads[i]);
+
+    printf("\nDone! %d rows (%d failed) in %.0f ms, %.0f rows/s using %d "
+           "thread(s).\n", num_rows, num_failed, time_ms,
+           (time_ms > 0.0) ? (1000.0 * num_rows) / time_ms : 0.0,
+           num_threads);
+
+    Cond_Free(&batch.chunk_done);
+    Cond_Free(&batch.chunk_ready);
+    Mutex_Free(&batch.lock);
+
+    free(conf.vars);
+    free(lines);
+    free(threads);
+    free(batch.results);
+    free(batch.inputs);
+    fclose(fp);
+
+    return TRUE;
+}
@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------------
+ * File: batch.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Kr ett program med mnga uppsttningar input-vrden frn en CSV-fil,
+ *   frdelade ver flera trdar.
+ *
+ * Changes:
+ *   * Parametern use_lanes till Batch_Run().
+ *   * Parametrarna max_steps och timeout_ms till Batch_Run().
+ *   * Parametern detect_loops till Batch_Run().
+ *----------------------------------------------------------------------------*/
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "ast.h"
+#include "bytecode.h"
+#include "common.h"
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Batch_Run()
+ * Parameters:
+ *   prog          Det bytekodsprogram som ska kras.
+ *   root          Root-noden i programmets AST, vars vrden anger
+ *                 input-variablerna.
+ *   num_vars      Antalet variabler, se AST_ResolveVars().
+ *   file_name     CSV-filen med input-vrden. Varje rad innehller ett
+ *                 kommaseparerat vrde fr varje input-variabel, i samma
+ *                 ordning som i PROGRAM-raden.
+ *   num_threads   Antalet trdar, eller noll fr en trd per processor.
+ *   use_lanes     Sant om raderna ska kras VM_LANES t gngen, se
+ *                 VM_ExecLanes(). Det gr bara fortare om raderna tar
+ *                 ungefr lika lng tid.
+ *   max_steps     Grnsen fr antalet loop-varv fr varje rad, se VM_Config.
+ *   timeout_ms    Tidsgrnsen fr varje rad, se VM_Config.
+ *   detect_loops  Sant om ondliga loopar ska upptckas, se VM_Config.
+ *
+ * Description:
+ *   Kr programmet en gng fr varje rad i filen och skriver ut resultaten i
+ *   samma ordning som raderna, fljt av den totala genomstrmningen. Filen
+ *   lses in block fr block, s den kan vara hur stor som helst. Returnerar
+ *   falskt om filen inte gick att ppna.
+ *------------------------------------*/
+Bool Batch_Run(const BC_Program* prog, const AST_Node* root, int num_vars,
+               const char* file_name, int num_threads, Bool use_lanes,
+               long long max_steps, double timeout_ms, Bool detect_loops);
+
+#endif // BATCH_H_
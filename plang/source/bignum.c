@@ -0,0 +1,479 @@
+/*------------------------------------------------------------------------------
+ * File: bignum.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Naturliga tal med godtycklig precision, fr -bignum. S lnge vrdet fr
+ *   plats i ett maskinord lagras det direkt i structen, och frst nr det
+ *   vxer ur ordet allokeras limbs p heapen.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "bignum.h"
+#include "common.h"
+#include "debug.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: CHUNK_BASE
+ *
+ * Description:
+ *   Den strsta tiopotens som fr plats i en limb. Vid omvandling till och
+ *   frn decimal form hanterar vi CHUNK_DIGITS siffror t gngen.
+ *------------------------------------*/
+#define CHUNK_BASE 1000000000u
+
+/*--------------------------------------
+ * Constant: CHUNK_DIGITS
+ *
+ * Description:
+ *   Antalet siffror i CHUNK_BASE-1.
+ *------------------------------------*/
+#define CHUNK_DIGITS 9
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+// Inline-funktionen i bignum.h mste ha en extern definition i precis en fil,
+// annars gr den inte att lnka nr kompilatorn inte lgger den inline.
+extern Bool Big_IsZero(const Big_Num* n);
+
+/*--------------------------------------
+ * Function: Compare()
+ * Parameters:
+ *   a  Det frsta talet.
+ *   b  Det andra talet.
+ *
+ * Description:
+ *   Returnerar ett negativt tal om a < b, noll om a = b och ett positivt tal
+ *   om a > b.
+ *------------------------------------*/
+static int Compare(const Big_Num* a, const Big_Num* b) {
+    // Tal med limbs r alltid strre n alla tal som fr plats i word, se
+    // Normalize().
+    if (a->num_limbs == 0 && b->num_limbs == 0) {
+        if (a->word == b->word)
+            return 0;
+        return (a->word < b->word) ? -1 : 1;
+    }
+
+    if (a->num_limbs != b->num_limbs)
+        return (a->num_limbs < b->num_limbs) ? -1 : 1;
+
+    for (int i = a->num_limbs-1; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i])
+            return (a->limbs[i] < b->limbs[i]) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/*--------------------------------------
+ * Function: GetLimb()
+ * Parameters:
+ *   n  Talet.
+ *   i  Limbens index.
+ *
+ * Description:
+ *   Returnerar limb nummer i, oavsett om vrdet ligger i word eller i limbs.
+ *------------------------------------*/
+static unsigned int GetLimb(const Big_Num* n, int i) {
+    if (n->num_limbs == 0) {
+        if (i == 0) return (unsigned int)n->word;
+        if (i == 1) return (unsigned int)(n->word >> 32);
+        return 0;
+    }
+
+    return (i < n->num_limbs) ? n->limbs[i] : 0;
+}
+
+/*--------------------------------------
+ * Function: NumLimbs()
+ * Parameters:
+ *   n  Talet.
+ *
+ * Description:
+ *   Returnerar antalet limbs som behvs fr att rymma talet.
+ *------------------------------------*/
+static int NumLimbs(const Big_Num* n) {
+    return (n->num_limbs == 0) ? 2 : n->num_limbs;
+}
+
+/*--------------------------------------
+ * Function: Normalize()
+ * Parameters:
+ *   n  Talet som ska normaliseras.
+ *
+ * Description:
+ *   Tar bort inledande nollor, och flyttar tillbaka vrdet till word om det
+ *   fr plats dr.
+ *------------------------------------*/
+static void Normalize(Big_Num* n) {
+    while (n->num_limbs > 0 && n->limbs[n->num_limbs-1] == 0)
+        n->num_limbs--;
+
+    if (n->num_limbs <= 2) {
+        n->word = (unsigned long long)GetLimb(n, 1) << 32 | GetLimb(n, 0);
+        n->num_limbs = 0;
+    }
+}
+
+/*--------------------------------------
+ * Function: Reserve()
+ * Parameters:
+ *   n          Talet.
+ *   num_limbs  Antalet limbs som det ska finnas plats fr.
+ *
+ * Description:
+ *   Ser till att det finns plats fr minst num_limbs limbs.
+ *------------------------------------*/
+static void Reserve(Big_Num* n, int num_limbs) {
+    if (num_limbs <= n->max_limbs)
+        return;
+
+    int max_limbs = 2 * n->max_limbs;
+    if (max_limbs < num_limbs)
+        max_limbs = num_limbs;
+
+    n->limbs     = realloc(n->limbs, max_limbs * sizeof(unsigned int));
+    n->max_limbs = max_limbs;
+}
+
+/*--------------------------------------
+ * Function: ToLimbs()
+ * Parameters:
+ *   n          Talet.
+ *   num_limbs  Antalet limbs som talet ska ha.
+ *
+ * Description:
+ *   Flyttar vrdet till limbs, med minst num_limbs limbs dr de vre r noll.
+ *   Vrdet ndras inte, men mste normaliseras eftert.
+ *------------------------------------*/
+static void ToLimbs(Big_Num* n, int num_limbs) {
+    Reserve(n, num_limbs);
+
+    if (n->num_limbs == 0) {
+        n->limbs[0]  = (unsigned int)n->word;
+        n->limbs[1]  = (unsigned int)(n->word >> 32);
+        n->num_limbs = 2;
+    }
+
+    while (n->num_limbs < num_limbs)
+        n->limbs[n->num_limbs++] = 0;
+}
+
+/*--------------------------------------
+ * Function: MulAddSmall()
+ * Parameters:
+ *   n    Talet.
+ *   mul  Faktorn, hgst CHUNK_BASE.
+ *   add  Termen, mindre n CHUNK_BASE.
+ *
+ * Description:
+ *   Berknar n := n*mul + add.
+ *------------------------------------*/
+static void MulAddSmall(Big_Num* n, unsigned int mul, unsigned int add) {
+    if (n->num_limbs == 0 && n->word <= (ULLONG_MAX - add) / mul) {
+        n->word = n->word*mul + add;
+        return;
+    }
+
+    ToLimbs(n, NumLimbs(n)+1);
+
+    unsigned long long carry = add;
+    for (int i = 0; i < n->num_limbs; i++) {
+        carry += (unsigned long long)n->limbs[i] * mul;
+        n->limbs[i] = (unsigned int)carry;
+        carry >>= 32;
+    }
+
+    Normalize(n);
+}
+
+/*--------------------------------------
+ * Function: Big_Add()
+ * Parameters:
+ *   dst  Talet som ska adderas till.
+ *   src  Talet som ska adderas.
+ *
+ * Description:
+ *   Berknar dst := dst + src.
+ *------------------------------------*/
+void Big_Add(Big_Num* dst, const Big_Num* src) {
+    if (dst->num_limbs == 0 && src->num_limbs == 0) {
+        unsigned long long sum = dst->word + src->word;
+        if (sum >= dst->word) {
+            dst->word = sum;
+            return;
+        }
+    }
+
+    // src kan vara samma tal som dst, men ToLimbs() ndrar inte vrdet och
+    // varje limb i src lses innan motsvarande limb i dst skrivs.
+    int num_limbs = NumLimbs(dst);
+    if (num_limbs < NumLimbs(src))
+        num_limbs = NumLimbs(src);
+
+    ToLimbs(dst, num_limbs+1);
+
+    unsigned long long carry = 0;
+    for (int i = 0; i < dst->num_limbs; i++) {
+        carry += (unsigned long long)dst->limbs[i] + GetLimb(src, i);
+        dst->limbs[i] = (unsigned int)carry;
+        carry >>= 32;
+    }
+
+    Normalize(dst);
+}
+
+/*--------------------------------------
+ * Function: Big_Copy()
+ * Parameters:
+ *   dst  Talet som ska skrivas ver.
+ *   src  Talet som ska kopieras.
+ *
+ * Description:
+ *   Berknar dst := src. dst mste redan vara initierat.
+ *------------------------------------*/
+void Big_Copy(Big_Num* dst, const Big_Num* src) {
+    if (dst == src)
+        return;
+
+    if (src->num_limbs == 0) {
+        dst->word      = src->word;
+        dst->num_limbs = 0;
+        return;
+    }
+
+    Reserve(dst, src->num_limbs);
+    memcpy(dst->limbs, src->limbs, src->num_limbs * sizeof(unsigned int));
+    dst->num_limbs = src->num_limbs;
+}
+
+/*--------------------------------------
+ * Function: Big_Dec()
+ * Parameters:
+ *   n  Talet som ska rknas ned.
+ *
+ * Description:
+ *   Rknar ned talet med ett, men aldrig under noll.
+ *------------------------------------*/
+void Big_Dec(Big_Num* n) {
+    if (n->num_limbs == 0) {
+        if (n->word > 0)
+            n->word--;
+        return;
+    }
+
+    // Tal med limbs r strre n noll, s lnet tar slut innan limbs gr det.
+    for (int i = 0; n->limbs[i]-- == 0; i++)
+        ;
+
+    Normalize(n);
+}
+
+/*--------------------------------------
+ * Function: Big_Free()
+ * Parameters:
+ *   n  Talet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper talets limbs ur minnet.
+ *------------------------------------*/
+void Big_Free(Big_Num* n) {
+    free(n->limbs);
+    Big_Init(n);
+}
+
+/*--------------------------------------
+ * Function: Big_FromStr()
+ * Parameters:
+ *   n    Talet som vrdet ska lagras i. Mste redan vara initierat.
+ *   str  Strngen som ska lsas av, ex. "123456789012345678901234567890".
+ *
+ * Description:
+ *   Lser in ett tal i decimal form. Returnerar falskt, utan att ndra n, om
+ *   strngen r tom eller innehller annat n siffror.
+ *------------------------------------*/
+Bool Big_FromStr(Big_Num* n, const char* str) {
+    int len = strlen(str);
+    if (len == 0)
+        return FALSE;
+
+    for (int i = 0; i < len; i++) {
+        if (str[i] < '0' || str[i] > '9')
+            return FALSE;
+    }
+
+    // Vi lser CHUNK_DIGITS siffror t gngen, utom i den frsta biten som
+    // fr resten.
+    Big_Set(n, 0);
+
+    int i = 0;
+    while (i < len) {
+        int num_digits = (i == 0 && len % CHUNK_DIGITS != 0)
+                       ? len % CHUNK_DIGITS : CHUNK_DIGITS;
+
+        unsigned int mul   = 1;
+        unsigned int chunk = 0;
+        for (int j = 0; j < num_digits; j++) {
+            mul   = mul*10;
+            chunk = chunk*10 + (str[i++] - '0');
+        }
+
+        MulAddSmall(n, mul, chunk);
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Big_Inc()
+ * Parameters:
+ *   n  Talet som ska rknas upp.
+ *
+ * Description:
+ *   Rknar upp talet med ett.
+ *------------------------------------*/
+void Big_Inc(Big_Num* n) {
+    if (n->num_limbs == 0 && n->word != ULLONG_MAX) {
+        n->word++;
+        return;
+    }
+
+    ToLimbs(n, NumLimbs(n)+1);
+
+    for (int i = 0; ++n->limbs[i] == 0; i++)
+        ;
+
+    Normalize(n);
+}
+
+/*--------------------------------------
+ * Function: Big_Init()
+ * Parameters:
+ *   n  Talet som ska initieras.
+ *
+ * Description:
+ *   Initierar ett tal till noll.
+ *------------------------------------*/
+void Big_Init(Big_Num* n) {
+    n->word      = 0;
+    n->limbs     = NULL;
+    n->num_limbs = 0;
+    n->max_limbs = 0;
+}
+
+/*--------------------------------------
+ * Function: Big_Set()
+ * Parameters:
+ *   n    Talet som ska skrivas ver.
+ *   val  Det nya vrdet.
+ *
+ * Description:
+ *   Berknar n := val.
+ *------------------------------------*/
+void Big_Set(Big_Num* n, unsigned long long val) {
+    n->word      = val;
+    n->num_limbs = 0;
+}
+
+/*--------------------------------------
+ * Function: Big_Sub()
+ * Parameters:
+ *   dst  Talet som ska subtraheras frn.
+ *   src  Talet som ska subtraheras.
+ *
+ * Description:
+ *   Berknar dst := dst - src, men aldrig under noll.
+ *------------------------------------*/
+void Big_Sub(Big_Num* dst, const Big_Num* src) {
+    if (Compare(dst, src) <= 0) {
+        Big_Set(dst, 0);
+        return;
+    }
+
+    if (dst->num_limbs == 0) {
+        dst->word -= src->word;
+        return;
+    }
+
+    // dst > src, s lnet tar slut innan limbs gr det.
+    long long borrow = 0;
+    for (int i = 0; i < dst->num_limbs; i++) {
+        long long diff = (long long)dst->limbs[i] - GetLimb(src, i) - borrow;
+        borrow = (diff < 0);
+        dst->limbs[i] = (unsigned int)(diff + (borrow << 32));
+    }
+
+    Normalize(dst);
+}
+
+/*--------------------------------------
+ * Function: Big_ToStr()
+ * Parameters:
+ *   n  Talet som ska skrivas ut.
+ *
+ * Description:
+ *   Returnerar talet i decimal form. Glm inte anropa free()!
+ *------------------------------------*/
+char* Big_ToStr(const Big_Num* n) {
+    if (n->num_limbs == 0) {
+        char* s = malloc(24);
+        sprintf(s, "%llu", n->word);
+        return s;
+    }
+
+    // Vi delar upprepade gnger med CHUNK_BASE och fr d fram siffrorna
+    // CHUNK_DIGITS t gngen, de minst signifikanta frst. Varje limb ger
+    // hgst tv sdana bitar, och talet har minst en limb, s det blir
+    // alltid minst en bit.
+    int           num_limbs  = n->num_limbs;
+    unsigned int* limbs      = malloc(num_limbs * sizeof(unsigned int));
+    unsigned int* chunks     = malloc(2 * num_limbs * sizeof(unsigned int));
+    int           num_chunks = 0;
+
+    memcpy(limbs, n->limbs, num_limbs * sizeof(unsigned int));
+
+    do {
+        unsigned long long rem = 0;
+        for (int i = num_limbs-1; i >= 0; i--) {
+            rem      = (rem << 32) | limbs[i];
+            limbs[i] = (unsigned int)(rem / CHUNK_BASE);
+            rem      = rem % CHUNK_BASE;
+        }
+
+        chunks[num_chunks++] = (unsigned int)rem;
+
+        while (num_limbs > 0 && limbs[num_limbs-1] == 0)
+            num_limbs--;
+    } while (num_limbs > 0);
+
+    char* s   = malloc(num_chunks*CHUNK_DIGITS + 1);
+    int   len = sprintf(s, "%u", chunks[num_chunks-1]);
+    for (int i = num_chunks-2; i >= 0; i--)
+        len += sprintf(s+len, "%09u", chunks[i]);
+
+    free(limbs);
+    free(chunks);
+
+    return s;
+}
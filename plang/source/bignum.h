@@ -0,0 +1,171 @@
+/*------------------------------------------------------------------------------
+ * File: bignum.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Naturliga tal med godtycklig precision, fr -bignum. S lnge vrdet fr
+ *   plats i ett maskinord lagras det direkt i structen, och frst nr det
+ *   vxer ur ordet allokeras limbs p heapen.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef BIGNUM_H_
+#define BIGNUM_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Big_Num
+ *
+ * Description:
+ *   Ett naturligt tal. Om num_limbs r noll ligger vrdet i word, annars i
+ *   limbs, 32 bitar per limb med den minst signifikanta frst. limbs sparas
+ *   ven nr vrdet krymper tillbaka till word, s att det inte behver
+ *   allokeras om nr vrdet vxer igen.
+ *------------------------------------*/
+typedef struct {
+    unsigned long long word;
+    unsigned int*      limbs;
+    int                num_limbs;
+    int                max_limbs;
+} Big_Num;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Big_Add()
+ * Parameters:
+ *   dst  Talet som ska adderas till.
+ *   src  Talet som ska adderas.
+ *
+ * Description:
+ *   Berknar dst := dst + src.
+ *------------------------------------*/
+void Big_Add(Big_Num* dst, const Big_Num* src);
+
+/*--------------------------------------
+ * Function: Big_Copy()
+ * Parameters:
+ *   dst  Talet som ska skrivas ver.
+ *   src  Talet som ska kopieras.
+ *
+ * Description:
+ *   Berknar dst := src. dst mste redan vara initierat.
+ *------------------------------------*/
+void Big_Copy(Big_Num* dst, const Big_Num* src);
+
+/*--------------------------------------
+ * Function: Big_Dec()
+ * Parameters:
+ *   n  Talet som ska rknas ned.
+ *
+ * Description:
+ *   Rknar ned talet med ett, men aldrig under noll.
+ *------------------------------------*/
+void Big_Dec(Big_Num* n);
+
+/*--------------------------------------
+ * Function: Big_Free()
+ * Parameters:
+ *   n  Talet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper talets limbs ur minnet.
+ *------------------------------------*/
+void Big_Free(Big_Num* n);
+
+/*--------------------------------------
+ * Function: Big_FromStr()
+ * Parameters:
+ *   n    Talet som vrdet ska lagras i. Mste redan vara initierat.
+ *   str  Strngen som ska lsas av, ex. "123456789012345678901234567890".
+ *
+ * Description:
+ *   Lser in ett tal i decimal form. Returnerar falskt, utan att ndra n, om
+ *   strngen r tom eller innehller annat n siffror.
+ *------------------------------------*/
+Bool Big_FromStr(Big_Num* n, const char* str);
+
+/*--------------------------------------
+ * Function: Big_Inc()
+ * Parameters:
+ *   n  Talet som ska rknas upp.
+ *
+ * Description:
+ *   Rknar upp talet med ett.
+ *------------------------------------*/
+void Big_Inc(Big_Num* n);
+
+/*--------------------------------------
+ * Function: Big_Init()
+ * Parameters:
+ *   n  Talet som ska initieras.
+ *
+ * Description:
+ *   Initierar ett tal till noll.
+ *------------------------------------*/
+void Big_Init(Big_Num* n);
+
+/*--------------------------------------
+ * Function: Big_IsZero()
+ * Parameters:
+ *   n  Talet som ska underskas.
+ *
+ * Description:
+ *   Returnerar sant om talet r noll.
+ *------------------------------------*/
+INLINE_HINT
+Bool Big_IsZero(const Big_Num* n) {
+    // Talet normaliseras alltid, s ett nollskilt tal ligger i word om det
+    // inte har limbs.
+    return (n->num_limbs == 0 && n->word == 0);
+}
+
+/*--------------------------------------
+ * Function: Big_Set()
+ * Parameters:
+ *   n    Talet som ska skrivas ver.
+ *   val  Det nya vrdet.
+ *
+ * Description:
+ *   Berknar n := val.
+ *------------------------------------*/
+void Big_Set(Big_Num* n, unsigned long long val);
+
+/*--------------------------------------
+ * Function: Big_Sub()
+ * Parameters:
+ *   dst  Talet som ska subtraheras frn.
+ *   src  Talet som ska subtraheras.
+ *
+ * Description:
+ *   Berknar dst := dst - src, men aldrig under noll.
+ *------------------------------------*/
+void Big_Sub(Big_Num* dst, const Big_Num* src);
+
+/*--------------------------------------
+ * Function: Big_ToStr()
+ * Parameters:
+ *   n  Talet som ska skrivas ut.
+ *
+ * Description:
+ *   Returnerar talet i decimal form. Glm inte anropa free()!
+ *------------------------------------*/
+char* Big_ToStr(const Big_Num* n);
+
+#endif // BIGNUM_H_
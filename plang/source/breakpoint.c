@@ -0,0 +1,286 @@
+/*------------------------------------------------------------------------------
+ * File: breakpoint.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Brytpunkter fr debug-lget, se breakpoint.h.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "breakpoint.h"
+#include "common.h"
+#include "debug.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: FindNode()
+ * Parameters:
+ *   node  Noden varifrn skningen ska brja.
+ *   row   Raden som sks.
+ *
+ * Description:
+ *   Returnerar den frsta satsen, i kllkodens ordning, som str p den
+ *   angivna raden eller senare. Returnerar NULL om det inte finns ngon.
+ *------------------------------------*/
+static AST_Node* FindNode(AST_Node* node, int row) {
+    if (node->type != AST_PROGRAM && node->row >= row)
+        return node;
+
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        AST_Node* found = FindNode(child, row);
+
+        if (found != NULL)
+            return found;
+    }
+
+    return NULL;
+}
+
+/*--------------------------------------
+ * Function: ParseOp()
+ * Parameters:
+ *   s   Strngen som ska tolkas. Pekar efter jmfrelsen eftert.
+ *   op  Jmfrelsen som ska fyllas i.
+ *
+ * Description:
+ *   Tolkar en jmfrelse. Returnerar falskt om det inte finns ngon.
+ *------------------------------------*/
+static Bool ParseOp(const char** s, Break_Op* op) {
+    const char* c = *s;
+
+    if      (c[0] == '=' && c[1] == '=') *op = BREAK_EQ;
+    else if (c[0] == '!' && c[1] == '=') *op = BREAK_NE;
+    else if (c[0] == '<' && c[1] == '=') *op = BREAK_LE;
+    else if (c[0] == '>' && c[1] == '=') *op = BREAK_GE;
+    else if (c[0] == '<')                *op = BREAK_LT;
+    else if (c[0] == '>')                *op = BREAK_GT;
+    else                                 return FALSE;
+
+    *s += (*op == BREAK_LT || *op == BREAK_GT) ? 1 : 2;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: ParseNat()
+ * Parameters:
+ *   s      Strngen som ska tolkas. Pekar efter talet eftert.
+ *   value  Talet som ska fyllas i.
+ *
+ * Description:
+ *   Tolkar ett naturligt tal. Returnerar falskt om det inte finns ngot.
+ *------------------------------------*/
+static Bool ParseNat(const char** s, int* value) {
+    if (!isdigit((unsigned char)**s))
+        return FALSE;
+
+    char* end;
+    long  n = strtol(*s, &end, 10);
+
+    if (n > INT_MAX)
+        return FALSE;
+
+    *value = (int)n;
+    *s     = end;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: SkipSpace()
+ * Parameters:
+ *   s  Strngen vars inledande blanktecken ska hoppas ver.
+ *
+ * Description:
+ *   Returnerar en pekare till det frsta tecknet som inte r ett blanktecken.
+ *------------------------------------*/
+static const char* SkipSpace(const char* s) {
+    while (isspace((unsigned char)*s))
+        s++;
+
+    return s;
+}
+
+/*--------------------------------------
+ * Function: Break_Add()
+ * Parameters:
+ *   root       Root-noden i det AST som brytpunkten ska lggas i.
+ *   bp         Brytpunkten, se Break_Parse(). Den kopieras.
+ *   var_names  Det ursprungliga variabelnumret fr varje plats, se
+ *              AST_ResolveVars().
+ *   num_vars   Antalet platser i var_names.
+ *
+ * Description:
+ *   Hnger brytpunkten p den frsta satsen p den angivna raden, eller p
+ *   nrmast fljande rad som har en sats. Returnerar raden brytpunkten
+ *   hamnade p, eller noll om det inte finns ngon sdan sats. Brytpunkten
+ *   slpps av AST_FreeNode().
+ *------------------------------------*/
+int Break_Add(AST_Node* root, const Break_Point* bp, const int* var_names,
+              int num_vars)
+{
+    AST_Node* node = FindNode(root, bp->row);
+    if (node == NULL)
+        return 0;
+
+    Break_Point* copy = malloc(sizeof(Break_Point));
+    *copy      = *bp;
+    copy->row  = node->row;
+    copy->var  = -1;
+    copy->next = NULL;
+
+    // Villkoret skrivs med de ursprungliga variabelnamnen, men ska lsa frn
+    // variablernas platser.
+    for (int i = 0; i < num_vars; i++) {
+        if (var_names[i] == bp->name) {
+            copy->var = i;
+            break;
+        }
+    }
+
+    // Brytpunkterna ligger i den ordning de lades till.
+    Break_Point** last = &node->breakpoints;
+    while (*last != NULL)
+        last = &(*last)->next;
+    *last = copy;
+
+    return node->row;
+}
+
+/*--------------------------------------
+ * Function: Break_Check()
+ * Parameters:
+ *   bp    Den frsta brytpunkten p en sats.
+ *   vars  Variabelvrdena.
+ *
+ * Description:
+ *   Returnerar den frsta brytpunkten vars villkor r uppfyllt, eller NULL om
+ *   ingen r det.
+ *------------------------------------*/
+const Break_Point* Break_Check(const Break_Point* bp, const int* vars) {
+    for ( ; bp != NULL; bp = bp->next) {
+        int  value = (bp->var >= 0) ? vars[bp->var] : 0;
+        Bool hit   = FALSE;
+
+        switch (bp->op) {
+        case BREAK_ALWAYS: hit = TRUE;                 break;
+        case BREAK_EQ:     hit = (value == bp->value); break;
+        case BREAK_GE:     hit = (value >= bp->value); break;
+        case BREAK_GT:     hit = (value >  bp->value); break;
+        case BREAK_LE:     hit = (value <= bp->value); break;
+        case BREAK_LT:     hit = (value <  bp->value); break;
+        case BREAK_NE:     hit = (value != bp->value); break;
+        default:           FAIL();
+        }
+
+        if (hit)
+            return bp;
+    }
+
+    return NULL;
+}
+
+/*--------------------------------------
+ * Function: Break_Free()
+ * Parameters:
+ *   bp  Den frsta brytpunkten i listan som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper brytpunkten och alla som fljer efter den ur minnet.
+ *------------------------------------*/
+void Break_Free(Break_Point* bp) {
+    while (bp != NULL) {
+        Break_Point* next = bp->next;
+        free(bp);
+        bp = next;
+    }
+}
+
+/*--------------------------------------
+ * Function: Break_Parse()
+ * Parameters:
+ *   s   En strng p formen "<rad>" eller "<rad> if X<n> <op> <tal>", dr
+ *       <op> r ==, !=, <, <=, > eller >=.
+ *   bp  Brytpunkten som ska fyllas i.
+ *
+ * Description:
+ *   Tolkar en brytpunkt som anvndaren skrivit in. Returnerar falskt om
+ *   strngen inte gr att tolka.
+ *------------------------------------*/
+Bool Break_Parse(const char* s, Break_Point* bp) {
+    bp->op    = BREAK_ALWAYS;
+    bp->name  = -1;
+    bp->var   = -1;
+    bp->value = 0;
+    bp->next  = NULL;
+
+    s = SkipSpace(s);
+    if (!ParseNat(&s, &bp->row) || bp->row == 0)
+        return FALSE;
+
+    s = SkipSpace(s);
+    if (*s == '\0')
+        return TRUE;
+
+    // "if" och X fr skrivas med stora eller sm bokstver.
+    if (tolower((unsigned char)s[0]) != 'i'
+     || tolower((unsigned char)s[1]) != 'f'
+     || !isspace((unsigned char)s[2]))
+    {
+        return FALSE;
+    }
+
+    s = SkipSpace(s+2);
+    if (tolower((unsigned char)*s) != 'x')
+        return FALSE;
+
+    s++;
+    if (!ParseNat(&s, &bp->name) || bp->name >= PLANG_NUM_VARS)
+        return FALSE;
+
+    s = SkipSpace(s);
+    if (!ParseOp(&s, &bp->op))
+        return FALSE;
+
+    s = SkipSpace(s);
+    if (!ParseNat(&s, &bp->value))
+        return FALSE;
+
+    return *SkipSpace(s) == '\0';
+}
+
+/*--------------------------------------
+ * Function: Break_Print()
+ * Parameters:
+ *   bp  Brytpunkten som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut brytpunktens rad och villkor, utan radbrytning.
+ *------------------------------------*/
+void Break_Print(const Break_Point* bp) {
+    static const char* ops[] = { "", "==", ">=", ">", "<=", "<", "!=" };
+
+    printf("line %d", bp->row);
+
+    if (bp->op != BREAK_ALWAYS)
+        printf(" if X%d %s %d", bp->name, ops[bp->op], bp->value);
+}
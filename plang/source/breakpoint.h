@@ -0,0 +1,132 @@
+/*------------------------------------------------------------------------------
+ * File: breakpoint.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Brytpunkter fr debug-lget. En brytpunkt anges med ett radnummer och
+ *   eventuellt ett villkor, ex. "42 if X3 == 1000", och hngs p den sats i
+ *   syntax-trdet som str p raden. Den virtuella maskinen behver d bara
+ *   titta p de satser som faktiskt har en brytpunkt.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef BREAKPOINT_H_
+#define BREAKPOINT_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "ast.h"
+#include "common.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Break_Op
+ *
+ * Description:
+ *   Jmfrelsen i en brytpunkts villkor.
+ *------------------------------------*/
+typedef enum {
+    BREAK_ALWAYS, // Inget villkor.
+    BREAK_EQ,     // ==
+    BREAK_GE,     // >=
+    BREAK_GT,     // >
+    BREAK_LE,     // <=
+    BREAK_LT,     // <
+    BREAK_NE      // !=
+} Break_Op;
+
+/*--------------------------------------
+ * Type: Break_Point
+ *
+ * Description:
+ *   En brytpunkt. name r variabelns ursprungliga nummer och var dess plats i
+ *   variabel-arrayen, eller -1 om programmet inte anvnder variabeln (den r
+ *   d alltid noll). next pekar p nsta brytpunkt p samma sats.
+ *------------------------------------*/
+typedef struct Break_Point {
+           int          row;
+           Break_Op     op;
+           int          name;
+           int          var;
+           int          value;
+    struct Break_Point* next;
+} Break_Point;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Break_Add()
+ * Parameters:
+ *   root       Root-noden i det AST som brytpunkten ska lggas i.
+ *   bp         Brytpunkten, se Break_Parse(). Den kopieras.
+ *   var_names  Det ursprungliga variabelnumret fr varje plats, se
+ *              AST_ResolveVars().
+ *   num_vars   Antalet platser i var_names.
+ *
+ * Description:
+ *   Hnger brytpunkten p den frsta satsen p den angivna raden, eller p
+ *   nrmast fljande rad som har en sats. Returnerar raden brytpunkten
+ *   hamnade p, eller noll om det inte finns ngon sdan sats. Brytpunkten
+ *   slpps av AST_FreeNode().
+ *------------------------------------*/
+int Break_Add(AST_Node* root, const Break_Point* bp, const int* var_names,
+              int num_vars);
+
+/*--------------------------------------
+ * Function: Break_Check()
+ * Parameters:
+ *   bp    Den frsta brytpunkten p en sats.
+ *   vars  Variabelvrdena.
+ *
+ * Description:
+ *   Returnerar den frsta brytpunkten vars villkor r uppfyllt, eller NULL om
+ *   ingen r det.
+ *------------------------------------*/
+const Break_Point* Break_Check(const Break_Point* bp, const int* vars);
+
+/*--------------------------------------
+ * Function: Break_Free()
+ * Parameters:
+ *   bp  Den frsta brytpunkten i listan som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper brytpunkten och alla som fljer efter den ur minnet.
+ *------------------------------------*/
+void Break_Free(Break_Point* bp);
+
+/*--------------------------------------
+ * Function: Break_Parse()
+ * Parameters:
+ *   s   En strng p formen "<rad>" eller "<rad> if X<n> <op> <tal>", dr
+ *       <op> r ==, !=, <, <=, > eller >=.
+ *   bp  Brytpunkten som ska fyllas i.
+ *
+ * Description:
+ *   Tolkar en brytpunkt som anvndaren skrivit in. Returnerar falskt om
+ *   strngen inte gr att tolka.
+ *------------------------------------*/
+Bool Break_Parse(const char* s, Break_Point* bp);
+
+/*--------------------------------------
+ * Function: Break_Print()
+ * Parameters:
+ *   bp  Brytpunkten som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut brytpunktens rad och villkor, utan radbrytning.
+ *------------------------------------*/
+void Break_Print(const Break_Point* bp);
+
+#endif // BREAKPOINT_H_
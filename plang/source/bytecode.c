@@ -0,0 +1,312 @@
+/*------------------------------------------------------------------------------
+ * File: bytecode.c
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   verstter abstrakta syntax-trd till en platt, linjr bytekod som den
+ *   virtuella maskinen kan kra i en enkel loop istllet fr att rekursivt g
+ *   igenom trdet.
+ *
+ * Changes:
+ *   * verstter AST_ADD_CLEAR- och AST_COPY-noder.
+ *   * Sammanfattade loopar inleds med en BC_SUMMARY-instruktion.
+ *   * BC_Compile() rknar ut det strsta loop-djupet, fr VM_ExecLanes().
+ *   * Varje instruktion minns noden den versattes frn, i BC_Program.nodes.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "bytecode.h"
+#include "common.h"
+#include "debug.h"
+#include "summary.h"
+#include "vm.h"
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: EmitInstr()
+ * Parameters:
+ *   prog  Programmet som instruktionen ska lggas till i.
+ *   node  Noden som instruktionen verstts frn.
+ *   op    Instruktionens typ.
+ *   a     Den frsta operanden.
+ *   b     Den andra operanden.
+ *
+ * Description:
+ *   Lgger till en instruktion sist i programmet och returnerar dess index.
+ *------------------------------------*/
+static int EmitInstr(BC_Program* prog, const AST_Node* node, BC_Opcode op,
+                     int a, int b)
+{
+    BC_Instr instr = { .op = op, .a = a, .b = b };
+
+    Array_AddElem(&prog->instrs, &instr);
+    Array_AddElem(&prog->nodes , &node);
+
+    return Array_Length(&prog->instrs) - 1;
+}
+
+/*--------------------------------------
+ * Function: IsValidVar()
+ * Parameters:
+ *   var  Variabelindexet som ska kontrolleras.
+ *
+ * Description:
+ *   Returnerar sant om variabelindexet ligger inom variabel-arrayen.
+ *------------------------------------*/
+static Bool IsValidVar(int var) {
+    return (var >= 0 && var < PLANG_NUM_VARS);
+}
+
+/*--------------------------------------
+ * Function: CompileNode()
+ * Parameters:
+ *   node   Den nod som ska versttas till bytekod.
+ *   prog   Det program som bytekoden ska lagras i.
+ *   depth  Antalet loopar som noden ligger i.
+ *
+ * Description:
+ *   verstter den specificerade noden, och rekursivt alla dess barn, till
+ *   bytekod.
+ *------------------------------------*/
+static void CompileNode(const AST_Node* node, BC_Program* prog, int depth) {
+    // Ogiltiga variabler ger fel frst nr instruktionen faktiskt krs, precis
+    // som i VM_ExecAST(), s vi erstter sdana instruktioner med BC_ERROR
+    // istllet fr att avbryta versttningen.
+
+    switch (node->type) {
+    /*----------------------------------------------------
+     * PROGRAM (<variabel>[, <variabel>])
+     *--------------------------------------------------*/
+    case AST_PROGRAM: {
+        int num_children = Array_Length(&node->children);
+        for (int i = 0; i < num_children; i++) {
+            AST_Node* child = Array_GetElemPtr(&node->children, i);
+            CompileNode(child, prog, depth);
+        }
+
+        // Om programmet tar slut utan RESULT-nod finns inget resultat.
+        EmitInstr(prog, node, BC_HALT, 0, 0);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * X<src> * faktor lggs till andra variabler, X<src> := 0
+     *--------------------------------------------------*/
+    case AST_ADD_CLEAR: {
+        // Faktorn r nstan alltid ett, s vi upprepar helt enkelt BC_ADD-
+        // eller BC_SUB-instruktionen lika mnga gnger som faktorn anger.
+
+        int src = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (!IsValidVar(src)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+            break;
+        }
+
+        int num_values = Array_Length(&node->values);
+        for (int i = 1; i < num_values; i += 2) {
+            int var    = *(int*)Array_GetElemPtr(&node->values, i);
+            int factor = *(int*)Array_GetElemPtr(&node->values, i+1);
+
+            if (!IsValidVar(var)) {
+                EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+                break;
+            }
+
+            for (int j = 0; j < factor; j++)
+                EmitInstr(prog, node, BC_ADD, var, src);
+            for (int j = 0; j < -factor; j++)
+                EmitInstr(prog, node, BC_SUB, var, src);
+        }
+
+        EmitInstr(prog, node, BC_ASSIGN, src, 0);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * <variabel> := <naturligt-tal>
+     *--------------------------------------------------*/
+    case AST_ASSIGN: {
+        int var = *(int*)Array_GetElemPtr(&node->values, 0);
+        int val = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(var)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+            break;
+        }
+
+        EmitInstr(prog, node, BC_ASSIGN, var, (val < 0) ? 0 : val);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * X<dst> := X<src>
+     *--------------------------------------------------*/
+    case AST_COPY: {
+        int dst = *(int*)Array_GetElemPtr(&node->values, 0);
+        int src = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(dst) || !IsValidVar(src)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+            break;
+        }
+
+        EmitInstr(prog, node, BC_COPY, dst, src);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * <variabel> := PRED(<variabel>)
+     * <variabel> := SUCC(<variabel>)
+     *--------------------------------------------------*/
+    case AST_PRED:
+    case AST_SUCC: {
+        int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+        int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(var0) || !IsValidVar(var1)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+            break;
+        }
+
+        // X1 := PRED(X1) och X1 := SUCC(X1) r s vanliga att de fr egna
+        // instruktioner med bara en operand.
+        if (var0 == var1) {
+            BC_Opcode op = (node->type == AST_PRED) ? BC_DEC : BC_INC;
+            EmitInstr(prog, node, op, var0, 0);
+        }
+        else {
+            BC_Opcode op = (node->type == AST_PRED) ? BC_PRED : BC_SUCC;
+            EmitInstr(prog, node, op, var0, var1);
+        }
+
+        break;
+    }
+
+    /*----------------------------------------------------
+     * WHILE <variabel> != 0 DO ... END
+     *--------------------------------------------------*/
+    case AST_WHILE: {
+        // While-loopar verstts till ett villkorligt hopp frbi loopen, fljt
+        // av loopens innehll och ett villkorligt hopp tillbaka till brjan av
+        // innehllet. P s vis krs bara ett hopp per iteration.
+        //
+        //          JZ  X<var>, end
+        //   body:  ...
+        //          JNZ X<var>, body
+        //   end:
+        //
+        // Om loopen har sammanfattats av Sum_SummarizeTree() frsker vi
+        // frst kra sammanfattningen, och hoppar i s fall direkt till end.
+
+        int var = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (!IsValidVar(var)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+            break;
+        }
+
+        int sum = -1;
+        if (node->summary != NULL) {
+            int index = Array_Length(&prog->summaries);
+            Array_AddElem(&prog->summaries, &node->summary);
+            sum = EmitInstr(prog, node, BC_SUMMARY, index, 0);
+        }
+
+        int jz   = EmitInstr(prog, node, BC_JZ, var, 0);
+        int body = Array_Length(&prog->instrs);
+
+        if (depth + 1 > prog->max_depth)
+            prog->max_depth = depth + 1;
+
+        int num_children = Array_Length(&node->children);
+        for (int i = 0; i < num_children; i++) {
+            AST_Node* child = Array_GetElemPtr(&node->children, i);
+            CompileNode(child, prog, depth + 1);
+        }
+
+        EmitInstr(prog, node, BC_JNZ, var, body);
+
+        // Nu vet vi var loopen tar slut, s vi fyller i hoppadresserna.
+        BC_Instr* jz_instr = Array_GetElemPtr(&prog->instrs, jz);
+        jz_instr->b = Array_Length(&prog->instrs);
+
+        if (sum >= 0) {
+            BC_Instr* sum_instr = Array_GetElemPtr(&prog->instrs, sum);
+            sum_instr->b = Array_Length(&prog->instrs);
+        }
+
+        break;
+    }
+
+    /*----------------------------------------------------
+     * RESULT (<variabel>)
+     *--------------------------------------------------*/
+    case AST_RESULT: {
+        int var = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (!IsValidVar(var)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_INVALID_VAR, 0);
+            break;
+        }
+
+        if (!AST_IsLastNode(node)) {
+            EmitInstr(prog, node, BC_ERROR, VM_ERR_PREMATURE_RESULT, 0);
+            break;
+        }
+
+        EmitInstr(prog, node, BC_RESULT, var, 0);
+        break;
+    }
+
+    default:
+        // Det hr ska inte hnda.
+        FAIL();
+    }
+}
+
+/*--------------------------------------
+ * Function: BC_Compile()
+ * Parameters:
+ *   root  Root-noden i det AST som ska versttas till bytekod.
+ *   prog  Det program som bytekoden ska lagras i.
+ *
+ * Description:
+ *   verstter ett abstrakt syntax-trd till bytekod. Glm inte anropa
+ *   BC_Free()!
+ *------------------------------------*/
+void BC_Compile(const AST_Node* root, BC_Program* prog) {
+    ASSERT(root->type == AST_PROGRAM);
+
+    Array_Init(&prog->instrs   , sizeof(BC_Instr));
+    Array_Init(&prog->nodes    , sizeof(AST_Node*));
+    Array_Init(&prog->summaries, sizeof(Sum_Loop*));
+    prog->max_depth = 0;
+
+    CompileNode(root, prog, 0);
+}
+
+/*--------------------------------------
+ * Function: BC_Free()
+ * Parameters:
+ *   prog  Programmet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper ett bytekodsprogram ur minnet.
+ *------------------------------------*/
+void BC_Free(BC_Program* prog) {
+    Array_Free(&prog->instrs);
+    Array_Free(&prog->nodes);
+    Array_Free(&prog->summaries);
+}
@@ -0,0 +1,115 @@
+/*------------------------------------------------------------------------------
+ * File: bytecode.h
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   verstter abstrakta syntax-trd till en platt, linjr bytekod som den
+ *   virtuella maskinen kan kra i en enkel loop istllet fr att rekursivt g
+ *   igenom trdet.
+ *
+ * Changes:
+ *   * Instruktionerna BC_ADD, BC_COPY och BC_SUB fr optimerade idiom.
+ *   * Instruktionen BC_SUMMARY fr sammanfattade loopar.
+ *   * max_depth i BC_Program.
+ *   * nodes i BC_Program, med noden som varje instruktion kommer ifrn.
+ *----------------------------------------------------------------------------*/
+
+#ifndef BYTECODE_H_
+#define BYTECODE_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: BC_Opcode
+ *
+ * Description:
+ *   De instruktioner som finns i bytekoden. Operanderna a och b i BC_Instr
+ *   anvnds enligt kommentarerna nedan.
+ *------------------------------------*/
+typedef enum {
+    BC_ADD,    // X<a> := X<a> + X<b>
+    BC_ASSIGN, // X<a> := b
+    BC_COPY,   // X<a> := X<b>
+    BC_DEC,    // X<a> := PRED(X<a>)
+    BC_ERROR,  // Avbryt exekveringen med felkoden a.
+    BC_HALT,   // Avbryt exekveringen utan resultat.
+    BC_INC,    // X<a> := SUCC(X<a>)
+    BC_JNZ,    // Hoppa till instruktion b om X<a> != 0.
+    BC_JZ,     // Hoppa till instruktion b om X<a> == 0.
+    BC_PRED,   // X<a> := PRED(X<b>)
+    BC_RESULT, // RESULT (X<a>)
+    BC_SUB,    // X<a> := X<a> - X<b>, dock inte under noll.
+    BC_SUCC,   // X<a> := SUCC(X<b>)
+    BC_SUMMARY // Hoppa till instruktion b om sammanfattning a kunde kras.
+} BC_Opcode;
+
+/*--------------------------------------
+ * Type: BC_Instr
+ *
+ * Description:
+ *   En enskild instruktion med frdigavkodade operander.
+ *------------------------------------*/
+typedef struct {
+    BC_Opcode op;
+    int       a;
+    int       b;
+} BC_Instr;
+
+/*--------------------------------------
+ * Type: BC_Program
+ *
+ * Description:
+ *   Ett helt program i bytekodsform. summaries innehller pekare till de
+ *   loop-sammanfattningar som BC_SUMMARY anvnder. De gs av syntax-trdet.
+ *   max_depth r det strsta antalet nstlade loopar i programmet. nodes
+ *   innehller, fr varje instruktion i instrs, en pekare till noden som den
+ *   versattes frn, s att VM_CheckLimits() vet vilken loop som hoppar
+ *   tillbaka.
+ *------------------------------------*/
+typedef struct {
+    Array instrs;
+    Array nodes;
+    Array summaries;
+    int   max_depth;
+} BC_Program;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: BC_Compile()
+ * Parameters:
+ *   root  Root-noden i det AST som ska versttas till bytekod.
+ *   prog  Det program som bytekoden ska lagras i.
+ *
+ * Description:
+ *   verstter ett abstrakt syntax-trd till bytekod. Glm inte anropa
+ *   BC_Free()!
+ *------------------------------------*/
+void BC_Compile(const AST_Node* root, BC_Program* prog);
+
+/*--------------------------------------
+ * Function: BC_Free()
+ * Parameters:
+ *   prog  Programmet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper ett bytekodsprogram ur minnet.
+ *------------------------------------*/
+void BC_Free(BC_Program* prog);
+
+#endif // BYTECODE_H_
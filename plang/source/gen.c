@@ -0,0 +1,680 @@
+/*------------------------------------------------------------------------------
+ * File: gen.c
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Genererar P-program och mter kompilatorns frsta faser, se gen.h.
+ *
+ * Changes:
+ *   * Gen_BenchTokenizer() mter tokeniseraren fr sig.
+ *   * Syntax-kontrollen och syntax-trdet mts utan ngon token-array.
+ *   * Mter Syn_Parse(), som kontrollerar syntaxen och bygger syntax-trdet
+ *     i samma pass.
+ *   * Loops ms r skillnaden i tid nr loop-variablerna rknas ned sist
+ *     istllet fr frst, som nu ska vara nra noll.
+ *   * Syntax-trdet och felmeddelandena allokeras ur en arena, precis som nr
+ *     ett program kompileras.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "arena.h"
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "debug.h"
+#include "gen.h"
+#include "syntax.h"
+#include "thread.h"
+#include "timing.h"
+#include "tokenizer.h"
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: DEPTH_NUM_RUNS
+ *
+ * Description:
+ *   Antalet gnger som programmen med olika loop-djup mts.
+ *------------------------------------*/
+#define DEPTH_NUM_RUNS 3
+
+/*--------------------------------------
+ * Constant: DEPTH_NUM_STMTS
+ *
+ * Description:
+ *   Antalet satser i programmen som mts med olika loop-djup. Antalet anges
+ *   istllet fr storleken, eftersom indenteringen gr djupa program strre.
+ *------------------------------------*/
+#define DEPTH_NUM_STMTS 32768
+
+/*--------------------------------------
+ * Constant: MAX_BENCH_DEPTH
+ *
+ * Description:
+ *   Det strsta loop-djupet som mts. Djupen dubblas frn ett upp till detta.
+ *------------------------------------*/
+#define MAX_BENCH_DEPTH 64
+
+/*--------------------------------------
+ * Constant: MAX_LINE_LEN
+ *
+ * Description:
+ *   Det strsta antal tecken i en rad, utan indentering.
+ *------------------------------------*/
+#define MAX_LINE_LEN 128
+
+/*--------------------------------------
+ * Constant: MIN_BENCH_BYTES
+ *
+ * Description:
+ *   Den minsta mngd kllkod, i byte, som mts fr varje storlek. Mindre
+ *   program mts flera gnger, och den snabbaste gngen anvnds, s att
+ *   klockans upplsning inte pverkar resultatet.
+ *------------------------------------*/
+#define MIN_BENCH_BYTES (4*1024*1024)
+
+/*--------------------------------------
+ * Constant: MIN_BENCH_SIZE
+ *
+ * Description:
+ *   Storleken, i byte, p det minsta programmet som mts.
+ *------------------------------------*/
+#define MIN_BENCH_SIZE 1024
+
+/*--------------------------------------
+ * Constant: TOK_BENCH_BYTES
+ *
+ * Description:
+ *   Den mngd kllkod, i byte, som Gen_BenchTokenizer() delar upp i tokens
+ *   fr varje storlek. Den snabbaste gngen anvnds.
+ *------------------------------------*/
+#define TOK_BENCH_BYTES (256*1024*1024)
+
+/*--------------------------------------
+ * Constant: TOK_MIN_RUNS
+ *
+ * Description:
+ *   Det minsta antal gnger som Gen_BenchTokenizer() delar upp ett program.
+ *------------------------------------*/
+#define TOK_MIN_RUNS 3
+
+/*--------------------------------------
+ * Constant: TOK_MIN_SIZE
+ *
+ * Description:
+ *   Storleken, i byte, p det minsta programmet som Gen_BenchTokenizer()
+ *   mter. Mindre program sger mer om klockan n om tokeniseraren.
+ *------------------------------------*/
+#define TOK_MIN_SIZE (64*1024)
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Buffer
+ *
+ * Description:
+ *   Kllkoden som genereras. text r alltid NUL-terminerad.
+ *------------------------------------*/
+typedef struct {
+    char*     text;
+    long long length;
+    long long max_length;
+} Buffer;
+
+/*--------------------------------------
+ * Type: Front_Result
+ *
+ * Description:
+ *   Mtningen av ett program. Tiderna r de snabbaste av alla krningar, och
+ *   loop_ns skillnaden i tid fr Syn_Parse() nr loop-variablerna rknas ned
+ *   sist respektive frst i looparna.
+ *------------------------------------*/
+typedef struct {
+    long long num_tokens;
+    long long num_nodes;
+    long long peak_bytes;
+    long long tokenize_ns;
+    long long parse_ns;
+    long long loop_ns;
+} Front_Result;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Append()
+ * Parameters:
+ *   buf    Bufferten som texten ska lggas till i.
+ *   depth  Antal niver som raden ska indenteras.
+ *   fmt    Formatstrng fr raden, som till printf().
+ *
+ * Description:
+ *   Lgger till en rad i bufferten, och gr den strre om det behvs.
+ *------------------------------------*/
+static void Append(Buffer* buf, int depth, const char* fmt, ...) {
+    char    line[MAX_LINE_LEN];
+    va_list args;
+
+    va_start(args, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+
+    ASSERT(len >= 0 && len < (int)sizeof(line));
+
+    long long needed = buf->length + 4*depth + len + 2;
+    if (needed > buf->max_length) {
+        long long old_max_length = buf->max_length;
+
+        while (buf->max_length < needed)
+            buf->max_length *= 2;
+
+        buf->text = realloc(buf->text, buf->max_length);
+
+        Timing_CountAlloc(buf->max_length);
+        Timing_CountFree(old_max_length);
+    }
+
+    char* s = buf->text + buf->length;
+
+    memset(s, ' ', 4*depth);
+    s += 4*depth;
+
+    memcpy(s, line, len);
+    s += len;
+
+    *(s++) = '\n';
+    *s     = '\0';
+
+    buf->length = s - buf->text;
+}
+
+/*--------------------------------------
+ * Function: CountNodes()
+ * Parameters:
+ *   node  Noden vars undertrd ska rknas.
+ *
+ * Description:
+ *   Returnerar antalet noder i trdet, inklusive noden sjlv.
+ *------------------------------------*/
+static long long CountNodes(const AST_Node* node) {
+    long long num_nodes = 1;
+
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        num_nodes += CountNodes(child);
+    }
+
+    return num_nodes;
+}
+
+/*--------------------------------------
+ * Function: FormatSize()
+ * Parameters:
+ *   num_bytes  Storleken i byte.
+ *   buf        Bufferten som texten ska skrivas till. Den mste rymma 32
+ *              tecken.
+ *
+ * Description:
+ *   Skriver storleken i den strsta enhet som gr jmnt ut, ex. "64 MB".
+ *------------------------------------*/
+static void FormatSize(long long num_bytes, char* buf) {
+    const char* units[] = { "B", "KB", "MB", "GB" };
+
+    int unit = 0;
+    while (unit < 3 && num_bytes >= 1024 && num_bytes % 1024 == 0) {
+        num_bytes /= 1024;
+        unit++;
+    }
+
+    sprintf(buf, "%lld %s", num_bytes, units[unit]);
+}
+
+/*--------------------------------------
+ * Function: NextRandom()
+ * Parameters:
+ *   state  Slumptalsgeneratorns tillstnd.
+ *
+ * Description:
+ *   Returnerar ett slumptal mellan noll och 32767. Generatorn r skriven hr
+ *   istllet fr att anvnda rand(), s att programmen blir likadana p alla
+ *   plattformar.
+ *------------------------------------*/
+static int NextRandom(unsigned int* state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7fff;
+}
+
+/*--------------------------------------
+ * Function: RandomVar()
+ * Parameters:
+ *   state        Slumptalsgeneratorns tillstnd.
+ *   num_vars     Antalet variabler.
+ *   is_loop_var  Sant fr de variabler som styr en omgivande loop.
+ *
+ * Description:
+ *   Returnerar numret p en slumpvis vald variabel som inte styr ngon av de
+ *   omgivande looparna.
+ *------------------------------------*/
+static int RandomVar(unsigned int* state, int num_vars,
+                     const Bool* is_loop_var)
+{
+    while (TRUE) {
+        int var = 1 + NextRandom(state) % num_vars;
+        if (!is_loop_var[var])
+            return var;
+    }
+}
+
+/*--------------------------------------
+ * Function: MeasureOnce()
+ * Parameters:
+ *   options    Instllningarna fr programmet.
+ *   result     Resultatet. Tiderna erstts om de r snabbare n de som redan
+ *              finns dr.
+ *   parse_ns   Pekare till dr tiden fr Syn_Parse() ska lagras.
+ *
+ * Description:
+ *   Genererar och mter ett program. Returnerar falskt om programmet inte
+ *   klarade syntax-kontrollen.
+ *------------------------------------*/
+static Bool MeasureOnce(const Gen_Options* options, Front_Result* result,
+                        long long* parse_ns)
+{
+    Timing_Enable();
+    Timing_Begin("Front end", TRUE);
+
+    char* source = Gen_Program(options, NULL);
+
+    Arena arena;  Arena_Init(&arena);
+    Array errors; Array_InitSized(&errors, sizeof(Syntax_Error), 0, &arena);
+
+    // Syn_Parse() delar sjlv upp kllkoden, s tokens rknas hr bara fr
+    // att mta tokeniseraren fr sig.
+    P_Tokenizer tokenizer;
+    P_Token     tok;
+    long long   num_tokens = 0;
+
+    long long start_ns = Thread_WallTimeNs();
+    Tok_Init(&tokenizer, source);
+    while (Tok_Next(&tokenizer, &tok))
+        num_tokens++;
+    long long tokenize_ns = Thread_WallTimeNs();
+    AST_Node  tree;
+    Bool      is_valid  = Syn_Parse(source, &errors, &tree, &arena);
+    long long syntax_ns = Thread_WallTimeNs();
+
+    result->peak_bytes = Timing_PeakBytes();
+    Timing_Disable();
+
+    syntax_ns   -= tokenize_ns;
+    tokenize_ns -= start_ns;
+
+    if (tokenize_ns < result->tokenize_ns)
+        result->tokenize_ns = tokenize_ns;
+    if (syntax_ns   < *parse_ns)
+        *parse_ns = syntax_ns;
+
+    result->num_tokens = num_tokens;
+    result->num_nodes  = is_valid ? CountNodes(&tree) : 0;
+
+    // De genererade programmen ska inte ens ge ngra varningar.
+    int num_errors = Array_Length(&errors);
+
+    // Trdet har inget minne utanfr arenan, eftersom det inte har
+    // optimerats eller sammanfattats.
+    Arena_Free(&arena);
+    free(source);
+
+    return num_errors == 0;
+}
+
+/*--------------------------------------
+ * Function: Measure()
+ * Parameters:
+ *   label     Texten i radens frsta kolumn, ex. "64 MB".
+ *   options   Instllningarna fr programmet. dec_first anvnds inte.
+ *   num_runs  Antalet gnger programmet ska mtas.
+ *
+ * Description:
+ *   Mter programmet och skriver ut en rad med resultatet. Returnerar falskt
+ *   om programmet inte klarade syntax-kontrollen.
+ *------------------------------------*/
+static Bool Measure(const char* label, const Gen_Options* options,
+                    long long num_runs)
+{
+    Gen_Options dec_last  = *options;
+    Gen_Options dec_first = *options;
+
+    dec_last.dec_first  = FALSE;
+    dec_first.dec_first = TRUE;
+
+    // vriga flt nollstlls, s att resultatet r definierat ven om
+    // MeasureOnce() aldrig krs.
+    Front_Result result = { .tokenize_ns = LLONG_MAX };
+
+    long long parse_ns        = LLONG_MAX;
+    long long dec_first_ns    = LLONG_MAX;
+    Front_Result first_result = result;
+
+    for (long long i = 0; i < num_runs; i++) {
+        if (!MeasureOnce(&dec_last , &result      , &parse_ns    )
+         || !MeasureOnce(&dec_first, &first_result, &dec_first_ns))
+        {
+            printf("%7s syntax errors in generated program\n", label);
+            return FALSE;
+        }
+    }
+
+    result.parse_ns = parse_ns;
+    result.loop_ns  = parse_ns - dec_first_ns;
+    if (result.loop_ns < 0)
+        result.loop_ns = 0;
+
+    // Tiderna kan bli noll fr sm program om klockan r grov.
+    double tokens_per_us = (result.tokenize_ns > 0)
+                         ? 1000.0 * result.num_tokens / result.tokenize_ns
+                         : 0.0;
+    double nodes_per_us  = (result.parse_ns > 0)
+                         ? 1000.0 * result.num_nodes / result.parse_ns
+                         : 0.0;
+
+    printf("%7s %11lld %7.1f %10.3f %9.3f %10lld %8.1f %9.1f\n", label,
+           result.num_tokens, tokens_per_us, result.parse_ns / 1000000.0,
+           result.loop_ns / 1000000.0, result.num_nodes, nodes_per_us,
+           result.peak_bytes / (1024.0*1024.0));
+    fflush(stdout);
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: PrintHeader()
+ * Parameters:
+ *   label  Rubriken fr den frsta kolumnen.
+ *
+ * Description:
+ *   Skriver ut kolumnernas rubriker.
+ *------------------------------------*/
+static void PrintHeader(const char* label) {
+    printf("%7s %11s %7s %10s %9s %10s %8s %9s\n", label, "Tokens", "Mtok/s",
+           "Parse ms", "Loops ms", "Nodes", "Mnode/s", "Peak MB");
+}
+
+/*--------------------------------------
+ * Function: Gen_Benchmark()
+ * Parameters:
+ *   max_size  Storleken p det strsta programmet, i byte.
+ *   options   Instllningarna fr programmen. num_stmts och max_size
+ *             anvnds inte.
+ *
+ * Description:
+ *   Genererar program frn 1 KB och uppt, fyra gnger strre varje gng,
+ *   till och med max_size, och skriver ut antalet tokens och AST-noder per
+ *   sekund, tiden fr Syn_Parse() och dess loop-kontroll samt det
+ *   strsta minnesbehovet fr varje storlek. Skriver sedan ut samma sak fr
+ *   allt djupare loopar med ett lika stort antal satser. Returnerar falskt
+ *   om ett genererat program inte klarade syntax-kontrollen.
+ *------------------------------------*/
+Bool Gen_Benchmark(long long max_size, const Gen_Options* options) {
+    char label[32];
+
+    printf("Program size (loop depth %d, %d variables, seed %u):\n\n",
+           options->max_depth, options->num_vars, options->seed);
+    PrintHeader("Size");
+
+    for (long long size = MIN_BENCH_SIZE; size <= max_size; size *= 4) {
+        Gen_Options size_options = *options;
+
+        size_options.num_stmts = 0;
+        size_options.max_size  = size;
+
+        FormatSize(size, label);
+        if (!Measure(label, &size_options,
+                     (MIN_BENCH_BYTES + size - 1) / size))
+        {
+            return FALSE;
+        }
+    }
+
+    printf("\nLoop depth (%d statements, seed %u):\n\n", DEPTH_NUM_STMTS,
+           options->seed);
+    PrintHeader("Depth");
+
+    for (int depth = 1; depth <= MAX_BENCH_DEPTH; depth *= 2) {
+        Gen_Options depth_options = *options;
+
+        depth_options.num_stmts = DEPTH_NUM_STMTS;
+        depth_options.max_size  = 0;
+        depth_options.max_depth = depth;
+
+        // Varje loop-niv behver en egen variabel, och den innersta en till
+        // att tilldela.
+        if (depth_options.num_vars <= depth)
+            depth_options.num_vars = depth + 1;
+
+        sprintf(label, "%d", depth);
+        if (!Measure(label, &depth_options, DEPTH_NUM_RUNS))
+            return FALSE;
+    }
+
+    printf("\nParse ms is the time to check the syntax and build the syntax"
+           "\ntree in one pass, tokenizing the source code as it goes. It"
+           "\nincludes Loops ms, the extra time it takes when each loop"
+           "\nvariable is counted down last in its loop instead of first,"
+           "\nwhich should be close to zero. Mnode/s is based on Parse ms."
+           "\nPeak MB counts the source code and syntax tree.\n");
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Gen_BenchTokenizer()
+ * Parameters:
+ *   max_size  Storleken p det strsta programmet, i byte.
+ *   options   Instllningarna fr programmen. num_stmts och max_size
+ *             anvnds inte.
+ *
+ * Description:
+ *   Genererar program frn 64 KB och uppt, fyra gnger strre varje gng,
+ *   till och med max_size, och skriver ut hur mnga megabyte kllkod och
+ *   miljoner tokens per sekund som Tok_Tokenize() klarar fr varje storlek.
+ *------------------------------------*/
+void Gen_BenchTokenizer(long long max_size, const Gen_Options* options) {
+    char label[32];
+
+    printf("Tokenizer (loop depth %d, %d variables, seed %u):\n\n",
+           options->max_depth, options->num_vars, options->seed);
+    printf("%7s %11s %9s %8s %7s\n", "Size", "Tokens", "MB/s", "Mtok/s",
+           "ns/tok");
+
+    long long size = (max_size < TOK_MIN_SIZE) ? max_size : TOK_MIN_SIZE;
+    for (; size <= max_size; size *= 4) {
+        Gen_Options size_options = *options;
+
+        size_options.num_stmts = 0;
+        size_options.max_size  = size;
+
+        long long length;
+        char*     source = Gen_Program(&size_options, &length);
+
+        long long num_runs = TOK_BENCH_BYTES / length;
+        if (num_runs < TOK_MIN_RUNS)
+            num_runs = TOK_MIN_RUNS;
+
+        long long num_tokens = 0;
+        long long best_ns    = LLONG_MAX;
+
+        // Arrayen allokeras om varje gng, eftersom Tok_Tokenize() sjlv
+        // reserverar plats och det ocks ska rknas.
+        for (long long i = 0; i < num_runs; i++) {
+            Array tokens; Array_Init(&tokens, sizeof(P_Token));
+
+            long long start_ns = Thread_WallTimeNs();
+            Tok_Tokenize(source, &tokens);
+            long long ns = Thread_WallTimeNs() - start_ns;
+
+            if (ns < best_ns)
+                best_ns = ns;
+
+            num_tokens = Array_Length(&tokens);
+            Array_Free(&tokens);
+        }
+
+        free(source);
+
+        if (best_ns < 1)
+            best_ns = 1;
+
+        FormatSize(size, label);
+        printf("%7s %11lld %9.1f %8.1f %7.2f\n", label, num_tokens,
+               (length / (1024.0*1024.0)) / (best_ns / 1000000000.0),
+               1000.0 * num_tokens / best_ns, (double)best_ns / num_tokens);
+        fflush(stdout);
+    }
+}
+
+/*--------------------------------------
+ * Function: Gen_Program()
+ * Parameters:
+ *   options  Instllningarna fr programmet.
+ *   length   Pekare till dr programmets lngd i byte ska lagras, eller
+ *            NULL.
+ *
+ * Description:
+ *   Genererar ett program och returnerar dess kllkod, som ska slppas med
+ *   free().
+ *------------------------------------*/
+char* Gen_Program(const Gen_Options* options, long long* length) {
+    ASSERT(options->num_stmts > 0 || options->max_size > 0);
+
+    int num_vars  = (options->num_vars > 1) ? options->num_vars : 1;
+    int max_depth = options->max_depth;
+
+    if (max_depth > num_vars-1) max_depth = num_vars-1;
+    if (max_depth < 0         ) max_depth = 0;
+
+    // Loopar som redan r ppna nr programmet ntt sin storlek ska ocks
+    // f plats, s bufferten allokeras med lite marginal.
+    Buffer buf;
+    buf.length     = 0;
+    buf.max_length = (options->max_size > 0)
+                   ? options->max_size + (max_depth+2) * (MAX_LINE_LEN+256)
+                   : 64 * options->num_stmts;
+    buf.text       = malloc(buf.max_length);
+    Timing_CountAlloc(buf.max_length);
+
+    // loop_vars[d] och num_body[d] gller loopen p djupet d+1.
+    Bool*      is_loop_var = calloc(num_vars+1, sizeof(Bool));
+    int*       loop_vars   = malloc((max_depth+1) * sizeof(int));
+    long long* num_body    = malloc((max_depth+1) * sizeof(long long));
+
+    unsigned int state     = options->seed;
+    long long    num_stmts = 0;
+    int          depth     = 0;
+
+    Append(&buf, 0, "# Generated by plang (loop depth %d, %d variables, "
+                    "seed %u).", max_depth, num_vars, options->seed);
+    Append(&buf, 0, "");
+
+    if (num_vars > 1) Append(&buf, 0, "PROGRAM (X1, X2)");
+    else              Append(&buf, 0, "PROGRAM (X1)");
+
+    while ((options->num_stmts <= 0 || num_stmts  < options->num_stmts)
+        && (options->max_size  <= 0 || buf.length < options->max_size ))
+    {
+        int choice = NextRandom(&state) % 6;
+
+        if (depth < max_depth && choice < 2) {
+            // Loopar ppnas oftare n de stngs, s programmet hller sig
+            // oftast nra det strsta djupet.
+            int var = RandomVar(&state, num_vars, is_loop_var);
+
+            Append(&buf, depth+1, "WHILE X%d != 0 DO", var);
+            num_stmts++;
+
+            is_loop_var[var] = TRUE;
+            loop_vars[depth] = var;
+            num_body[depth]  = 0;
+            depth++;
+
+            if (options->dec_first) {
+                Append(&buf, depth+1, "X%d := PRED(X%d)", var, var);
+                num_stmts++;
+            }
+        }
+        else if (depth > 0 && num_body[depth-1] > 0 && choice == 5) {
+            int var = loop_vars[--depth];
+
+            if (!options->dec_first) {
+                Append(&buf, depth+2, "X%d := PRED(X%d)", var, var);
+                num_stmts++;
+            }
+
+            Append(&buf, depth+1, "END");
+            is_loop_var[var] = FALSE;
+        }
+        else {
+            int var  = RandomVar(&state, num_vars, is_loop_var);
+            int kind = NextRandom(&state) % 12;
+            int src  = 1 + NextRandom(&state) % num_vars;
+
+            // Kommentarer finns i riktiga program, och ska ocks hoppas ver.
+            Bool has_comment = (NextRandom(&state) % 8 == 0);
+
+            if (kind < 2) {
+                Append(&buf, depth+1, has_comment ? "X%d := 0  # Clear X%d."
+                                                  : "X%d := 0", var, var);
+            }
+            else {
+                const char* op = (kind < 7) ? "SUCC" : "PRED";
+                Append(&buf, depth+1, has_comment
+                                      ? "X%d := %s(X%d)  # Statement %lld."
+                                      : "X%d := %s(X%d)",
+                       var, op, src, num_stmts+1);
+            }
+
+            num_stmts++;
+            if (depth > 0)
+                num_body[depth-1]++;
+        }
+    }
+
+    // Stng de loopar som fortfarande r ppna.
+    while (depth > 0) {
+        int var = loop_vars[--depth];
+
+        if (!options->dec_first)
+            Append(&buf, depth+2, "X%d := PRED(X%d)", var, var);
+
+        Append(&buf, depth+1, "END");
+    }
+
+    Append(&buf, 0, "RESULT (X%d)", num_vars);
+
+    free(is_loop_var);
+    free(loop_vars);
+    free(num_body);
+
+    if (length)
+        *length = buf.length;
+
+    return buf.text;
+}
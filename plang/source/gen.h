@@ -0,0 +1,139 @@
+/*------------------------------------------------------------------------------
+ * File: gen.h
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Genererar syntaktiskt korrekta P-program av godtycklig storlek, och mter
+ *   hur snabbt kompilatorns frsta faser (Tok_Tokenize() och Syn_Parse())
+ *   klarar dem nr storleken och loop-djupet kar.
+ *
+ *   Programmen blir likadana fr samma instllningar och samma fr, p alla
+ *   plattformar. Varje loop rknar ned sin egen variabel, och satserna inuti
+ *   en loop ndrar aldrig variablerna i de loopar som omger den, s alla
+ *   loopar tar slut och syntax-kontrollen ger inga varningar. Variablerna
+ *   kan dremot bli s stora att programmen inte hinner kras klart.
+ *
+ *   Tokeniseraren kan ocks mtas fr sig, i megabyte kllkod per sekund.
+ *
+ * Changes:
+ *   * Gen_BenchTokenizer() mter tokeniseraren fr sig.
+ *   * Mter Syn_Parse() istllet fr Syn_CheckSyntax() och AST_GenerateTree().
+ *   * Loop-kontrollen lser inte lngre looparna i frvg.
+ *----------------------------------------------------------------------------*/
+
+#ifndef GEN_H_
+#define GEN_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: GEN_MAX_DEPTH
+ *
+ * Description:
+ *   Det strsta loop-djupet, om inget annat anges.
+ *------------------------------------*/
+#define GEN_MAX_DEPTH 4
+
+/*--------------------------------------
+ * Constant: GEN_NUM_STMTS
+ *
+ * Description:
+ *   Antalet satser, om inget annat anges.
+ *------------------------------------*/
+#define GEN_NUM_STMTS 1000
+
+/*--------------------------------------
+ * Constant: GEN_NUM_VARS
+ *
+ * Description:
+ *   Antalet variabler, om inget annat anges.
+ *------------------------------------*/
+#define GEN_NUM_VARS 8
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Gen_Options
+ *
+ * Description:
+ *   Instllningar fr Gen_Program(). Programmet slutar nr det har num_stmts
+ *   satser eller r max_size byte stort, det som kommer frst, och sedan
+ *   stngs de loopar som r ppna. Noll betyder ingen grns, men en av dem
+ *   mste anges. Loop-djupet blir hgst num_vars-1, eftersom det mste
+ *   finnas en variabel kvar att tilldela i den innersta loopen.
+ *
+ *   Om dec_first r sant rknas loop-variabeln ned frst i loopen, annars
+ *   sist. Skillnaden i tid mellan de tv visar om loop-kontrollen i
+ *   Syn_Parse() lser looparna mer n en gng, vilket den inte ska gra.
+ *------------------------------------*/
+typedef struct {
+    long long    num_stmts;
+    long long    max_size;
+    int          max_depth;
+    int          num_vars;
+    unsigned int seed;
+    Bool         dec_first;
+} Gen_Options;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Gen_Benchmark()
+ * Parameters:
+ *   max_size  Storleken p det strsta programmet, i byte.
+ *   options   Instllningarna fr programmen. num_stmts och max_size
+ *             anvnds inte.
+ *
+ * Description:
+ *   Genererar program frn 1 KB och uppt, fyra gnger strre varje gng,
+ *   till och med max_size, och skriver ut antalet tokens och AST-noder per
+ *   sekund, tiden fr Syn_Parse() och dess loop-kontroll samt det
+ *   strsta minnesbehovet fr varje storlek. Skriver sedan ut samma sak fr
+ *   allt djupare loopar med ett lika stort antal satser. Returnerar falskt
+ *   om ett genererat program inte klarade syntax-kontrollen.
+ *------------------------------------*/
+Bool Gen_Benchmark(long long max_size, const Gen_Options* options);
+
+/*--------------------------------------
+ * Function: Gen_BenchTokenizer()
+ * Parameters:
+ *   max_size  Storleken p det strsta programmet, i byte.
+ *   options   Instllningarna fr programmen. num_stmts och max_size
+ *             anvnds inte.
+ *
+ * Description:
+ *   Genererar program frn 64 KB och uppt, fyra gnger strre varje gng,
+ *   till och med max_size, och skriver ut hur mnga megabyte kllkod och
+ *   miljoner tokens per sekund som Tok_Tokenize() klarar fr varje storlek.
+ *------------------------------------*/
+void Gen_BenchTokenizer(long long max_size, const Gen_Options* options);
+
+/*--------------------------------------
+ * Function: Gen_Program()
+ * Parameters:
+ *   options  Instllningarna fr programmet.
+ *   length   Pekare till dr programmets lngd i byte ska lagras, eller
+ *            NULL.
+ *
+ * Description:
+ *   Genererar ett program och returnerar dess kllkod, som ska slppas med
+ *   free().
+ *------------------------------------*/
+char* Gen_Program(const Gen_Options* options, long long* length);
+
+#endif // GEN_H_
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: io.h
  * Created: January 4, 2015
- * Last changed: January 9, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -11,19 +11,39 @@
  *
  * Changes:
  *   * ndrade s IO_GetIntFromUser() inte accepterar tomma inputs.
- *
+ *   * IO_GetNatFromUser() fr tal med godtyckligt mnga siffror.
+ *   * IO_GetLongFromUser() fr -int64.
+ *   * IO_GetStrFromUser() ger en tom strng vid slutet av input.
+ *   * IO_MapFile() mappar in kllkoden i minnet istllet fr att lsa den.
+ *   * Strngarna frn IO_GetNatFromUser() och IO_GetStrFromUser() slpps
+ *     med Str_Free().
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
  * INCLUDES
  *----------------------------------------------*/
 
+#include "array.h"
 #include "common.h"
 #include "io.h"
 #include "string.h"
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+// windows.h definierar TRUE och FALSE som makron, s common.h mste
+// inkluderas frst fr att Bool ska fungera.
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
 
 /*------------------------------------------------
  * FUNCTIONS
@@ -70,18 +90,102 @@ int IO_GetIntFromUser() {
     return atoi(buf);
 }
 
+/*--------------------------------------
+ * Function: IO_GetLongFromUser()
+ * Parameters:
+ *
+ * Description:
+ *   Lter anvndaren skriva in ett naturligt tal som ryms i en long long.
+ *------------------------------------*/
+long long IO_GetLongFromUser() {
+    while (TRUE) {
+        char*     s     = IO_GetNatFromUser();
+        long long val   = 0;
+        Bool      is_ok = TRUE;
+
+        for (int i = 0; s[i] != '\0'; i++) {
+            int digit = s[i] - '0';
+            if (val > (LLONG_MAX - digit) / 10) {
+                is_ok = FALSE;
+                break;
+            }
+
+            val = 10*val + digit;
+        }
+
+        Str_Free(s);
+
+        if (is_ok)
+            return val;
+
+        printf("Integer too large. Try again: ");
+    }
+}
+
+/*--------------------------------------
+ * Function: IO_GetNatFromUser()
+ * Parameters:
+ *
+ * Description:
+ *   Lter anvndaren skriva in ett naturligt tal med godtyckligt mnga
+ *   siffror, och returnerar det som en strng. Glm inte anropa
+ *   Str_Free()!
+ *------------------------------------*/
+char* IO_GetNatFromUser() {
+    while (TRUE) {
+        // Vi lser tecken fr tecken s att raden kan vara hur lng som
+        // helst.
+        Array buf;
+        Array_Init(&buf, sizeof(char));
+
+        int c;
+        while ((c = getchar()) != EOF && c != '\n') {
+            char ch = (char)c;
+            if (ch != '\r')
+                Array_AddElem(&buf, &ch);
+        }
+
+        int  len          = Array_Length(&buf);
+        Bool is_valid_int = (len > 0);
+        for (int i = 0; i < len; i++) {
+            if (!Chr_IsDigit(*(char*)Array_GetElemPtr(&buf, i))) {
+                is_valid_int = FALSE;
+                break;
+            }
+        }
+
+        char nul = '\0';
+        Array_AddElem(&buf, &nul);
+
+        // Om inmatningen tar slut finns inget mer att vnta p, s d blir
+        // vrdet noll.
+        char* result = NULL;
+        if (is_valid_int)  result = Str_Duplicate(buf.elems);
+        else if (c == EOF) result = Str_Duplicate("0");
+
+        Array_Free(&buf);
+
+        if (result)
+            return result;
+
+        printf("Invalid integer. Try again: ");
+    }
+}
+
 /*--------------------------------------
  * Function: IO_GetStrFromUser()
  * Parameters:
  *
  * Description:
- *   Lter anvndaren skriva in en strng. Glm inte anropa free() eftert fr
- *   att frhindra minneslckage.
+ *   Lter anvndaren skriva in en strng. Glm inte anropa Str_Free() eftert
+ *   fr att frhindra minneslckage.
  *------------------------------------*/
 char* IO_GetStrFromUser() {
     char buf[1024];
 
-    fgets(buf, sizeof(buf), stdin);
+    // Vid slutet av input ger vi en tom strng.
+    if (!fgets(buf, sizeof(buf), stdin))
+        buf[0] = '\0';
 
     int len = Str_Length(buf);
     for (int i = 0; i < len; i++) {
@@ -95,6 +199,87 @@ char* IO_GetStrFromUser() {
     return Str_Duplicate(buf);
 }
 
+/*--------------------------------------
+ * Function: IO_MapFile()
+ * Parameters:
+ *   file_name  Namnet p filen som ska mappas.
+ *   view       Vyn som ska fyllas i.
+ *
+ * Description:
+ *   Mappar in filen i minnet, s att operativsystemet lser in den sida fr
+ *   sida nr den anvnds och kan slppa sidorna igen nr minnet behvs.
+ *   Resten av filens sista sida r nollor, vilket ger NUL-tecknet i slutet.
+ *   Filer vars lngd r en jmn multipel av sidstorleken, eller som inte
+ *   gr att mappa, lses in med IO_ReadFile() istllet. Returnerar falskt
+ *   om filen inte kunde ppnas. Glm inte anropa IO_UnmapFile()!
+ *------------------------------------*/
+Bool IO_MapFile(const char* file_name, IO_File_View* view) {
+    const char* text   = NULL;
+    long long   length = 0;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    LARGE_INTEGER size;
+    SYSTEM_INFO   info;
+    GetSystemInfo(&info);
+
+    if (GetFileSizeEx(file, &size) && size.QuadPart % info.dwPageSize != 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0,
+                                            NULL);
+
+        // Vyn hller sjlv mappningen vid liv, s handtaget kan stngas.
+        if (mapping) {
+            text   = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            length = size.QuadPart;
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+#else
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0)
+        return FALSE;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size % sysconf(_SC_PAGESIZE) != 0) {
+        void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (p != MAP_FAILED) {
+            // Kllkoden lses frn brjan till slut, s krnan kan lsa in
+            // sidorna i frvg.
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+            text   = p;
+            length = st.st_size;
+        }
+    }
+
+    close(fd);
+#endif
+
+    if (text) {
+        view->text      = text;
+        view->length    = length;
+        view->is_mapped = TRUE;
+        return TRUE;
+    }
+
+    // Filen r tom, slutar precis p en sidgrns eller gick inte att mappa.
+    char* s = IO_ReadFile(file_name);
+    if (!s)
+        return FALSE;
+
+    view->text      = s;
+    view->length    = strlen(s);
+    view->is_mapped = FALSE;
+    return TRUE;
+}
+
 /*--------------------------------------
  * Function: IO_Pause()
  * Parameters:
@@ -133,3 +318,27 @@ char* IO_ReadFile(const char* file_name) {
 
     return s;
 }
+
+/*--------------------------------------
+ * Function: IO_UnmapFile()
+ * Parameters:
+ *   view  Vyn som ska slppas, se IO_MapFile().
+ *
+ * Description:
+ *   Slpper filen ur minnet.
+ *------------------------------------*/
+void IO_UnmapFile(IO_File_View* view) {
+    if (!view->is_mapped) {
+        free((char*)view->text);
+    }
+    else {
+#ifdef _WIN32
+        UnmapViewOfFile(view->text);
+#else
+        munmap((void*)view->text, view->length);
+#endif
+    }
+
+    view->text   = NULL;
+    view->length = 0;
+}
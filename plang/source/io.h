@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: io.h
  * Created: January 4, 2015
- * Last changed: January 9, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -10,12 +10,40 @@
  *   eller filer.
  *
  * Changes:
- *
+ *   * Lade till IO_GetNatFromUser().
+ *   * Lade till IO_GetLongFromUser().
+ *   * Lade till IO_MapFile() och IO_UnmapFile().
+ *   * Strngarna frn IO_GetNatFromUser() och IO_GetStrFromUser() slpps
+ *     med Str_Free().
  *----------------------------------------------------------------------------*/
 
 #ifndef IO_H_
 #define IO_H_
 
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: IO_File_View
+ *
+ * Description:
+ *   En fil som IO_MapFile() har gjort tillgnglig. text r filens innehll
+ *   och alltid NUL-terminerad, men fr inte ndras. is_mapped r falskt om
+ *   filen lstes in med IO_ReadFile() istllet fr att mappas.
+ *------------------------------------*/
+typedef struct {
+    const char* text;
+    long long   length;
+    Bool        is_mapped;
+} IO_File_View;
+
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
@@ -29,16 +57,52 @@
  *------------------------------------*/
 int IO_GetIntFromUser();
 
+/*--------------------------------------
+ * Function: IO_GetLongFromUser()
+ * Parameters:
+ *
+ * Description:
+ *   Lter anvndaren skriva in ett naturligt tal som ryms i en long long.
+ *------------------------------------*/
+long long IO_GetLongFromUser();
+
+/*--------------------------------------
+ * Function: IO_GetNatFromUser()
+ * Parameters:
+ *
+ * Description:
+ *   Lter anvndaren skriva in ett naturligt tal med godtyckligt mnga
+ *   siffror, och returnerar det som en strng. Glm inte anropa
+ *   Str_Free()!
+ *------------------------------------*/
+char* IO_GetNatFromUser();
+
 /*--------------------------------------
  * Function: IO_GetStrFromUser()
  * Parameters:
  *
  * Description:
- *   Lter anvndaren skriva in en strng. Glm inte anropa free() eftert fr
- *   att frhindra minneslckage.
+ *   Lter anvndaren skriva in en strng. Glm inte anropa Str_Free() eftert
+ *   fr att frhindra minneslckage.
  *------------------------------------*/
 char* IO_GetStrFromUser();
 
+/*--------------------------------------
+ * Function: IO_MapFile()
+ * Parameters:
+ *   file_name  Namnet p filen som ska mappas.
+ *   view       Vyn som ska fyllas i.
+ *
+ * Description:
+ *   Mappar in filen i minnet, s att operativsystemet lser in den sida fr
+ *   sida nr den anvnds och kan slppa sidorna igen nr minnet behvs.
+ *   Resten av filens sista sida r nollor, vilket ger NUL-tecknet i slutet.
+ *   Filer vars lngd r en jmn multipel av sidstorleken, eller som inte
+ *   gr att mappa, lses in med IO_ReadFile() istllet. Returnerar falskt
+ *   om filen inte kunde ppnas. Glm inte anropa IO_UnmapFile()!
+ *------------------------------------*/
+Bool IO_MapFile(const char* file_name, IO_File_View* view);
+
 /*--------------------------------------
  * Function: IO_Pause()
  * Parameters:
@@ -59,4 +123,14 @@ void IO_Pause();
  *------------------------------------*/
 char* IO_ReadFile(const char* file_name);
 
+/*--------------------------------------
+ * Function: IO_UnmapFile()
+ * Parameters:
+ *   view  Vyn som ska slppas, se IO_MapFile().
+ *
+ * Description:
+ *   Slpper filen ur minnet.
+ *------------------------------------*/
+void IO_UnmapFile(IO_File_View* view);
+
 #endif // IO_H_
@@ -0,0 +1,663 @@
+/*------------------------------------------------------------------------------
+ * File: jit.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   verstter abstrakta syntax-trd direkt till x86-64-maskinkod i minnet och
+ *   kr den, utan att g via assembly-filer och fasm. Stds bara p Linux.
+ *
+ * Changes:
+ *   * Loopar rknar ner en budget i R12 nr de hoppar tillbaka, och anropar
+ *     VM_CheckLimits() nr den tar slut.
+ *   * VM_CheckLimits() fr ven loopens nod, och felkoden den returnerar
+ *     returneras direkt.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "debug.h"
+#include "jit.h"
+#include "summary.h"
+#include "vm.h"
+
+#include <string.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: JIT_SUPPORTED
+ *
+ * Description:
+ *   Definieras om plattformen stds. Maskinkoden frutstter x86-64 och
+ *   System V-anropskonventionen, och minnet allokeras med mmap().
+ *------------------------------------*/
+#if defined(__linux__) && defined(__x86_64__)
+#    define JIT_SUPPORTED
+#endif
+
+#ifdef JIT_SUPPORTED
+
+#include <sys/mman.h>
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Code_Info
+ *
+ * Description:
+ *   Hller reda p maskinkoden och de hopp som ska fyllas i nr koden fr
+ *   hela programmet har genererats.
+ *------------------------------------*/
+typedef struct {
+    Array bytes;          // Maskinkoden.
+    Array exit_jumps;     // Offset till hopp som ska g till exit.
+    Array overflow_jumps; // Offset till hopp som ska g till overflow.
+} Code_Info;
+
+/*--------------------------------------
+ * Type: Jit_Func
+ *
+ * Description:
+ *   Den genererade maskinkoden anropas som en vanlig C-funktion som tar
+ *   variabel-arrayen och krningens grnser som argument och returnerar
+ *   resultatet.
+ *------------------------------------*/
+typedef int (*Jit_Func)(int* vars, VM_Limits* limits);
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: EmitBytes()
+ * Parameters:
+ *   ci     Hjlpobjekt fr kodgenerering.
+ *   bytes  Maskinkoden som ska lggas till.
+ *   n      Antal bytes.
+ *
+ * Description:
+ *   Lgger till maskinkod sist i programmet.
+ *------------------------------------*/
+static void EmitBytes(Code_Info* ci, const char* bytes, int n) {
+    for (int i = 0; i < n; i++)
+        Array_AddElem(&ci->bytes, &bytes[i]);
+}
+
+/*--------------------------------------
+ * Function: EmitInt32()
+ * Parameters:
+ *   ci   Hjlpobjekt fr kodgenerering.
+ *   val  Vrdet som ska lggas till.
+ *
+ * Description:
+ *   Lgger till ett 32-bitars vrde, i little endian, sist i programmet.
+ *------------------------------------*/
+static void EmitInt32(Code_Info* ci, int val) {
+    unsigned u = (unsigned)val;
+
+    for (int i = 0; i < 4; i++) {
+        char b = (char)((u >> (8*i)) & 0xff);
+        Array_AddElem(&ci->bytes, &b);
+    }
+}
+
+/*--------------------------------------
+ * Function: EmitPtr()
+ * Parameters:
+ *   ci   Hjlpobjekt fr kodgenerering.
+ *   ptr  Pekaren som ska lggas till.
+ *
+ * Description:
+ *   Lgger till en 64-bitars pekare, i little endian, sist i programmet.
+ *------------------------------------*/
+static void EmitPtr(Code_Info* ci, const void* ptr) {
+    unsigned long long u = (unsigned long long)(size_t)ptr;
+
+    for (int i = 0; i < 8; i++) {
+        char b = (char)((u >> (8*i)) & 0xff);
+        Array_AddElem(&ci->bytes, &b);
+    }
+}
+
+/*--------------------------------------
+ * Function: EmitVarOp()
+ * Parameters:
+ *   ci   Hjlpobjekt fr kodgenerering.
+ *   op   Instruktionens opcode och ModRM-byte.
+ *   n    Antal bytes i op.
+ *   var  Variabeln som instruktionen ska arbeta p.
+ *
+ * Description:
+ *   Lgger till en instruktion med operanden [rbx+var*4], dvs en variabel i
+ *   variabel-arrayen.
+ *------------------------------------*/
+static void EmitVarOp(Code_Info* ci, const char* op, int n, int var) {
+    EmitBytes(ci, op, n);
+    EmitInt32(ci, var*(int)sizeof(int));
+}
+
+/*--------------------------------------
+ * Function: EmitJump()
+ * Parameters:
+ *   ci  Hjlpobjekt fr kodgenerering.
+ *   op  Hoppinstruktionens opcode.
+ *   n   Antal bytes i op.
+ *
+ * Description:
+ *   Lgger till en hoppinstruktion med en 32-bitars relativ adress som fylls i
+ *   senare med PatchJump(). Returnerar adressens offset.
+ *------------------------------------*/
+static int EmitJump(Code_Info* ci, const char* op, int n) {
+    EmitBytes(ci, op, n);
+
+    int offs = Array_Length(&ci->bytes);
+    EmitInt32(ci, 0);
+
+    return offs;
+}
+
+/*--------------------------------------
+ * Function: EmitError()
+ * Parameters:
+ *   ci   Hjlpobjekt fr kodgenerering.
+ *   err  Felkoden som ska returneras.
+ *
+ * Description:
+ *   Lgger till kod som avbryter exekveringen med den angivna felkoden.
+ *------------------------------------*/
+static void EmitError(Code_Info* ci, int err) {
+    EmitBytes(ci, "\xB8", 1); // mov eax, err
+    EmitInt32(ci, err);
+
+    int offs = EmitJump(ci, "\xE9", 1); // jmp exit
+    Array_AddElem(&ci->exit_jumps, &offs);
+}
+
+/*--------------------------------------
+ * Function: EmitOverflowJump()
+ * Parameters:
+ *   ci  Hjlpobjekt fr kodgenerering.
+ *   op  Hoppinstruktionens opcode.
+ *   n   Antal bytes i op.
+ *
+ * Description:
+ *   Lgger till ett villkorligt hopp till koden som returnerar
+ *   VM_ERR_OVERFLOW.
+ *------------------------------------*/
+static void EmitOverflowJump(Code_Info* ci, const char* op, int n) {
+    int offs = EmitJump(ci, op, n);
+    Array_AddElem(&ci->overflow_jumps, &offs);
+}
+
+/*--------------------------------------
+ * Function: IsValidVar()
+ * Parameters:
+ *   var  Variabelindexet som ska kontrolleras.
+ *
+ * Description:
+ *   Returnerar sant om variabelindexet ligger inom variabel-arrayen.
+ *------------------------------------*/
+static Bool IsValidVar(int var) {
+    return (var >= 0 && var < PLANG_NUM_VARS);
+}
+
+/*--------------------------------------
+ * Function: PatchJump()
+ * Parameters:
+ *   ci      Hjlpobjekt fr kodgenerering.
+ *   offs    Offset till hoppets relativa adress.
+ *   target  Offset som hoppet ska g till.
+ *
+ * Description:
+ *   Fyller i den relativa adressen i ett hopp som lagts till med EmitJump().
+ *------------------------------------*/
+static void PatchJump(Code_Info* ci, int offs, int target) {
+    unsigned rel = (unsigned)(target - (offs + 4));
+
+    for (int i = 0; i < 4; i++) {
+        char* b = Array_GetElemPtr(&ci->bytes, offs+i);
+        *b = (char)((rel >> (8*i)) & 0xff);
+    }
+}
+
+/*--------------------------------------
+ * Function: CompileNode()
+ * Parameters:
+ *   node  Den nod som ska versttas till maskinkod.
+ *   ci    Hjlpobjekt fr kodgenerering.
+ *
+ * Description:
+ *   verstter den specificerade noden, och rekursivt alla dess barn, till
+ *   maskinkod. RBX pekar hela tiden p variabel-arrayen.
+ *------------------------------------*/
+static void CompileNode(const AST_Node* node, Code_Info* ci) {
+    // Precis som i BC_Compile() ger ogiltiga variabler fel frst nr koden
+    // faktiskt krs.
+
+    switch (node->type) {
+    /*----------------------------------------------------
+     * PROGRAM (<variabel>[, <variabel>])
+     *--------------------------------------------------*/
+    case AST_PROGRAM: {
+        int num_children = Array_Length(&node->children);
+        for (int i = 0; i < num_children; i++) {
+            AST_Node* child = Array_GetElemPtr(&node->children, i);
+            CompileNode(child, ci);
+        }
+
+        // Om programmet tar slut utan RESULT-nod finns inget resultat.
+        EmitError(ci, VM_NO_RESULT);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * X<src> * faktor lggs till andra variabler, X<src> := 0
+     *--------------------------------------------------*/
+    case AST_ADD_CLEAR: {
+        // Vi rknar i 64 bitar, precis som VM_ExecAST(), s att vi kan
+        // upptcka overflow innan vi skriver tillbaka vrdet.
+
+        int src = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (!IsValidVar(src)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        EmitVarOp(ci, "\x48\x63\x8B", 3, src); // movsxd rcx, [src]
+
+        int num_values = Array_Length(&node->values);
+        for (int i = 1; i < num_values; i += 2) {
+            int var    = *(int*)Array_GetElemPtr(&node->values, i);
+            int factor = *(int*)Array_GetElemPtr(&node->values, i+1);
+
+            if (!IsValidVar(var)) {
+                EmitError(ci, VM_ERR_INVALID_VAR);
+                break;
+            }
+
+            EmitVarOp(ci, "\x48\x63\x83", 3, var); // movsxd rax, [var]
+            EmitBytes(ci, "\x48\x69\xD1", 3);      // imul rdx, rcx, factor
+            EmitInt32(ci, factor);
+            EmitBytes(ci, "\x48\x01\xD0", 3);      // add rax, rdx
+
+            if (factor > 0) {
+                EmitBytes(ci, "\x48\x3D", 2);              // cmp rax, INT_MAX
+                EmitInt32(ci, 0x7fffffff);
+                EmitOverflowJump(ci, "\x0F\x8F", 2);       // jg overflow
+            }
+            else {
+                // Negativa faktorer motsvarar PRED.
+                EmitBytes(ci, "\x31\xD2", 2);              // xor edx, edx
+                EmitBytes(ci, "\x48\x85\xC0", 3);          // test rax, rax
+                EmitBytes(ci, "\x48\x0F\x48\xC2", 4);      // cmovs rax, rdx
+            }
+
+            EmitVarOp(ci, "\x89\x83", 2, var); // mov [var], eax
+        }
+
+        EmitVarOp(ci, "\xC7\x83", 2, src); // mov dword [src], 0
+        EmitInt32(ci, 0);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * <variabel> := <naturligt-tal>
+     *--------------------------------------------------*/
+    case AST_ASSIGN: {
+        int var = *(int*)Array_GetElemPtr(&node->values, 0);
+        int val = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(var)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        EmitVarOp(ci, "\xC7\x83", 2, var); // mov dword [var], val
+        EmitInt32(ci, (val < 0) ? 0 : val);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * X<dst> := X<src>
+     *--------------------------------------------------*/
+    case AST_COPY: {
+        // Erstter X<dst> := SUCC(X<src>) fljt av X<dst> := PRED(X<dst>), s
+        // vi gr precis det, fr att f samma overflow som SUCC.
+
+        int dst = *(int*)Array_GetElemPtr(&node->values, 0);
+        int src = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(dst) || !IsValidVar(src)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        EmitVarOp(ci, "\x8B\x83", 2, src);   // mov eax, [src]
+        EmitBytes(ci, "\x83\xC0\x01", 3);    // add eax, 1
+        EmitVarOp(ci, "\x89\x83", 2, dst);   // mov [dst], eax
+        EmitOverflowJump(ci, "\x0F\x80", 2); // jo overflow
+        EmitBytes(ci, "\x83\xE8\x01", 3);    // sub eax, 1
+        EmitVarOp(ci, "\x89\x83", 2, dst);   // mov [dst], eax
+        break;
+    }
+
+    /*----------------------------------------------------
+     * <variabel> := PRED(<variabel>)
+     *--------------------------------------------------*/
+    case AST_PRED: {
+        int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+        int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(var0) || !IsValidVar(var1)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        // Vrdet fr inte g under noll, s vi erstter -1 med 0.
+        EmitBytes(ci, "\x31\xC9", 2);        // xor ecx, ecx
+        EmitVarOp(ci, "\x8B\x83", 2, var1);  // mov eax, [var1]
+        EmitBytes(ci, "\x83\xE8\x01", 3);    // sub eax, 1
+        EmitBytes(ci, "\x0F\x48\xC1", 3);    // cmovs eax, ecx
+        EmitVarOp(ci, "\x89\x83", 2, var0);  // mov [var0], eax
+        break;
+    }
+
+    /*----------------------------------------------------
+     * <variabel> := SUCC(<variabel>)
+     *--------------------------------------------------*/
+    case AST_SUCC: {
+        // Vrdet skrivs tillbaka innan vi kontrollerar overflow, s variabeln
+        // fr samma vrde som i VM_ExecAST() ven nr det blir fel.
+
+        int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+        int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+
+        if (!IsValidVar(var0) || !IsValidVar(var1)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        EmitVarOp(ci, "\x8B\x83", 2, var1);  // mov eax, [var1]
+        EmitBytes(ci, "\x83\xC0\x01", 3);    // add eax, 1
+        EmitVarOp(ci, "\x89\x83", 2, var0);  // mov [var0], eax
+        EmitOverflowJump(ci, "\x0F\x80", 2); // jo overflow
+        break;
+    }
+
+    /*----------------------------------------------------
+     * WHILE <variabel> != 0 DO ... END
+     *--------------------------------------------------*/
+    case AST_WHILE: {
+        // Samma upplgg som i BC_Compile(), med bara ett hopp per iteration.
+        // Sammanfattningar krs genom att anropa Sum_Apply() direkt frn
+        // maskinkoden.
+
+        int var = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (!IsValidVar(var)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        int sum = -1;
+        if (node->summary != NULL) {
+            EmitBytes(ci, "\x48\xBF", 2);     // mov rdi, summary
+            EmitPtr(ci, node->summary);
+            EmitBytes(ci, "\x48\x89\xDE", 3); // mov rsi, rbx
+            EmitBytes(ci, "\x48\xB8", 2);     // mov rax, Sum_Apply
+            EmitPtr(ci, (const void*)(size_t)&Sum_Apply);
+            EmitBytes(ci, "\xFF\xD0", 2);     // call rax
+            EmitBytes(ci, "\x85\xC0", 2);     // test eax, eax
+            sum = EmitJump(ci, "\x0F\x85", 2); // jne end
+        }
+
+        EmitVarOp(ci, "\x83\xBB", 2, var);   // cmp dword [var], 0
+        EmitBytes(ci, "\x00", 1);
+        int jz   = EmitJump(ci, "\x0F\x84", 2); // je end
+        int body = Array_Length(&ci->bytes);
+
+        int num_children = Array_Length(&node->children);
+        for (int i = 0; i < num_children; i++) {
+            AST_Node* child = Array_GetElemPtr(&node->children, i);
+            CompileNode(child, ci);
+        }
+
+        // Budgeten rknas ner i R12 varje gng loopen hoppar tillbaka. Nr
+        // den tar slut fr VM_CheckLimits() avgra om vi ska fortstta, och
+        // returnerar i s fall en ny budget. Annars returnerar den felkoden,
+        // som redan ligger i EAX nr vi hoppar till exit.
+        EmitVarOp(ci, "\x83\xBB", 2, var);   // cmp dword [var], 0
+        EmitBytes(ci, "\x00", 1);
+        int je  = EmitJump(ci, "\x0F\x84", 2); // je end
+        EmitBytes(ci, "\x49\xFF\xCC", 3);      // dec r12
+        int jnz = EmitJump(ci, "\x0F\x85", 2); // jne body
+        PatchJump(ci, jnz, body);
+
+        EmitBytes(ci, "\x4C\x89\xEF", 3); // mov rdi, r13
+        EmitBytes(ci, "\x48\xBE", 2);     // mov rsi, node
+        EmitPtr(ci, node);
+        EmitBytes(ci, "\xBA", 1);         // mov edx, var
+        EmitInt32(ci, var);
+        EmitBytes(ci, "\x48\xB8", 2);     // mov rax, VM_CheckLimits
+        EmitPtr(ci, (const void*)(size_t)&VM_CheckLimits);
+        EmitBytes(ci, "\xFF\xD0", 2);     // call rax
+        EmitBytes(ci, "\x49\x89\xC4", 3); // mov r12, rax
+        EmitBytes(ci, "\x48\x85\xC0", 3); // test rax, rax
+        int jg = EmitJump(ci, "\x0F\x8F", 2); // jg body
+        PatchJump(ci, jg, body);
+        int err = EmitJump(ci, "\xE9", 1);   // jmp exit
+        Array_AddElem(&ci->exit_jumps, &err);
+
+        int end = Array_Length(&ci->bytes);
+        PatchJump(ci, jz, end);
+        PatchJump(ci, je, end);
+        if (sum >= 0)
+            PatchJump(ci, sum, end);
+
+        break;
+    }
+
+    /*----------------------------------------------------
+     * RESULT (<variabel>)
+     *--------------------------------------------------*/
+    case AST_RESULT: {
+        int var = *(int*)Array_GetElemPtr(&node->values, 0);
+
+        if (!IsValidVar(var)) {
+            EmitError(ci, VM_ERR_INVALID_VAR);
+            break;
+        }
+
+        if (!AST_IsLastNode(node)) {
+            EmitError(ci, VM_ERR_PREMATURE_RESULT);
+            break;
+        }
+
+        EmitVarOp(ci, "\x8B\x83", 2, var); // mov eax, [var]
+        int offs = EmitJump(ci, "\xE9", 1); // jmp exit
+        Array_AddElem(&ci->exit_jumps, &offs);
+        break;
+    }
+
+    default:
+        // Det hr ska inte hnda.
+        FAIL();
+    }
+}
+
+/*--------------------------------------
+ * Function: Jit_Compile()
+ * Parameters:
+ *   root  Root-noden i det AST som ska versttas till maskinkod.
+ *   prog  Det program som maskinkoden ska lagras i.
+ *
+ * Description:
+ *   verstter ett abstrakt syntax-trd till maskinkod. Returnerar falskt om
+ *   plattformen inte stds eller om det inte gick att allokera krbart minne.
+ *   Glm inte anropa Jit_Free()!
+ *------------------------------------*/
+Bool Jit_Compile(const AST_Node* root, Jit_Program* prog) {
+    ASSERT(root->type == AST_PROGRAM);
+
+    Code_Info ci;
+    Array_Init(&ci.bytes         , sizeof(char));
+    Array_Init(&ci.exit_jumps    , sizeof(int));
+    Array_Init(&ci.overflow_jumps, sizeof(int));
+
+    // RBX, R12 och R13 r callee-saved, s vi sparar dem och lter RBX peka
+    // p variabel-arrayen, R12 hlla budgeten och R13 peka p grnserna under
+    // hela krningen. De tre push:arna gr samtidigt att stacken r
+    // 16-bytes-justerad infr anrop till Sum_Apply() och VM_CheckLimits().
+    EmitBytes(&ci, "\x53", 1);         // push rbx
+    EmitBytes(&ci, "\x41\x54", 2);     // push r12
+    EmitBytes(&ci, "\x41\x55", 2);     // push r13
+    EmitBytes(&ci, "\x48\x89\xFB", 3); // mov rbx, rdi
+    EmitBytes(&ci, "\x49\x89\xF5", 3); // mov r13, rsi
+    EmitBytes(&ci, "\x4C\x8B\x26", 3); // mov r12, [rsi]
+
+    CompileNode(root, &ci);
+
+    int overflow = Array_Length(&ci.bytes);
+    EmitBytes(&ci, "\xB8", 1); // mov eax, VM_ERR_OVERFLOW
+    EmitInt32(&ci, VM_ERR_OVERFLOW);
+
+    int exit = Array_Length(&ci.bytes);
+    EmitBytes(&ci, "\x41\x5D", 2); // pop r13
+    EmitBytes(&ci, "\x41\x5C", 2); // pop r12
+    EmitBytes(&ci, "\x5B", 1);     // pop rbx
+    EmitBytes(&ci, "\xC3", 1);     // ret
+
+    int num_jumps = Array_Length(&ci.overflow_jumps);
+    for (int i = 0; i < num_jumps; i++)
+        PatchJump(&ci, *(int*)Array_GetElemPtr(&ci.overflow_jumps, i),
+                  overflow);
+
+    num_jumps = Array_Length(&ci.exit_jumps);
+    for (int i = 0; i < num_jumps; i++)
+        PatchJump(&ci, *(int*)Array_GetElemPtr(&ci.exit_jumps, i), exit);
+
+    // Minnet mappas frst som skrivbart, och grs sedan krbart men inte
+    // lngre skrivbart, s att det aldrig r bde och samtidigt.
+    size_t size = (size_t)Array_Length(&ci.bytes);
+    void*  code = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    Bool ok = (code != MAP_FAILED);
+    if (ok) {
+        memcpy(code, ci.bytes.elems, size);
+
+        if (mprotect(code, size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(code, size);
+            ok = FALSE;
+        }
+    }
+
+    Array_Free(&ci.bytes);
+    Array_Free(&ci.exit_jumps);
+    Array_Free(&ci.overflow_jumps);
+
+    prog->code = ok ? code : NULL;
+    prog->size = ok ? size : 0;
+
+    return ok;
+}
+
+/*--------------------------------------
+ * Function: Jit_Exec()
+ * Parameters:
+ *   prog    Programmet som ska kras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Kr ett program som versatts med Jit_Compile(). Returnerar samma
+ *   resultat och felkoder som VM_ExecAST().
+ *------------------------------------*/
+int Jit_Exec(const Jit_Program* prog, VM_Config* config) {
+    ASSERT(prog->code != NULL);
+
+    Jit_Func func;
+    memcpy(&func, &prog->code, sizeof(func));
+
+    VM_Limits limits;
+    VM_StartLimits(config, &limits);
+
+    return func(config->vars, &limits);
+}
+
+/*--------------------------------------
+ * Function: Jit_Free()
+ * Parameters:
+ *   prog  Programmet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper ett program som versatts med Jit_Compile() ur minnet.
+ *------------------------------------*/
+void Jit_Free(Jit_Program* prog) {
+    if (prog->code != NULL)
+        munmap(prog->code, prog->size);
+
+    prog->code = NULL;
+    prog->size = 0;
+}
+
+#else // JIT_SUPPORTED
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Jit_Compile()
+ * Parameters:
+ *   root  Root-noden i det AST som ska versttas till maskinkod.
+ *   prog  Det program som maskinkoden ska lagras i.
+ *
+ * Description:
+ *   Plattformen stds inte, s vi returnerar alltid falskt.
+ *------------------------------------*/
+Bool Jit_Compile(const AST_Node* root, Jit_Program* prog) {
+    prog->code = NULL;
+    prog->size = 0;
+
+    return FALSE;
+}
+
+/*--------------------------------------
+ * Function: Jit_Exec()
+ * Parameters:
+ *   prog    Programmet som ska kras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Plattformen stds inte, s det hr ska aldrig anropas.
+ *------------------------------------*/
+int Jit_Exec(const Jit_Program* prog, VM_Config* config) {
+    FAIL();
+    return VM_NO_RESULT;
+}
+
+/*--------------------------------------
+ * Function: Jit_Free()
+ * Parameters:
+ *   prog  Programmet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Plattformen stds inte, s det finns inget att slppa.
+ *------------------------------------*/
+void Jit_Free(Jit_Program* prog) {
+}
+
+#endif // JIT_SUPPORTED
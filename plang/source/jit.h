@@ -0,0 +1,84 @@
+/*------------------------------------------------------------------------------
+ * File: jit.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   verstter abstrakta syntax-trd direkt till x86-64-maskinkod i minnet och
+ *   kr den, utan att g via assembly-filer och fasm. Stds bara p Linux.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef JIT_H_
+#define JIT_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "ast.h"
+#include "common.h"
+#include "vm.h"
+
+#include <stddef.h>
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Jit_Program
+ *
+ * Description:
+ *   Ett program versatt till maskinkod. code pekar p en krbar
+ *   minnesyta p size bytes.
+ *------------------------------------*/
+typedef struct {
+    void*  code;
+    size_t size;
+} Jit_Program;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Jit_Compile()
+ * Parameters:
+ *   root  Root-noden i det AST som ska versttas till maskinkod.
+ *   prog  Det program som maskinkoden ska lagras i.
+ *
+ * Description:
+ *   verstter ett abstrakt syntax-trd till maskinkod. Returnerar falskt om
+ *   plattformen inte stds eller om det inte gick att allokera krbart minne.
+ *   Glm inte anropa Jit_Free()!
+ *------------------------------------*/
+Bool Jit_Compile(const AST_Node* root, Jit_Program* prog);
+
+/*--------------------------------------
+ * Function: Jit_Exec()
+ * Parameters:
+ *   prog    Programmet som ska kras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Kr ett program som versatts med Jit_Compile(). Returnerar samma
+ *   resultat och felkoder som VM_ExecAST().
+ *------------------------------------*/
+int Jit_Exec(const Jit_Program* prog, VM_Config* config);
+
+/*--------------------------------------
+ * Function: Jit_Free()
+ * Parameters:
+ *   prog  Programmet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper ett program som versatts med Jit_Compile() ur minnet.
+ *------------------------------------*/
+void Jit_Free(Jit_Program* prog);
+
+#endif // JIT_H_
@@ -0,0 +1,280 @@
+/*------------------------------------------------------------------------------
+ * File: optimize.c
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Optimeringar av abstrakta syntax-trd. Knner igen vanliga idiom i P, ex.
+ *   loopar som flyttar vrdet frn en variabel till en annan, och erstter dem
+ *   med noder som kan kras med en enda aritmetisk operation.
+ *
+ * Changes:
+ *   * Den nya noden fr samma rad och kolumn som den den erstter.
+ *   * Den nya noden allokeras i samma arena som den den erstter.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "debug.h"
+#include "optimize.h"
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: GetSelfOpVar()
+ * Parameters:
+ *   node  Noden som ska kontrolleras.
+ *
+ * Description:
+ *   Returnerar variabelindexet om noden r p formen X<n> := PRED(X<n>) eller
+ *   X<n> := SUCC(X<n>), annars -1.
+ *------------------------------------*/
+static int GetSelfOpVar(const AST_Node* node) {
+    if (node->type != AST_PRED && node->type != AST_SUCC)
+        return -1;
+
+    int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+    int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+
+    return (var0 == var1) ? var0 : -1;
+}
+
+/*--------------------------------------
+ * Function: MatchCopy()
+ * Parameters:
+ *   node1   Den frsta av tv efterfljande satser.
+ *   node2   Den andra av tv efterfljande satser.
+ *   result  Den nod som ska erstta de tv satserna.
+ *
+ * Description:
+ *   Knner igen kopieringsidiomet X<a> := SUCC(X<b>), X<a> := PRED(X<a>) och
+ *   skapar i s fall en AST_COPY-nod. Returnerar sant om idiomet hittades.
+ *------------------------------------*/
+static Bool MatchCopy(const AST_Node* node1, const AST_Node* node2,
+                      AST_Node* result)
+{
+    if (node1->type != AST_SUCC || node2->type != AST_PRED)
+        return FALSE;
+
+    int dst = *(int*)Array_GetElemPtr(&node1->values, 0);
+    int src = *(int*)Array_GetElemPtr(&node1->values, 1);
+
+    // Om dst och src r samma variabel gr satserna ingenting alls (s lnge
+    // det inte blir overflow), men det idiomet lmnar vi i fred.
+    if (dst == src || GetSelfOpVar(node2) != dst)
+        return FALSE;
+
+    // PRED kan inte begrnsas av noll hr eftersom SUCC precis gjort vrdet
+    // strre n noll, s X<dst> blir exakt X<src>.
+    *result = AST_CreateNode(AST_COPY, node1->values.arena);
+    AST_AddValue(result, dst);
+    AST_AddValue(result, src);
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: MatchTransferLoop()
+ * Parameters:
+ *   loop    While-noden som ska kontrolleras.
+ *   result  Den nod som ska erstta loopen.
+ *
+ * Description:
+ *   Knner igen loopar som rknar ned loop-variabeln med ett per iteration och
+ *   samtidigt rknar upp eller ned andra variabler, och skapar i s fall en
+ *   AST_ADD_CLEAR-nod (eller en vanlig tilldelning om loopen bara nollar loop-
+ *   variabeln). Returnerar sant om idiomet hittades.
+ *------------------------------------*/
+static Bool MatchTransferLoop(const AST_Node* loop, AST_Node* result) {
+    if (loop->type != AST_WHILE)
+        return FALSE;
+
+    int src          = *(int*)Array_GetElemPtr(&loop->values, 0);
+    int num_children = Array_Length(&loop->children);
+
+    if (num_children == 0)
+        return FALSE;
+
+    // WHILE X<src> != 0 DO X<src> := 0 END
+    if (num_children == 1) {
+        AST_Node* child = Array_GetElemPtr(&loop->children, 0);
+        if (child->type == AST_ASSIGN) {
+            int var = *(int*)Array_GetElemPtr(&child->values, 0);
+            int val = *(int*)Array_GetElemPtr(&child->values, 1);
+            if (var != src || val != 0)
+                return FALSE;
+
+            *result = AST_CreateNode(AST_ASSIGN, loop->values.arena);
+            AST_AddValue(result, src);
+            AST_AddValue(result, 0);
+            return TRUE;
+        }
+    }
+
+    // Varannan int r variabelindex och varannan faktor, precis som i
+    // AST_ADD_CLEAR-noden.
+    Array pairs; Array_Init(&pairs, sizeof(int));
+    int   num_src_preds = 0;
+    Bool  is_match      = TRUE;
+
+    for (int i = 0; i < num_children && is_match; i++) {
+        AST_Node* child = Array_GetElemPtr(&loop->children, i);
+        int       var   = GetSelfOpVar(child);
+        int       delta = (child->type == AST_SUCC) ? 1 : -1;
+
+        if (var < 0) {
+            is_match = FALSE;
+            break;
+        }
+
+        if (var == src) {
+            // Loop-variabeln fr bara rknas ned, och bara en gng per
+            // iteration. Annars blir antalet iterationer ngot annat n
+            // variabelns vrde.
+            if (delta > 0 || ++num_src_preds > 1)
+                is_match = FALSE;
+            continue;
+        }
+
+        int num_pairs = Array_Length(&pairs);
+        int j;
+        for (j = 0; j < num_pairs; j += 2) {
+            if (*(int*)Array_GetElemPtr(&pairs, j) == var)
+                break;
+        }
+
+        if (j == num_pairs) {
+            Array_AddElem(&pairs, &var);
+            Array_AddElem(&pairs, &delta);
+            continue;
+        }
+
+        // Blandar vi SUCC och PRED p samma variabel spelar ordningen roll
+        // eftersom PRED begrnsas av noll, s d ger vi upp.
+        int* factor = Array_GetElemPtr(&pairs, j+1);
+        if ((*factor > 0) != (delta > 0))
+            is_match = FALSE;
+        *factor += delta;
+    }
+
+    if (!is_match || num_src_preds != 1) {
+        Array_Free(&pairs);
+        return FALSE;
+    }
+
+    int num_pairs = Array_Length(&pairs);
+    if (num_pairs == 0) {
+        // WHILE X<src> != 0 DO X<src> := PRED(X<src>) END
+        *result = AST_CreateNode(AST_ASSIGN, loop->values.arena);
+        AST_AddValue(result, src);
+        AST_AddValue(result, 0);
+    }
+    else {
+        *result = AST_CreateNode(AST_ADD_CLEAR, loop->values.arena);
+        AST_AddValue(result, src);
+        for (int i = 0; i < num_pairs; i++)
+            AST_AddValue(result, *(int*)Array_GetElemPtr(&pairs, i));
+    }
+
+    Array_Free(&pairs);
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: ReplaceNode()
+ * Parameters:
+ *   node         Noden som ska ersttas.
+ *   replacement  Den nya noden.
+ *
+ * Description:
+ *   Slpper den gamla noden ur minnet och lgger den nya p dess plats.
+ *------------------------------------*/
+static void ReplaceNode(AST_Node* node, const AST_Node* replacement) {
+    AST_Node* parent = node->parent;
+    int       row    = node->row;
+    int       col    = node->col;
+
+    AST_FreeNode(node);
+
+    *node        = *replacement;
+    node->parent = parent;
+    node->row    = row;
+    node->col    = col;
+}
+
+/*--------------------------------------
+ * Function: OptimizeNode()
+ * Parameters:
+ *   node  Noden vars barn ska optimeras.
+ *
+ * Description:
+ *   Optimerar frst alla loopar bland nodens barn, inifrn och ut, och letar
+ *   sedan efter idiom bland barnen. Returnerar antalet ersatta idiom.
+ *------------------------------------*/
+static int OptimizeNode(AST_Node* node) {
+    int num_replaced = 0;
+
+    // Vi brjar med de innersta looparna, eftersom en loop kan bli mjlig att
+    // optimera frst nr looparna inuti den har optimerats.
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        if (child->type == AST_WHILE)
+            num_replaced += OptimizeNode(child);
+    }
+
+    for (int i = 0; i < Array_Length(&node->children); i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        AST_Node  replacement;
+
+        if (MatchTransferLoop(child, &replacement)) {
+            ReplaceNode(child, &replacement);
+            num_replaced++;
+            continue;
+        }
+
+        if (i+1 < Array_Length(&node->children)) {
+            AST_Node* next = Array_GetElemPtr(&node->children, i+1);
+
+            if (MatchCopy(child, next, &replacement)) {
+                ReplaceNode(child, &replacement);
+                AST_FreeNode(next);
+                Array_RemoveElem(&node->children, i+1);
+                num_replaced++;
+            }
+        }
+    }
+
+    return num_replaced;
+}
+
+/*--------------------------------------
+ * Function: Opt_OptimizeTree()
+ * Parameters:
+ *   root  Root-noden i det AST som ska optimeras.
+ *
+ * Description:
+ *   Letar upp knda idiom i trdet och erstter dem med nya noder. Se
+ *   optimize.h fr en beskrivning av noderna. Returnerar antalet ersatta
+ *   idiom.
+ *------------------------------------*/
+int Opt_OptimizeTree(AST_Node* root) {
+    ASSERT(root->type == AST_PROGRAM);
+
+    int num_replaced = OptimizeNode(root);
+
+    // Noderna ligger direkt i barn-arrayerna, s nr vi tagit bort noder har
+    // andra noder flyttats och frldra-lnkarna mste terstllas.
+    AST_Repair(root);
+
+    return num_replaced;
+}
@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------------
+ * File: optimize.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Optimeringar av abstrakta syntax-trd. Knner igen vanliga idiom i P, ex.
+ *   loopar som flyttar vrdet frn en variabel till en annan, och erstter dem
+ *   med noder som kan kras med en enda aritmetisk operation.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef OPTIMIZE_H_
+#define OPTIMIZE_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "ast.h"
+#include "common.h"
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Opt_OptimizeTree()
+ * Parameters:
+ *   root  Root-noden i det AST som ska optimeras.
+ *
+ * Description:
+ *   Letar upp knda idiom i trdet och erstter dem med nya noder:
+ *
+ *   AST_ADD_CLEAR  Vrden: src, var1, faktor1, var2, faktor2, ...
+ *                  Erstter loopar p formen
+ *
+ *                    WHILE X<src> != 0 DO
+ *                        X<src> := PRED(X<src>)
+ *                        X<var> := SUCC(X<var>)  # eller PRED
+ *                        ...
+ *                    END
+ *
+ *                  Fr varje par lggs faktor*X<src> till X<var>. r faktorn
+ *                  negativ begrnsas resultatet s att det inte gr under
+ *                  noll, precis som PRED. Till sist nollas X<src>. En loop
+ *                  som bara nollar X<src> blir en vanlig tilldelning.
+ *
+ *   AST_COPY       Vrden: dst, src
+ *                  Erstter de tv satserna X<dst> := SUCC(X<src>) och
+ *                  X<dst> := PRED(X<dst>), dvs X<dst> := X<src>.
+ *
+ *   Returnerar antalet ersatta idiom.
+ *------------------------------------*/
+int Opt_OptimizeTree(AST_Node* root);
+
+#endif // OPTIMIZE_H_
@@ -0,0 +1,265 @@
+/*------------------------------------------------------------------------------
+ * File: perf.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Mtning med processorns prestandarknare, se perf.h.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+#include "perf.h"
+#include "thread.h"
+
+#include <stdio.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: PERF_SUPPORTED
+ *
+ * Description:
+ *   Definieras om rknarna kan lsas med perf_event_open().
+ *------------------------------------*/
+#ifdef __linux__
+#    define PERF_SUPPORTED
+#endif
+
+#ifdef PERF_SUPPORTED
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: OpenCounter()
+ * Parameters:
+ *   counter  Rknaren som ska ppnas.
+ *
+ * Description:
+ *   ppnar en rknare fr den anropande trden, utan att starta den.
+ *   Returnerar en fildeskriptor, eller -1 om rknaren inte gick att ppna.
+ *------------------------------------*/
+static int OpenCounter(Perf_Counter counter) {
+    // Lsningar frn L1-cachen fr data.
+    unsigned long long l1_read = PERF_COUNT_HW_CACHE_L1D
+                               | (PERF_COUNT_HW_CACHE_OP_READ << 8);
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+
+    switch (counter) {
+    case PERF_CYCLES:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PERF_INSTRUCTIONS:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PERF_BRANCHES:
+        attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+        break;
+    case PERF_BRANCH_MISSES:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case PERF_L1_LOADS:
+        attr.type   = PERF_TYPE_HW_CACHE;
+        attr.config = l1_read | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16);
+        break;
+    case PERF_L1_MISSES:
+        attr.type   = PERF_TYPE_HW_CACHE;
+        attr.config = l1_read | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    default:
+        return -1;
+    }
+
+    // Bara anvndarlget mts, eftersom det ofta r allt som en vanlig
+    // anvndare fr mta. Om processorn har frre rknare n vi ber om turas
+    // de om, och d skalas vrdena upp i ReadCounter().
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED
+                        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/*--------------------------------------
+ * Function: ReadCounter()
+ * Parameters:
+ *   fd  Rknarens fildeskriptor.
+ *
+ * Description:
+ *   Returnerar rknarens vrde, uppskalat till hela mttiden, eller -1 om den
+ *   inte gick att lsa.
+ *------------------------------------*/
+static long long ReadCounter(int fd) {
+    // Vrdet, tiden rknaren var aktiverad och tiden den faktiskt rknade.
+    unsigned long long data[3];
+
+    if (read(fd, data, sizeof(data)) != sizeof(data) || data[2] == 0)
+        return -1;
+
+    if (data[2] < data[1])
+        return (long long)((double)data[0] * data[1] / data[2]);
+
+    return (long long)data[0];
+}
+
+#endif // PERF_SUPPORTED
+
+/*--------------------------------------
+ * Function: Perf_Report()
+ * Parameters:
+ *   stats      Mtningen som ska skrivas ut.
+ *   num_stmts  Antalet satser som krdes, eller -1 om det inte r knt.
+ *
+ * Description:
+ *   Skriver ut rknarna, tillsammans med instruktioner per klockcykel,
+ *   andelen hopp som gissades fel och tiden per sats.
+ *------------------------------------*/
+void Perf_Report(const Perf_Stats* stats, long long num_stmts) {
+    const long long* v = stats->values;
+
+    printf("Statistics:\n\n");
+    printf("  %-20s %16.3f ms\n", "Wall time", stats->wall_ms);
+
+    if (num_stmts > 0) {
+        printf("  %-20s %16lld    (%.3f ns per statement)\n", "Statements",
+               num_stmts, 1000000.0 * stats->wall_ms / num_stmts);
+    }
+
+    Bool has_counters = FALSE;
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (v[i] >= 0)
+            has_counters = TRUE;
+    }
+
+    if (!has_counters) {
+        printf("\n  Hardware counters are not available, so only the wall "
+               "time was measured.\n");
+        return;
+    }
+
+    if (v[PERF_CYCLES] >= 0)
+        printf("  %-20s %16lld\n", "Cycles", v[PERF_CYCLES]);
+
+    if (v[PERF_INSTRUCTIONS] >= 0) {
+        printf("  %-20s %16lld", "Instructions", v[PERF_INSTRUCTIONS]);
+        if (v[PERF_CYCLES] > 0)
+            printf("    (%.2f per cycle)",
+                   (double)v[PERF_INSTRUCTIONS] / v[PERF_CYCLES]);
+        printf("\n");
+    }
+
+    if (v[PERF_BRANCHES] >= 0)
+        printf("  %-20s %16lld\n", "Branches", v[PERF_BRANCHES]);
+
+    if (v[PERF_BRANCH_MISSES] >= 0) {
+        printf("  %-20s %16lld", "Branch misses", v[PERF_BRANCH_MISSES]);
+        if (v[PERF_BRANCHES] > 0)
+            printf("    (%.3f%% of branches)",
+                   100.0 * v[PERF_BRANCH_MISSES] / v[PERF_BRANCHES]);
+        printf("\n");
+    }
+
+    if (v[PERF_L1_LOADS] >= 0)
+        printf("  %-20s %16lld\n", "L1 data loads", v[PERF_L1_LOADS]);
+
+    if (v[PERF_L1_MISSES] >= 0) {
+        printf("  %-20s %16lld", "L1 data misses", v[PERF_L1_MISSES]);
+        if (v[PERF_L1_LOADS] > 0)
+            printf("    (%.3f%% of loads)",
+                   100.0 * v[PERF_L1_MISSES] / v[PERF_L1_LOADS]);
+        printf("\n");
+    }
+
+    if (num_stmts > 0 && v[PERF_CYCLES] >= 0) {
+        printf("  %-20s %16.2f\n", "Cycles per statement",
+               (double)v[PERF_CYCLES] / num_stmts);
+    }
+}
+
+/*--------------------------------------
+ * Function: Perf_Start()
+ * Parameters:
+ *   stats  Mtningen som ska startas.
+ *
+ * Description:
+ *   ppnar och nollstller rknarna och startar mtningen. Rknare som inte
+ *   gr att ppna hoppas ver.
+ *------------------------------------*/
+void Perf_Start(Perf_Stats* stats) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        stats->fds[i]    = -1;
+        stats->values[i] = -1;
+
+#ifdef PERF_SUPPORTED
+        stats->fds[i] = OpenCounter((Perf_Counter)i);
+#endif
+    }
+
+    stats->wall_ms = 0.0;
+
+    // Rknarna startas sist, s att de rknar s lite som mjligt utver
+    // sjlva krningen.
+#ifdef PERF_SUPPORTED
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (stats->fds[i] >= 0) {
+            ioctl(stats->fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(stats->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+
+    stats->start_ms = Thread_WallTimeMs();
+}
+
+/*--------------------------------------
+ * Function: Perf_Stop()
+ * Parameters:
+ *   stats  Mtningen som ska stoppas.
+ *
+ * Description:
+ *   Stoppar mtningen, lser av rknarna och stnger dem.
+ *------------------------------------*/
+void Perf_Stop(Perf_Stats* stats) {
+    stats->wall_ms = Thread_WallTimeMs() - stats->start_ms;
+
+#ifdef PERF_SUPPORTED
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (stats->fds[i] >= 0)
+            ioctl(stats->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (stats->fds[i] < 0)
+            continue;
+
+        stats->values[i] = ReadCounter(stats->fds[i]);
+        close(stats->fds[i]);
+        stats->fds[i] = -1;
+    }
+#endif
+}
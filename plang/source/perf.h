@@ -0,0 +1,101 @@
+/*------------------------------------------------------------------------------
+ * File: perf.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Mter en krning med processorns prestandarknare: klockcykler,
+ *   instruktioner, hopp som gissats fel och missar i L1-cachen. Rknarna
+ *   lses med perf_event_open() p Linux. P andra system, eller om
+ *   rknarna inte fr anvndas, mts bara tiden.
+ *
+ *   Rknarna gller bara den trd som anropar Perf_Start(), s exempelvis
+ *   trden i sampler.h rknas inte med.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef PERF_H_
+#define PERF_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Perf_Counter
+ *
+ * Description:
+ *   De rknare som mts.
+ *------------------------------------*/
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCHES,
+    PERF_BRANCH_MISSES,
+    PERF_L1_LOADS,
+    PERF_L1_MISSES,
+    PERF_NUM_COUNTERS
+} Perf_Counter;
+
+/*--------------------------------------
+ * Type: Perf_Stats
+ *
+ * Description:
+ *   En mtning. values innehller rknarnas vrden efter Perf_Stop(), eller
+ *   -1 fr de rknare som inte kunde mtas. wall_ms r krtiden.
+ *------------------------------------*/
+typedef struct {
+    int       fds[PERF_NUM_COUNTERS];
+    long long values[PERF_NUM_COUNTERS];
+    double    start_ms;
+    double    wall_ms;
+} Perf_Stats;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Perf_Report()
+ * Parameters:
+ *   stats      Mtningen som ska skrivas ut.
+ *   num_stmts  Antalet satser som krdes, eller -1 om det inte r knt.
+ *
+ * Description:
+ *   Skriver ut rknarna, tillsammans med instruktioner per klockcykel,
+ *   andelen hopp som gissades fel och tiden per sats.
+ *------------------------------------*/
+void Perf_Report(const Perf_Stats* stats, long long num_stmts);
+
+/*--------------------------------------
+ * Function: Perf_Start()
+ * Parameters:
+ *   stats  Mtningen som ska startas.
+ *
+ * Description:
+ *   ppnar och nollstller rknarna och startar mtningen. Rknare som inte
+ *   gr att ppna hoppas ver.
+ *------------------------------------*/
+void Perf_Start(Perf_Stats* stats);
+
+/*--------------------------------------
+ * Function: Perf_Stop()
+ * Parameters:
+ *   stats  Mtningen som ska stoppas.
+ *
+ * Description:
+ *   Stoppar mtningen, lser av rknarna och stnger dem.
+ *------------------------------------*/
+void Perf_Stop(Perf_Stats* stats);
+
+#endif // PERF_H_
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: plang.c
  * Created: January 2, 2015
- * Last changed: January 12, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -9,23 +9,79 @@
  *   Detta r huvudfilen fr plang, som knyter samman alla andra moduler.
  *
  * Changes:
- *
+ *   * -runvm kr numer programmet som bytekod, utom i debug-lge.
+ *   * Vanliga loop-idiom optimeras bort innan programmet krs eller kompileras,
+ *     om inte -no-opt anges.
+ *   * -runvm sammanfattar nstlade rkne-loopar, och skriver ut en rapport
+ *     ver dem om -report anges.
+ *   * -runjit verstter programmet till x86-64-maskinkod och kr det direkt.
+ *   * Variablerna numreras om till en tt array innan programmet krs eller
+ *     kompileras.
+ *   * -bignum kr programmet med godtyckligt stora variabler.
+ *   * -int64 och -saturate kr programmet med 64-bitars respektive mttade
+ *     variabler, och -benchvm jmfr alla varianter av den virtuella maskinen.
+ *   * -batch kr programmet en gng fr varje rad i en CSV-fil, i flera
+ *     trdar.
+ *   * -batch kr raderna tta t gngen i parallella banor om -lanes
+ *     anges.
+ *   * -max-steps och -timeout begrnsar hur lnge programmet fr kra.
+ *   * -detect-loops avbryter program som hamnat i en ondlig loop.
+ *   * -break lgger till brytpunkter i debug-lget, som annars stegar sats
+ *     fr sats istllet fr att stanna vid varje loop-varv.
+ *   * -profile mter tiden fr varje rad i kllkoden.
+ *   * -sample visar frloppet under lnga krningar och tar stickprov p
+ *     vilken loop som krs.
+ *   * -stats mter krningen med processorns prestandarknare.
+ *   * -timings tidtar kompilatorns faser och rknar deras allokeringar.
+ *   * -bench kr en svit av prestandatester och jmfr med en baslinje.
+ *   * -genprog genererar P-program av valfri storlek, och -benchgen mter
+ *     hur kompilatorns frsta faser klarar allt strre program.
+ *   * -benchtok mter tokeniseraren i megabyte kllkod per sekund.
+ *   * Kllkoden mappas in i minnet, och delas upp i tokens en i taget av
+ *     syntax-kontrollen och nr syntax-trdet genereras.
+ *   * Syntaxen kontrolleras och syntax-trdet byggs i samma pass.
+ *   * Syntax-trdet och felmeddelandena allokeras ur en arena, och allt minne
+ *     slpps innan programmet avslutas.
+ *   * Avslutar med ERR_UNSUPPORTED om JIT-kompilatorn inte stds p
+ *     plattformen.
+ *   * Sger till om -detect-loops inte kan anvndas med -bignum.
+ *   * Hjlptexten listar flaggorna fr -runvm en och en.
+ *   * Felen nr en grns ns eller en ondlig loop upptcks anger loopens
+ *     rad.
+ *   * -profile optimerar inte bort ngra loopar, s att alla rader rknas.
+ *   * -stats rknar satserna i programmet som det r skrivet, i bytekod
+ *     istllet fr i syntax-trdet.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
  * INCLUDES
  *----------------------------------------------*/
 
+#include "arena.h"
 #include "array.h"
 #include "asm.h"
 #include "ast.h"
+#include "batch.h"
+#include "bignum.h"
+#include "breakpoint.h"
+#include "bytecode.h"
 #include "debug.h"
+#include "gen.h"
 #include "io.h"
-#include "tokenizer.h"
+#include "jit.h"
+#include "optimize.h"
+#include "perf.h"
+#include "profile.h"
+#include "sampler.h"
 #include "string.h"
+#include "suite.h"
+#include "summary.h"
 #include "syntax.h"
+#include "timing.h"
 #include "vm.h"
 
+#include <limits.h>
+#include <string.h>
 #include <time.h>
 
 /*------------------------------------------------
@@ -77,6 +133,110 @@
  *------------------------------------*/
 #define CMD_SYN_CHECK 5
 
+/*--------------------------------------
+ * Constant: CMD_RUN_JIT
+ *
+ * Description:
+ *   Som CMD_RUN_VM, men programmet verstts till maskinkod och krs direkt
+ *   av processorn istllet fr i den virtuella maskinen.
+ *------------------------------------*/
+#define CMD_RUN_JIT 6
+
+/*--------------------------------------
+ * Constant: CMD_BENCH_VM
+ *
+ * Description:
+ *   Det hr kommandot innebr att vi kr programmet upprepade gnger i varje
+ *   variant av den virtuella maskinen och skriver ut hur snabba de r.
+ *------------------------------------*/
+#define CMD_BENCH_VM 7
+
+/*--------------------------------------
+ * Constant: CMD_BENCH
+ *
+ * Description:
+ *   Det hr kommandot innebr att vi kr alla program i en svit av
+ *   prestandatester, se suite.h.
+ *------------------------------------*/
+#define CMD_BENCH 8
+
+/*--------------------------------------
+ * Constant: CMD_GEN_PROG
+ *
+ * Description:
+ *   Det hr kommandot innebr att vi genererar ett P-program och skriver det
+ *   till en fil, se gen.h.
+ *------------------------------------*/
+#define CMD_GEN_PROG 9
+
+/*--------------------------------------
+ * Constant: CMD_BENCH_GEN
+ *
+ * Description:
+ *   Det hr kommandot innebr att vi genererar allt strre program och mter
+ *   hur snabbt de delas upp i tokens, syntax-kontrolleras och grs om till
+ *   syntax-trd.
+ *------------------------------------*/
+#define CMD_BENCH_GEN 10
+
+/*--------------------------------------
+ * Constant: CMD_BENCH_TOK
+ *
+ * Description:
+ *   Det hr kommandot innebr att vi genererar allt strre program och mter
+ *   hur mnga megabyte kllkod per sekund som delas upp i tokens.
+ *------------------------------------*/
+#define CMD_BENCH_TOK 11
+
+/*--------------------------------------
+ * Constant: BENCH_MIN_MS
+ *
+ * Description:
+ *   Den minsta tid, i millisekunder, som -benchvm kr programmet i varje
+ *   variant av den virtuella maskinen.
+ *------------------------------------*/
+#define BENCH_MIN_MS 1000
+
+/*--------------------------------------
+ * Constant: BENCH_INT32
+ *
+ * Description:
+ *   Varianten med int-variabler, dvs VM_ExecBytecode().
+ *------------------------------------*/
+#define BENCH_INT32 0
+
+/*--------------------------------------
+ * Constant: BENCH_INT64
+ *
+ * Description:
+ *   Varianten med long long-variabler, dvs VM_ExecBytecode64().
+ *------------------------------------*/
+#define BENCH_INT64 1
+
+/*--------------------------------------
+ * Constant: BENCH_SATURATE
+ *
+ * Description:
+ *   Varianten med mttade int-variabler, dvs VM_ExecSaturating().
+ *------------------------------------*/
+#define BENCH_SATURATE 2
+
+/*--------------------------------------
+ * Constant: BENCH_BIGNUM
+ *
+ * Description:
+ *   Varianten med godtyckligt stora variabler, dvs VM_ExecBignum().
+ *------------------------------------*/
+#define BENCH_BIGNUM 3
+
+/*--------------------------------------
+ * Constant: BENCH_NUM_VARIANTS
+ *
+ * Description:
+ *   Antalet varianter som -benchvm jmfr.
+ *------------------------------------*/
+#define BENCH_NUM_VARIANTS 4
+
 /*--------------------------------------
  * Constant: ERR_IO_ERROR
  *
@@ -93,10 +253,204 @@
  *------------------------------------*/
 #define ERR_SYNTAX_ERROR 2
 
+/*--------------------------------------
+ * Constant: ERR_REGRESSION
+ *
+ * Description:
+ *   Exit-vrde som indikerar att -bench hittat tester som blivit
+ *   lngsammare n baslinjen.
+ *------------------------------------*/
+#define ERR_REGRESSION 3
+
+/*--------------------------------------
+ * Constant: ERR_UNSUPPORTED
+ *
+ * Description:
+ *   Exit-vrde som indikerar att programmet inte kan kras p det valda
+ *   sttet p den hr plattformen, ex. med -runjit.
+ *------------------------------------*/
+#define ERR_UNSUPPORTED 4
+
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
+/*--------------------------------------
+ * Function: AddBreakpoints()
+ * Parameters:
+ *   argc       Antal argument i kommandoraden.
+ *   argv       Vektor innehllande argumenten i kommandoraden.
+ *   root       Root-noden i det AST som brytpunkterna ska lggas i.
+ *   var_names  Variabelnamnen frn AST_ResolveVars().
+ *
+ * Description:
+ *   Lgger till en brytpunkt fr varje -break efter filnamnet, och
+ *   returnerar hur mnga som kunde lggas till.
+ *------------------------------------*/
+static int AddBreakpoints(int argc, char* argv[], AST_Node* root,
+                          const Array* var_names)
+{
+    int num_added = 0;
+
+    for (int i = 3; i < argc-1; i++) {
+        if (Str_Compare(argv[i], "-break") != 0)
+            continue;
+
+        Break_Point bp;
+        if (!Break_Parse(argv[i+1], &bp)) {
+            printf("Invalid breakpoint: %s\n", argv[i+1]);
+            continue;
+        }
+
+        int row = Break_Add(root, &bp, var_names->elems,
+                            Array_Length(var_names));
+        if (row == 0) {
+            printf("No statement on or after line %d.\n", bp.row);
+            continue;
+        }
+
+        printf("Breakpoint set at line %d.\n", row);
+        num_added++;
+    }
+
+    return num_added;
+}
+
+/*--------------------------------------
+ * Function: Benchmark()
+ * Parameters:
+ *   source    Programmets kllkod.
+ *   inputs    Input-vrdena, i samma ordning som i PROGRAM-raden.
+ *   variant   Varianten av den virtuella maskinen, ex. BENCH_INT64.
+ *   optimize  Sant om looparna ska optimeras.
+ *
+ * Description:
+ *   Kr programmet om och om igen i den angivna varianten av den virtuella
+ *   maskinen, i minst BENCH_MIN_MS millisekunder, och skriver ut hur mnga
+ *   krningar som hanns med.
+ *------------------------------------*/
+static void Benchmark(const char* source, const int* inputs, int variant,
+                      Bool optimize)
+{
+    static const char* names[BENCH_NUM_VARIANTS] = {
+        "int32", "int64", "saturate", "bignum"
+    };
+
+    // Sammanfattningarna beror p variablernas strsta vrde, s varje
+    // variant fr ett eget trd.
+    Arena    arena; Arena_Init(&arena);
+    AST_Node tree;
+    Syn_Parse(source, NULL, &tree, &arena);
+
+    if (optimize) {
+        Opt_OptimizeTree(&tree);
+        if (variant != BENCH_BIGNUM) {
+            long long max = (variant == BENCH_INT64) ? SUM_MAX_INT64
+                                                     : INT_MAX;
+            Sum_SummarizeTree(&tree, max, FALSE);
+        }
+    }
+
+    Array var_names;
+    AST_ResolveVars(&tree, &var_names);
+
+    BC_Program bytecode;
+    BC_Compile(&tree, &bytecode);
+
+    VM_Config vm_conf;
+    vm_conf.num_vars     = Array_Length(&var_names);
+    vm_conf.vars         = malloc(vm_conf.num_vars * sizeof(int));
+    vm_conf.vars64       = malloc(vm_conf.num_vars * sizeof(long long));
+    vm_conf.big_vars     = malloc(vm_conf.num_vars * sizeof(Big_Num));
+    vm_conf.var_names    = var_names.elems;
+    vm_conf.enable_debug = FALSE;
+    vm_conf.max_steps    = 0;
+    vm_conf.timeout_ms   = 0.0;
+    vm_conf.detect_loops = FALSE;
+    vm_conf.single_step  = FALSE;
+    vm_conf.progress     = NULL;
+
+    for (int i = 0; i < vm_conf.num_vars; i++)
+        Big_Init(&vm_conf.big_vars[i]);
+
+    Big_Num big_result;
+    Big_Init(&big_result);
+
+    int       num_inputs = Array_Length(&tree.values);
+    int       num_runs   = 0;
+    long long result;
+    clock_t   start      = clock();
+    clock_t   finish;
+
+    do {
+        // Varje krning brjar om frn input-vrdena. Det gr fort jmfrt
+        // med sjlva krningen, s vi terstller alla tre arrayerna oavsett
+        // variant.
+        for (int i = 0; i < vm_conf.num_vars; i++) {
+            vm_conf.vars[i]   = 0;
+            vm_conf.vars64[i] = 0;
+            Big_Set(&vm_conf.big_vars[i], 0);
+        }
+
+        for (int i = 0; i < num_inputs; i++) {
+            int var = *(int*)Array_GetElemPtr(&tree.values, i);
+            vm_conf.vars[var]   = inputs[i];
+            vm_conf.vars64[var] = inputs[i];
+            Big_Set(&vm_conf.big_vars[var], inputs[i]);
+        }
+
+        switch (variant) {
+        case BENCH_INT64:
+            result = VM_ExecBytecode64(&bytecode, &vm_conf);
+            break;
+        case BENCH_SATURATE:
+            result = VM_ExecSaturating(&bytecode, &vm_conf);
+            break;
+        case BENCH_BIGNUM:
+            result = VM_ExecBignum(&bytecode, &vm_conf, &big_result);
+            break;
+        default:
+            result = VM_ExecBytecode(&bytecode, &vm_conf);
+            break;
+        }
+
+        num_runs++;
+        finish = clock();
+    } while ((1000 * (finish - start)) / CLOCKS_PER_SEC < BENCH_MIN_MS);
+
+    double time_ms = (1000.0 * (finish - start)) / CLOCKS_PER_SEC;
+
+    printf("%-10s %10d %14.4f %14.1f   ", names[variant], num_runs,
+           time_ms / num_runs, (1000.0 * num_runs) / time_ms);
+
+    if (variant == BENCH_BIGNUM && result == 0) {
+        char* s = Big_ToStr(&big_result);
+        printf("%s\n", s);
+        free(s);
+    }
+    else if (result == VM_ERR_OVERFLOW) {
+        printf("overflow\n");
+    }
+    else if (result < 0) {
+        printf("error %lld\n", result);
+    }
+    else {
+        printf("%lld\n", result);
+    }
+
+    for (int i = 0; i < vm_conf.num_vars; i++)
+        Big_Free(&vm_conf.big_vars[i]);
+
+    Big_Free(&big_result);
+    free(vm_conf.big_vars);
+    free(vm_conf.vars64);
+    free(vm_conf.vars);
+    BC_Free(&bytecode);
+    Array_Free(&var_names);
+    AST_FreeNode(&tree);
+    Arena_Free(&arena);
+}
+
 /*--------------------------------------
  * Function: ChangeFileExt()
  * Parameters:
@@ -138,6 +492,168 @@ static char* ChangeFileExt(const char* file_name, const char* file_ext) {
     FAIL(); return NULL;
 }
 
+/*--------------------------------------
+ * Function: CountStatements()
+ * Parameters:
+ *   count_code  Bytekoden fr programmet innan det optimerades.
+ *   config      Konfigurationen som programmet krdes med.
+ *   inputs      Variablernas vrden innan programmet krdes, som int eller,
+ *               om config->vars64 anvnds, som long long.
+ *   timeout_ms  Den lngsta tid som rkningen fr ta.
+ *
+ * Description:
+ *   Kr programmet som det r skrivet en gng till med
+ *   VM_CountStatements(), och returnerar hur mnga satser som krdes.
+ *   Returnerar VM_ERR_LIMIT om rkningen tog fr lng tid, och -1 om den
+ *   avbrts av ngot annat skl.
+ *------------------------------------*/
+static long long CountStatements(const BC_Program* count_code,
+                                 const VM_Config* config, const void* inputs,
+                                 double timeout_ms)
+{
+    // Bytekoden versattes innan variablerna numrerades om, s den anvnder
+    // variablernas ursprungliga nummer som platser.
+    VM_Config conf = *config;
+
+    conf.num_vars     = PLANG_NUM_VARS;
+    conf.vars         = NULL;
+    conf.vars64       = NULL;
+    conf.big_vars     = NULL;
+    conf.max_steps    = 0;
+    conf.timeout_ms   = timeout_ms;
+    conf.detect_loops = FALSE;
+    conf.progress     = NULL;
+
+    long long result;
+    if (config->vars64 != NULL) {
+        const long long* values = inputs;
+
+        conf.vars64 = calloc(PLANG_NUM_VARS, sizeof(long long));
+        for (int i = 0; i < config->num_vars; i++)
+            conf.vars64[config->var_names[i]] = values[i];
+
+        result = VM_CountStatements64(count_code, &conf);
+        free(conf.vars64);
+    }
+    else {
+        const int* values = inputs;
+
+        conf.vars = calloc(PLANG_NUM_VARS, sizeof(int));
+        for (int i = 0; i < config->num_vars; i++)
+            conf.vars[config->var_names[i]] = values[i];
+
+        result = VM_CountStatements(count_code, &conf);
+        free(conf.vars);
+    }
+
+    if (result == VM_ERR_LIMIT)
+        return VM_ERR_LIMIT;
+
+    return (result >= 0) ? conf.num_stmts : -1;
+}
+
+/*--------------------------------------
+ * Function: GetOptionValue()
+ * Parameters:
+ *   argc    Antal argument i kommandoraden.
+ *   argv    Vektor innehllande argumenten i kommandoraden.
+ *   option  Flaggan som ska letas efter, ex. "-batch".
+ *
+ * Description:
+ *   Returnerar argumentet som fljer efter flaggan, eller NULL om flaggan
+ *   inte angetts efter filnamnet eller saknar vrde.
+ *------------------------------------*/
+static char* GetOptionValue(int argc, char* argv[], const char* option) {
+    for (int i = 3; i < argc-1; i++) {
+        if (Str_Compare(argv[i], option) == 0)
+            return argv[i+1];
+    }
+
+    return NULL;
+}
+
+/*--------------------------------------
+ * Function: ParseSize()
+ * Parameters:
+ *   s  En storlek i byte, eventuellt fljd av K, M eller G, ex. "64M".
+ *
+ * Description:
+ *   Returnerar storleken i byte, eller noll om strngen inte gr att tolka.
+ *------------------------------------*/
+static long long ParseSize(const char* s) {
+    char*     end;
+    long long size = strtoll(s, &end, 10);
+
+    long long unit = 1;
+         if (*end == 'K' || *end == 'k') unit = 1024LL;
+    else if (*end == 'M' || *end == 'm') unit = 1024LL*1024;
+    else if (*end == 'G' || *end == 'g') unit = 1024LL*1024*1024;
+
+    if (unit > 1) {
+        size *= unit;
+        end++;
+    }
+
+    if (end == s || (*end != '\0' && Str_CompareI(end, "B") != 0))
+        return 0;
+
+    return (size > 0) ? size : 0;
+}
+
+/*--------------------------------------
+ * Function: GetGenOptions()
+ * Parameters:
+ *   argc     Antal argument i kommandoraden.
+ *   argv     Vektor innehllande argumenten i kommandoraden.
+ *   options  Instllningarna som ska fyllas i.
+ *
+ * Description:
+ *   Fyller i instllningarna fr Gen_Program() frn -stmts, -size, -depth,
+ *   -vars och -seed efter filnamnet.
+ *------------------------------------*/
+static void GetGenOptions(int argc, char* argv[], Gen_Options* options) {
+    char* stmts = GetOptionValue(argc, argv, "-stmts");
+    char* size  = GetOptionValue(argc, argv, "-size");
+    char* depth = GetOptionValue(argc, argv, "-depth");
+    char* vars  = GetOptionValue(argc, argv, "-vars");
+    char* seed  = GetOptionValue(argc, argv, "-seed");
+
+    options->num_stmts = stmts ? atoll(stmts)            : 0;
+    options->max_size  = size  ? ParseSize(size)         : 0;
+    options->max_depth = depth ? atoi(depth)             : GEN_MAX_DEPTH;
+    options->num_vars  = vars  ? atoi(vars)              : GEN_NUM_VARS;
+    options->seed      = seed  ? strtoul(seed, NULL, 10) : 1;
+    options->dec_first = FALSE;
+
+    if (options->num_stmts <= 0 && options->max_size <= 0)
+        options->num_stmts = GEN_NUM_STMTS;
+    if (options->num_vars < 1)
+        options->num_vars = 1;
+    if (options->max_depth > options->num_vars-1)
+        options->max_depth = options->num_vars-1;
+    if (options->max_depth < 0)
+        options->max_depth = 0;
+}
+
+/*--------------------------------------
+ * Function: HasOption()
+ * Parameters:
+ *   argc    Antal argument i kommandoraden.
+ *   argv    Vektor innehllande argumenten i kommandoraden.
+ *   option  Flaggan som ska letas efter, ex. "-debug".
+ *
+ * Description:
+ *   Returnerar sant om flaggan angetts ngonstans efter filnamnet.
+ *------------------------------------*/
+static Bool HasOption(int argc, char* argv[], const char* option) {
+    for (int i = 3; i < argc; i++) {
+        if (Str_Compare(argv[i], option) == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
 /*--------------------------------------
  * Function: PrintLogo()
  * Parameters:
@@ -159,7 +675,7 @@ static void PrintLogo() {
  *------------------------------------*/
 static void PrintUsage() {
     printf(
-        "Usage: plang [command|filename] [filename] [-debug|-no-opt]"       "\n"
+        "Usage: plang [command|filename] [filename] [options]"              "\n"
         ""                                                                  "\n"
         "Commands:"                                                         "\n"
         ""                                                                  "\n"
@@ -173,16 +689,249 @@ static void PrintUsage() {
         "             runnable executable file. Specify -no-opt after the"  "\n"
         "             filename to disable code optimizations."              "\n"
         ""                                                                  "\n"
-        "  -runvm     Runs the specified input source file in a virtual."   "\n"
-        "             machine. Specify -debug to step through the program"  "\n"
-        "             and print out the variable values as they change."    "\n"
+        "  -runvm     Runs the specified input source file in a virtual"    "\n"
+        "             machine. See the options below."                      "\n"
+        ""                                                                  "\n"
+        "  -runjit    Like -runvm, but compiles the program to native"      "\n"
+        "             machine code first. Only supported on x86-64 Linux."  "\n"
+        "             Debugging is not available in this mode."             "\n"
+        ""                                                                  "\n"
+        "  -benchvm   Runs the program repeatedly in each variant of the"   "\n"
+        "             virtual machine and displays their throughput."       "\n"
+        "             Specify -no-opt to disable loop optimizations."       "\n"
         ""                                                                  "\n"
         "  -syncheck  Loads the source code from the specified input file"  "\n"
         "             and performs a syntax check."                         "\n"
         ""                                                                  "\n"
+        "  -bench     Runs each program listed in the specified suite file" "\n"
+        "             (see examples/bench.txt) with its input values in"    "\n"
+        "             every executor, and displays the median and 95th"     "\n"
+        "             percentile time per run. Specify -json <file> to"     "\n"
+        "             save the results, and -baseline <file> to compare"    "\n"
+        "             with saved results and flag runs that are more than"  "\n"
+        "             -threshold <percent> (default 10) slower. Specify"    "\n"
+        "             -samples <n> and -warmups <n> to change the number"   "\n"
+        "             of measured and discarded samples, and -no-opt to"    "\n"
+        "             disable loop optimizations."                          "\n"
+        ""                                                                  "\n"
+        "  -genprog   Generates a random P program and writes it to the"    "\n"
+        "             specified file. Specify -stmts <n> or -size <bytes>"  "\n"
+        "             (with an optional K, M or G suffix) to set its"       "\n"
+        "             length (default 1000 statements), -depth <n> for"     "\n"
+        "             the deepest loop nesting (default 4), -vars <n> for"  "\n"
+        "             the number of variables (default 8) and -seed <n>"    "\n"
+        "             for a different program."                             "\n"
+        ""                                                                  "\n"
+        "  -benchgen  Generates programs from 1 KB up to the specified"     "\n"
+        "             size (e.g. 64M or 1G), four times larger each time,"  "\n"
+        "             and displays the tokens and syntax tree nodes per"    "\n"
+        "             second, the time spent parsing and checking loops,"   "\n"
+        "             and the peak memory for each size. Then does the"     "\n"
+        "             same for deeper and deeper loops. Specify -depth,"    "\n"
+        "             -vars and -seed as for -genprog."                     "\n"
+        ""                                                                  "\n"
+        "  -benchtok  Generates programs from 64 KB up to the specified"    "\n"
+        "             size and displays how many megabytes of source code"  "\n"
+        "             and tokens per second the tokenizer handles for each" "\n"
+        "             size. Specify -depth, -vars and -seed as for"         "\n"
+        "             -genprog."                                            "\n"
+        ""                                                                  "\n"
+        "Options for -runvm:"                                               "\n"
+        ""                                                                  "\n"
+        "  -debug             Steps through the program and prints out the" "\n"
+        "                     variable values as they change."              "\n"
+        "  -break <line>      Stops at the line. With -break \"<line> if"   "\n"
+        "                     X<n> op <value>\", stops there only when the" "\n"
+        "                     condition holds, where op is ==, !=, <, <=,"  "\n"
+        "                     > or >=. The program runs at full speed"      "\n"
+        "                     until a breakpoint is hit, and more can be"   "\n"
+        "                     added there."                                 "\n"
+        "  -no-opt            Disables loop optimizations."                 "\n"
+        "  -report            Lists which loops were accelerated."          "\n"
+        "  -profile           Times each line of the program and lists the" "\n"
+        "                     lines where the most time was spent. Loop"    "\n"
+        "                     optimizations are disabled while profiling,"  "\n"
+        "                     so every line is counted as written. Loop"    "\n"
+        "                     nesting is written to the source file name"   "\n"
+        "                     with the extension changed to .folded, for"   "\n"
+        "                     flame graph tools."                           "\n"
+        "  -sample            Displays the progress of long runs every"     "\n"
+        "                     second and lists the loops that were running" "\n"
+        "                     when the program was sampled."                "\n"
+        "  -stats             Measures the run with the hardware"           "\n"
+        "                     performance counters (cycles, instructions,"  "\n"
+        "                     branch and L1 cache misses) where available," "\n"
+        "                     and the time per executed statement."         "\n"
+        "                     Statements are counted as written, before"    "\n"
+        "                     optimization, in a second run of the"         "\n"
+        "                     bytecode afterwards. The count is skipped if" "\n"
+        "                     it takes more than ten times as long as the"  "\n"
+        "                     run."                                         "\n"
+        "  -bignum            Allows arbitrarily large values instead of"   "\n"
+        "                     stopping on overflow."                        "\n"
+        "  -int64             Uses 64-bit values."                          "\n"
+        "  -saturate          Keeps values at the largest integer instead"  "\n"
+        "                     of stopping on overflow."                     "\n"
+        "  -batch <file.csv>  Runs the program once for each line of input" "\n"
+        "                     values in the file, using one thread per"     "\n"
+        "                     CPU."                                         "\n"
+        "  -threads <n>       Runs -batch with n threads."                  "\n"
+        "  -lanes             Runs the -batch rows eight at a time in"      "\n"
+        "                     parallel lanes. Each group of eight takes as" "\n"
+        "                     long as its slowest row, so this is only"     "\n"
+        "                     faster when the rows take about equally"      "\n"
+        "                     long."                                        "\n"
+        "  -max-steps <n>     Stops the program after n loop iterations."   "\n"
+        "                     With -batch, the limit applies to each line"  "\n"
+        "                     separately."                                  "\n"
+        "  -timeout <ms>      Stops the program after ms milliseconds."     "\n"
+        "                     With -batch, the limit applies to each line"  "\n"
+        "                     separately."                                  "\n"
+        "  -detect-loops      Stops the program as soon as a loop repeats"  "\n"
+        "                     with exactly the same values, which means"    "\n"
+        "                     that it will never finish. Not available"     "\n"
+        "                     with -bignum, and disables parallel lanes."   "\n"
+        ""                                                                  "\n"
+        "Specify -timings after the filename with any command to"           "\n"
+        "display the time, allocations and peak memory of each"             "\n"
+        "compiler phase."                                                   "\n"
+        ""                                                                  "\n"
     );
 }
 
+/*--------------------------------------
+ * Function: RunBenchGen()
+ * Parameters:
+ *   argc      Antal argument i kommandoraden.
+ *   argv      Vektor innehllande argumenten i kommandoraden.
+ *   max_size  Storleken p det strsta programmet, ex. "64M".
+ *
+ * Description:
+ *   Mter kompilatorns frsta faser med genererade program, och returnerar
+ *   programmets exit-vrde.
+ *------------------------------------*/
+static int RunBenchGen(int argc, char* argv[], const char* max_size) {
+    long long size = ParseSize(max_size);
+    if (size == 0) {
+        printf("ERROR: Invalid program size: %s\n", max_size);
+        return ERR_IO_ERROR;
+    }
+
+    Gen_Options options;
+    GetGenOptions(argc, argv, &options);
+
+    if (!Gen_Benchmark(size, &options))
+        return ERR_SYNTAX_ERROR;
+
+    return 0;
+}
+
+/*--------------------------------------
+ * Function: RunBenchTok()
+ * Parameters:
+ *   argc      Antal argument i kommandoraden.
+ *   argv      Vektor innehllande argumenten i kommandoraden.
+ *   max_size  Storleken p det strsta programmet, ex. "64M".
+ *
+ * Description:
+ *   Mter tokeniseraren med genererade program, och returnerar programmets
+ *   exit-vrde.
+ *------------------------------------*/
+static int RunBenchTok(int argc, char* argv[], const char* max_size) {
+    long long size = ParseSize(max_size);
+    if (size == 0) {
+        printf("ERROR: Invalid program size: %s\n", max_size);
+        return ERR_IO_ERROR;
+    }
+
+    Gen_Options options;
+    GetGenOptions(argc, argv, &options);
+
+    Gen_BenchTokenizer(size, &options);
+
+    return 0;
+}
+
+/*--------------------------------------
+ * Function: RunGenerator()
+ * Parameters:
+ *   argc       Antal argument i kommandoraden.
+ *   argv       Vektor innehllande argumenten i kommandoraden.
+ *   file_name  Filen som programmet ska skrivas till.
+ *
+ * Description:
+ *   Genererar ett program med instllningarna frn kommandoraden och skriver
+ *   det till filen. Returnerar programmets exit-vrde.
+ *------------------------------------*/
+static int RunGenerator(int argc, char* argv[], const char* file_name) {
+    Gen_Options options;
+    GetGenOptions(argc, argv, &options);
+
+    long long length;
+    char*     source = Gen_Program(&options, &length);
+
+    FILE* fp = fopen(file_name, "wb");
+    Bool  ok = (fp != NULL);
+
+    if (fp) {
+        ok = (fwrite(source, 1, (size_t)length, fp) == (size_t)length);
+        ok = (fclose(fp) == 0) && ok;
+    }
+
+    free(source);
+
+    if (!ok) {
+        printf("ERROR: Could not write %s.\n", file_name);
+        return ERR_IO_ERROR;
+    }
+
+    printf("Wrote %lld bytes to %s (loop depth %d, %d variables, seed %u).\n",
+           length, file_name, options.max_depth, options.num_vars,
+           options.seed);
+    return 0;
+}
+
+/*--------------------------------------
+ * Function: RunSuite()
+ * Parameters:
+ *   argc        Antal argument i kommandoraden.
+ *   argv        Vektor innehllande argumenten i kommandoraden.
+ *   suite_file  Filen med sviten.
+ *
+ * Description:
+ *   Kr sviten med instllningarna frn kommandoraden, och returnerar
+ *   programmets exit-vrde.
+ *------------------------------------*/
+static int RunSuite(int argc, char* argv[], const char* suite_file) {
+    char* samples   = GetOptionValue(argc, argv, "-samples");
+    char* warmups   = GetOptionValue(argc, argv, "-warmups");
+    char* threshold = GetOptionValue(argc, argv, "-threshold");
+
+    Suite_Options options;
+    options.json_file     = GetOptionValue(argc, argv, "-json");
+    options.baseline_file = GetOptionValue(argc, argv, "-baseline");
+    options.threshold     = threshold ? atof(threshold) : SUITE_THRESHOLD;
+    options.num_samples   = samples   ? atoi(samples)   : SUITE_NUM_SAMPLES;
+    options.num_warmups   = warmups   ? atoi(warmups)   : SUITE_NUM_WARMUPS;
+    options.optimize      = !HasOption(argc, argv, "-no-opt");
+
+    if (options.num_samples < 1)
+        options.num_samples = 1;
+    if (options.num_warmups < 0)
+        options.num_warmups = 0;
+
+    printf("Benchmark suite: %s (%d samples, %d warmups)\n", suite_file,
+           options.num_samples, options.num_warmups);
+    if (!options.optimize)
+        printf("Code optimizations disabled.\n");
+
+    int num_regressions = Suite_Run(suite_file, &options);
+    if (num_regressions < 0)
+        return ERR_IO_ERROR;
+
+    return (num_regressions > 0) ? ERR_REGRESSION : 0;
+}
+
 /*--------------------------------------
  * Function: main()
  * Parameters:
@@ -224,38 +973,71 @@ int main(int argc, char* argv[]) {
     }
     else if (argc >= 3) {
              if (Str_Compare(argv[1], "-asm"     )==0) command = CMD_ASM;
+        else if (Str_Compare(argv[1], "-bench"   )==0) command = CMD_BENCH;
+        else if (Str_Compare(argv[1], "-benchgen")==0) command = CMD_BENCH_GEN;
+        else if (Str_Compare(argv[1], "-benchtok")==0) command = CMD_BENCH_TOK;
+        else if (Str_Compare(argv[1], "-benchvm" )==0) command = CMD_BENCH_VM;
         else if (Str_Compare(argv[1], "-compile" )==0) command = CMD_COMPILE;
+        else if (Str_Compare(argv[1], "-genprog" )==0) command = CMD_GEN_PROG;
         else if (Str_Compare(argv[1], "-printast")==0) command = CMD_PRINT_AST;
+        else if (Str_Compare(argv[1], "-runjit"  )==0) command = CMD_RUN_JIT;
         else if (Str_Compare(argv[1], "-runvm"   )==0) command = CMD_RUN_VM;
         else if (Str_Compare(argv[1], "-syncheck")==0) command = CMD_SYN_CHECK;
 
         file_name = Str_Duplicate(argv[2]);
     }
 
+    // Sviten lser sjlv in sina program, och de genererade programmen
+    // finns inte i ngon fil, s inget av det nedan behvs.
+    int status = -1;
+    if (command == CMD_BENCH)     status = RunSuite(argc, argv, file_name);
+    if (command == CMD_BENCH_GEN) status = RunBenchGen(argc, argv, file_name);
+    if (command == CMD_BENCH_TOK) status = RunBenchTok(argc, argv, file_name);
+    if (command == CMD_GEN_PROG)  status = RunGenerator(argc, argv, file_name);
+
+    if (status >= 0) {
+        Str_Free(file_name);
+        return status;
+    }
+
     printf("Source file: %s\n", file_name);
 
-    char* source_code = IO_ReadFile(file_name);
+    // Flaggorna kommer efter filnamnet, s med frre argument finns inga.
+    Bool timings = (argc >= 3) && HasOption(argc, argv, "-timings");
+    if (timings)
+        Timing_Enable();
 
-    if (!source_code) {
-        free(file_name);
+    // Kllkoden mappas in i minnet istllet fr att lsas in, s stora
+    // program behver inte f plats i minnet p en gng.
+    Timing_Begin("Read file", TRUE);
+    IO_File_View source_file;
+
+    if (!IO_MapFile(file_name, &source_file)) {
+        Str_Free(file_name);
         printf("ERROR: Could not load source file.\n");
         if (pause_on_exit)
             IO_Pause();
         return ERR_IO_ERROR;
     }
 
-    Array errors; Array_Init(&errors, sizeof(Syntax_Error));
-    Array tokens; Array_Init(&tokens, sizeof(P_Token));
+    const char* source_code = source_file.text;
 
-    /*----------------------------------------------------
-     * 1. Dela upp kllkoden i s.k. tokens.
-     *--------------------------------------------------*/
-    Tok_Tokenize(source_code, &tokens);
+    // Syntax-trdet och felmeddelandena allokeras ur samma arena, s att de
+    // kan slppas i ett enda anrop nr vi r klara med dem.
+    Arena    arena; Arena_Init(&arena);
+    Array    errors; Array_InitSized(&errors, sizeof(Syntax_Error), 0, &arena);
+    AST_Node syntax_tree;
 
     /*----------------------------------------------------
-     * 2. Kontrollera att syntaxen r korrekt.
+     * 1. Kontrollera att syntaxen r korrekt och generera
+     *    syntax-trdet. Kllkoden delas upp i s.k. tokens
+     *    under tiden, en i taget. Trdet behvs inte om
+     *    vi bara ska kontrollera syntaxen.
      *--------------------------------------------------*/
-    Syn_CheckSyntax(&tokens, &errors, source_code);
+    Timing_Begin("Parse", TRUE);
+    Syn_Parse(source_code, &errors,
+              (command == CMD_SYN_CHECK) ? NULL : &syntax_tree, &arena);
+    Timing_End();
 
     int num_errors = Array_Length(&errors);
     if (num_errors > 0) {
@@ -275,20 +1057,13 @@ int main(int argc, char* argv[]) {
                 num_warnings++;
         }
 
-        // Slpp felmeddelandena ur minnet.
-        for (int i = 0; i < num_errors; i++) {
-            Syntax_Error* err = Array_GetElemPtr(&errors, i);
-            free(err->text);
-        }
-
-        Array_Free(&errors);
-
         printf("\n%d errors, %d warnings\n\n", num_actual_errors, num_warnings);
 
         if (num_actual_errors > 0) {
-            Array_Free(&tokens);
-            free(source_code);
-            free(file_name);
+            // Trdet har redan slppts av Syn_Parse().
+            Arena_Free(&arena);
+            IO_UnmapFile(&source_file);
+            Str_Free(file_name);
             if (pause_on_exit)
                 IO_Pause();
             return ERR_SYNTAX_ERROR;
@@ -298,38 +1073,47 @@ int main(int argc, char* argv[]) {
     if (command == CMD_SYN_CHECK) {
         // Kommandot innebr att vi bara ska kontrollera syntaxen, s vi r
         // klara hr.
-        Array_Free(&tokens);
-        free(source_code);
-        free(file_name);
+        if (timings) {
+            printf("\n");
+            Timing_Report();
+        }
+
+        Arena_Free(&arena);
+        IO_UnmapFile(&source_file);
+        Str_Free(file_name);
         if (pause_on_exit)
             IO_Pause();
         return 0;
     }
 
-    /*----------------------------------------------------
-     * 3. Generera syntax-trdet.
-     *--------------------------------------------------*/
-    AST_Node syntax_tree = AST_GenerateTree(&tokens);
-
-    // Vi mste anropa AST_Repair() hr pga att trdet kopierats frn funktionen
-    // AST_GenerateTree() till nuvarande stack.
-    AST_Repair(&syntax_tree);
+    int exit_code = 0;
 
     switch (command) {
     /*----------------------------------------------------
-     * 4a. Kompilera syntax-trdet till assembly-kod och
+     * 2a. Kompilera syntax-trdet till assembly-kod och
      *     generera eventuellt en exe-fil.
      *--------------------------------------------------*/
     case CMD_ASM:
     case CMD_COMPILE: {
-        Bool optimize = !(argc>3 && Str_Compare(argv[3], "-no-opt")==0);
+        Bool optimize = !HasOption(argc, argv, "-no-opt");
         if (!optimize)
             printf("Code optimizations disabled.\n");
 
+        Timing_Begin("Optimize", TRUE);
+        if (optimize)
+            Opt_OptimizeTree(&syntax_tree);
+
+        Timing_Begin("Resolve vars", TRUE);
+        Array var_names;
+        AST_ResolveVars(&syntax_tree, &var_names);
+        Timing_End();
+
         char* asm_file = ChangeFileExt(file_name, "asm");
         
         // Frst genererar vi assembly-koden...
-        Asm_GenerateCode(&syntax_tree, asm_file, optimize);
+        Timing_Begin("Generate asm", TRUE);
+        Asm_GenerateCode(&syntax_tree, &var_names, asm_file, optimize);
+        Timing_End();
 
         if (command == CMD_COMPILE) {
             printf("\n");
@@ -342,11 +1126,12 @@ int main(int argc, char* argv[]) {
         }
 
         free(asm_file);
+        Array_Free(&var_names);
         break;
     }
 
     /*----------------------------------------------------
-     * 4b. Skriv ut det abstrakta syntax-trdet.
+     * 2b. Skriv ut det abstrakta syntax-trdet.
      *--------------------------------------------------*/
     case CMD_PRINT_AST:
         printf("\n");
@@ -354,42 +1139,269 @@ int main(int argc, char* argv[]) {
         break;
 
     /*----------------------------------------------------
-     * 4c. Kr syntax-trdet i en virtuell maskin.
+     * 2c. Kr syntax-trdet i en virtuell maskin.
      *--------------------------------------------------*/
+    case CMD_RUN_JIT:
     case CMD_RUN_VM: {
-        Bool debug = (argc>3 && Str_Compare(argv[3], "-debug")==0);
+        // Maskinkoden kan inte stega igenom kllkoden, s med -runjit gr det
+        // inte att kra i debug-lge.
+        // Likas kr -bignum, -int64 och -saturate alltid bytekod, i var sin
+        // variant av den virtuella maskinen. -batch kr vanlig bytekod.
+        // -profile kr syntax-trdet, precis som debug-lget, och optimerar
+        // inte heller bort ngra loopar, se nedan.
+        Bool  jit        = (command == CMD_RUN_JIT);
+        char* batch_file = jit ? NULL : GetOptionValue(argc, argv, "-batch");
+        Bool  batch      = (batch_file != NULL);
+        Bool  bignum     = !jit && !batch && HasOption(argc, argv, "-bignum");
+        Bool  int64      = !jit && !batch && !bignum
+                        && HasOption(argc, argv, "-int64");
+        Bool  saturate   = !jit && !batch && !bignum && !int64
+                        && HasOption(argc, argv, "-saturate");
+        Bool  variant    = batch || bignum || int64 || saturate;
+        Bool  debug      = !jit && !variant
+                        && (HasOption(argc, argv, "-debug")
+                         || GetOptionValue(argc, argv, "-break") != NULL);
+        Bool  optimize   = !HasOption(argc, argv, "-no-opt");
 #   ifdef DEBUG
-        debug = TRUE;
+        debug = !jit && !variant;
 #   endif
+        Bool  profile    = !jit && !variant && !debug
+                        && HasOption(argc, argv, "-profile");
+        Bool  run_ast    = debug || profile;
+        Bool  sample     = !debug && !batch
+                        && HasOption(argc, argv, "-sample");
+        Bool  stats      = !debug && !batch
+                        && HasOption(argc, argv, "-stats");
         if (debug)
             printf("Debug mode enabled.\n");
+        if (profile)
+            printf("Profiling enabled.\n");
+        if (sample)
+            printf("Sampling enabled.\n");
+        if (stats)
+            printf("Performance counters enabled.\n");
+        if (bignum)
+            printf("Arbitrary-precision mode enabled.\n");
+        if (int64)
+            printf("64-bit mode enabled.\n");
+        if (saturate)
+            printf("Saturating mode enabled.\n");
+        if (batch)
+            printf("Batch mode enabled, reading input from %s.\n", batch_file);
+
+        // Grnserna gller i alla lgen, ven fr maskinkoden frn -runjit.
+        char*     steps      = GetOptionValue(argc, argv, "-max-steps");
+        char*     timeout    = GetOptionValue(argc, argv, "-timeout");
+        long long max_steps  = steps   ? atoll(steps)  : 0;
+        double    timeout_ms = timeout ? atof(timeout) : 0.0;
+        Bool      detect     = HasOption(argc, argv, "-detect-loops");
+
+        // Godtyckligt stora tal kan inte jmfras, s med -bignum skulle en
+        // ondlig loop aldrig upptckas. D sger vi till istllet fr att
+        // lta programmet hnga.
+        if (detect && bignum) {
+            printf("Infinite loop detection is not available with "
+                   "-bignum.\n");
+            detect = FALSE;
+        }
+        else if (detect) {
+            printf("Infinite loop detection enabled.\n");
+        }
+
+        // -stats rknar satserna i programmet som det r skrivet, s bytekoden
+        // fr det verstts innan trdet optimeras och variablerna numreras
+        // om. Nr syntax-trdet krs rknas satserna redan under krningen.
+        BC_Program count_code;
+        Bool       count_stmts = stats && !run_ast && !bignum;
+        if (count_stmts) {
+            Timing_Begin("Compile", TRUE);
+            BC_Compile(&syntax_tree, &count_code);
+        }
+
+        // I debug-lge stegar vi igenom kllkoden, och vid profilering rknas
+        // tiden per rad, s dr mste trdet se ut precis som programmet r
+        // skrivet. Annars fr rader i bortoptimerade loopar ingen tid alls.
+        // Loop-sammanfattningarna rknar med int och anvnds drfr inte med
+        // -bignum.
+        Timing_Begin("Optimize", TRUE);
+        if (optimize && !debug && !profile) {
+            Opt_OptimizeTree(&syntax_tree);
+            if (!bignum)
+                Sum_SummarizeTree(&syntax_tree,
+                                  int64 ? SUM_MAX_INT64 : INT_MAX,
+                                  HasOption(argc, argv, "-report"));
+        }
+
+        // Variablerna numreras om till tta platser sist av allt, s att
+        // rapporten ovan fortfarande visar de ursprungliga namnen.
+        Timing_Begin("Resolve vars", TRUE);
+        Array var_names;
+        AST_ResolveVars(&syntax_tree, &var_names);
+        Timing_End();
+
+        // Brytpunkterna anges med de ursprungliga variabelnamnen, s de kan
+        // lggas till frst nu. Utan brytpunkter stegar vi frn brjan.
+        Bool single_step = debug
+                        && AddBreakpoints(argc, argv, &syntax_tree,
+                                          &var_names) == 0;
+
+        // I debug-lge mste vi kra syntax-trdet direkt eftersom vi stegar
+        // igenom kllkoden, och vid profilering fr att kunna rkna per nod.
+        // Annars verstter vi frst trdet till bytekod eller maskinkod,
+        // vilket gr mycket snabbare att kra.
+        Timing_Begin("Compile", TRUE);
+        BC_Program  bytecode;
+        Jit_Program machine_code;
+        if (jit) {
+            if (!Jit_Compile(&syntax_tree, &machine_code)) {
+                printf("ERROR: The JIT compiler is not supported on this "
+                       "platform.\n");
+                Timing_End();
+                if (count_stmts)
+                    BC_Free(&count_code);
+                Array_Free(&var_names);
+                exit_code = ERR_UNSUPPORTED;
+                break;
+            }
+        }
+        else if (!run_ast) {
+            BC_Compile(&syntax_tree, &bytecode);
+        }
+        Timing_End();
+
+        if (batch) {
+            // Input-vrdena kommer frn filen, s vi frgar inte anvndaren
+            // efter ngra.
+            char* threads     = GetOptionValue(argc, argv, "-threads");
+            int   num_threads = threads ? atoi(threads) : 0;
+            Bool  use_lanes   = HasOption(argc, argv, "-lanes");
+
+            // Banorna jmfr inte tillstnden, s de kan inte anvndas nr
+            // ondliga loopar ska upptckas.
+            if (detect)
+                use_lanes = FALSE;
+
+            // Raderna krs i flera trdar, s allokeringarna kan inte rknas.
+            printf("\n");
+            Timing_Begin("Execute", FALSE);
+            if (!Batch_Run(&bytecode, &syntax_tree, Array_Length(&var_names),
+                           batch_file, num_threads, use_lanes, max_steps,
+                           timeout_ms, detect))
+            {
+                printf("ERROR: Could not open input file.\n");
+            }
+            Timing_End();
+
+            BC_Free(&bytecode);
+            Array_Free(&var_names);
+            break;
+        }
 
         VM_Config vm_conf;
 
-        // Nolla alla variabler.
-        for (int i = 0; i < PLANG_NUM_VARS; i++)
-            vm_conf.vars[i] = 0;
+        // Alla variabler brjar p noll.
+        vm_conf.num_vars  = Array_Length(&var_names);
+        vm_conf.vars      = calloc(vm_conf.num_vars, sizeof(int));
+        vm_conf.vars64    = NULL;
+        vm_conf.big_vars  = NULL;
+        vm_conf.var_names = var_names.elems;
+
+        if (int64)
+            vm_conf.vars64 = calloc(vm_conf.num_vars, sizeof(long long));
+
+        if (bignum) {
+            vm_conf.big_vars = malloc(vm_conf.num_vars * sizeof(Big_Num));
+            for (int i = 0; i < vm_conf.num_vars; i++)
+                Big_Init(&vm_conf.big_vars[i]);
+        }
 
         // Lt anvndaren skriva in input-vrdena.
         int num_inputs = Array_Length(&syntax_tree.values);
         for (int i = 0; i < num_inputs; i++) {
             int var = *(int*)Array_GetElemPtr(&syntax_tree.values, i);
 
-            printf("X%d = ", var);
-            vm_conf.vars[var] = IO_GetIntFromUser();
+            printf("X%d = ", vm_conf.var_names[var]);
+
+            if (bignum) {
+                char* s = IO_GetNatFromUser();
+                Big_FromStr(&vm_conf.big_vars[var], s);
+                Str_Free(s);
+            }
+            else if (int64) {
+                vm_conf.vars64[var] = IO_GetLongFromUser();
+            }
+            else {
+                vm_conf.vars[var] = IO_GetIntFromUser();
+            }
         }
 
         printf("\nRunning program, please wait...\n");
 
         vm_conf.enable_debug = debug;
+        vm_conf.max_steps    = max_steps;
+        vm_conf.timeout_ms   = timeout_ms;
+        vm_conf.detect_loops = detect;
+        vm_conf.single_step  = single_step;
+        vm_conf.progress     = NULL;
+
+        Big_Num big_result;
+        Big_Init(&big_result);
+
+        if (profile)
+            Prof_Start(&syntax_tree);
+
+        // Trden som tar stickprov startas sist, s att den inte rknar tiden
+        // innan programmet faktiskt krs.
+        Sampler sampler;
+        if (sample && !Sampler_Start(&sampler, &vm_conf)) {
+            printf("ERROR: Could not start the sampling thread.\n");
+            sample = FALSE;
+        }
 
-        clock_t start   = clock();
-        int     result  = VM_ExecAST(&syntax_tree, &vm_conf);
-        clock_t finish  = clock();
-        int     time_ms = (1000 * (finish - start)) / CLOCKS_PER_SEC;
+        // Satserna rknas i en extra krning eftert, s input-vrdena mste
+        // sparas innan programmet ndrar dem.
+        void* inputs = NULL;
+        if (count_stmts) {
+            size_t size = vm_conf.num_vars * (int64 ? sizeof(long long)
+                                                    : sizeof(int));
+
+            inputs = malloc(size + 1);
+            memcpy(inputs, int64 ? (void*)vm_conf.vars64 : vm_conf.vars, size);
+        }
+
+        Perf_Stats perf;
+        if (stats)
+            Perf_Start(&perf);
+
+        Timing_Begin("Execute", TRUE);
+        clock_t   start   = clock();
+        long long result  = jit      ? Jit_Exec(&machine_code, &vm_conf)
+                          : run_ast  ? VM_ExecAST(&syntax_tree, &vm_conf)
+                          : bignum   ? VM_ExecBignum(&bytecode, &vm_conf,
+                                                     &big_result)
+                          : int64    ? VM_ExecBytecode64(&bytecode, &vm_conf)
+                          : saturate ? VM_ExecSaturating(&bytecode, &vm_conf)
+                                     : VM_ExecBytecode(&bytecode, &vm_conf);
+        clock_t   finish  = clock();
+        int       time_ms = (1000 * (finish - start)) / CLOCKS_PER_SEC;
+        Timing_End();
+
+        if (stats)
+            Perf_Stop(&perf);
+
+        if (sample)
+            Sampler_Stop(&sampler);
+
+        if (jit)
+            Jit_Free(&machine_code);
+        else if (!run_ast)
+            BC_Free(&bytecode);
 
         if (result == VM_ERR_INF_LOOP) {
-            printf("\nERROR: Program got stuck in an infinite loop.\n");
+            printf("\nERROR: Program got stuck in an infinite loop, in WHILE "
+                   "X%d != 0 (line %d).\n",
+                   vm_conf.var_names[vm_conf.limit_var],
+                   vm_conf.limit_loop->row);
             VM_StateDump(&syntax_tree, 0, &vm_conf);
             printf("\nVM state dump!\n");
         }
@@ -408,14 +1420,116 @@ int main(int argc, char* argv[]) {
             VM_StateDump(&syntax_tree, 0, &vm_conf);
             printf("\nVM state dump!\n");
         }
+        else if (result == VM_ERR_LIMIT) {
+            printf("\nERROR: Stopped after %lld loop iterations, in WHILE "
+                   "X%d != 0 (line %d).\n", vm_conf.num_steps,
+                   vm_conf.var_names[vm_conf.limit_var],
+                   vm_conf.limit_loop->row);
+            VM_StateDump(&syntax_tree, 0, &vm_conf);
+            printf("\nVM state dump!\n");
+        }
         else {
             if (!debug)
                 printf("Done! Execution time: %d ms\n", time_ms);
             else
                 printf("Done!\n");
-            printf("\nResult: %d\n\n", result);
+
+            if (bignum) {
+                char* s = Big_ToStr(&big_result);
+                printf("\nResult: %s\n\n", s);
+                free(s);
+            }
+            else {
+                printf("\nResult: %lld\n\n", result);
+            }
+        }
+
+        // Profilen skrivs ut ven om programmet avbrts, ex. av -timeout, s
+        // att man kan se var tiden gick t.
+        if (profile) {
+            char* folded_file = ChangeFileExt(file_name, "folded");
+
+            printf("\n");
+            if (Prof_Report(&syntax_tree, source_code, folded_file))
+                printf("\nFolded stacks written to %s.\n", folded_file);
+            else
+                printf("\nERROR: Could not write %s.\n", folded_file);
+
+            free(folded_file);
+        }
+
+        if (sample) {
+            printf("\n");
+            Sampler_Report(&sampler);
+            Sampler_Free(&sampler);
+        }
+
+        if (stats) {
+            // Rkningen fr ta hgst tio gnger s lng tid som krningen, s
+            // att den inte hnger nr optimeringarna sparade mycket tid.
+            long long num_stmts = -1;
+            if (result >= 0 && run_ast) {
+                num_stmts = vm_conf.num_stmts;
+            }
+            else if (result >= 0 && count_stmts) {
+                Timing_Begin("Count statements", TRUE);
+                num_stmts = CountStatements(&count_code, &vm_conf, inputs,
+                                            10.0 * perf.wall_ms + 1000.0);
+                Timing_End();
+            }
+
+            printf("\n");
+            Perf_Report(&perf, num_stmts);
+
+            if (num_stmts == VM_ERR_LIMIT) {
+                printf("\n  Statements were not counted, since the program "
+                       "is too slow to run as written.\n");
+            }
+
+            if (count_stmts)
+                BC_Free(&count_code);
+            free(inputs);
+        }
+
+        if (bignum) {
+            for (int i = 0; i < vm_conf.num_vars; i++)
+                Big_Free(&vm_conf.big_vars[i]);
+            free(vm_conf.big_vars);
         }
 
+        Big_Free(&big_result);
+        free(vm_conf.vars64);
+        free(vm_conf.vars);
+        Array_Free(&var_names);
+        break;
+    }
+
+    /*----------------------------------------------------
+     * 2d. Jmfr varianterna av den virtuella maskinen.
+     *--------------------------------------------------*/
+    case CMD_BENCH_VM: {
+        Bool optimize = !HasOption(argc, argv, "-no-opt");
+        if (!optimize)
+            printf("Loop optimizations disabled.\n");
+
+        // Input-vrdena lses in en gng och anvnds sedan i alla varianter,
+        // s de mste rymmas i en int.
+        int  num_inputs = Array_Length(&syntax_tree.values);
+        int* inputs     = malloc(num_inputs * sizeof(int));
+        for (int i = 0; i < num_inputs; i++) {
+            int var = *(int*)Array_GetElemPtr(&syntax_tree.values, i);
+            printf("X%d = ", var);
+            inputs[i] = IO_GetIntFromUser();
+        }
+
+        printf("\nRunning benchmark, please wait...\n\n");
+        printf("%-10s %10s %14s %14s   %s\n", "Variant", "Runs", "ms/run",
+               "Runs/s", "Result");
+
+        for (int i = 0; i < BENCH_NUM_VARIANTS; i++)
+            Benchmark(source_code, inputs, i, optimize);
+
+        free(inputs);
         break;
     }
 
@@ -424,13 +1538,20 @@ int main(int argc, char* argv[]) {
         break;
     }
 
-    // TODO: Rensa upp allt minne hr.
+    if (timings) {
+        printf("\n");
+        Timing_Report();
+    }
 
-    Array_Free(&tokens);
-    free(source_code);
-    free(file_name);
+    // Sammanfattningar, brytpunkter och profileringsrknare ligger inte i
+    // arenan, s trdet mste gs igenom innan arenan slpps.
+    AST_FreeNode(&syntax_tree);
+    Arena_Free(&arena);
+
+    IO_UnmapFile(&source_file);
+    Str_Free(file_name);
 
     if (pause_on_exit)
         IO_Pause();
-    return 0;
+    return exit_code;
 }
@@ -0,0 +1,687 @@
+/*------------------------------------------------------------------------------
+ * File: poly.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Polynom i flera variabler med exakta, rationella koefficienter. Anvnds
+ *   fr att rkna ut slutna uttryck fr loopar, se summary.h.
+ *
+ * Changes:
+ *   * Poly_Eval64() fr 64-bitars variabler.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "common.h"
+#include "debug.h"
+#include "poly.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h> // qsort()
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: AddChecked()
+ * Parameters:
+ *   a       Den frsta termen.
+ *   b       Den andra termen.
+ *   result  Pekare till den long long som summan ska lagras i.
+ *
+ * Description:
+ *   Berknar a+b. Returnerar falskt om summan inte fr plats i en long long.
+ *------------------------------------*/
+static Bool AddChecked(long long a, long long b, long long* result) {
+    if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b))
+        return FALSE;
+
+    *result = a + b;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: MulChecked()
+ * Parameters:
+ *   a       Den frsta faktorn.
+ *   b       Den andra faktorn.
+ *   result  Pekare till den long long som produkten ska lagras i.
+ *
+ * Description:
+ *   Berknar a*b. Returnerar falskt om produkten inte fr plats i en long
+ *   long.
+ *------------------------------------*/
+static Bool MulChecked(long long a, long long b, long long* result) {
+    if (a > 0) {
+        if (b > 0) { if (a > LLONG_MAX / b) return FALSE; }
+        else       { if (b < LLONG_MIN / a) return FALSE; }
+    }
+    else if (a < 0) {
+        if (b > 0) { if (a < LLONG_MIN / b) return FALSE; }
+        else       { if (b < 0 && a < LLONG_MAX / b) return FALSE; }
+    }
+
+    *result = a * b;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: GCD()
+ * Parameters:
+ *   a  Det frsta talet.
+ *   b  Det andra talet.
+ *
+ * Description:
+ *   Returnerar den strsta gemensamma delaren till a och b.
+ *------------------------------------*/
+static long long GCD(long long a, long long b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+
+    while (b != 0) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/*--------------------------------------
+ * Function: CompareTerms()
+ * Parameters:
+ *   a  Pekare till den frsta termen.
+ *   b  Pekare till den andra termen.
+ *
+ * Description:
+ *   Jmfrelsefunktion fr qsort(). Termer med hgre grad kommer frst, s
+ *   att polynomen skrivs ut i den ordning man frvntar sig.
+ *------------------------------------*/
+static int CompareTerms(const void* a, const void* b) {
+    const Poly_Term* t1 = a;
+    const Poly_Term* t2 = b;
+
+    if (t1->degree != t2->degree)
+        return t2->degree - t1->degree;
+
+    for (int i = 0; i < t1->degree; i++) {
+        if (t1->syms[i] != t2->syms[i])
+            return t1->syms[i] - t2->syms[i];
+    }
+
+    return 0;
+}
+
+/*--------------------------------------
+ * Function: Normalize()
+ * Parameters:
+ *   p  Polynomet som ska normaliseras.
+ *
+ * Description:
+ *   Sorterar termerna, slr ihop lika termer, tar bort termer med
+ *   koefficienten noll och frkortar brket. Returnerar falskt om en
+ *   koefficient blev fr stor.
+ *------------------------------------*/
+static Bool Normalize(Poly* p) {
+    int num_terms = Array_Length(&p->terms);
+    Poly_Term* terms = p->terms.elems;
+
+    qsort(terms, num_terms, sizeof(Poly_Term), CompareTerms);
+
+    // Sl ihop lika termer och ta bort nollor p samma gng.
+    int n = 0;
+    for (int i = 0; i < num_terms; i++) {
+        if (n > 0 && CompareTerms(&terms[n-1], &terms[i]) == 0) {
+            if (!AddChecked(terms[n-1].coeff, terms[i].coeff,
+                            &terms[n-1].coeff))
+            {
+                return FALSE;
+            }
+        }
+        else {
+            if (n > 0 && terms[n-1].coeff == 0)
+                n--;
+            terms[n++] = terms[i];
+        }
+    }
+
+    if (n > 0 && terms[n-1].coeff == 0)
+        n--;
+
+    p->terms.num_elems = n;
+
+    if (n == 0) {
+        p->denom = 1;
+        return TRUE;
+    }
+
+    long long gcd = p->denom;
+    for (int i = 0; i < n && gcd != 1; i++)
+        gcd = GCD(gcd, terms[i].coeff);
+
+    for (int i = 0; i < n; i++)
+        terms[i].coeff /= gcd;
+    p->denom /= gcd;
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: MulTerms()
+ * Parameters:
+ *   t1      Den frsta termen.
+ *   t2      Den andra termen.
+ *   result  Pekare till den term som produkten ska lagras i.
+ *
+ * Description:
+ *   Multiplicerar tv termer. Returnerar falskt om produkten blev fr stor.
+ *------------------------------------*/
+static Bool MulTerms(const Poly_Term* t1, const Poly_Term* t2,
+                     Poly_Term* result)
+{
+    if (t1->degree + t2->degree > POLY_MAX_DEGREE)
+        return FALSE;
+
+    if (!MulChecked(t1->coeff, t2->coeff, &result->coeff))
+        return FALSE;
+
+    // Symbolerna r sorterade i bda termerna, s vi kan sl ihop dem.
+    int i = 0, j = 0, k = 0;
+    while (i < t1->degree || j < t2->degree) {
+        if (j >= t2->degree
+         || (i < t1->degree && t1->syms[i] <= t2->syms[j]))
+        {
+            result->syms[k++] = t1->syms[i++];
+        }
+        else {
+            result->syms[k++] = t2->syms[j++];
+        }
+    }
+
+    result->degree = k;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: PrintSym()
+ * Parameters:
+ *   sym  Symbolen som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut en symbol.
+ *------------------------------------*/
+static void PrintSym(int sym) {
+    if (sym == POLY_SYM_ITER) printf("j");
+    else                      printf("X%d", sym);
+}
+
+/*--------------------------------------
+ * Function: Poly_Add()
+ * Parameters:
+ *   p       Polynomet som ska adderas till.
+ *   q       Polynomet som ska adderas.
+ *   factor  Faktor som q multipliceras med innan additionen.
+ *
+ * Description:
+ *   Berknar p := p + factor*q. Returnerar falskt om en koefficient blev fr
+ *   stor, och p r d odefinierat.
+ *------------------------------------*/
+Bool Poly_Add(Poly* p, const Poly* q, long long factor) {
+    // Vi frlnger bda brken till minsta gemensamma nmnare.
+    long long gcd = GCD(p->denom, q->denom);
+    long long denom, p_scale, q_scale;
+
+    if (!MulChecked(p->denom / gcd, q->denom, &denom))
+        return FALSE;
+
+    p_scale = denom / p->denom;
+    if (!MulChecked(denom / q->denom, factor, &q_scale))
+        return FALSE;
+
+    int num_p_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_p_terms; i++) {
+        Poly_Term* term = Array_GetElemPtr(&p->terms, i);
+        if (!MulChecked(term->coeff, p_scale, &term->coeff))
+            return FALSE;
+    }
+
+    int num_q_terms = Array_Length(&q->terms);
+    for (int i = 0; i < num_q_terms; i++) {
+        Poly_Term term = *(Poly_Term*)Array_GetElemPtr(&q->terms, i);
+        if (!MulChecked(term.coeff, q_scale, &term.coeff))
+            return FALSE;
+        Array_AddElem(&p->terms, &term);
+    }
+
+    p->denom = denom;
+    return Normalize(p);
+}
+
+/*--------------------------------------
+ * Function: Poly_Coeff()
+ * Parameters:
+ *   p       Polynomet vars koefficient ska tas fram.
+ *   sym     Symbolen.
+ *   exp     Exponenten.
+ *   result  Polynomet som koefficienten ska lagras i.
+ *
+ * Description:
+ *   Tar fram koefficienten framfr sym^exp, dvs summan av de termer som
+ *   innehller sym exakt exp gnger, med sym borttagen. result initieras av
+ *   funktionen.
+ *------------------------------------*/
+void Poly_Coeff(const Poly* p, int sym, int exp, Poly* result) {
+    Poly_Init(result, 0);
+    result->denom = p->denom;
+
+    int num_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* term = Array_GetElemPtr(&p->terms, i);
+        Poly_Term  coeff;
+
+        coeff.coeff  = term->coeff;
+        coeff.degree = 0;
+
+        int count = 0;
+        for (int j = 0; j < term->degree; j++) {
+            if (term->syms[j] == sym)
+                count++;
+            else
+                coeff.syms[coeff.degree++] = term->syms[j];
+        }
+
+        if (count == exp)
+            Array_AddElem(&result->terms, &coeff);
+    }
+
+    // Termerna r redan unika eftersom sym frekom lika mnga gnger i alla,
+    // s det hr kan inte misslyckas.
+    Normalize(result);
+}
+
+/*--------------------------------------
+ * Function: Poly_Compose()
+ * Parameters:
+ *   p        Polynomet vars symboler ska bytas ut.
+ *   pos_map  Ersttningar fr symbolerna i termer med positiv koefficient.
+ *   neg_map  Ersttningar fr symbolerna i termer med negativ koefficient.
+ *   result   Polynomet som resultatet ska lagras i.
+ *
+ * Description:
+ *   Byter ut symbolerna i p mot andra polynom. Bda tabellerna ska ha
+ *   POLY_NUM_SYMS element, och NULL betyder att symbolen behlls. Normalt r
+ *   tabellerna samma, men genom att anvnda olika kan man f fram en undre
+ *   grns fr p. result initieras av funktionen. Returnerar falskt om
+ *   resultatet blev fr stort.
+ *------------------------------------*/
+Bool Poly_Compose(const Poly* p, const Poly* const* pos_map,
+                  const Poly* const* neg_map, Poly* result)
+{
+    Poly_Init(result, 0);
+
+    Bool is_ok     = TRUE;
+    int  num_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_terms && is_ok; i++) {
+        Poly_Term*         term = Array_GetElemPtr(&p->terms, i);
+        const Poly* const* map  = (term->coeff > 0) ? pos_map : neg_map;
+
+        Poly prod;
+        Poly_Init(&prod, term->coeff);
+
+        for (int j = 0; j < term->degree && is_ok; j++) {
+            Poly sym_poly;
+            if (map[term->syms[j]] == NULL)
+                Poly_InitSym(&sym_poly, term->syms[j]);
+            else
+                Poly_Copy(&sym_poly, map[term->syms[j]]);
+
+            Poly tmp;
+            is_ok = Poly_Mul(&prod, &sym_poly, &tmp);
+
+            Poly_Free(&sym_poly);
+            Poly_Free(&prod);
+            prod = tmp;
+        }
+
+        if (is_ok)
+            is_ok = Poly_Add(result, &prod, 1);
+
+        Poly_Free(&prod);
+    }
+
+    if (is_ok)
+        is_ok = MulChecked(result->denom, p->denom, &result->denom);
+    if (is_ok)
+        is_ok = Normalize(result);
+
+    if (!is_ok) {
+        Poly_Free(result);
+        Poly_Init(result, 0);
+    }
+
+    return is_ok;
+}
+
+/*--------------------------------------
+ * Function: Poly_Copy()
+ * Parameters:
+ *   dst  Polynomet som ska initieras som en kopia.
+ *   src  Polynomet som ska kopieras.
+ *
+ * Description:
+ *   Initierar dst som en kopia av src.
+ *------------------------------------*/
+void Poly_Copy(Poly* dst, const Poly* src) {
+    Poly_Init(dst, 0);
+
+    int num_terms = Array_Length(&src->terms);
+    for (int i = 0; i < num_terms; i++)
+        Array_AddElem(&dst->terms, Array_GetElemPtr(&src->terms, i));
+
+    dst->denom = src->denom;
+}
+
+/*--------------------------------------
+ * Function: Poly_Degree()
+ * Parameters:
+ *   p    Polynomet som ska underskas.
+ *   sym  Symbolen.
+ *
+ * Description:
+ *   Returnerar den hgsta potens som symbolen frekommer med i polynomet.
+ *------------------------------------*/
+int Poly_Degree(const Poly* p, int sym) {
+    int max_count = 0;
+
+    int num_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* term = Array_GetElemPtr(&p->terms, i);
+
+        int count = 0;
+        for (int j = 0; j < term->degree; j++) {
+            if (term->syms[j] == sym)
+                count++;
+        }
+
+        if (count > max_count)
+            max_count = count;
+    }
+
+    return max_count;
+}
+
+/*--------------------------------------
+ * Function: Poly_Equals()
+ * Parameters:
+ *   p  Det frsta polynomet.
+ *   q  Det andra polynomet.
+ *
+ * Description:
+ *   Returnerar sant om polynomen r lika.
+ *------------------------------------*/
+Bool Poly_Equals(const Poly* p, const Poly* q) {
+    int num_terms = Array_Length(&p->terms);
+
+    if (p->denom != q->denom || num_terms != Array_Length(&q->terms))
+        return FALSE;
+
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* t1 = Array_GetElemPtr(&p->terms, i);
+        Poly_Term* t2 = Array_GetElemPtr(&q->terms, i);
+
+        if (t1->coeff != t2->coeff || CompareTerms(t1, t2) != 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Poly_Eval()
+ * Parameters:
+ *   p       Polynomet som ska berknas.
+ *   vars    Variabelvrdena som symbolerna ska ersttas med.
+ *   result  Pekare till den long long som vrdet ska lagras i.
+ *
+ * Description:
+ *   Berknar polynomets vrde, avrundat nedt. Returnerar falskt om
+ *   berkningen inte fr plats i en long long.
+ *------------------------------------*/
+Bool Poly_Eval(const Poly* p, const int* vars, long long* result) {
+    long long sum = 0;
+
+    int num_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* term = Array_GetElemPtr(&p->terms, i);
+        long long  val  = term->coeff;
+
+        for (int j = 0; j < term->degree; j++) {
+            ASSERT(term->syms[j] < PLANG_NUM_VARS);
+            if (!MulChecked(val, vars[term->syms[j]], &val))
+                return FALSE;
+        }
+
+        if (!AddChecked(sum, val, &sum))
+            return FALSE;
+    }
+
+    // Division i C avrundar mot noll, s negativa tal fr specialbehandling.
+    if (sum >= 0) *result = sum / p->denom;
+    else          *result = -((-sum + p->denom - 1) / p->denom);
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Poly_Eval64()
+ * Parameters:
+ *   p       Polynomet som ska berknas.
+ *   vars    Variabelvrdena som symbolerna ska ersttas med.
+ *   result  Pekare till den long long som vrdet ska lagras i.
+ *
+ * Description:
+ *   Som Poly_Eval(), men med 64-bitars variabelvrden.
+ *------------------------------------*/
+Bool Poly_Eval64(const Poly* p, const long long* vars, long long* result) {
+    long long sum = 0;
+
+    int num_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* term = Array_GetElemPtr(&p->terms, i);
+        long long  val  = term->coeff;
+
+        for (int j = 0; j < term->degree; j++) {
+            ASSERT(term->syms[j] < PLANG_NUM_VARS);
+            if (!MulChecked(val, vars[term->syms[j]], &val))
+                return FALSE;
+        }
+
+        if (!AddChecked(sum, val, &sum))
+            return FALSE;
+    }
+
+    if (sum >= 0) *result = sum / p->denom;
+    else          *result = -((-sum + p->denom - 1) / p->denom);
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Poly_Free()
+ * Parameters:
+ *   p  Polynomet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper ett polynom ur minnet.
+ *------------------------------------*/
+void Poly_Free(Poly* p) {
+    Array_Free(&p->terms);
+}
+
+/*--------------------------------------
+ * Function: Poly_GetConst()
+ * Parameters:
+ *   p      Polynomet som ska underskas.
+ *   value  Pekare till den long long som vrdet ska lagras i.
+ *
+ * Description:
+ *   Returnerar sant om polynomet r ett heltal, som d lagras i value.
+ *------------------------------------*/
+Bool Poly_GetConst(const Poly* p, long long* value) {
+    int num_terms = Array_Length(&p->terms);
+
+    if (num_terms == 0) {
+        *value = 0;
+        return TRUE;
+    }
+
+    Poly_Term* term = Array_GetElemPtr(&p->terms, 0);
+    if (num_terms != 1 || term->degree != 0 || p->denom != 1)
+        return FALSE;
+
+    *value = term->coeff;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Poly_Init()
+ * Parameters:
+ *   p      Polynomet som ska initieras.
+ *   value  Konstanten som polynomet ska ha som vrde.
+ *
+ * Description:
+ *   Initierar ett konstant polynom.
+ *------------------------------------*/
+void Poly_Init(Poly* p, long long value) {
+    Array_Init(&p->terms, sizeof(Poly_Term));
+    p->denom = 1;
+
+    if (value != 0) {
+        Poly_Term term = { .coeff = value, .degree = 0 };
+        Array_AddElem(&p->terms, &term);
+    }
+}
+
+/*--------------------------------------
+ * Function: Poly_InitSym()
+ * Parameters:
+ *   p    Polynomet som ska initieras.
+ *   sym  Symbolen.
+ *
+ * Description:
+ *   Initierar ett polynom som bara bestr av den angivna symbolen.
+ *------------------------------------*/
+void Poly_InitSym(Poly* p, int sym) {
+    ASSERT(0 <= sym && sym < POLY_NUM_SYMS);
+
+    Poly_Init(p, 0);
+
+    Poly_Term term = { .coeff = 1, .degree = 1, .syms = { sym } };
+    Array_AddElem(&p->terms, &term);
+}
+
+/*--------------------------------------
+ * Function: Poly_Mul()
+ * Parameters:
+ *   p       Det frsta polynomet.
+ *   q       Det andra polynomet.
+ *   result  Polynomet som produkten ska lagras i.
+ *
+ * Description:
+ *   Berknar p*q. result initieras av funktionen. Returnerar falskt om
+ *   produkten blev fr stor.
+ *------------------------------------*/
+Bool Poly_Mul(const Poly* p, const Poly* q, Poly* result) {
+    Poly_Init(result, 0);
+
+    Bool is_ok = MulChecked(p->denom, q->denom, &result->denom);
+
+    int num_p_terms = Array_Length(&p->terms);
+    int num_q_terms = Array_Length(&q->terms);
+    for (int i = 0; i < num_p_terms && is_ok; i++) {
+        for (int j = 0; j < num_q_terms && is_ok; j++) {
+            Poly_Term term;
+            is_ok = MulTerms(Array_GetElemPtr(&p->terms, i),
+                             Array_GetElemPtr(&q->terms, j), &term);
+            if (is_ok)
+                Array_AddElem(&result->terms, &term);
+        }
+    }
+
+    if (is_ok)
+        is_ok = Normalize(result);
+
+    if (!is_ok) {
+        Poly_Free(result);
+        Poly_Init(result, 0);
+    }
+
+    return is_ok;
+}
+
+/*--------------------------------------
+ * Function: Poly_Print()
+ * Parameters:
+ *   p  Polynomet som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut polynomet, ex. "(X1^2 + X1)/2".
+ *------------------------------------*/
+void Poly_Print(const Poly* p) {
+    int num_terms = Array_Length(&p->terms);
+
+    if (num_terms == 0) {
+        printf("0");
+        return;
+    }
+
+    if (p->denom != 1 && num_terms > 1)
+        printf("(");
+
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* term  = Array_GetElemPtr(&p->terms, i);
+        long long  coeff = term->coeff;
+
+        if (coeff < 0) {
+            printf((i == 0) ? "-" : " - ");
+            coeff = -coeff;
+        }
+        else if (i > 0) {
+            printf(" + ");
+        }
+
+        if (coeff != 1 || term->degree == 0) {
+            printf("%lld", coeff);
+            if (term->degree > 0)
+                printf("*");
+        }
+
+        // Upprepade symboler skrivs ut som potenser.
+        for (int j = 0; j < term->degree; ) {
+            int exp = 1;
+            while (j+exp < term->degree && term->syms[j+exp] == term->syms[j])
+                exp++;
+
+            if (j > 0)
+                printf("*");
+            PrintSym(term->syms[j]);
+            if (exp > 1)
+                printf("^%d", exp);
+
+            j += exp;
+        }
+    }
+
+    if (p->denom != 1 && num_terms > 1)
+        printf(")");
+    if (p->denom != 1)
+        printf("/%lld", p->denom);
+}
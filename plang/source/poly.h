@@ -0,0 +1,260 @@
+/*------------------------------------------------------------------------------
+ * File: poly.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Polynom i flera variabler med exakta, rationella koefficienter. Anvnds
+ *   fr att rkna ut slutna uttryck fr loopar, se summary.h.
+ *
+ * Changes:
+ *   * Poly_Eval64() fr 64-bitars variabler.
+ *----------------------------------------------------------------------------*/
+
+#ifndef POLY_H_
+#define POLY_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "common.h"
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: POLY_MAX_DEGREE
+ *
+ * Description:
+ *   Den hgsta grad en term fr ha. Operationer som skulle ge en hgre grad
+ *   misslyckas istllet.
+ *------------------------------------*/
+#define POLY_MAX_DEGREE 8
+
+/*--------------------------------------
+ * Constant: POLY_NUM_SYMS
+ *
+ * Description:
+ *   Antalet symboler som kan frekomma i ett polynom. Symbolerna 0 till och
+ *   med PLANG_NUM_VARS-1 r variabler, POLY_SYM_ITER r loop-rknaren.
+ *------------------------------------*/
+#define POLY_NUM_SYMS (PLANG_NUM_VARS+1)
+
+/*--------------------------------------
+ * Constant: POLY_SYM_ITER
+ *
+ * Description:
+ *   Symbol fr loop-variabelns vrde under en viss iteration.
+ *------------------------------------*/
+#define POLY_SYM_ITER PLANG_NUM_VARS
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Poly_Term
+ *
+ * Description:
+ *   En term i ett polynom, dvs en koefficient multiplicerad med en eller flera
+ *   symboler. Symbolerna r sorterade i stigande ordning och upprepas fr
+ *   hgre potenser, s x1^2*x3 lagras som { 1, 1, 3 }.
+ *------------------------------------*/
+typedef struct {
+    long long coeff;
+    int       degree;
+    int       syms[POLY_MAX_DEGREE];
+} Poly_Term;
+
+/*--------------------------------------
+ * Type: Poly
+ *
+ * Description:
+ *   Ett polynom p formen (term1 + term2 + ...) / denom. Termerna r
+ *   sorterade och frkortade, s tv lika polynom lagras alltid likadant.
+ *------------------------------------*/
+typedef struct {
+    Array     terms;
+    long long denom;
+} Poly;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Poly_Add()
+ * Parameters:
+ *   p       Polynomet som ska adderas till.
+ *   q       Polynomet som ska adderas.
+ *   factor  Faktor som q multipliceras med innan additionen.
+ *
+ * Description:
+ *   Berknar p := p + factor*q. Returnerar falskt om en koefficient blev fr
+ *   stor, och p r d odefinierat.
+ *------------------------------------*/
+Bool Poly_Add(Poly* p, const Poly* q, long long factor);
+
+/*--------------------------------------
+ * Function: Poly_Coeff()
+ * Parameters:
+ *   p       Polynomet vars koefficient ska tas fram.
+ *   sym     Symbolen.
+ *   exp     Exponenten.
+ *   result  Polynomet som koefficienten ska lagras i.
+ *
+ * Description:
+ *   Tar fram koefficienten framfr sym^exp, dvs summan av de termer som
+ *   innehller sym exakt exp gnger, med sym borttagen. result initieras av
+ *   funktionen.
+ *------------------------------------*/
+void Poly_Coeff(const Poly* p, int sym, int exp, Poly* result);
+
+/*--------------------------------------
+ * Function: Poly_Compose()
+ * Parameters:
+ *   p        Polynomet vars symboler ska bytas ut.
+ *   pos_map  Ersttningar fr symbolerna i termer med positiv koefficient.
+ *   neg_map  Ersttningar fr symbolerna i termer med negativ koefficient.
+ *   result   Polynomet som resultatet ska lagras i.
+ *
+ * Description:
+ *   Byter ut symbolerna i p mot andra polynom. Bda tabellerna ska ha
+ *   POLY_NUM_SYMS element, och NULL betyder att symbolen behlls. Normalt r
+ *   tabellerna samma, men genom att anvnda olika kan man f fram en undre
+ *   grns fr p. result initieras av funktionen. Returnerar falskt om
+ *   resultatet blev fr stort.
+ *------------------------------------*/
+Bool Poly_Compose(const Poly* p, const Poly* const* pos_map,
+                  const Poly* const* neg_map, Poly* result);
+
+/*--------------------------------------
+ * Function: Poly_Copy()
+ * Parameters:
+ *   dst  Polynomet som ska initieras som en kopia.
+ *   src  Polynomet som ska kopieras.
+ *
+ * Description:
+ *   Initierar dst som en kopia av src.
+ *------------------------------------*/
+void Poly_Copy(Poly* dst, const Poly* src);
+
+/*--------------------------------------
+ * Function: Poly_Degree()
+ * Parameters:
+ *   p    Polynomet som ska underskas.
+ *   sym  Symbolen.
+ *
+ * Description:
+ *   Returnerar den hgsta potens som symbolen frekommer med i polynomet.
+ *------------------------------------*/
+int Poly_Degree(const Poly* p, int sym);
+
+/*--------------------------------------
+ * Function: Poly_Equals()
+ * Parameters:
+ *   p  Det frsta polynomet.
+ *   q  Det andra polynomet.
+ *
+ * Description:
+ *   Returnerar sant om polynomen r lika.
+ *------------------------------------*/
+Bool Poly_Equals(const Poly* p, const Poly* q);
+
+/*--------------------------------------
+ * Function: Poly_Eval()
+ * Parameters:
+ *   p       Polynomet som ska berknas.
+ *   vars    Variabelvrdena som symbolerna ska ersttas med.
+ *   result  Pekare till den long long som vrdet ska lagras i.
+ *
+ * Description:
+ *   Berknar polynomets vrde, avrundat nedt. Returnerar falskt om
+ *   berkningen inte fr plats i en long long.
+ *------------------------------------*/
+Bool Poly_Eval(const Poly* p, const int* vars, long long* result);
+
+/*--------------------------------------
+ * Function: Poly_Eval64()
+ * Parameters:
+ *   p       Polynomet som ska berknas.
+ *   vars    Variabelvrdena som symbolerna ska ersttas med.
+ *   result  Pekare till den long long som vrdet ska lagras i.
+ *
+ * Description:
+ *   Som Poly_Eval(), men med 64-bitars variabelvrden.
+ *------------------------------------*/
+Bool Poly_Eval64(const Poly* p, const long long* vars, long long* result);
+
+/*--------------------------------------
+ * Function: Poly_Free()
+ * Parameters:
+ *   p  Polynomet som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper ett polynom ur minnet.
+ *------------------------------------*/
+void Poly_Free(Poly* p);
+
+/*--------------------------------------
+ * Function: Poly_GetConst()
+ * Parameters:
+ *   p      Polynomet som ska underskas.
+ *   value  Pekare till den long long som vrdet ska lagras i.
+ *
+ * Description:
+ *   Returnerar sant om polynomet r ett heltal, som d lagras i value.
+ *------------------------------------*/
+Bool Poly_GetConst(const Poly* p, long long* value);
+
+/*--------------------------------------
+ * Function: Poly_Init()
+ * Parameters:
+ *   p      Polynomet som ska initieras.
+ *   value  Konstanten som polynomet ska ha som vrde.
+ *
+ * Description:
+ *   Initierar ett konstant polynom.
+ *------------------------------------*/
+void Poly_Init(Poly* p, long long value);
+
+/*--------------------------------------
+ * Function: Poly_InitSym()
+ * Parameters:
+ *   p    Polynomet som ska initieras.
+ *   sym  Symbolen.
+ *
+ * Description:
+ *   Initierar ett polynom som bara bestr av den angivna symbolen.
+ *------------------------------------*/
+void Poly_InitSym(Poly* p, int sym);
+
+/*--------------------------------------
+ * Function: Poly_Mul()
+ * Parameters:
+ *   p       Det frsta polynomet.
+ *   q       Det andra polynomet.
+ *   result  Polynomet som produkten ska lagras i.
+ *
+ * Description:
+ *   Berknar p*q. result initieras av funktionen. Returnerar falskt om
+ *   produkten blev fr stor.
+ *------------------------------------*/
+Bool Poly_Mul(const Poly* p, const Poly* q, Poly* result);
+
+/*--------------------------------------
+ * Function: Poly_Print()
+ * Parameters:
+ *   p  Polynomet som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut polynomet, ex. "(X1^2 + X1)/2".
+ *------------------------------------*/
+void Poly_Print(const Poly* p);
+
+#endif // POLY_H_
@@ -0,0 +1,304 @@
+/*------------------------------------------------------------------------------
+ * File: profile.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Profilering av program som krs med VM_ExecAST(), se profile.h.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "debug.h"
+#include "profile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: MAX_LINE_LEN
+ *
+ * Description:
+ *   Det strsta antal tecken frn en rad i kllkoden som skrivs ut.
+ *------------------------------------*/
+#define MAX_LINE_LEN 60
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Line_Stat
+ *
+ * Description:
+ *   Rknarna fr alla satser p en rad i kllkoden.
+ *------------------------------------*/
+typedef struct {
+    int       row;
+    long long count;
+    double    self_ms;
+} Line_Stat;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: CompareLines()
+ * Parameters:
+ *   a  Pekare till en Line_Stat.
+ *   b  Pekare till en Line_Stat.
+ *
+ * Description:
+ *   Jmfrelsefunktion fr qsort() som sorterar raderna med mest tid frst,
+ *   och annars i den ordning de str i kllkoden.
+ *------------------------------------*/
+static int CompareLines(const void* a, const void* b) {
+    const Line_Stat* l1 = a;
+    const Line_Stat* l2 = b;
+
+    if (l1->self_ms != l2->self_ms)
+        return (l1->self_ms > l2->self_ms) ? -1 : 1;
+
+    return l1->row - l2->row;
+}
+
+/*--------------------------------------
+ * Function: GetLine()
+ * Parameters:
+ *   source  Programmets kllkod.
+ *   row     Radens nummer, med brjan p ett.
+ *   buf     Bufferten som raden ska kopieras till. Den mste rymma
+ *           MAX_LINE_LEN+1 tecken.
+ *
+ * Description:
+ *   Kopierar raden till buf, utan indentering och radbrytning.
+ *------------------------------------*/
+static void GetLine(const char* source, int row, char* buf) {
+    for (int i = 1; i < row && *source != '\0'; source++) {
+        if (*source == '\n')
+            i++;
+    }
+
+    while (*source == ' ' || *source == '\t')
+        source++;
+
+    int len = 0;
+    while (len < MAX_LINE_LEN && source[len] != '\0' && source[len] != '\r'
+        && source[len] != '\n')
+    {
+        // Semikolon skiljer ramarna t i flamegraph-formatet.
+        buf[len] = (source[len] == ';') ? ',' : source[len];
+        len++;
+    }
+
+    buf[len] = '\0';
+}
+
+/*--------------------------------------
+ * Function: SelfMs()
+ * Parameters:
+ *   node  Noden vars tid ska rknas ut.
+ *
+ * Description:
+ *   Returnerar tiden fr noden, utan tiden fr dess barn.
+ *------------------------------------*/
+static double SelfMs(const AST_Node* node) {
+    double self_ms = node->profile->total_ms;
+
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        self_ms -= child->profile->total_ms;
+    }
+
+    // Mtningarna r inte exakta, s barnen kan ha ftt ngot mer tid n
+    // frldern.
+    return (self_ms > 0.0) ? self_ms : 0.0;
+}
+
+/*--------------------------------------
+ * Function: CollectLines()
+ * Parameters:
+ *   node   Noden vars rknare ska lggas till.
+ *   lines  Arrayen med en Line_Stat fr varje rad.
+ *
+ * Description:
+ *   Lgger till rknarna fr noden och alla dess barn till raderna de str
+ *   p.
+ *------------------------------------*/
+static void CollectLines(const AST_Node* node, Array* lines) {
+    if (node->type != AST_PROGRAM) {
+        // Noderna besks i samma ordning som de str i kllkoden, s satser
+        // p samma rad kommer direkt efter varandra.
+        int        num_lines = Array_Length(lines);
+        Line_Stat* line      = NULL;
+
+        if (num_lines > 0) {
+            line = Array_GetElemPtr(lines, num_lines-1);
+            if (line->row != node->row)
+                line = NULL;
+        }
+
+        if (line == NULL) {
+            Line_Stat new_line = { node->row, 0, 0.0 };
+            line = Array_AddElem(lines, &new_line);
+        }
+
+        if (node->profile->count > line->count)
+            line->count = node->profile->count;
+        line->self_ms += SelfMs(node);
+    }
+
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        CollectLines(child, lines);
+    }
+}
+
+/*--------------------------------------
+ * Function: WriteFolded()
+ * Parameters:
+ *   fp      Filen som ska skrivas till.
+ *   node    Noden vars tid ska skrivas.
+ *   source  Programmets kllkod.
+ *   stack   Noderna frn roten ned till nodens frlder.
+ *
+ * Description:
+ *   Skriver en rad fr noden och en fr vart och ett av dess barn, med
+ *   kedjan av nstlade noder fljd av tiden i mikrosekunder.
+ *------------------------------------*/
+static void WriteFolded(FILE* fp, const AST_Node* node, const char* source,
+                        Array* stack)
+{
+    Array_AddElem(stack, &node);
+
+    long long self_us = llround(1000.0 * SelfMs(node));
+    if (self_us > 0) {
+        int depth = Array_Length(stack);
+        for (int i = 0; i < depth; i++) {
+            const AST_Node* frame = *(AST_Node**)Array_GetElemPtr(stack, i);
+
+            if (i > 0)
+                fprintf(fp, ";");
+
+            if (frame->type == AST_PROGRAM) {
+                fprintf(fp, "PROGRAM");
+            }
+            else {
+                char line[MAX_LINE_LEN+1];
+                GetLine(source, frame->row, line);
+                fprintf(fp, "%s (line %d)", line, frame->row);
+            }
+        }
+
+        fprintf(fp, " %lld\n", self_us);
+    }
+
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+        WriteFolded(fp, child, source, stack);
+    }
+
+    Array_RemoveElem(stack, Array_Length(stack)-1);
+}
+
+/*--------------------------------------
+ * Function: Prof_Report()
+ * Parameters:
+ *   root         Root-noden i det AST som har profilerats.
+ *   source       Programmets kllkod.
+ *   folded_file  Filen som loop-nstlingen ska skrivas till, eller NULL.
+ *
+ * Description:
+ *   Skriver ut raderna i kllkoden sorterade efter hur mycket tid som gtt
+ *   t p dem, utan tiden fr nstlade satser. Om folded_file anges skrivs
+ *   ven tiden fr varje kedja av nstlade loopar till filen, i det format
+ *   som flamegraph-verktyg lser ("PROGRAM;WHILE...;<sats> <mikrosekunder>").
+ *   Returnerar falskt om filen inte kunde skrivas.
+ *------------------------------------*/
+Bool Prof_Report(const AST_Node* root, const char* source,
+                 const char* folded_file)
+{
+    ASSERT(root->type == AST_PROGRAM && root->profile != NULL);
+
+    Array lines; Array_Init(&lines, sizeof(Line_Stat));
+    CollectLines(root, &lines);
+
+    int num_lines = Array_Length(&lines);
+    qsort(lines.elems, num_lines, sizeof(Line_Stat), CompareLines);
+
+    double total_ms = root->profile->total_ms;
+
+    printf("Profile (%.3f ms in total):\n\n", total_ms);
+    printf("%6s %14s %12s %7s   %s\n", "Line", "Count", "Self ms", "Self %",
+           "Source");
+
+    for (int i = 0; i < num_lines; i++) {
+        Line_Stat* line = Array_GetElemPtr(&lines, i);
+
+        char text[MAX_LINE_LEN+1];
+        GetLine(source, line->row, text);
+
+        double percent = (total_ms > 0.0) ? 100.0 * line->self_ms / total_ms
+                                          : 0.0;
+        printf("%6d %14lld %12.3f %6.1f%%   %s\n", line->row, line->count,
+               line->self_ms, percent, text);
+    }
+
+    Array_Free(&lines);
+
+    if (folded_file == NULL)
+        return TRUE;
+
+    FILE* fp = fopen(folded_file, "w");
+    if (!fp)
+        return FALSE;
+
+    Array stack; Array_Init(&stack, sizeof(AST_Node*));
+    WriteFolded(fp, root, source, &stack);
+    Array_Free(&stack);
+
+    fclose(fp);
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Prof_Start()
+ * Parameters:
+ *   root  Root-noden i det AST som ska profileras.
+ *
+ * Description:
+ *   Ger alla noder i trdet nollstllda rknare, som VM_ExecAST() sedan
+ *   rknar upp. Rknarna slpps av AST_FreeNode().
+ *------------------------------------*/
+void Prof_Start(AST_Node* root) {
+    if (root->profile == NULL)
+        root->profile = malloc(sizeof(Prof_Node));
+
+    root->profile->count    = 0;
+    root->profile->total_ms = 0.0;
+
+    int num_children = Array_Length(&root->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&root->children, i);
+        Prof_Start(child);
+    }
+}
@@ -0,0 +1,79 @@
+/*------------------------------------------------------------------------------
+ * File: profile.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Profilering av program som krs med VM_ExecAST(). Varje nod i syntax-
+ *   trdet fr en rknare fr hur mnga gnger den krts och hur lng tid
+ *   det tagit, och efter krningen skrivs en lista ver de rader i kllkoden
+ *   dr mest tid gtt t. Noder utan rknare kostar ingenting extra.
+ *
+ *   Sjlva tidtagningen tar ocks tid, och den hamnar hos frldern. Loopar
+ *   med mnga korta satser ser drfr ngot dyrare ut n de r.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "ast.h"
+#include "common.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Prof_Node
+ *
+ * Description:
+ *   Rknare fr en nod. total_ms r den sammanlagda tiden fr alla krningar
+ *   av noden, inklusive dess barn.
+ *------------------------------------*/
+typedef struct Prof_Node {
+    long long count;
+    double    total_ms;
+} Prof_Node;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Prof_Report()
+ * Parameters:
+ *   root         Root-noden i det AST som har profilerats.
+ *   source       Programmets kllkod.
+ *   folded_file  Filen som loop-nstlingen ska skrivas till, eller NULL.
+ *
+ * Description:
+ *   Skriver ut raderna i kllkoden sorterade efter hur mycket tid som gtt
+ *   t p dem, utan tiden fr nstlade satser. Om folded_file anges skrivs
+ *   ven tiden fr varje kedja av nstlade loopar till filen, i det format
+ *   som flamegraph-verktyg lser ("PROGRAM;WHILE...;<sats> <mikrosekunder>").
+ *   Returnerar falskt om filen inte kunde skrivas.
+ *------------------------------------*/
+Bool Prof_Report(const AST_Node* root, const char* source,
+                 const char* folded_file);
+
+/*--------------------------------------
+ * Function: Prof_Start()
+ * Parameters:
+ *   root  Root-noden i det AST som ska profileras.
+ *
+ * Description:
+ *   Ger alla noder i trdet nollstllda rknare, som VM_ExecAST() sedan
+ *   rknar upp. Rknarna slpps av AST_FreeNode().
+ *------------------------------------*/
+void Prof_Start(AST_Node* root);
+
+#endif // PROFILE_H_
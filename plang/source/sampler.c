@@ -0,0 +1,368 @@
+/*------------------------------------------------------------------------------
+ * File: sampler.c
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Statistisk profilering och frloppsrapportering, se sampler.h.
+ *
+ * Changes:
+ *   * Stickproven rknas per loop, och loopens rad skrivs ut.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "debug.h"
+#include "sampler.h"
+#include "thread.h"
+#include "vm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> // memcpy()
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: REPORT_INTERVAL_MS
+ *
+ * Description:
+ *   Antalet millisekunder mellan varje utskrift av frloppet.
+ *------------------------------------*/
+#define REPORT_INTERVAL_MS 1000.0
+
+/*--------------------------------------
+ * Constant: SAMPLE_INTERVAL_MS
+ *
+ * Description:
+ *   Antalet millisekunder mellan varje stickprov.
+ *------------------------------------*/
+#define SAMPLE_INTERVAL_MS 10.0
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Loop_Stat
+ *
+ * Description:
+ *   Antalet stickprov fr en loop, se Sampler.loops. loop r NULL fr tiden
+ *   innan ngon loop hoppat tillbaka.
+ *------------------------------------*/
+typedef struct {
+    const AST_Node* loop;
+          int       num_samples;
+} Loop_Stat;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: CompareLoops()
+ * Parameters:
+ *   a  Pekare till en Loop_Stat.
+ *   b  Pekare till en Loop_Stat.
+ *
+ * Description:
+ *   Jmfrelsefunktion fr qsort() som sorterar looparna med flest stickprov
+ *   frst, och annars i radernas ordning.
+ *------------------------------------*/
+static int CompareLoops(const void* a, const void* b) {
+    const Loop_Stat* l1 = a;
+    const Loop_Stat* l2 = b;
+
+    if (l1->num_samples != l2->num_samples)
+        return l2->num_samples - l1->num_samples;
+
+    int row1 = (l1->loop != NULL) ? l1->loop->row : 0;
+    int row2 = (l2->loop != NULL) ? l2->loop->row : 0;
+
+    return row1 - row2;
+}
+
+/*--------------------------------------
+ * Function: FormatLoop()
+ * Parameters:
+ *   config  Konfigurationen fr krningen.
+ *   loop    Loopens nod.
+ *   buf     Loopen skrivs hit.
+ *
+ * Description:
+ *   Skriver loopens villkor och rad till buf, som mste ha plats fr minst
+ *   48 tecken.
+ *------------------------------------*/
+static void FormatLoop(const VM_Config* config, const AST_Node* loop,
+                       char* buf)
+{
+    int var = *(int*)Array_GetElemPtr(&loop->values, 0);
+
+    sprintf(buf, "WHILE X%d (line %d)", config->var_names[var], loop->row);
+}
+
+/*--------------------------------------
+ * Function: CountSample()
+ * Parameters:
+ *   sampler  Profileringen.
+ *   loop     Loopen som krdes, eller NULL.
+ *
+ * Description:
+ *   Rknar ett stickprov fr loopen. Program har sllan mer n ett ftal
+ *   loopar, s de letas upp med en linjr skning.
+ *------------------------------------*/
+static void CountSample(Sampler* sampler, const AST_Node* loop) {
+    int num_loops = Array_Length(&sampler->loops);
+
+    for (int i = 0; i < num_loops; i++) {
+        Loop_Stat* stat = Array_GetElemPtr(&sampler->loops, i);
+        if (stat->loop == loop) {
+            stat->num_samples++;
+            return;
+        }
+    }
+
+    Loop_Stat stat = { .loop = loop, .num_samples = 1 };
+    Array_AddElem(&sampler->loops, &stat);
+}
+
+/*--------------------------------------
+ * Function: LargestVar()
+ * Parameters:
+ *   config  Konfigurationen fr krningen.
+ *   value   Variabelns vrde skrivs hit.
+ *
+ * Description:
+ *   Returnerar platsen fr variabeln med strst vrde, eller -1 om den inte
+ *   gr att lsa. Variablerna ndras medan vi lser dem, s vrdet kan vara
+ *   ngot inaktuellt, men aldrig trasigt.
+ *------------------------------------*/
+static int LargestVar(const VM_Config* config, long long* value) {
+    // Godtyckligt stora tal byggs om medan de rknas upp, s dem kan vi inte
+    // lsa frn en annan trd.
+    if (config->big_vars != NULL || config->num_vars == 0)
+        return -1;
+
+    int largest = 0;
+    *value = 0;
+
+    for (int i = 0; i < config->num_vars; i++) {
+        long long x = (config->vars64 != NULL)
+                    ? ((volatile long long*)config->vars64)[i]
+                    : ((volatile int*)config->vars)[i];
+
+        if (i == 0 || x > *value) {
+            largest = i;
+            *value  = x;
+        }
+    }
+
+    return largest;
+}
+
+/*--------------------------------------
+ * Function: PrintProgress()
+ * Parameters:
+ *   sampler    Profileringen.
+ *   now        Tiden just nu, se Thread_WallTimeMs().
+ *   last_ms    Tiden vid frra utskriften.
+ *   last_steps Antalet hopp tillbaka vid frra utskriften.
+ *
+ * Description:
+ *   Skriver ver frra raden med frloppet med en ny, utan radbrytning.
+ *------------------------------------*/
+static void PrintProgress(const Sampler* sampler, double now, double last_ms,
+                          long long last_steps)
+{
+    const VM_Config* config = sampler->config;
+
+    long long       steps   = sampler->progress.num_steps;
+    const AST_Node* node    = sampler->progress.loop;
+    double          per_sec = 1000.0 * (steps - last_steps) / (now - last_ms);
+
+    char loop[48] = "-";
+    if (node != NULL)
+        FormatLoop(config, node, loop);
+
+    char      largest[48] = "-";
+    long long value;
+    int       var = LargestVar(config, &value);
+    if (var >= 0)
+        sprintf(largest, "X%d = %lld", config->var_names[var], value);
+
+    // Raden skrivs ver varje gng, s den fylls ut till samma lngd.
+    printf("\r%7.1f s %14.0f it/s   %-22s largest %-24s",
+           (now - sampler->start_ms) / 1000.0, per_sec, loop, largest);
+    fflush(stdout);
+}
+
+/*--------------------------------------
+ * Function: SampleThread()
+ * Parameters:
+ *   arg  Profileringen.
+ *
+ * Description:
+ *   Tar ett stickprov var SAMPLE_INTERVAL_MS:e millisekund och skriver ut
+ *   frloppet var REPORT_INTERVAL_MS:e, tills Sampler_Stop() anropas.
+ *------------------------------------*/
+static void SampleThread(void* arg) {
+    Sampler* sampler = arg;
+
+    double    last_ms    = sampler->start_ms;
+    long long last_steps = 0;
+
+    Mutex_Lock(&sampler->mutex);
+
+    while (TRUE) {
+        Cond_TimedWait(&sampler->cond, &sampler->mutex, SAMPLE_INTERVAL_MS);
+        if (sampler->is_done)
+            break;
+
+        CountSample(sampler, sampler->progress.loop);
+        sampler->num_samples++;
+
+        double now = Thread_WallTimeMs();
+        if (now - last_ms >= REPORT_INTERVAL_MS) {
+            PrintProgress(sampler, now, last_ms, last_steps);
+            sampler->has_progress = TRUE;
+            last_ms    = now;
+            last_steps = sampler->progress.num_steps;
+        }
+    }
+
+    Mutex_Unlock(&sampler->mutex);
+}
+
+/*--------------------------------------
+ * Function: Sampler_Free()
+ * Parameters:
+ *   sampler  Profileringen som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper profileringen ur minnet. Den mste ha stoppats med
+ *   Sampler_Stop().
+ *------------------------------------*/
+void Sampler_Free(Sampler* sampler) {
+    Array_Free(&sampler->loops);
+}
+
+/*--------------------------------------
+ * Function: Sampler_Report()
+ * Parameters:
+ *   sampler  Profileringen som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut loopar sorterade efter hur stor andel av stickproven som de
+ *   krdes i.
+ *------------------------------------*/
+void Sampler_Report(const Sampler* sampler) {
+    printf("Sampled profile (%d samples, %.0f ms apart):\n\n",
+           sampler->num_samples, SAMPLE_INTERVAL_MS);
+
+    if (sampler->num_samples == 0) {
+        printf("  The program finished before the first sample.\n");
+        return;
+    }
+
+    int        num_loops = Array_Length(&sampler->loops);
+    Loop_Stat* loops     = malloc(num_loops * sizeof(Loop_Stat));
+
+    memcpy(loops, sampler->loops.elems, num_loops * sizeof(Loop_Stat));
+
+    qsort(loops, num_loops, sizeof(Loop_Stat), CompareLoops);
+
+    printf("%9s %7s   %s\n", "Samples", "%", "Loop");
+
+    for (int i = 0; i < num_loops; i++) {
+        double percent = 100.0 * loops[i].num_samples / sampler->num_samples;
+
+        printf("%9d %6.1f%%   ", loops[i].num_samples, percent);
+
+        if (loops[i].loop == NULL) {
+            printf("(before the first loop iteration)\n");
+            continue;
+        }
+
+        char loop[48];
+        FormatLoop(sampler->config, loops[i].loop, loop);
+        printf("%s\n", loop);
+    }
+
+    free(loops);
+}
+
+/*--------------------------------------
+ * Function: Sampler_Start()
+ * Parameters:
+ *   sampler  Profileringen som ska startas.
+ *   config   Konfigurationen fr krningen som ska fljas. Den fr inte
+ *            kras med VM_ExecLanes().
+ *
+ * Description:
+ *   Stter config->progress och startar trden som tar stickprov. Anropas
+ *   precis innan krningen startar. Returnerar falskt om trden inte kunde
+ *   startas, och d krs programmet som vanligt utan profilering.
+ *------------------------------------*/
+Bool Sampler_Start(Sampler* sampler, VM_Config* config) {
+    sampler->progress.num_steps = 0;
+    sampler->progress.loop      = NULL;
+    sampler->config             = config;
+    sampler->is_done            = FALSE;
+    sampler->has_progress       = FALSE;
+    sampler->start_ms           = Thread_WallTimeMs();
+    sampler->num_samples        = 0;
+
+    Array_Init(&sampler->loops, sizeof(Loop_Stat));
+
+    Mutex_Init(&sampler->mutex);
+    Cond_Init(&sampler->cond);
+
+    config->progress = &sampler->progress;
+
+    if (!Thread_Create(&sampler->thread, SampleThread, sampler)) {
+        config->progress = NULL;
+
+        Cond_Free(&sampler->cond);
+        Mutex_Free(&sampler->mutex);
+        Sampler_Free(sampler);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Sampler_Stop()
+ * Parameters:
+ *   sampler  Profileringen som ska stoppas.
+ *
+ * Description:
+ *   Vntar tills trden som tar stickprov r klar och avslutar raden med
+ *   frloppet. Anropas direkt nr krningen r klar.
+ *------------------------------------*/
+void Sampler_Stop(Sampler* sampler) {
+    Mutex_Lock(&sampler->mutex);
+    sampler->is_done = TRUE;
+    Cond_Broadcast(&sampler->cond);
+    Mutex_Unlock(&sampler->mutex);
+
+    Thread_Join(&sampler->thread);
+
+    Cond_Free(&sampler->cond);
+    Mutex_Free(&sampler->mutex);
+
+    sampler->config->progress = NULL;
+
+    // Frloppet skrevs utan radbrytning.
+    if (sampler->has_progress)
+        printf("\n");
+}
@@ -0,0 +1,113 @@
+/*------------------------------------------------------------------------------
+ * File: sampler.h
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Statistisk profilering och frloppsrapportering fr lnga krningar. En
+ *   egen trd tittar med jmna mellanrum p hur lngt den virtuella maskinen
+ *   kommit, se VM_Progress, och skriver ut antalet loop-varv per sekund,
+ *   vilken loop som krs och den strsta variabeln. Nr krningen r klar
+ *   skrivs en lista ver hur stor del av tiden som varje loop krdes.
+ *
+ *   Den virtuella maskinen rapporterar bara nr loopar hoppar tillbaka, och
+ *   d bara vid de tillfllen d grnserna nd kontrolleras, s sjlva
+ *   krningen pverkas knappt alls.
+ *
+ * Changes:
+ *   * Stickproven rknas per loop istllet fr per variabel i loopens
+ *     villkor, s att loopar med samma variabel hlls isr.
+ *----------------------------------------------------------------------------*/
+
+#ifndef SAMPLER_H_
+#define SAMPLER_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "common.h"
+#include "thread.h"
+#include "vm.h"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Sampler
+ *
+ * Description:
+ *   En pgende profilering. loops har en plats fr varje loop som setts i
+ *   ett stickprov, med antalet gnger som den krdes, och en plats med
+ *   noden NULL fr nr ingen loop hunnit hoppa tillbaka n. has_progress r
+ *   sant nr frloppet skrivits ut minst en gng.
+ *------------------------------------*/
+typedef struct {
+    VM_Progress progress;
+    VM_Config*  config;
+    Thread      thread;
+    Mutex       mutex;
+    Cond        cond;
+    Bool        is_done;
+    Bool        has_progress;
+    double      start_ms;
+    int         num_samples;
+    Array       loops;
+} Sampler;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Sampler_Free()
+ * Parameters:
+ *   sampler  Profileringen som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper profileringen ur minnet. Den mste ha stoppats med
+ *   Sampler_Stop().
+ *------------------------------------*/
+void Sampler_Free(Sampler* sampler);
+
+/*--------------------------------------
+ * Function: Sampler_Report()
+ * Parameters:
+ *   sampler  Profileringen som ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut loopar sorterade efter hur stor andel av stickproven som de
+ *   krdes i.
+ *------------------------------------*/
+void Sampler_Report(const Sampler* sampler);
+
+/*--------------------------------------
+ * Function: Sampler_Start()
+ * Parameters:
+ *   sampler  Profileringen som ska startas.
+ *   config   Konfigurationen fr krningen som ska fljas. Den fr inte
+ *            kras med VM_ExecLanes().
+ *
+ * Description:
+ *   Stter config->progress och startar trden som tar stickprov. Anropas
+ *   precis innan krningen startar. Returnerar falskt om trden inte kunde
+ *   startas, och d krs programmet som vanligt utan profilering.
+ *------------------------------------*/
+Bool Sampler_Start(Sampler* sampler, VM_Config* config);
+
+/*--------------------------------------
+ * Function: Sampler_Stop()
+ * Parameters:
+ *   sampler  Profileringen som ska stoppas.
+ *
+ * Description:
+ *   Vntar tills trden som tar stickprov r klar och avslutar raden med
+ *   frloppet. Anropas direkt nr krningen r klar.
+ *------------------------------------*/
+void Sampler_Stop(Sampler* sampler);
+
+#endif // SAMPLER_H_
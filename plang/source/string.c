@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: string.c
  * Created: January 14, 2015
- * Last changed: January 14, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -9,7 +9,8 @@
  *   Strng-funktioner.
  *
  * Changes:
- *
+ *   * Str_Duplicate() rapporterar sina allokeringar till timing.h.
+ *   * Str_Free() rknar bort strngarna igen.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
@@ -18,6 +19,7 @@
 
 #include "debug.h"
 #include "string.h"
+#include "timing.h"
 
 #include <stdlib.h>
 
@@ -219,11 +221,12 @@ int Str_CompareI(const char* s1, const char* s2) {
  *   s  En strng.
  *
  * Description:
- *   Duplicerar den angivna strngen i minnet. Glm inte anropa free()!
+ *   Duplicerar den angivna strngen i minnet. Glm inte anropa Str_Free()!
  *------------------------------------*/
 char* Str_Duplicate(const char* s) {
     int   len = Str_Length(s);
     char* s2  = malloc((size_t)len+1);
+    Timing_CountAlloc((size_t)len+1);
 
     for (int i = 0; i <= len; i++)
         s2[i] = s[i];
@@ -231,6 +234,23 @@ char* Str_Duplicate(const char* s) {
     return s2;
 }
 
+/*--------------------------------------
+ * Function: Str_Free()
+ * Parameters:
+ *   s  En strng frn Str_Duplicate(), eller NULL.
+ *
+ * Description:
+ *   Slpper en strng frn Str_Duplicate() ur minnet och rknar bort den i
+ *   timing.h. Strngen fr inte ha kortats av sedan den duplicerades.
+ *------------------------------------*/
+void Str_Free(char* s) {
+    if (s == NULL)
+        return;
+
+    Timing_CountFree((size_t)Str_Length(s)+1);
+    free(s);
+}
+
 /*--------------------------------------
  * Function: Str_IsAlpha()
  * Parameters:
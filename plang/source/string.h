@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: string.h
  * Created: January 14, 2015
- * Last changed: January 14, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -9,7 +9,7 @@
  *   Strng-funktioner.
  *
  * Changes:
- *
+ *   * Str_Free() fr strngar frn Str_Duplicate().
  *----------------------------------------------------------------------------*/
 
 #ifndef STRING_H_
@@ -94,10 +94,21 @@ int Str_CompareI(const char* s1, const char* s2);
  *   s  En strng.
  *
  * Description:
- *   Duplicerar den angivna strngen i minnet. Glm inte anropa free()!
+ *   Duplicerar den angivna strngen i minnet. Glm inte anropa Str_Free()!
  *------------------------------------*/
 char* Str_Duplicate(const char* s);
 
+/*--------------------------------------
+ * Function: Str_Free()
+ * Parameters:
+ *   s  En strng frn Str_Duplicate(), eller NULL.
+ *
+ * Description:
+ *   Slpper en strng frn Str_Duplicate() ur minnet och rknar bort den i
+ *   timing.h. Strngen fr inte ha kortats av sedan den duplicerades.
+ *------------------------------------*/
+void Str_Free(char* s);
+
 /*--------------------------------------
  * Function: Str_IsAlpha()
  * Parameters:
@@ -0,0 +1,771 @@
+/*------------------------------------------------------------------------------
+ * File: suite.c
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Kr en svit av prestandatester, se suite.h.
+ *
+ * Changes:
+ *   * Programmen mappas in i minnet och delas upp i tokens en i taget.
+ *   * Syntaxen kontrolleras och syntax-trdet byggs i samma pass.
+ *   * Syntax-trden allokeras ur en arena.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "arena.h"
+#include "array.h"
+#include "ast.h"
+#include "bignum.h"
+#include "bytecode.h"
+#include "common.h"
+#include "debug.h"
+#include "io.h"
+#include "jit.h"
+#include "optimize.h"
+#include "suite.h"
+#include "summary.h"
+#include "syntax.h"
+#include "thread.h"
+#include "vm.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: MAX_NAME_LEN
+ *
+ * Description:
+ *   Det strsta antal tecken i ett tests namn, dvs programmet och dess
+ *   input-vrden.
+ *------------------------------------*/
+#define MAX_NAME_LEN 128
+
+/*--------------------------------------
+ * Constant: MIN_SAMPLE_NS
+ *
+ * Description:
+ *   Den kortaste tiden fr en mtning, i nanosekunder. Program som gr
+ *   fortare n s krs flera gnger i varje mtning, s att klockans
+ *   upplsning inte pverkar resultatet.
+ *------------------------------------*/
+#define MIN_SAMPLE_NS 1000000
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Executor
+ *
+ * Description:
+ *   Stten som ett program kan kras p.
+ *------------------------------------*/
+typedef enum {
+    EXEC_AST,      // VM_ExecAST()
+    EXEC_INT32,    // VM_ExecBytecode()
+    EXEC_INT64,    // VM_ExecBytecode64()
+    EXEC_SATURATE, // VM_ExecSaturating()
+    EXEC_BIGNUM,   // VM_ExecBignum()
+    EXEC_JIT,      // Jit_Exec()
+    NUM_EXECUTORS
+} Executor;
+
+/*--------------------------------------
+ * Type: Baseline
+ *
+ * Description:
+ *   Medianen fr ett test i baslinjen.
+ *------------------------------------*/
+typedef struct {
+    char   name[MAX_NAME_LEN];
+    char   executor[16];
+    double median_ns;
+} Baseline;
+
+/*--------------------------------------
+ * Type: Case_Result
+ *
+ * Description:
+ *   Resultatet fr ett test med ett av stten att kra programmet. result r
+ *   programmets resultat i textform, och baseline_ns medianen i baslinjen,
+ *   eller -1 om testet inte finns dr.
+ *------------------------------------*/
+typedef struct {
+    char      name[MAX_NAME_LEN];
+    Executor  executor;
+    char*     result;
+    long long runs_per_sample;
+    double    median_ns;
+    double    p95_ns;
+    double    baseline_ns;
+} Case_Result;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: CompareDoubles()
+ * Parameters:
+ *   a  Pekare till en double.
+ *   b  Pekare till en double.
+ *
+ * Description:
+ *   Jmfrelsefunktion fr qsort() som sorterar i stigande ordning.
+ *------------------------------------*/
+static int CompareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+/*--------------------------------------
+ * Function: ExecutorName()
+ * Parameters:
+ *   executor  Sttet att kra programmet.
+ *
+ * Description:
+ *   Returnerar namnet som anvnds i utskrifter och i JSON-rapporten.
+ *------------------------------------*/
+static const char* ExecutorName(Executor executor) {
+    static const char* names[NUM_EXECUTORS] = {
+        "ast", "bytecode", "int64", "saturate", "bignum", "jit"
+    };
+
+    return names[executor];
+}
+
+/*--------------------------------------
+ * Function: FindBaseline()
+ * Parameters:
+ *   baselines  Arrayen med baslinjens tester.
+ *   name       Testets namn.
+ *   executor   Sttet att kra programmet.
+ *
+ * Description:
+ *   Returnerar medianen fr testet i baslinjen, eller -1 om det inte finns
+ *   dr.
+ *------------------------------------*/
+static double FindBaseline(const Array* baselines, const char* name,
+                           Executor executor)
+{
+    int num_baselines = Array_Length(baselines);
+    for (int i = 0; i < num_baselines; i++) {
+        const Baseline* baseline = Array_GetElemPtr(baselines, i);
+
+        if (strcmp(baseline->name, name) == 0
+         && strcmp(baseline->executor, ExecutorName(executor)) == 0)
+        {
+            return baseline->median_ns;
+        }
+    }
+
+    return -1.0;
+}
+
+/*--------------------------------------
+ * Function: FindJsonValue()
+ * Parameters:
+ *   line  En rad i en JSON-rapport frn WriteJson().
+ *   key   Nyckeln vars vrde sks.
+ *
+ * Description:
+ *   Returnerar en pekare till vrdet fr nyckeln, eller NULL om den inte
+ *   finns p raden. WriteJson() skriver varje test p en egen rad, s mer
+ *   n s behver vi inte kunna lsa.
+ *------------------------------------*/
+static const char* FindJsonValue(const char* line, const char* key) {
+    char pattern[32];
+    sprintf(pattern, "\"%s\": ", key);
+
+    const char* value = strstr(line, pattern);
+    return value ? value + strlen(pattern) : NULL;
+}
+
+/*--------------------------------------
+ * Function: GetJsonStr()
+ * Parameters:
+ *   line  En rad i en JSON-rapport.
+ *   key   Nyckeln vars vrde sks.
+ *   buf   Bufferten som strngen ska kopieras till.
+ *   size  Buffertens storlek.
+ *
+ * Description:
+ *   Kopierar strngen fr nyckeln till buf. Returnerar falskt om nyckeln
+ *   inte finns eller om strngen inte fr plats.
+ *------------------------------------*/
+static Bool GetJsonStr(const char* line, const char* key, char* buf,
+                       int size)
+{
+    const char* s = FindJsonValue(line, key);
+    if (s == NULL || *s != '"')
+        return FALSE;
+
+    int len = 0;
+    for (s++; *s != '"'; s++) {
+        if (*s == '\0' || len == size-1)
+            return FALSE;
+
+        // Namnen innehller bara citattecken och bakstreck som
+        // WriteJsonStr() har skyddat.
+        if (*s == '\\' && s[1] != '\0')
+            s++;
+
+        buf[len++] = *s;
+    }
+
+    buf[len] = '\0';
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: LoadBaseline()
+ * Parameters:
+ *   file_name  JSON-rapporten som ska lsas.
+ *   baselines  Arrayen som testerna ska lggas till i.
+ *
+ * Description:
+ *   Lser in medianerna frn en rapport som skrivits av WriteJson().
+ *   Returnerar falskt om filen inte kunde lsas.
+ *------------------------------------*/
+static Bool LoadBaseline(const char* file_name, Array* baselines) {
+    char* json = IO_ReadFile(file_name);
+    if (!json)
+        return FALSE;
+
+    for (char* line = strtok(json, "\n"); line; line = strtok(NULL, "\n")) {
+        Baseline    baseline;
+        const char* median = FindJsonValue(line, "median_ns");
+
+        if (median != NULL
+         && GetJsonStr(line, "name", baseline.name, MAX_NAME_LEN)
+         && GetJsonStr(line, "executor", baseline.executor, 16))
+        {
+            baseline.median_ns = atof(median);
+            Array_AddElem(baselines, &baseline);
+        }
+    }
+
+    free(json);
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: ParseInput()
+ * Parameters:
+ *   s      Input-vrdet som det str i sviten.
+ *   value  Vrdet skrivs hit.
+ *
+ * Description:
+ *   Lser ett input-vrde. Returnerar falskt om det inte r ett naturligt
+ *   tal som ryms i en int.
+ *------------------------------------*/
+static Bool ParseInput(const char* s, int* value) {
+    if (*s == '\0')
+        return FALSE;
+
+    *value = 0;
+    for (; *s != '\0'; s++) {
+        if (*s < '0' || *s > '9')
+            return FALSE;
+
+        int digit = *s - '0';
+        if (*value > (INT_MAX - digit) / 10)
+            return FALSE;
+
+        *value = 10 * *value + digit;
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: ResetVars()
+ * Parameters:
+ *   conf      Den virtuella maskinens konfiguration.
+ *   executor  Sttet att kra programmet.
+ *   root      Root-noden i programmets AST.
+ *   inputs    Input-vrdena, i samma ordning som i PROGRAM-raden.
+ *
+ * Description:
+ *   Nollstller de variabler som executor anvnder och stter input-
+ *   vrdena.
+ *------------------------------------*/
+static void ResetVars(VM_Config* conf, Executor executor,
+                      const AST_Node* root, const int* inputs)
+{
+    int num_inputs = Array_Length(&root->values);
+
+    for (int i = 0; i < conf->num_vars; i++) {
+        if (executor == EXEC_INT64)
+            conf->vars64[i] = 0;
+        else if (executor == EXEC_BIGNUM)
+            Big_Set(&conf->big_vars[i], 0);
+        else
+            conf->vars[i] = 0;
+    }
+
+    for (int i = 0; i < num_inputs; i++) {
+        int var = *(int*)Array_GetElemPtr(&root->values, i);
+
+        if (executor == EXEC_INT64)
+            conf->vars64[var] = inputs[i];
+        else if (executor == EXEC_BIGNUM)
+            Big_Set(&conf->big_vars[var], inputs[i]);
+        else
+            conf->vars[var] = inputs[i];
+    }
+}
+
+/*--------------------------------------
+ * Function: ResultStr()
+ * Parameters:
+ *   result      Resultatet eller felkoden frn krningen.
+ *   big_result  Resultatet frn VM_ExecBignum(), eller NULL.
+ *
+ * Description:
+ *   Returnerar resultatet i textform. Glm inte anropa free()!
+ *------------------------------------*/
+static char* ResultStr(long long result, const Big_Num* big_result) {
+    if (big_result != NULL && result == 0)
+        return Big_ToStr(big_result);
+
+    char s[32];
+    if (result == VM_ERR_OVERFLOW)
+        sprintf(s, "overflow");
+    else if (result < 0)
+        sprintf(s, "error %lld", result);
+    else
+        sprintf(s, "%lld", result);
+
+    char* s2 = malloc(strlen(s) + 1);
+    strcpy(s2, s);
+    return s2;
+}
+
+/*--------------------------------------
+ * Function: RunCase()
+ * Parameters:
+ *   source    Programmets kllkod.
+ *   inputs    Input-vrdena, i samma ordning som i PROGRAM-raden.
+ *   executor  Sttet att kra programmet.
+ *   options   Svitens instllningar.
+ *   result    Resultatet som ska fyllas i. Namnet mste redan vara satt.
+ *
+ * Description:
+ *   Kompilerar programmet, kr det ngra varv fr uppvrmning och mter
+ *   sedan tiden per krning. Returnerar falskt om executor inte stds p
+ *   den hr plattformen.
+ *------------------------------------*/
+static Bool RunCase(const char* source, const int* inputs, Executor executor,
+                    const Suite_Options* options, Case_Result* result)
+{
+    // Sammanfattningarna beror p variablernas strsta vrde, s varje stt
+    // att kra programmet fr ett eget trd, precis som i -benchvm.
+    Arena    arena; Arena_Init(&arena);
+    AST_Node tree;
+    Syn_Parse(source, NULL, &tree, &arena);
+
+    if (options->optimize) {
+        Opt_OptimizeTree(&tree);
+        if (executor != EXEC_BIGNUM) {
+            long long max = (executor == EXEC_INT64) ? SUM_MAX_INT64
+                                                     : INT_MAX;
+            Sum_SummarizeTree(&tree, max, FALSE);
+        }
+    }
+
+    Array var_names;
+    AST_ResolveVars(&tree, &var_names);
+
+    BC_Program  bytecode;
+    Jit_Program machine_code;
+    if (executor == EXEC_JIT) {
+        if (!Jit_Compile(&tree, &machine_code)) {
+            Array_Free(&var_names);
+            AST_FreeNode(&tree);
+            Arena_Free(&arena);
+            return FALSE;
+        }
+    }
+    else if (executor != EXEC_AST) {
+        BC_Compile(&tree, &bytecode);
+    }
+
+    VM_Config conf;
+    conf.num_vars     = Array_Length(&var_names);
+    conf.vars         = malloc(conf.num_vars * sizeof(int) + 1);
+    conf.vars64       = NULL;
+    conf.big_vars     = NULL;
+    conf.var_names    = var_names.elems;
+    conf.enable_debug = FALSE;
+    conf.max_steps    = 0;
+    conf.timeout_ms   = 0.0;
+    conf.detect_loops = FALSE;
+    conf.single_step  = FALSE;
+    conf.progress     = NULL;
+
+    if (executor == EXEC_INT64)
+        conf.vars64 = malloc(conf.num_vars * sizeof(long long) + 1);
+
+    if (executor == EXEC_BIGNUM) {
+        conf.big_vars = malloc(conf.num_vars * sizeof(Big_Num) + 1);
+        for (int i = 0; i < conf.num_vars; i++)
+            Big_Init(&conf.big_vars[i]);
+    }
+
+    Big_Num big_result;
+    Big_Init(&big_result);
+
+    // Den frsta mtningen r en enda krning. Den och uppvrmningsvarven
+    // avgr hur mnga krningar som behvs fr att varje mtning ska ta
+    // minst MIN_SAMPLE_NS, men rknas inte sjlva.
+    int       first       = 1 + options->num_warmups;
+    int       num_samples = first + options->num_samples;
+    double*   samples     = malloc(num_samples * sizeof(double));
+    long long num_runs    = 1;
+    long long value       = 0;
+
+    for (int i = 0; i < num_samples; i++) {
+        long long start = Thread_WallTimeNs();
+
+        for (long long j = 0; j < num_runs; j++) {
+            ResetVars(&conf, executor, &tree, inputs);
+
+            switch (executor) {
+            case EXEC_AST:
+                value = VM_ExecAST(&tree, &conf);
+                break;
+            case EXEC_INT32:
+                value = VM_ExecBytecode(&bytecode, &conf);
+                break;
+            case EXEC_INT64:
+                value = VM_ExecBytecode64(&bytecode, &conf);
+                break;
+            case EXEC_SATURATE:
+                value = VM_ExecSaturating(&bytecode, &conf);
+                break;
+            case EXEC_BIGNUM:
+                value = VM_ExecBignum(&bytecode, &conf, &big_result);
+                break;
+            case EXEC_JIT:
+                value = Jit_Exec(&machine_code, &conf);
+                break;
+            default:
+                FAIL();
+            }
+        }
+
+        long long ns = Thread_WallTimeNs() - start;
+        samples[i] = (double)ns / num_runs;
+
+        if (i < first && ns < MIN_SAMPLE_NS)
+            num_runs = num_runs * MIN_SAMPLE_NS / ((ns > 0) ? ns : 1) + 1;
+    }
+
+    int     num_kept = options->num_samples;
+    double* kept     = samples + first;
+
+    qsort(kept, num_kept, sizeof(double), CompareDoubles);
+
+    // Medianen, och den 95:e percentilen som det minsta vrde som minst 95
+    // procent av mtningarna inte verstiger.
+    int p95 = (95 * num_kept + 99) / 100 - 1;
+
+    result->executor        = executor;
+    result->runs_per_sample = num_runs;
+    result->median_ns       = (num_kept % 2 == 1)
+                            ? kept[num_kept/2]
+                            : (kept[num_kept/2-1] + kept[num_kept/2]) / 2.0;
+    result->p95_ns          = kept[(p95 > 0) ? p95 : 0];
+    result->result          = ResultStr(value, (executor == EXEC_BIGNUM)
+                                               ? &big_result : NULL);
+
+    free(samples);
+
+    if (executor == EXEC_BIGNUM) {
+        for (int i = 0; i < conf.num_vars; i++)
+            Big_Free(&conf.big_vars[i]);
+    }
+
+    Big_Free(&big_result);
+    free(conf.big_vars);
+    free(conf.vars64);
+    free(conf.vars);
+
+    if (executor == EXEC_JIT)
+        Jit_Free(&machine_code);
+    else if (executor != EXEC_AST)
+        BC_Free(&bytecode);
+
+    Array_Free(&var_names);
+    AST_FreeNode(&tree);
+    Arena_Free(&arena);
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: WriteJsonStr()
+ * Parameters:
+ *   fp  Filen som ska skrivas till.
+ *   s   Strngen som ska skrivas.
+ *
+ * Description:
+ *   Skriver strngen inom citattecken, med citattecken och bakstreck
+ *   skyddade.
+ *------------------------------------*/
+static void WriteJsonStr(FILE* fp, const char* s) {
+    fputc('"', fp);
+
+    for ( ; *s != '\0'; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', fp);
+        fputc(*s, fp);
+    }
+
+    fputc('"', fp);
+}
+
+/*--------------------------------------
+ * Function: WriteJson()
+ * Parameters:
+ *   file_name   Filen som rapporten ska skrivas till.
+ *   suite_file  Filen med sviten.
+ *   options     Svitens instllningar.
+ *   results     Arrayen med resultaten.
+ *
+ * Description:
+ *   Skriver resultaten som JSON, med ett test per rad s att LoadBaseline()
+ *   kan lsa rapporten. Returnerar falskt om filen inte kunde skrivas.
+ *------------------------------------*/
+static Bool WriteJson(const char* file_name, const char* suite_file,
+                      const Suite_Options* options, const Array* results)
+{
+    FILE* fp = fopen(file_name, "w");
+    if (!fp)
+        return FALSE;
+
+    fprintf(fp, "{\n  \"suite\": ");
+    WriteJsonStr(fp, suite_file);
+    fprintf(fp, ",\n  \"samples\": %d,\n  \"warmups\": %d,\n"
+                "  \"optimize\": %s,\n  \"results\": [\n",
+            options->num_samples, options->num_warmups,
+            options->optimize ? "true" : "false");
+
+    int num_results = Array_Length(results);
+    for (int i = 0; i < num_results; i++) {
+        const Case_Result* result = Array_GetElemPtr(results, i);
+
+        fprintf(fp, "    {\"name\": ");
+        WriteJsonStr(fp, result->name);
+        fprintf(fp, ", \"executor\": \"%s\", \"result\": ",
+                ExecutorName(result->executor));
+        WriteJsonStr(fp, result->result);
+        fprintf(fp, ", \"runs_per_sample\": %lld, \"median_ns\": %.1f, "
+                    "\"p95_ns\": %.1f}%s\n",
+                result->runs_per_sample, result->median_ns, result->p95_ns,
+                (i < num_results-1) ? "," : "");
+    }
+
+    fprintf(fp, "  ]\n}\n");
+
+    Bool ok = !ferror(fp);
+    if (fclose(fp) != 0)
+        ok = FALSE;
+
+    return ok;
+}
+
+/*--------------------------------------
+ * Function: Suite_Run()
+ * Parameters:
+ *   suite_file  Filen med sviten.
+ *   options     Instllningarna.
+ *
+ * Description:
+ *   Kr alla tester i sviten och skriver ut resultatet. Returnerar antalet
+ *   tester som blivit lngsammare n baslinjen, eller -1 om sviten eller
+ *   baslinjen inte kunde lsas eller rapporten inte kunde skrivas.
+ *------------------------------------*/
+int Suite_Run(const char* suite_file, const Suite_Options* options) {
+    ASSERT(options->num_samples > 0 && options->num_warmups >= 0);
+
+    char* suite = IO_ReadFile(suite_file);
+    if (!suite) {
+        printf("ERROR: Could not read %s.\n", suite_file);
+        return -1;
+    }
+
+    Array baselines; Array_Init(&baselines, sizeof(Baseline));
+    if (options->baseline_file != NULL
+     && !LoadBaseline(options->baseline_file, &baselines))
+    {
+        printf("ERROR: Could not read %s.\n", options->baseline_file);
+        Array_Free(&baselines);
+        free(suite);
+        return -1;
+    }
+
+    // Programmen ligger i samma katalog som sviten.
+    int dir_len = 0;
+    for (int i = 0; suite_file[i] != '\0'; i++) {
+        if (suite_file[i] == '/' || suite_file[i] == '\\')
+            dir_len = i+1;
+    }
+
+    printf("\n%-28s %-10s %14s %14s   %s\n", "Case", "Executor", "Median ns",
+           "p95 ns", "Baseline");
+
+    Array results; Array_Init(&results, sizeof(Case_Result));
+    int   num_regressions = 0;
+
+    char* next_line = suite;
+    while (next_line != NULL) {
+        char* line = next_line;
+
+        next_line = strchr(line, '\n');
+        if (next_line != NULL)
+            *next_line++ = '\0';
+
+        // Namnet p testet r programmet och input-vrdena, med ett
+        // mellanslag mellan varje.
+        char   name[MAX_NAME_LEN] = "";
+        char   program[MAX_NAME_LEN];
+        int    inputs[PLANG_NUM_VARS];
+        int    num_inputs = 0;
+        char*  bad_input  = NULL;
+        size_t len;
+
+        char* word = strtok(line, " \t\r");
+        if (word == NULL || word[0] == '#')
+            continue;
+
+        // Lngderna kontrolleras hr, s att namnen kan kopieras utan att
+        // ngot kan skrivas utanfr buffertarna.
+        len = strlen(word);
+        if (dir_len + len >= MAX_NAME_LEN) {
+            printf("%-28.28s program name too long\n", word);
+            continue;
+        }
+
+        memcpy(program, suite_file, dir_len);
+        memcpy(program + dir_len, word, len+1);
+        memcpy(name, word, len+1);
+
+        while ((word = strtok(NULL, " \t\r")) != NULL
+            && num_inputs < PLANG_NUM_VARS)
+        {
+            if (!ParseInput(word, &inputs[num_inputs++]) && !bad_input)
+                bad_input = word;
+
+            size_t word_len = strlen(word);
+            if (len + 1 + word_len < MAX_NAME_LEN) {
+                name[len] = ' ';
+                memcpy(name + len + 1, word, word_len+1);
+                len += 1 + word_len;
+            }
+        }
+
+        if (bad_input != NULL) {
+            printf("%-28s invalid input value %s\n", name, bad_input);
+            continue;
+        }
+
+        IO_File_View source_file;
+        if (!IO_MapFile(program, &source_file)) {
+            printf("%-28s could not read %s\n", name, program);
+            continue;
+        }
+
+        const char* source = source_file.text;
+
+        // Antalet input-vrden kontrolleras mot ett trd som bara anvnds
+        // till det. Trdet har inget minne utanfr arenan.
+        Arena    arena; Arena_Init(&arena);
+        AST_Node tree;
+        Bool     has_errors = !Syn_Parse(source, NULL, &tree, &arena);
+        int      num_params = has_errors ? -1 : Array_Length(&tree.values);
+        Arena_Free(&arena);
+
+        if (has_errors)
+            printf("%-28s syntax errors\n", name);
+        else if (num_params != num_inputs)
+            printf("%-28s expected %d input values\n", name, num_params);
+
+        for (int i = 0; i < NUM_EXECUTORS && num_params == num_inputs; i++) {
+            Case_Result result;
+            strcpy(result.name, name);
+
+            if (!RunCase(source, inputs, (Executor)i, options, &result))
+                continue;
+
+            result.baseline_ns = FindBaseline(&baselines, name, (Executor)i);
+
+            printf("%-28s %-10s %14.1f %14.1f   ", name, ExecutorName(i),
+                   result.median_ns, result.p95_ns);
+
+            if (result.baseline_ns <= 0.0) {
+                printf("-\n");
+            }
+            else {
+                double change = 100.0 * (result.median_ns - result.baseline_ns)
+                                      / result.baseline_ns;
+
+                printf("%+.1f%%", change);
+                if (change > options->threshold) {
+                    printf("  REGRESSION");
+                    num_regressions++;
+                }
+                printf("\n");
+            }
+
+            Array_AddElem(&results, &result);
+        }
+
+        IO_UnmapFile(&source_file);
+    }
+
+    printf("\n");
+
+    if (options->baseline_file != NULL) {
+        printf("%d regressions beyond %.1f%% compared to %s.\n",
+               num_regressions, options->threshold, options->baseline_file);
+    }
+
+    int status = num_regressions;
+    if (options->json_file != NULL) {
+        if (WriteJson(options->json_file, suite_file, options, &results)) {
+            printf("Report written to %s.\n", options->json_file);
+        }
+        else {
+            printf("ERROR: Could not write %s.\n", options->json_file);
+            status = -1;
+        }
+    }
+
+    int num_results = Array_Length(&results);
+    for (int i = 0; i < num_results; i++) {
+        Case_Result* result = Array_GetElemPtr(&results, i);
+        free(result->result);
+    }
+
+    Array_Free(&results);
+    Array_Free(&baselines);
+    free(suite);
+
+    return status;
+}
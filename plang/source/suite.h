@@ -0,0 +1,101 @@
+/*------------------------------------------------------------------------------
+ * File: suite.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Kr en svit av prestandatester, ex. examples/bench.txt. Varje rad i
+ *   sviten anger ett program och dess input-vrden:
+ *
+ *     # Kommentar.
+ *     multiply.p 1000 1000
+ *
+ *   Programmen lses frn samma katalog som sviten och krs i varje variant
+ *   av den virtuella maskinen, och med maskinkod frn jit.h om plattformen
+ *   stds. Efter ngra uppvrmningsvarv tas ett antal mtningar, och median
+ *   och 95:e percentil fr tiden per krning skrivs ut och kan sparas som
+ *   JSON. En tidigare sparad rapport kan anges som baslinje, och d flaggas
+ *   de tester som blivit mer n en viss procentsats lngsammare.
+ *
+ * Changes:
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef SUITE_H_
+#define SUITE_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: SUITE_NUM_SAMPLES
+ *
+ * Description:
+ *   Antalet mtningar fr varje test, om inget annat anges.
+ *------------------------------------*/
+#define SUITE_NUM_SAMPLES 15
+
+/*--------------------------------------
+ * Constant: SUITE_NUM_WARMUPS
+ *
+ * Description:
+ *   Antalet uppvrmningsvarv fr varje test, om inget annat anges.
+ *------------------------------------*/
+#define SUITE_NUM_WARMUPS 3
+
+/*--------------------------------------
+ * Constant: SUITE_THRESHOLD
+ *
+ * Description:
+ *   Den procentsats som medianen fr ka med jmfrt med baslinjen innan
+ *   testet flaggas, om inget annat anges.
+ *------------------------------------*/
+#define SUITE_THRESHOLD 10.0
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Suite_Options
+ *
+ * Description:
+ *   Instllningar fr Suite_Run(). json_file och baseline_file fr vara
+ *   NULL. threshold anges i procent.
+ *------------------------------------*/
+typedef struct {
+    const char* json_file;
+    const char* baseline_file;
+    double      threshold;
+    int         num_warmups;
+    int         num_samples;
+    Bool        optimize;
+} Suite_Options;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Suite_Run()
+ * Parameters:
+ *   suite_file  Filen med sviten.
+ *   options     Instllningarna.
+ *
+ * Description:
+ *   Kr alla tester i sviten och skriver ut resultatet. Returnerar antalet
+ *   tester som blivit lngsammare n baslinjen, eller -1 om sviten eller
+ *   baslinjen inte kunde lsas eller rapporten inte kunde skrivas.
+ *------------------------------------*/
+int Suite_Run(const char* suite_file, const Suite_Options* options);
+
+#endif // SUITE_H_
@@ -0,0 +1,1286 @@
+/*------------------------------------------------------------------------------
+ * File: summary.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Rknar ut slutna uttryck fr nstlade rkne-loopar, s att en loop som
+ *   X1 := X1 + X2*X3 kan kras med en enda berkning istllet fr X2*X3
+ *   iterationer.
+ *
+ *   Loopkroppen krs symboliskt, s att varje variabel fr ett polynom i
+ *   variablernas vrden i brjan av iterationen. Om loop-variabeln rknas ned
+ *   med exakt ett, och vriga variabler antingen rknas upp med ett polynom
+ *   eller fr ett nytt vrde som inte beror p det gamla, kan hela loopen
+ *   summeras med Faulhabers formler. PRED som kan begrnsas av noll och SUCC
+ *   som kan ge overflow blir villkor som kontrolleras innan sammanfattningen
+ *   anvnds. Gller de inte krs loopen som vanligt.
+ *
+ * Changes:
+ *   * Sum_Renumber() fr AST_ResolveVars().
+ *   * Sum_Apply64() och ett strsta vrde till Sum_SummarizeTree(), fr
+ *     -int64.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "debug.h"
+#include "poly.h"
+#include "summary.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: REASON_LEN
+ *
+ * Description:
+ *   Maxlngden p frklaringen till varfr en loop inte kunde sammanfattas.
+ *------------------------------------*/
+#define REASON_LEN 128
+
+/*--------------------------------------
+ * Constant: REASON_TOO_LARGE
+ *
+ * Description:
+ *   Frklaringen nr ett polynom fick fr hg grad eller fr stora
+ *   koefficienter.
+ *------------------------------------*/
+#define REASON_TOO_LARGE "the closed form is too large"
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: LoopVar
+ *
+ * Description:
+ *   En variabel som ndras av en loop som ska sammanfattas. Ackumulatorer
+ *   rknas upp med delta varje iteration, vriga variabler fr vrdet delta.
+ *   closed r vrdet i brjan av den iteration d loop-variabeln har vrdet
+ *   j, och final r vrdet efter loopen.
+ *------------------------------------*/
+typedef struct {
+    int  var;
+    Bool is_accumulator;
+    Bool is_solved;
+    Poly delta;
+    Poly closed;
+    Poly final;
+} LoopVar;
+
+/*--------------------------------------
+ * Type: ReportEntry
+ *
+ * Description:
+ *   En rad i rapporten ver alla loopar. reason r tom om loopen kunde
+ *   sammanfattas.
+ *------------------------------------*/
+typedef struct {
+    const AST_Node* loop;
+    int             depth;
+    char            reason[REASON_LEN];
+} ReportEntry;
+
+/*--------------------------------------
+ * Type: SymState
+ *
+ * Description:
+ *   Tillstndet under symbolisk krning av en loopkropp. values innehller
+ *   de variabler som ndrats, vriga variabler har kvar sina vrden frn
+ *   brjan av iterationen. guards innehller de polynom som mste vara strre
+ *   n eller lika med noll. max r det strsta vrde en variabel kan ha
+ *   innan den ger overflow.
+ *------------------------------------*/
+typedef struct {
+    Array     values;
+    Array     guards;
+    long long max;
+} SymState;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: IsValidVar()
+ * Parameters:
+ *   var  Variabelindexet som ska kontrolleras.
+ *
+ * Description:
+ *   Returnerar sant om variabelindexet ligger inom variabel-arrayen.
+ *------------------------------------*/
+static Bool IsValidVar(int var) {
+    return (var >= 0 && var < PLANG_NUM_VARS);
+}
+
+/*--------------------------------------
+ * Function: HasValidVars()
+ * Parameters:
+ *   node  Noden som ska kontrolleras.
+ *
+ * Description:
+ *   Returnerar sant om alla variabler som noden anvnder ligger inom
+ *   variabel-arrayen.
+ *------------------------------------*/
+static Bool HasValidVars(const AST_Node* node) {
+    int num_values = Array_Length(&node->values);
+
+    for (int i = 0; i < num_values; i++) {
+        int value = *(int*)Array_GetElemPtr(&node->values, i);
+
+        // I AST_ADD_CLEAR r varannan int en faktor, och i AST_ASSIGN r den
+        // andra int:en ett tal.
+        Bool is_var = (node->type == AST_ADD_CLEAR) ? (i == 0 || i % 2 == 1)
+                    : (node->type == AST_ASSIGN)    ? (i == 0)
+                    :                                 TRUE;
+
+        if (is_var && !IsValidVar(value))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: ReplacePoly()
+ * Parameters:
+ *   dst  Polynomet som ska ersttas.
+ *   src  Det nya polynomet.
+ *
+ * Description:
+ *   Slpper dst ur minnet och flyttar src dit.
+ *------------------------------------*/
+static void ReplacePoly(Poly* dst, Poly* src) {
+    Poly_Free(dst);
+    *dst = *src;
+}
+
+/*--------------------------------------
+ * Function: AddGuard()
+ * Parameters:
+ *   guards  De villkor som guard ska lggas till i.
+ *   guard   Polynomet som mste vara strre n eller lika med noll.
+ *   reason  Buffert fr frklaringen om villkoret aldrig kan glla.
+ *
+ * Description:
+ *   Lgger till ett villkor, som tas ver av funktionen. Konstanta villkor
+ *   som alltid gller, och villkor som redan finns, hoppar vi ver.
+ *   Returnerar falskt om villkoret aldrig kan glla.
+ *------------------------------------*/
+static Bool AddGuard(Array* guards, Poly* guard, char* reason) {
+    long long value;
+    if (Poly_GetConst(guard, &value)) {
+        Poly_Free(guard);
+
+        if (value < 0) {
+            sprintf(reason, "the loop always overflows");
+            return FALSE;
+        }
+
+        return TRUE;
+    }
+
+    int num_guards = Array_Length(guards);
+    for (int i = 0; i < num_guards; i++) {
+        if (Poly_Equals(Array_GetElemPtr(guards, i), guard)) {
+            Poly_Free(guard);
+            return TRUE;
+        }
+    }
+
+    Array_AddElem(guards, guard);
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: AddMaxGuard()
+ * Parameters:
+ *   state   Tillstndet som villkoret ska lggas till i.
+ *   value   Polynomet som inte fr bli strre n max.
+ *   max     Det strsta tilltna vrdet.
+ *   reason  Buffert fr frklaringen om ngot gr fel.
+ *
+ * Description:
+ *   Lgger till villkoret value <= max, dvs max - value >= 0.
+ *------------------------------------*/
+static Bool AddMaxGuard(SymState* state, const Poly* value, long long max,
+                        char* reason)
+{
+    Poly guard;
+    Poly_Init(&guard, max);
+
+    if (!Poly_Add(&guard, value, -1)) {
+        Poly_Free(&guard);
+        sprintf(reason, REASON_TOO_LARGE);
+        return FALSE;
+    }
+
+    return AddGuard(&state->guards, &guard, reason);
+}
+
+/*--------------------------------------
+ * Function: AddMinGuard()
+ * Parameters:
+ *   state   Tillstndet som villkoret ska lggas till i.
+ *   value   Polynomet som inte fr bli mindre n min.
+ *   min     Det minsta tilltna vrdet.
+ *   reason  Buffert fr frklaringen om ngot gr fel.
+ *
+ * Description:
+ *   Lgger till villkoret value >= min, dvs value - min >= 0.
+ *------------------------------------*/
+static Bool AddMinGuard(SymState* state, const Poly* value, long long min,
+                        char* reason)
+{
+    Poly guard;
+    Poly_Init(&guard, -min);
+
+    if (!Poly_Add(&guard, value, 1)) {
+        Poly_Free(&guard);
+        sprintf(reason, REASON_TOO_LARGE);
+        return FALSE;
+    }
+
+    return AddGuard(&state->guards, &guard, reason);
+}
+
+/*--------------------------------------
+ * Function: FindValue()
+ * Parameters:
+ *   state  Tillstndet som ska skas igenom.
+ *   var    Variabelindexet.
+ *
+ * Description:
+ *   Returnerar variabelns tilldelning, eller NULL om variabeln inte har
+ *   ndrats.
+ *------------------------------------*/
+static Sum_Assign* FindValue(const SymState* state, int var) {
+    int num_values = Array_Length(&state->values);
+    for (int i = 0; i < num_values; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&state->values, i);
+        if (assign->var == var)
+            return assign;
+    }
+
+    return NULL;
+}
+
+/*--------------------------------------
+ * Function: GetValue()
+ * Parameters:
+ *   state   Tillstndet.
+ *   var     Variabelindexet.
+ *   result  Polynomet som vrdet ska lagras i.
+ *
+ * Description:
+ *   Tar fram variabelns nuvarande vrde. result initieras av funktionen.
+ *------------------------------------*/
+static void GetValue(const SymState* state, int var, Poly* result) {
+    Sum_Assign* assign = FindValue(state, var);
+
+    if (assign != NULL) Poly_Copy(result, &assign->value);
+    else                Poly_InitSym(result, var);
+}
+
+/*--------------------------------------
+ * Function: SetValue()
+ * Parameters:
+ *   state  Tillstndet.
+ *   var    Variabelindexet.
+ *   value  Variabelns nya vrde, som tas ver av funktionen.
+ *
+ * Description:
+ *   Ger en variabel ett nytt vrde.
+ *------------------------------------*/
+static void SetValue(SymState* state, int var, Poly* value) {
+    Sum_Assign* assign = FindValue(state, var);
+
+    if (assign != NULL) {
+        ReplacePoly(&assign->value, value);
+        return;
+    }
+
+    Sum_Assign new_assign = { .var = var, .value = *value };
+    Array_AddElem(&state->values, &new_assign);
+}
+
+/*--------------------------------------
+ * Function: FreeAssigns()
+ * Parameters:
+ *   assigns  Arrayen med tilldelningar.
+ *
+ * Description:
+ *   Slpper en array med Sum_Assign-element ur minnet.
+ *------------------------------------*/
+static void FreeAssigns(Array* assigns) {
+    int num_assigns = Array_Length(assigns);
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(assigns, i);
+        Poly_Free(&assign->value);
+    }
+
+    Array_Free(assigns);
+}
+
+/*--------------------------------------
+ * Function: FreeGuards()
+ * Parameters:
+ *   guards  Arrayen med villkor.
+ *
+ * Description:
+ *   Slpper en array med Poly-element ur minnet.
+ *------------------------------------*/
+static void FreeGuards(Array* guards) {
+    int num_guards = Array_Length(guards);
+    for (int i = 0; i < num_guards; i++)
+        Poly_Free(Array_GetElemPtr(guards, i));
+
+    Array_Free(guards);
+}
+
+/*--------------------------------------
+ * Function: ApplySummary()
+ * Parameters:
+ *   sum     Sammanfattningen av en inre loop.
+ *   state   Tillstndet som loopen ska kras i.
+ *   reason  Buffert fr frklaringen om ngot gr fel.
+ *
+ * Description:
+ *   Kr en redan sammanfattad inre loop symboliskt genom att stta in de
+ *   nuvarande vrdena i dess polynom.
+ *------------------------------------*/
+static Bool ApplySummary(const Sum_Loop* sum, SymState* state, char* reason) {
+    const Poly* map[POLY_NUM_SYMS] = { NULL };
+
+    int num_values = Array_Length(&state->values);
+    for (int i = 0; i < num_values; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&state->values, i);
+        map[assign->var] = &assign->value;
+    }
+
+    Poly new_values[SUM_MAX_ASSIGNS];
+    int  num_assigns = Array_Length(&sum->assigns);
+    int  num_guards  = Array_Length(&sum->guards);
+    Bool is_ok       = TRUE;
+
+    // Alla nya vrden mste rknas ut innan vi ndrar ngot, eftersom
+    // polynomen i sammanfattningen gller vrdena fre loopen.
+    for (int i = 0; i < num_guards; i++) {
+        Poly guard;
+        if (!Poly_Compose(Array_GetElemPtr(&sum->guards, i), map, map,
+                          &guard))
+        {
+            Poly_Free(&guard);
+            sprintf(reason, REASON_TOO_LARGE);
+            return FALSE;
+        }
+
+        if (!AddGuard(&state->guards, &guard, reason))
+            return FALSE;
+    }
+
+    int num_computed = 0;
+    for (int i = 0; i < num_assigns && is_ok; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        is_ok = Poly_Compose(&assign->value, map, map, &new_values[i]);
+        num_computed++;
+    }
+
+    if (!is_ok) {
+        for (int i = 0; i < num_computed; i++)
+            Poly_Free(&new_values[i]);
+
+        sprintf(reason, REASON_TOO_LARGE);
+        return FALSE;
+    }
+
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        SetValue(state, assign->var, &new_values[i]);
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: ExecSymbolic()
+ * Parameters:
+ *   loop    While-noden vars kropp ska kras.
+ *   state   Tillstndet som kroppen ska kras i.
+ *   reason  Buffert fr frklaringen om kroppen inte gr att kra.
+ *
+ * Description:
+ *   Kr en loopkropp en gng symboliskt. Returnerar falskt om kroppen
+ *   innehller ngot som inte kan uttryckas med polynom.
+ *------------------------------------*/
+static Bool ExecSymbolic(const AST_Node* loop, SymState* state, char* reason) {
+    int num_children = Array_Length(&loop->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* node       = Array_GetElemPtr(&loop->children, i);
+        int       num_values = Array_Length(&node->values);
+
+        if (!HasValidVars(node)) {
+            sprintf(reason, "the loop uses an invalid variable");
+            return FALSE;
+        }
+
+        switch (node->type) {
+        case AST_ADD_CLEAR: {
+            int  src = *(int*)Array_GetElemPtr(&node->values, 0);
+            Poly amount;
+            GetValue(state, src, &amount);
+
+            for (int j = 1; j < num_values; j += 2) {
+                int  var    = *(int*)Array_GetElemPtr(&node->values, j);
+                int  factor = *(int*)Array_GetElemPtr(&node->values, j+1);
+                Poly value;
+                GetValue(state, var, &value);
+
+                Bool is_ok = Poly_Add(&value, &amount, factor);
+                if (!is_ok)
+                    sprintf(reason, REASON_TOO_LARGE);
+
+                if (is_ok && factor > 0) {
+                    is_ok = AddMaxGuard(state, &value, state->max, reason);
+                }
+                else if (is_ok) {
+                    // Negativa faktorer fr inte begrnsas av noll.
+                    is_ok = AddMinGuard(state, &value, 0, reason);
+                }
+
+                if (!is_ok) {
+                    Poly_Free(&value);
+                    Poly_Free(&amount);
+                    return FALSE;
+                }
+
+                SetValue(state, var, &value);
+            }
+
+            Poly_Free(&amount);
+
+            Poly zero;
+            Poly_Init(&zero, 0);
+            SetValue(state, src, &zero);
+            break;
+        }
+
+        case AST_ASSIGN: {
+            int var = *(int*)Array_GetElemPtr(&node->values, 0);
+            int val = *(int*)Array_GetElemPtr(&node->values, 1);
+
+            Poly value;
+            Poly_Init(&value, (val < 0) ? 0 : val);
+            SetValue(state, var, &value);
+            break;
+        }
+
+        case AST_COPY: {
+            int dst = *(int*)Array_GetElemPtr(&node->values, 0);
+            int src = *(int*)Array_GetElemPtr(&node->values, 1);
+
+            // AST_COPY ger overflow precis som SUCC, se vm.c.
+            Poly value;
+            GetValue(state, src, &value);
+            if (!AddMaxGuard(state, &value, state->max-1, reason)) {
+                Poly_Free(&value);
+                return FALSE;
+            }
+
+            SetValue(state, dst, &value);
+            break;
+        }
+
+        case AST_PRED:
+        case AST_SUCC: {
+            int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+            int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+
+            Poly      value, one;
+            long long const_val;
+            GetValue(state, var1, &value);
+            Poly_Init(&one, 1);
+
+            Bool is_ok;
+            if (node->type == AST_SUCC) {
+                is_ok = Poly_Add(&value, &one, 1);
+                if (is_ok)
+                    is_ok = AddMaxGuard(state, &value, state->max, reason);
+                else
+                    sprintf(reason, REASON_TOO_LARGE);
+            }
+            else if (Poly_GetConst(&value, &const_val)) {
+                // Konstanter kan vi begrnsa direkt.
+                Poly_Free(&value);
+                Poly_Init(&value, (const_val > 0) ? const_val-1 : 0);
+                is_ok = TRUE;
+            }
+            else {
+                // Vrdet mste vara minst ett, annars begrnsas det av noll
+                // och r inte lngre ett polynom.
+                is_ok = AddMinGuard(state, &value, 1, reason);
+                if (is_ok && !Poly_Add(&value, &one, -1)) {
+                    sprintf(reason, REASON_TOO_LARGE);
+                    is_ok = FALSE;
+                }
+            }
+
+            Poly_Free(&one);
+
+            if (!is_ok) {
+                Poly_Free(&value);
+                return FALSE;
+            }
+
+            SetValue(state, var0, &value);
+            break;
+        }
+
+        case AST_RESULT:
+            sprintf(reason, "the loop contains a RESULT statement");
+            return FALSE;
+
+        case AST_WHILE:
+            if (node->summary == NULL) {
+                sprintf(reason, "an inner loop could not be summarized");
+                return FALSE;
+            }
+
+            if (!ApplySummary(node->summary, state, reason))
+                return FALSE;
+
+            break;
+
+        default:
+            // Det hr ska inte hnda.
+            FAIL();
+        }
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: PowerSums()
+ * Parameters:
+ *   max_exp  Den hgsta exponenten.
+ *   sums     Array dr polynomen ska lagras.
+ *
+ * Description:
+ *   Rknar ut S_d(j) = 1^d + 2^d + ... + j^d som polynom i POLY_SYM_ITER fr
+ *   d = 0..max_exp, med hjlp av rekursionen
+ *
+ *     (j+1)^(d+1) - 1 = sum(k=0..d) binom(d+1, k) * S_k(j)
+ *
+ *   Alla polynom i sums initieras av funktionen.
+ *------------------------------------*/
+static void PowerSums(int max_exp, Poly* sums) {
+    ASSERT(max_exp < POLY_MAX_DEGREE);
+
+    Poly j_plus_one, one;
+    Poly_InitSym(&j_plus_one, POLY_SYM_ITER);
+    Poly_Init(&one, 1);
+    Poly_Add(&j_plus_one, &one, 1);
+
+    for (int d = 0; d <= max_exp; d++) {
+        Poly rhs;
+        Poly_Init(&rhs, 1);
+
+        for (int i = 0; i <= d; i++) {
+            Poly tmp;
+            Poly_Mul(&rhs, &j_plus_one, &tmp);
+            ReplacePoly(&rhs, &tmp);
+        }
+
+        Poly_Add(&rhs, &one, -1);
+
+        long long binom = 1; // binom(d+1, k)
+        for (int k = 0; k < d; k++) {
+            Poly_Add(&rhs, &sums[k], -binom);
+            binom = binom * (d+1-k) / (k+1);
+        }
+
+        // Nu r binom = binom(d+1, d) = d+1.
+        Poly inv;
+        Poly_Init(&inv, 1);
+        inv.denom = binom;
+
+        Poly_Mul(&rhs, &inv, &sums[d]);
+
+        Poly_Free(&inv);
+        Poly_Free(&rhs);
+    }
+
+    Poly_Free(&one);
+    Poly_Free(&j_plus_one);
+}
+
+/*--------------------------------------
+ * Function: SolveAccumulator()
+ * Parameters:
+ *   lv          Ackumulatorn.
+ *   loop_var    Loop-variabeln.
+ *   closed_map  Slutna uttryck fr redan lsta ackumulatorer.
+ *
+ * Description:
+ *   Summerar ackumulatorns kning ver alla iterationer och lagrar vrdet i
+ *   brjan av iteration j i lv->closed, och vrdet efter loopen i lv->final.
+ *   Returnerar falskt om polynomen blev fr stora.
+ *------------------------------------*/
+static Bool SolveAccumulator(LoopVar* lv, int loop_var,
+                             const Poly* const* closed_map)
+{
+    // kningen i en viss iteration beror bara p j och vrdena fre loopen
+    // nr vi satt in de andra ackumulatorernas slutna uttryck.
+    Poly delta;
+    Bool is_ok   = Poly_Compose(&lv->delta, closed_map, closed_map, &delta);
+    int  max_exp = Poly_Degree(&delta, POLY_SYM_ITER);
+
+    if (!is_ok || max_exp >= POLY_MAX_DEGREE) {
+        Poly_Free(&delta);
+        return FALSE;
+    }
+
+    Poly sums[POLY_MAX_DEGREE];
+    PowerSums(max_exp, sums);
+
+    // sum_j(j) = sum(d) coeff_d * S_d(j), dvs summan av kningarna fr
+    // loop-variabelns vrden 1..j.
+    Poly sum_j;
+    Poly_Init(&sum_j, 0);
+
+    for (int d = 0; d <= max_exp && is_ok; d++) {
+        Poly coeff, term;
+        Poly_Coeff(&delta, POLY_SYM_ITER, d, &coeff);
+        is_ok = Poly_Mul(&coeff, &sums[d], &term)
+             && Poly_Add(&sum_j, &term, 1);
+        Poly_Free(&coeff);
+        Poly_Free(&term);
+    }
+
+    for (int d = 0; d <= max_exp; d++)
+        Poly_Free(&sums[d]);
+    Poly_Free(&delta);
+
+    // Loop-variabeln gr frn sitt startvrde ned till ett, s loopen lgger
+    // totalt till sum_j(X<loop_var>), och innan iteration j har den lagt till
+    // sum_j(X<loop_var>) - sum_j(j).
+    const Poly* map[POLY_NUM_SYMS] = { NULL };
+    Poly total, start;
+    Poly_InitSym(&start, loop_var);
+    map[POLY_SYM_ITER] = &start;
+
+    if (is_ok)
+        is_ok = Poly_Compose(&sum_j, map, map, &total);
+    else
+        Poly_Init(&total, 0);
+
+    Poly closed, final;
+    Poly_InitSym(&closed, lv->var);
+    Poly_InitSym(&final, lv->var);
+
+    if (is_ok) {
+        is_ok = Poly_Add(&closed, &total, 1)
+             && Poly_Add(&closed, &sum_j, -1)
+             && Poly_Add(&final, &total, 1);
+    }
+
+    ReplacePoly(&lv->closed, &closed);
+    ReplacePoly(&lv->final, &final);
+
+    Poly_Free(&total);
+    Poly_Free(&start);
+    Poly_Free(&sum_j);
+
+    return is_ok;
+}
+
+/*--------------------------------------
+ * Function: SolveLoop()
+ * Parameters:
+ *   loop_var  Loop-variabeln.
+ *   state     Tillstndet efter en symbolisk krning av loopkroppen.
+ *   result    Sammanfattningen som ska fyllas i.
+ *   reason    Buffert fr frklaringen om loopen inte gr att summera.
+ *
+ * Description:
+ *   Summerar loopen ver alla iterationer, givet vad en iteration gr.
+ *------------------------------------*/
+static Bool SolveLoop(int loop_var, const SymState* state, Sum_Loop* result,
+                      char* reason)
+{
+    LoopVar vars[SUM_MAX_ASSIGNS];
+    int     num_vars   = 0;
+    int     num_values = Array_Length(&state->values);
+
+    // Klassificera alla ndrade variabler.
+    for (int i = 0; i < num_values; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&state->values, i);
+        int         var    = assign->var;
+
+        if (var == loop_var)
+            continue;
+
+        Poly sym;
+        Poly_InitSym(&sym, var);
+        Bool is_invariant = Poly_Equals(&assign->value, &sym);
+        Poly_Free(&sym);
+
+        if (is_invariant)
+            continue;
+
+        int deg = Poly_Degree(&assign->value, var);
+
+        Poly coeff;
+        Poly_Coeff(&assign->value, var, 1, &coeff);
+        long long coeff_val;
+        Bool is_accumulator = (deg == 1 && Poly_GetConst(&coeff, &coeff_val)
+                                        && coeff_val == 1);
+        Poly_Free(&coeff);
+
+        if (deg > 0 && !is_accumulator) {
+            sprintf(reason, "X%d does not grow by a fixed polynomial", var);
+            break;
+        }
+
+        if (num_vars == SUM_MAX_ASSIGNS-1) {
+            sprintf(reason, "the loop changes too many variables");
+            break;
+        }
+
+        LoopVar* lv = &vars[num_vars++];
+        lv->var            = var;
+        lv->is_accumulator = is_accumulator;
+        lv->is_solved      = FALSE;
+        Poly_Copy(&lv->delta, &assign->value);
+        Poly_Init(&lv->closed, 0);
+        Poly_Init(&lv->final, 0);
+
+        if (is_accumulator) {
+            Poly sym;
+            Poly_InitSym(&sym, var);
+            Poly_Add(&lv->delta, &sym, -1);
+            Poly_Free(&sym);
+        }
+    }
+
+    Bool is_ok = (reason[0] == '\0');
+
+    // Variabler som fr ett nytt vrde varje iteration fr inte lsas innan
+    // de tilldelats, fr d beror loopen p fregende iteration.
+    for (int i = 0; i < num_vars && is_ok; i++) {
+        if (vars[i].is_accumulator)
+            continue;
+
+        int  var     = vars[i].var;
+        Bool is_read = FALSE;
+
+        for (int j = 0; j < num_vars; j++)
+            is_read |= (Poly_Degree(&vars[j].delta, var) > 0);
+
+        int num_guards = Array_Length(&state->guards);
+        for (int j = 0; j < num_guards; j++)
+            is_read |= (Poly_Degree(Array_GetElemPtr(&state->guards, j),
+                                    var) > 0);
+
+        if (is_read) {
+            sprintf(reason, "X%d depends on its value from the previous "
+                            "iteration", var);
+            is_ok = FALSE;
+        }
+    }
+
+    // Ls ackumulatorerna i beroendeordning.
+    const Poly* closed_map[POLY_NUM_SYMS] = { NULL };
+    while (is_ok) {
+        LoopVar* next = NULL;
+
+        for (int i = 0; i < num_vars && next == NULL; i++) {
+            if (!vars[i].is_accumulator || vars[i].is_solved)
+                continue;
+
+            Bool is_ready = TRUE;
+            for (int j = 0; j < num_vars; j++) {
+                if (vars[j].is_accumulator && !vars[j].is_solved
+                 && Poly_Degree(&vars[i].delta, vars[j].var) > 0)
+                {
+                    is_ready = FALSE;
+                }
+            }
+
+            if (is_ready)
+                next = &vars[i];
+        }
+
+        if (next == NULL) {
+            for (int i = 0; i < num_vars; i++) {
+                if (vars[i].is_accumulator && !vars[i].is_solved) {
+                    sprintf(reason, "X%d depends on itself through another "
+                                    "variable", vars[i].var);
+                    is_ok = FALSE;
+                    break;
+                }
+            }
+
+            break;
+        }
+
+        if (!SolveAccumulator(next, loop_var, closed_map)) {
+            sprintf(reason, REASON_TOO_LARGE);
+            is_ok = FALSE;
+            break;
+        }
+
+        next->is_solved = TRUE;
+        closed_map[next->var] = &next->closed;
+    }
+
+    // Variabler som fr nya vrden fr de vrden de fick i sista iterationen,
+    // d loop-variabeln var ett.
+    const Poly* last_map[POLY_NUM_SYMS]  = { NULL };
+    const Poly* start_map[POLY_NUM_SYMS] = { NULL };
+    Poly        one, start;
+    Poly_Init(&one, 1);
+    Poly_InitSym(&start, loop_var);
+    last_map[POLY_SYM_ITER]  = &one;
+    start_map[POLY_SYM_ITER] = &start;
+
+    Bool has_resets = FALSE;
+    for (int i = 0; i < num_vars && is_ok; i++) {
+        if (vars[i].is_accumulator)
+            continue;
+
+        Poly last, final;
+        is_ok = Poly_Compose(&vars[i].delta, closed_map, closed_map, &last);
+        if (is_ok) {
+            is_ok = Poly_Compose(&last, last_map, last_map, &final);
+            ReplacePoly(&vars[i].final, &final);
+        }
+        Poly_Free(&last);
+
+        if (!is_ok)
+            sprintf(reason, REASON_TOO_LARGE);
+
+        has_resets = TRUE;
+    }
+
+    // Villkoren ska glla i varje iteration. Efter att ha satt in de slutna
+    // uttrycken beror de bara p j, som ligger mellan 1 och loop-variabelns
+    // startvrde, s vi fr en undre grns genom att vlja j = 1 i positiva
+    // termer och j = startvrdet i negativa.
+    int num_guards = Array_Length(&state->guards);
+    for (int i = 0; i < num_guards && is_ok; i++) {
+        Poly guard, bound;
+        is_ok = Poly_Compose(Array_GetElemPtr(&state->guards, i), closed_map,
+                             closed_map, &guard)
+             && Poly_Compose(&guard, last_map, start_map, &bound);
+        Poly_Free(&guard);
+
+        if (is_ok)
+            is_ok = AddGuard(&result->guards, &bound, reason);
+        else
+            sprintf(reason, REASON_TOO_LARGE);
+    }
+
+    // Om loopen aldrig krs behller de tilldelade variablerna sina gamla
+    // vrden, och det kan polynomen inte uttrycka.
+    if (is_ok && has_resets) {
+        Poly guard;
+        Poly_InitSym(&guard, loop_var);
+        Poly_Add(&guard, &one, -1);
+        is_ok = AddGuard(&result->guards, &guard, reason);
+    }
+
+    if (is_ok) {
+        Sum_Assign assign = { .var = loop_var };
+        Poly_Init(&assign.value, 0);
+        Array_AddElem(&result->assigns, &assign);
+
+        for (int i = 0; i < num_vars; i++) {
+            assign.var = vars[i].var;
+            Poly_Copy(&assign.value, &vars[i].final);
+            Array_AddElem(&result->assigns, &assign);
+        }
+    }
+
+    for (int i = 0; i < num_vars; i++) {
+        Poly_Free(&vars[i].delta);
+        Poly_Free(&vars[i].closed);
+        Poly_Free(&vars[i].final);
+    }
+
+    Poly_Free(&one);
+    Poly_Free(&start);
+
+    return is_ok;
+}
+
+/*--------------------------------------
+ * Function: RenumberPoly()
+ * Parameters:
+ *   p          Polynomet vars variabler ska numreras om.
+ *   slots      Den nya platsen fr varje variabel.
+ *   sym_polys  Array med POLY_NUM_SYMS polynom, se map.
+ *   map        Array med POLY_NUM_SYMS pekare. Element som r NULL initieras
+ *              av funktionen till att peka p motsvarande polynom i
+ *              sym_polys, som i sin tur initieras till den nya symbolen.
+ *
+ * Description:
+ *   Byter ut alla variabler i ett polynom mot deras nya platser.
+ *------------------------------------*/
+static void RenumberPoly(Poly* p, const int* slots, Poly* sym_polys,
+                         const Poly** map)
+{
+    int num_terms = Array_Length(&p->terms);
+    for (int i = 0; i < num_terms; i++) {
+        Poly_Term* term = Array_GetElemPtr(&p->terms, i);
+        for (int j = 0; j < term->degree; j++) {
+            int sym = term->syms[j];
+            if (sym == POLY_SYM_ITER || map[sym] != NULL)
+                continue;
+
+            Poly_InitSym(&sym_polys[sym], slots[sym]);
+            map[sym] = &sym_polys[sym];
+        }
+    }
+
+    // Att byta namn p symbolerna kan inte gra koefficienterna strre, s
+    // det hr kan inte misslyckas.
+    Poly result;
+    Bool is_ok = Poly_Compose(p, map, map, &result);
+    ASSERT(is_ok);
+
+    ReplacePoly(p, &result);
+}
+
+/*--------------------------------------
+ * Function: SummarizeLoop()
+ * Parameters:
+ *   loop    While-noden som ska sammanfattas.
+ *   max     Det strsta vrde en variabel kan ha, se Sum_SummarizeTree().
+ *   reason  Buffert fr frklaringen om loopen inte gr att sammanfatta.
+ *
+ * Description:
+ *   Frsker sammanfatta en loop. Returnerar sammanfattningen, eller NULL om
+ *   det inte gick.
+ *------------------------------------*/
+static Sum_Loop* SummarizeLoop(const AST_Node* loop, long long max,
+                               char* reason)
+{
+    int loop_var = *(int*)Array_GetElemPtr(&loop->values, 0);
+
+    reason[0] = '\0';
+
+    if (!IsValidVar(loop_var)) {
+        sprintf(reason, "the loop uses an invalid variable");
+        return NULL;
+    }
+
+    SymState state;
+    Array_Init(&state.values, sizeof(Sum_Assign));
+    Array_Init(&state.guards, sizeof(Poly));
+    state.max = max;
+
+    // Inuti loopen har loop-variabeln vrdet j i brjan av iterationen.
+    Poly iter;
+    Poly_InitSym(&iter, POLY_SYM_ITER);
+    SetValue(&state, loop_var, &iter);
+
+    Bool is_ok = ExecSymbolic(loop, &state, reason);
+
+    if (is_ok) {
+        Poly expected, one, actual;
+        Poly_InitSym(&expected, POLY_SYM_ITER);
+        Poly_Init(&one, 1);
+        Poly_Add(&expected, &one, -1);
+        GetValue(&state, loop_var, &actual);
+
+        if (!Poly_Equals(&actual, &expected)) {
+            sprintf(reason, "X%d is not decreased by exactly one per "
+                            "iteration", loop_var);
+            is_ok = FALSE;
+        }
+
+        Poly_Free(&expected);
+        Poly_Free(&one);
+        Poly_Free(&actual);
+    }
+
+    Sum_Loop* sum = malloc(sizeof(Sum_Loop));
+    Array_Init(&sum->assigns, sizeof(Sum_Assign));
+    Array_Init(&sum->guards, sizeof(Poly));
+
+    if (is_ok)
+        is_ok = SolveLoop(loop_var, &state, sum, reason);
+
+    FreeAssigns(&state.values);
+    FreeGuards(&state.guards);
+
+    if (!is_ok) {
+        Sum_Free(sum);
+        return NULL;
+    }
+
+    return sum;
+}
+
+/*--------------------------------------
+ * Function: SummarizeNode()
+ * Parameters:
+ *   node    Noden vars loopar ska sammanfattas.
+ *   depth   Nstlingsdjupet.
+ *   max     Det strsta vrde en variabel kan ha, se Sum_SummarizeTree().
+ *   report  Array med ReportEntry-element dr resultatet ska lagras.
+ *
+ * Description:
+ *   Sammanfattar alla loopar bland nodens barn, inifrn och ut. Returnerar
+ *   antalet sammanfattade loopar.
+ *------------------------------------*/
+static int SummarizeNode(AST_Node* node, int depth, long long max,
+                         Array* report)
+{
+    int num_summarized = 0;
+
+    int num_children = Array_Length(&node->children);
+    for (int i = 0; i < num_children; i++) {
+        AST_Node* child = Array_GetElemPtr(&node->children, i);
+
+        if (child->type != AST_WHILE)
+            continue;
+
+        // Raden i rapporten lggs till frst, s att rapporten hamnar i
+        // samma ordning som kllkoden trots att vi brjar med de inre
+        // looparna.
+        ReportEntry entry = { .loop = child, .depth = depth };
+        int         index = Array_Length(report);
+        Array_AddElem(report, &entry);
+
+        num_summarized += SummarizeNode(child, depth+1, max, report);
+
+        ReportEntry* e = Array_GetElemPtr(report, index);
+        child->summary = SummarizeLoop(child, max, e->reason);
+        if (child->summary != NULL)
+            num_summarized++;
+    }
+
+    return num_summarized;
+}
+
+/*--------------------------------------
+ * Function: PrintReport()
+ * Parameters:
+ *   report  Array med ReportEntry-element.
+ *
+ * Description:
+ *   Skriver ut rapporten ver alla loopar.
+ *------------------------------------*/
+static void PrintReport(const Array* report) {
+    int num_entries = Array_Length(report);
+
+    printf("\nLoop report:\n");
+    if (num_entries == 0)
+        printf("  (no loops)\n");
+
+    for (int i = 0; i < num_entries; i++) {
+        ReportEntry* entry = Array_GetElemPtr(report, i);
+        int          var   = *(int*)Array_GetElemPtr(&entry->loop->values, 0);
+
+        printf("  %*sWHILE X%d: ", 4*entry->depth, "", var);
+
+        const Sum_Loop* sum = entry->loop->summary;
+        if (sum == NULL) {
+            printf("not accelerated, %s\n", entry->reason);
+            continue;
+        }
+
+        int num_guards = Array_Length(&sum->guards);
+        printf("accelerated (%d runtime check%s)\n", num_guards,
+               (num_guards == 1) ? "" : "s");
+
+        int num_assigns = Array_Length(&sum->assigns);
+        for (int j = 0; j < num_assigns; j++) {
+            Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, j);
+            printf("  %*sX%d := ", 4*entry->depth + 4, "", assign->var);
+            Poly_Print(&assign->value);
+            printf("\n");
+        }
+    }
+
+    printf("\n");
+}
+
+/*--------------------------------------
+ * Function: Sum_Apply()
+ * Parameters:
+ *   sum   Sammanfattningen av loopen.
+ *   vars  Variabel-arrayen.
+ *
+ * Description:
+ *   Frsker kra en loop med hjlp av dess sammanfattning. Returnerar falskt,
+ *   utan att rra variablerna, om sammanfattningen inte gller fr de
+ *   aktuella vrdena, och loopen mste d kras som vanligt.
+ *------------------------------------*/
+Bool Sum_Apply(const Sum_Loop* sum, int* vars) {
+    int num_guards = Array_Length(&sum->guards);
+    for (int i = 0; i < num_guards; i++) {
+        long long value;
+        if (!Poly_Eval(Array_GetElemPtr(&sum->guards, i), vars, &value)
+         || value < 0)
+        {
+            return FALSE;
+        }
+    }
+
+    // Alla vrden rknas ut innan ngot skrivs tillbaka, eftersom polynomen
+    // gller variablernas vrden fre loopen.
+    long long values[SUM_MAX_ASSIGNS];
+    int       num_assigns = Array_Length(&sum->assigns);
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        if (!Poly_Eval(&assign->value, vars, &values[i])
+         || values[i] < 0 || values[i] > INT_MAX)
+        {
+            return FALSE;
+        }
+    }
+
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        vars[assign->var] = (int)values[i];
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Sum_Apply64()
+ * Parameters:
+ *   sum   Sammanfattningen av loopen.
+ *   vars  Variabel-arrayen.
+ *
+ * Description:
+ *   Som Sum_Apply(), men med 64-bitars variabler. Sammanfattningen mste ha
+ *   gjorts med SUM_MAX_INT64 som strsta vrde, se Sum_SummarizeTree().
+ *------------------------------------*/
+Bool Sum_Apply64(const Sum_Loop* sum, long long* vars) {
+    int num_guards = Array_Length(&sum->guards);
+    for (int i = 0; i < num_guards; i++) {
+        long long value;
+        if (!Poly_Eval64(Array_GetElemPtr(&sum->guards, i), vars, &value)
+         || value < 0)
+        {
+            return FALSE;
+        }
+    }
+
+    long long values[SUM_MAX_ASSIGNS];
+    int       num_assigns = Array_Length(&sum->assigns);
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        if (!Poly_Eval64(&assign->value, vars, &values[i]) || values[i] < 0)
+            return FALSE;
+    }
+
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        vars[assign->var] = values[i];
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Sum_Free()
+ * Parameters:
+ *   sum  Sammanfattningen som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper en sammanfattning ur minnet.
+ *------------------------------------*/
+void Sum_Free(Sum_Loop* sum) {
+    FreeAssigns(&sum->assigns);
+    FreeGuards(&sum->guards);
+    free(sum);
+}
+
+/*--------------------------------------
+ * Function: Sum_Renumber()
+ * Parameters:
+ *   sum    Sammanfattningen vars variabler ska numreras om.
+ *   slots  Den nya platsen fr varje variabel som frekommer i
+ *          sammanfattningen.
+ *
+ * Description:
+ *   Numrerar om variablerna i en sammanfattning, se AST_ResolveVars().
+ *------------------------------------*/
+void Sum_Renumber(Sum_Loop* sum, const int* slots) {
+    // Poly_Compose() sorterar om termerna t oss, s vi erstter helt enkelt
+    // varje variabel med en symbol fr dess nya plats.
+    Poly*        sym_polys = malloc(POLY_NUM_SYMS * sizeof(Poly));
+    const Poly** map       = calloc(POLY_NUM_SYMS, sizeof(Poly*));
+
+    int num_assigns = Array_Length(&sum->assigns);
+    for (int i = 0; i < num_assigns; i++) {
+        Sum_Assign* assign = Array_GetElemPtr(&sum->assigns, i);
+        assign->var = slots[assign->var];
+        RenumberPoly(&assign->value, slots, sym_polys, map);
+    }
+
+    int num_guards = Array_Length(&sum->guards);
+    for (int i = 0; i < num_guards; i++) {
+        Poly* guard = Array_GetElemPtr(&sum->guards, i);
+        RenumberPoly(guard, slots, sym_polys, map);
+    }
+
+    for (int i = 0; i < POLY_NUM_SYMS; i++) {
+        if (map[i] != NULL)
+            Poly_Free(&sym_polys[i]);
+    }
+
+    free(sym_polys);
+    free(map);
+}
+
+/*--------------------------------------
+ * Function: Sum_SummarizeTree()
+ * Parameters:
+ *   root          Root-noden i det AST vars loopar ska sammanfattas.
+ *   max           Det strsta vrde en variabel kan ha innan den ger
+ *                 overflow, dvs INT_MAX fr Sum_Apply() och SUM_MAX_INT64
+ *                 fr Sum_Apply64().
+ *   print_report  Sant om en rapport ver alla loopar ska skrivas ut.
+ *
+ * Description:
+ *   Frsker rkna ut ett slutet uttryck fr varje while-loop i trdet och
+ *   lagrar det i nodens summary-flt. Loopar som inte gr att sammanfatta
+ *   lmnas orrda. Returnerar antalet sammanfattade loopar.
+ *------------------------------------*/
+int Sum_SummarizeTree(AST_Node* root, long long max, Bool print_report) {
+    ASSERT(root->type == AST_PROGRAM);
+
+    Array report;
+    Array_Init(&report, sizeof(ReportEntry));
+
+    int num_summarized = SummarizeNode(root, 0, max, &report);
+
+    if (print_report)
+        PrintReport(&report);
+
+    Array_Free(&report);
+
+    return num_summarized;
+}
@@ -0,0 +1,151 @@
+/*------------------------------------------------------------------------------
+ * File: summary.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Rknar ut slutna uttryck fr nstlade rkne-loopar, s att en loop som
+ *   X1 := X1 + X2*X3 kan kras med en enda berkning istllet fr X2*X3
+ *   iterationer.
+ *
+ * Changes:
+ *   * Sum_Renumber() fr AST_ResolveVars().
+ *   * Sum_Apply64() och ett strsta vrde till Sum_SummarizeTree(), fr
+ *     -int64.
+ *----------------------------------------------------------------------------*/
+
+#ifndef SUMMARY_H_
+#define SUMMARY_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "array.h"
+#include "ast.h"
+#include "common.h"
+#include "poly.h"
+
+#include <limits.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: SUM_MAX_ASSIGNS
+ *
+ * Description:
+ *   Det strsta antal variabler en sammanfattad loop fr ndra.
+ *------------------------------------*/
+#define SUM_MAX_ASSIGNS 32
+
+/*--------------------------------------
+ * Constant: SUM_MAX_INT64
+ *
+ * Description:
+ *   Det strsta vrde som sammanfattningar fr 64-bitars variabler rknar
+ *   med. Polynomen behver marginal fr nmnare och konstanttermer, s vi kan
+ *   inte anvnda LLONG_MAX. Loopar som kommer ver grnsen krs som vanligt.
+ *------------------------------------*/
+#define SUM_MAX_INT64 (LLONG_MAX / 2)
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Sum_Assign
+ *
+ * Description:
+ *   Ett variabelvrde efter loopen, uttryckt i variablernas vrden innan
+ *   loopen.
+ *------------------------------------*/
+typedef struct {
+    int  var;
+    Poly value;
+} Sum_Assign;
+
+/*--------------------------------------
+ * Type: Sum_Loop
+ *
+ * Description:
+ *   En sammanfattning av en hel loop. Alla polynom i guards mste vara strre
+ *   n eller lika med noll fr att tilldelningarna i assigns ska ge samma
+ *   resultat som loopen. Annars mste loopen kras som vanligt.
+ *------------------------------------*/
+typedef struct Sum_Loop {
+    Array assigns;
+    Array guards;
+} Sum_Loop;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Sum_Apply()
+ * Parameters:
+ *   sum   Sammanfattningen av loopen.
+ *   vars  Variabel-arrayen.
+ *
+ * Description:
+ *   Frsker kra en loop med hjlp av dess sammanfattning. Returnerar falskt,
+ *   utan att rra variablerna, om sammanfattningen inte gller fr de
+ *   aktuella vrdena, och loopen mste d kras som vanligt.
+ *------------------------------------*/
+Bool Sum_Apply(const Sum_Loop* sum, int* vars);
+
+/*--------------------------------------
+ * Function: Sum_Apply64()
+ * Parameters:
+ *   sum   Sammanfattningen av loopen.
+ *   vars  Variabel-arrayen.
+ *
+ * Description:
+ *   Som Sum_Apply(), men med 64-bitars variabler. Sammanfattningen mste ha
+ *   gjorts med SUM_MAX_INT64 som strsta vrde, se Sum_SummarizeTree().
+ *------------------------------------*/
+Bool Sum_Apply64(const Sum_Loop* sum, long long* vars);
+
+/*--------------------------------------
+ * Function: Sum_Free()
+ * Parameters:
+ *   sum  Sammanfattningen som ska slppas ur minnet.
+ *
+ * Description:
+ *   Slpper en sammanfattning ur minnet.
+ *------------------------------------*/
+void Sum_Free(Sum_Loop* sum);
+
+/*--------------------------------------
+ * Function: Sum_Renumber()
+ * Parameters:
+ *   sum    Sammanfattningen vars variabler ska numreras om.
+ *   slots  Den nya platsen fr varje variabel som frekommer i
+ *          sammanfattningen.
+ *
+ * Description:
+ *   Numrerar om variablerna i en sammanfattning, se AST_ResolveVars().
+ *------------------------------------*/
+void Sum_Renumber(Sum_Loop* sum, const int* slots);
+
+/*--------------------------------------
+ * Function: Sum_SummarizeTree()
+ * Parameters:
+ *   root          Root-noden i det AST vars loopar ska sammanfattas.
+ *   max           Det strsta vrde en variabel kan ha innan den ger
+ *                 overflow, dvs INT_MAX fr Sum_Apply() och SUM_MAX_INT64
+ *                 fr Sum_Apply64().
+ *   print_report  Sant om en rapport ver alla loopar ska skrivas ut.
+ *
+ * Description:
+ *   Frsker rkna ut ett slutet uttryck fr varje while-loop i trdet och
+ *   lagrar det i nodens summary-flt. Loopar som inte gr att sammanfatta
+ *   lmnas orrda. Returnerar antalet sammanfattade loopar.
+ *------------------------------------*/
+int Sum_SummarizeTree(AST_Node* root, long long max, Bool print_report);
+
+#endif // SUMMARY_H_
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: syntax.c
  * Created: January 3, 2015
- * Last changed: February 19, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -18,13 +18,30 @@
  *     ersatte det med en varning istllet. Tilldelning av andra vrden n noll
  *     r nu tilltna.
  *   * Felkontroll fr heltal.
+ *   * Anvnder de variabelnummer och heltal som Tok_Tokenize() avkodat, och
+ *     heltal som inte ryms i en int r fel.
+ *   * Lser kllkoden en token i taget med Tok_Next(), istllet fr att g
+ *     igenom en token-array.
+ *   * Syn_Parse() bygger syntax-trdet i samma pass som syntaxen verifieras.
+ *   * Ersatte CheckLoopFinite(), som lste varje loop i frvg, med en stack
+ *     av ppna loopar som uppdateras medan kllkoden lses. Kontrollen tar
+ *     nu linjr tid ven fr djupt nstlade loopar.
+ *   * De ppna looparna som nnu inte kan ta slut ligger i en lista fr
+ *     varje variabel, s att en tilldelning inte behver g igenom alla
+ *     ppna loopar, och CheckSyntax() rknar bara de fel som tillkommit
+ *     sedan frra satsen.
+ *   * Syn_PrintError() hittar raden med felet via Syntax_Error.offset,
+ *     istllet fr att rkna rader frn brjan av kllkoden.
+ *   * Syntax-trdet och felmeddelandena kan allokeras ur en arena.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
  * INCLUDES
  *----------------------------------------------*/
 
+#include "arena.h"
 #include "array.h"
+#include "ast.h"
 #include "common.h"
 #include "debug.h"
 #include "string.h"
@@ -33,6 +50,7 @@
 #include "vm.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 /*------------------------------------------------
  * CONSTANTS
@@ -67,10 +85,144 @@
  *------------------------------------*/
 #define MAX_INT_LEN 11
 
+/*--------------------------------------
+ * Constant: MAX_TEXT_LEN
+ *
+ * Description:
+ *   Det strsta antal tecken frn en token som tas med i ett felmeddelande.
+ *------------------------------------*/
+#define MAX_TEXT_LEN 64
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Open_Loop
+ *
+ * Description:
+ *   En while-loop vars slut inte har lsts nnu. depth r antalet WHILE
+ *   minus antalet END fre loopens frsta sats, och slot r platsen i
+ *   errors-arrayen dr varningen hamnar om loop-variabeln aldrig rknas ned
+ *   eller nollstlls. next_pending r index fr nsta loop i samma lista,
+ *   se Loop_Tracker.
+ *------------------------------------*/
+typedef struct {
+    P_Token while_tok;
+    int     depth;
+    int     slot;
+    Bool    is_finite;
+    int     next_pending;
+} Open_Loop;
+
+/*--------------------------------------
+ * Type: Loop_Tracker
+ *
+ * Description:
+ *   Hller reda p de ppna while-looparna medan kllkoden lses, s att
+ *   varje tilldelning kan markera de loopar den kan avsluta. Kontrollen bryr
+ *   sig inte om syntaxen, utan rknar WHILE och END och letar efter
+ *   "<variabel> :=" bland alla tokens, s att varningarna blir desamma ven
+ *   i trasiga program.
+ *
+ *   Om has_assign r sant har vi lst "<variabel> :=" men inte vrdet, och
+ *   d r assign_var variabeln och num_assign_loops antalet loopar som var
+ *   ppna vid tilldelningen.
+ *
+ *   pending[X] r index fr den senast ppnade loopen med X i villkoret som
+ *   nnu inte kan ta slut, eller -1. Drifrn lnkar next_pending vidare
+ *   till de tidigare, s varje lista r sorterad med de innersta looparna
+ *   frst. Loopar med ogiltiga variabler delar p listan pending_other.
+ *   En loop tas bort ur sin lista nr den markeras som ndlig eller stngs,
+ *   s varje tilldelning kostar bara lika mycket som de loopar den markerar.
+ *
+ *   num_actual_errors r antalet egentliga fel, allts inte varningar, bland
+ *   de num_counted frsta platserna i errors, se CountActualErrors().
+ *------------------------------------*/
+typedef struct {
+    Array       loops;
+    Array*      errors;
+    const char* source;
+    P_Token     prev_tok;
+    int         depth;
+    int         last_offset;
+    Bool        has_assign;
+    int         assign_var;
+    int         num_assign_loops;
+    int         pending[PLANG_NUM_VARS];
+    int         pending_other;
+    int         num_counted;
+    int         num_actual_errors;
+} Loop_Tracker;
+
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
+/*--------------------------------------
+ * Function: AddNode()
+ * Parameters:
+ *   parent  Noden som den nya noden ska lggas i, eller NULL om inget
+ *           syntax-trd byggs.
+ *   type    Typen av den nya noden.
+ *   tok     Nodens frsta token.
+ *
+ * Description:
+ *   Skapar en nod med samma rad och kolumn som dess frsta token, lgger
+ *   den som barn till parent och returnerar den. Noden allokeras i samma
+ *   arena som parent. Returnerar NULL om parent r NULL.
+ *------------------------------------*/
+static AST_Node* AddNode(AST_Node* parent, AST_Node_Type type,
+                         const P_Token* tok)
+{
+    if (!parent)
+        return NULL;
+
+    AST_Node node = AST_CreateNode(type, parent->children.arena);
+
+    node.row = tok->row;
+    node.col = tok->col;
+
+    return AST_AddChild(parent, &node);
+}
+
+/*--------------------------------------
+ * Function: GetText()
+ * Parameters:
+ *   tok     Den token vars text ska hmtas.
+ *   source  Kllkoden, eller NULL.
+ *   buf     Bufferten som texten kan kopieras till. Den mste rymma
+ *           MAX_TEXT_LEN+1 tecken.
+ *
+ * Description:
+ *   Returnerar tokenens text i kllkoden fr variabler och heltal, s att
+ *   man kan se deras innehll direkt, och annars Tok_GetString().
+ *------------------------------------*/
+static const char* GetText(const P_Token* tok, const char* source, char* buf) {
+    if (source && (tok->type == PTOK_IDENT || tok->type == PTOK_INT))
+        return Tok_CopyText(tok, source, buf, MAX_TEXT_LEN+1);
+
+    return Tok_GetString(tok);
+}
+
+/*--------------------------------------
+ * Function: DuplicateText()
+ * Parameters:
+ *   errors  Den array som felet ska lggas i.
+ *   text    Felmeddelandet.
+ *
+ * Description:
+ *   Kopierar ett felmeddelande. Kopian allokeras i samma arena som errors,
+ *   eller med Str_Duplicate() om errors inte ligger i ngon arena. Alla fel i
+ *   en array slpps drmed p samma stt, se Syn_Parse().
+ *------------------------------------*/
+static char* DuplicateText(const Array* errors, const char* text) {
+    if (errors->arena)
+        return Arena_Duplicate(errors->arena, text);
+
+    return Str_Duplicate(text);
+}
+
 /*--------------------------------------
  * Function: ErrInvalidIdent()
  * Parameters:
@@ -86,13 +238,12 @@ static void ErrInvalidIdent(Array* errors, const char* source,
 {
     Syntax_Error error;
 
-    // Vi anvnder Str_Duplicate hr s att det r ok att kra free() p alla
-    // felmeddelanden.
-    error.text       = Str_Duplicate("invalid identifier");
+    error.text       = DuplicateText(errors, "invalid identifier");
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 }
@@ -112,13 +263,12 @@ static void ErrInvalidInt(Array* errors, const char* source,
 {
     Syntax_Error error;
 
-    // Vi anvnder Str_Duplicate hr s att det r ok att kra free() p alla
-    // felmeddelanden.
-    error.text       = Str_Duplicate("invalid integer");
+    error.text       = DuplicateText(errors, "invalid integer");
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 }
@@ -139,13 +289,12 @@ static void ErrLoopTestAgainstNonZero(Array* errors, const char* source,
 {
     Syntax_Error error;
 
-    // Vi anvnder Str_Duplicate hr s att det r ok att kra free() p alla
-    // felmeddelanden.
-    error.text       = Str_Duplicate("this must be zero");
+    error.text       = DuplicateText(errors, "this must be zero");
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 }
@@ -164,15 +313,17 @@ static void ErrUnexpectedToken(Array* errors, const char* source,
                                const P_Token* tok)
 {
     char         buf[1024];
+    char         text[MAX_TEXT_LEN+1];
     Syntax_Error error;
 
-    sprintf(buf, "unexpected token: %s", Tok_GetString(tok));
+    sprintf(buf, "unexpected token: %s", GetText(tok, source, text));
 
-    error.text       = Str_Duplicate(buf);
+    error.text       = DuplicateText(errors, buf);
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 }
@@ -195,6 +346,7 @@ static Bool ExpectToken(Array* errors, const char* source, const P_Token* tok,
         return TRUE;
 
     char         buf[1024];
+    char         text[MAX_TEXT_LEN+1];
     Syntax_Error error;
     const char*  str;
     P_Token      tmp_tok = { .type = expected };
@@ -203,13 +355,14 @@ static Bool ExpectToken(Array* errors, const char* source, const P_Token* tok,
     else if (expected == PTOK_INT)   { str = "integer";               }
     else                             { str = Tok_GetString(&tmp_tok); }
 
-    sprintf(buf, "expected %s but got %s", str, Tok_GetString(tok));
+    sprintf(buf, "expected %s but got %s", str, GetText(tok, source, text));
 
-    error.text       = Str_Duplicate(buf);
+    error.text       = DuplicateText(errors, buf);
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 
@@ -236,6 +389,7 @@ static Bool ExpectToken2(Array* errors, const char* source, const P_Token* tok,
         return TRUE;
 
     char         buf[1024];
+    char         text[MAX_TEXT_LEN+1];
     Syntax_Error error;
     const char*  str1;
     const char*  str2;
@@ -251,13 +405,14 @@ static Bool ExpectToken2(Array* errors, const char* source, const P_Token* tok,
     else                              { str2 = Tok_GetString(&tmp_tok2); }
 
     sprintf(buf, "expected %s or %s but got %s", str1, str2,
-            Tok_GetString(tok));
+            GetText(tok, source, text));
 
-    error.text       = Str_Duplicate(buf);
+    error.text       = DuplicateText(errors, buf);
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 
@@ -289,6 +444,7 @@ static Bool ExpectToken3(Array* errors, const char* source, const P_Token* tok,
     }
 
     char         buf[1024];
+    char         text[MAX_TEXT_LEN+1];
     Syntax_Error error;
     const char*  str1;
     const char*  str2;
@@ -310,13 +466,14 @@ static Bool ExpectToken3(Array* errors, const char* source, const P_Token* tok,
     else                              { str3 = Tok_GetString(&tmp_tok3); }
 
     sprintf(buf, "expected %s or %s or %s but got %s", str1, str2, str3,
-            Tok_GetString(tok));
+            GetText(tok, source, text));
 
-    error.text       = Str_Duplicate(buf);
+    error.text       = DuplicateText(errors, buf);
     error.is_warning = FALSE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 
@@ -338,13 +495,13 @@ static void WarnEmptyLoop(Array* errors, const char* source,
 {
     Syntax_Error error;
 
-    // Vi anvnder Str_Duplicate hr s att det r ok att kra free() p alla
-    // felmeddelanden.
-    error.text       = Str_Duplicate("loop is empty and will never finish");
+    error.text       = DuplicateText(errors,
+                                     "loop is empty and will never finish");
     error.is_warning = TRUE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 }
@@ -365,13 +522,12 @@ static void WarnAssignNonZero(Array* errors, const char* source,
 {
     Syntax_Error error;
 
-    // Vi anvnder Str_Duplicate hr s att det r ok att kra free() p alla
-    // felmeddelanden.
-    error.text       = Str_Duplicate("assigned value is non-zero");
+    error.text       = DuplicateText(errors, "assigned value is non-zero");
     error.is_warning = TRUE;
     error.source     = source;
     error.row        = tok->row;
     error.col        = tok->col;
+    error.offset     = tok->offset;
 
     Array_AddElem(errors, &error);
 }
@@ -380,27 +536,29 @@ static void WarnAssignNonZero(Array* errors, const char* source,
  * Function: WarnInfiniteLoop()
  * Parameters:
  *   errors  Den array som varningen ska lggas i.
+ *   slot    Platsen i errors som reserverats fr varningen.
  *   source  Kllkoden, eller NULL.
  *   tok     Den token som felet upptcktes vid.
  *
  * Description:
  *   Genererar en varning om ondlig while-loop.
  *------------------------------------*/
-static void WarnInfiniteLoop(Array* errors, const char* source,
+static void WarnInfiniteLoop(Array* errors, int slot, const char* source,
                              const P_Token* tok)
 {
-    char         buf[1024];
-    Syntax_Error error;
-
-    sprintf(buf, "the conditional loop var %s is never modified", tok->value);
-
-    error.text       = Str_Duplicate(buf);
-    error.is_warning = TRUE;
-    error.source     = source;
-    error.row        = tok->row;
-    error.col        = tok->col;
-
-    Array_AddElem(errors, &error);
+    char          buf[1024];
+    char          text[MAX_TEXT_LEN+1];
+    Syntax_Error* error = Array_GetElemPtr(errors, slot);
+
+    sprintf(buf, "the conditional loop var %s is never modified",
+            GetText(tok, source, text));
+
+    error->text       = DuplicateText(errors, buf);
+    error->is_warning = TRUE;
+    error->source     = source;
+    error->row        = tok->row;
+    error->col        = tok->col;
+    error->offset     = tok->offset;
 }
 
 /*--------------------------------------
@@ -416,30 +574,23 @@ static void WarnInfiniteLoop(Array* errors, const char* source,
 static void CheckIdent(Array* errors, const char* source,
                        const P_Token* ident_tok)
 {
-    if (!ident_tok->value) {
+    // Tok_Tokenize() har redan sett till att variabler brjar med X, och
+    // avkodat talet efter det.
+    if (ident_tok->type != PTOK_IDENT) {
         ErrInvalidIdent(errors, source, ident_tok);
         return;
     }
 
-    int len = strlen(ident_tok->value);
+    int len = ident_tok->length;
     if (len<2 || len>MAX_IDENT_LEN) {
         ErrInvalidIdent(errors, source, ident_tok);
         return;
     }
 
-    if (Chr_ToLower(ident_tok->value[0]) != 'x') {
-        ErrInvalidIdent(errors, source, ident_tok);
-        return;
-    }
-
-    if (!Str_IsNumeric(ident_tok->value+1)) {
-        ErrInvalidIdent(errors, source, ident_tok);
-        return;
-    }
-
-    // Talet i variabelns namn mste referera en giltig plats i minnet.
-    int var = atoi(ident_tok->value+1);
-    if (var < 0 || var >= PLANG_NUM_VARS)
+    // Talet i variabelns namn mste referera en giltig plats i minnet. Om
+    // det inte bara r siffror r value negativt.
+    int var = ident_tok->value;
+    if (ident_tok->overflow || var < 0 || var >= PLANG_NUM_VARS)
         ErrInvalidIdent(errors, source, ident_tok);
 }
 
@@ -456,190 +607,417 @@ static void CheckIdent(Array* errors, const char* source,
 static void CheckInt(Array* errors, const char* source,
                      const P_Token* int_tok)
 {
-    if (!int_tok->value) {
+    // Tok_Tokenize() ger bara tokens med enbart siffror typen PTOK_INT.
+    if (int_tok->type != PTOK_INT) {
         ErrInvalidInt(errors, source, int_tok);
         return;
     }
 
-    int len = strlen(int_tok->value);
+    int len = int_tok->length;
     if (len<1 || len>MAX_INT_LEN) {
         ErrInvalidInt(errors, source, int_tok);
         return;
     }
 
-    if (!Str_IsNumeric(int_tok->value))
+    // Syntax-trdet lagrar heltalen i en int.
+    if (int_tok->overflow)
         ErrInvalidInt(errors, source, int_tok);
 }
 
 /*--------------------------------------
- * Function: CheckLoopFinite()
+ * Function: PendingLoops()
  * Parameters:
- *   index      Det index i token-arrayen som verifieringen ska brja p.
- *   errors     Den array som alla eventuella fel ska lagras i.
- *   source     Kllkoden, eller NULL.
- *   while_tok  Den token som innehller loop-variabeln.
+ *   tracker  Loop-kontrollen.
+ *   var      Variabeln i loop-villkoret.
  *
  * Description:
- *   Verifierar att loop-variabeln modifieras inuti while-loopen. Annars
- *   genereras en varning om detta.
+ *   Returnerar brjan p listan med de ppna loopar med var i villkoret som
+ *   nnu inte kan ta slut, se Loop_Tracker.
  *------------------------------------*/
-static void CheckLoopFinite(int index, const Array* tokens, Array* errors,
-                            const char* source, P_Token* while_tok)
-{
-    Bool is_infinite_loop = TRUE;
-    int  num_nested_loops = 0;
-    int  num_tokens       = Array_Length(tokens);
-    int  while_var        = atoi(while_tok->value+1);
+static int* PendingLoops(Loop_Tracker* tracker, int var) {
+    if (var < 0 || var >= PLANG_NUM_VARS)
+        return &tracker->pending_other;
 
-    // Hr struntar vi i syntaxen. Vi loopar bara fram till END och kollar att
-    // vi hittar en token som indikerar tilldelning av loop-variabeln.
-    while (TRUE) {
-        if (index >= num_tokens) return;
-        P_Token* tok = Array_GetElemPtr(tokens, index++);
+    return &tracker->pending[var];
+}
 
-        if (tok->type == PTOK_ASSIGN) {
-            // Endast := kan leda till att loopen tar slut.
-            tok = Array_GetElemPtr(tokens, index-2);
-            // tok = den token som innehller variabeln som tilldelas.
+/*--------------------------------------
+ * Function: CloseLoop()
+ * Parameters:
+ *   tracker  Loop-kontrollen.
+ *
+ * Description:
+ *   Stnger den innersta ppna loopen och ger en varning om loop-variabeln
+ *   aldrig rknades ned eller nollstlldes i den.
+ *------------------------------------*/
+static void CloseLoop(Loop_Tracker* tracker) {
+    int        num_loops = Array_Length(&tracker->loops);
+    Open_Loop* loop      = Array_GetElemPtr(&tracker->loops, num_loops-1);
+
+    if (!loop->is_finite) {
+        // Alla loopar inuti den hr har redan stngts, s den ligger frst i
+        // sin lista.
+        int* pending = PendingLoops(tracker, loop->while_tok.value);
+        ASSERT(*pending == num_loops-1);
+        *pending = loop->next_pending;
+
+        WarnInfiniteLoop(tracker->errors, loop->slot, tracker->source,
+                         &loop->while_tok);
+    }
+    else if (loop->slot == Array_Length(tracker->errors)-1) {
+        // Inga fel har lagts till efter platsen, s den kan tas bort direkt.
+        // vriga tomma platser tas bort av FinishTracker().
+        Array_RemoveElem(tracker->errors, loop->slot);
+
+        // Platsen rknades som varning, s antalet fel r detsamma.
+        if (tracker->num_counted > loop->slot)
+            tracker->num_counted = loop->slot;
+    }
 
-            if (tok->type != PTOK_IDENT) {
-                // Trasig syntax, men det reder vi inte ut hr.
-                continue;
-            }
+    Array_RemoveElem(&tracker->loops, num_loops-1);
+}
 
-            int var = atoi(tok->value+1);
-            if (var != while_var) {
-                // Vi har en tilldelning, men den gller inte variabeln i loop-
-                // villkoret.
-                continue;
-            }
+/*--------------------------------------
+ * Function: CountActualErrors()
+ * Parameters:
+ *   tracker  Loop-kontrollen.
+ *
+ * Description:
+ *   Returnerar antalet egentliga fel i errors, allts inte varningar. Varje
+ *   ppen loop har en plats bland felen, s fr att inte g igenom dem
+ *   efter varje sats rknas bara de fel som tillkommit sedan frra anropet.
+ *------------------------------------*/
+static int CountActualErrors(Loop_Tracker* tracker) {
+    Array* errors     = tracker->errors;
+    int    num_errors = Array_Length(errors);
 
-            if (index >= num_tokens) return;
-            P_Token* int_pred_succ_tok = Array_GetElemPtr(tokens, index);
+    for (int i = tracker->num_counted; i < num_errors; i++) {
+        Syntax_Error* err = Array_GetElemPtr(errors, i);
 
-            if (int_pred_succ_tok->type == PTOK_INT) {
-                // Om det inte r vrdet noll vi tilldelar s kan tilldelningen
-                // inte stanna loopen.
-                int val = atoi(int_pred_succ_tok->value);
-                if (val > 0)
-                    continue;
-            }
-            else if (int_pred_succ_tok->type == PTOK_SUCC) {
-                // SUCC kan inte stoppa loopen annat n genom overflow, i vilket
-                // fall den virtuella maskinen nd avbryter exekveringen.
-                continue;
-            }
+        if (!err->is_warning)
+            tracker->num_actual_errors++;
+    }
 
-            // Tilldelningen r antingen <variabel> := PRED... eller
-            // <variabel> := 0.
+    tracker->num_counted = num_errors;
+    return tracker->num_actual_errors;
+}
 
-            is_infinite_loop = FALSE;
-            break;
+/*--------------------------------------
+ * Function: TrackToken()
+ * Parameters:
+ *   tracker  Loop-kontrollen.
+ *   tok      Den token som just lsts.
+ *
+ * Description:
+ *   Uppdaterar de ppna looparna med en token. Alla tokens mste skickas
+ *   hit i ordning, men samma token fr skickas flera gnger.
+ *------------------------------------*/
+static void TrackToken(Loop_Tracker* tracker, const P_Token* tok) {
+    // END lses tv gnger nr CheckSyntax() lmnar kvar det, men ska bara
+    // rknas en gng.
+    if (tok->offset <= tracker->last_offset)
+        return;
+
+    tracker->last_offset = tok->offset;
+
+    // var_tok = den token som str fre tok.
+    P_Token var_tok   = tracker->prev_tok;
+    tracker->prev_tok = *tok;
+
+    if (tracker->has_assign) {
+        // tok r vrdet i en tilldelning. Om det inte r vrdet noll vi
+        // tilldelar s kan tilldelningen inte stanna loopen. SUCC kan inte
+        // stoppa loopen annat n genom overflow, i vilket fall den virtuella
+        // maskinen nd avbryter exekveringen.
+        Bool is_non_zero = (tok->type == PTOK_INT
+                            && (tok->value != 0 || tok->overflow))
+                        || tok->type == PTOK_SUCC;
+
+        tracker->has_assign = FALSE;
+
+        // Tilldelningen kan stoppa alla loopar som var ppna d och har den
+        // tilldelade variabeln i loop-villkoret. Bara loopar som ppnats
+        // efter tilldelningen, och i pending_other loopar med andra
+        // variabler, hoppas ver. Resten markeras och tas bort ur listan.
+        int* next = PendingLoops(tracker, tracker->assign_var);
+        while (!is_non_zero && *next != -1) {
+            Open_Loop* loop = Array_GetElemPtr(&tracker->loops, *next);
+
+            if (*next < tracker->num_assign_loops
+                && loop->while_tok.value == tracker->assign_var)
+            {
+                loop->is_finite = TRUE;
+                *next           = loop->next_pending;
+            }
+            else {
+                next = &loop->next_pending;
+            }
         }
-        else if (tok->type == PTOK_WHILE) {
-            // Vi har hamnat i en while-loop inuti den vi kontrollerar.
-            num_nested_loops++;
+    }
+
+    switch (tok->type) {
+    case PTOK_ASSIGN:
+        // Endast := kan leda till att loopen tar slut. var_tok innehller
+        // variabeln som tilldelas, om syntaxen inte r trasig.
+        if (var_tok.type == PTOK_IDENT) {
+            tracker->has_assign       = TRUE;
+            tracker->assign_var       = var_tok.value;
+            tracker->num_assign_loops = Array_Length(&tracker->loops);
         }
-        else if (tok->type == PTOK_END) {
-            // Vi har ntt loopens syntaktiska slut om nesting blir noll hr.
-            if (num_nested_loops-- <= 0)
+        break;
+
+    case PTOK_WHILE:
+        tracker->depth++;
+        break;
+
+    case PTOK_END: {
+        // De innersta ppna looparna tar slut om END inte hr till en loop
+        // inuti dem. I trasiga program kan END st mellan WHILE och DO, och
+        // d kan flera loopar ta slut p samma END.
+        int num_loops = Array_Length(&tracker->loops);
+        while (num_loops > 0) {
+            Open_Loop* loop = Array_GetElemPtr(&tracker->loops, num_loops-1);
+
+            if (loop->depth != tracker->depth)
                 break;
+
+            CloseLoop(tracker);
+            num_loops--;
         }
+
+        tracker->depth--;
+        break;
     }
 
-    if (is_infinite_loop)
-        WarnInfiniteLoop(errors, source, while_tok);
+    default:
+        break;
+    }
 }
 
 /*--------------------------------------
- * Function: CheckSyntax()
+ * Function: NextToken()
  * Parameters:
- *   index   Det index i token-arrayen som verifieringen ska brja p.
- *   tokens  En array av P-tokens vars syntax ska verifieras.
- *   errors  Den array som alla eventuella fel ska lagras i.
- *   source  Kllkoden, eller NULL.
+ *   tokenizer  Tokeniseraren som ska lsa nsta token.
+ *   tracker    Loop-kontrollen.
+ *   tok        Den token som ska fyllas i.
  *
  * Description:
- *   Verifierar syntaxen av angivna P-tokens. Returnerar noll om syntaxen r
- *   korrekt, annars kan fel lsas ut ur errors-arrayen.
+ *   Lser nsta token med Tok_Next() och uppdaterar loop-kontrollen med den.
+ *   Returnerar falskt om kllkoden redan r slut.
  *------------------------------------*/
-static void CheckSyntax(int* index, const Array* tokens, Array* errors,
+static Bool NextToken(P_Tokenizer* tokenizer, Loop_Tracker* tracker,
+                      P_Token* tok)
+{
+    if (!Tok_Next(tokenizer, tok))
+        return FALSE;
+
+    TrackToken(tracker, tok);
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: FinishTracker()
+ * Parameters:
+ *   tracker    Loop-kontrollen.
+ *   tokenizer  En kopia av tokeniseraren, dr syntax-verifieringen slutade.
+ *
+ * Description:
+ *   Lser loopar som fortfarande r ppna till deras slut, ven om syntax-
+ *   verifieringen gav upp innan dess. Loopar som inte tar slut innan
+ *   kllkoden gr det ger ingen varning. Tar sedan bort de platser i errors
+ *   som reserverats fr varningar som aldrig behvdes, och slpper loop-
+ *   kontrollen ur minnet.
+ *------------------------------------*/
+static void FinishTracker(Loop_Tracker* tracker, P_Tokenizer tokenizer) {
+    P_Token tok;
+
+    // Om syntax-verifieringen gav upp r tokeniseraren avslutad fast EOF inte
+    // har lsts.
+    if (tracker->prev_tok.type != PTOK_EOF)
+        tokenizer.at_end = FALSE;
+
+    while (Array_Length(&tracker->loops) > 0 && Tok_Next(&tokenizer, &tok))
+        TrackToken(tracker, &tok);
+
+    Array* errors     = tracker->errors;
+    int    num_errors = Array_Length(errors);
+    int    n          = 0;
+    for (int i = 0; i < num_errors; i++) {
+        Syntax_Error* err = Array_GetElemPtr(errors, i);
+
+        if (err->text)
+            *(Syntax_Error*)Array_GetElemPtr(errors, n++) = *err;
+    }
+
+    errors->num_elems = n;
+
+    Array_Free(&tracker->loops);
+}
+
+/*--------------------------------------
+ * Function: InitTracker()
+ * Parameters:
+ *   tracker  Loop-kontrollen som ska initieras.
+ *   errors   Den array som varningarna ska lagras i.
+ *   source   Kllkoden.
+ *
+ * Description:
+ *   Initierar loop-kontrollen, som sedan ska f alla tokens i kllkoden av
+ *   NextToken().
+ *------------------------------------*/
+static void InitTracker(Loop_Tracker* tracker, Array* errors,
                         const char* source)
 {
-    int num_tokens = Array_Length(tokens);
+    Array_Init(&tracker->loops, sizeof(Open_Loop));
+
+    tracker->errors            = errors;
+    tracker->source            = source;
+    tracker->prev_tok.type     = PTOK_UNKNOWN;
+    tracker->depth             = 0;
+    tracker->last_offset       = -1;
+    tracker->has_assign        = FALSE;
+    tracker->pending_other     = -1;
+    tracker->num_counted       = 0;
+    tracker->num_actual_errors = 0;
+
+    for (int i = 0; i < PLANG_NUM_VARS; i++)
+        tracker->pending[i] = -1;
+}
+
+/*--------------------------------------
+ * Function: OpenLoop()
+ * Parameters:
+ *   tracker    Loop-kontrollen.
+ *   while_tok  Den token som innehller loop-variabeln.
+ *
+ * Description:
+ *   ppnar en loop vars frsta sats r nsta token. Platsen fr en eventuell
+ *   varning reserveras redan nu, s att den hamnar fre felen i loopens
+ *   satser.
+ *------------------------------------*/
+static void OpenLoop(Loop_Tracker* tracker, const P_Token* while_tok) {
+    Open_Loop    loop;
+    Syntax_Error error;
+    int*         pending = PendingLoops(tracker, while_tok->value);
+
+    loop.while_tok    = *while_tok;
+    loop.depth        = tracker->depth;
+    loop.slot         = Array_Length(tracker->errors);
+    loop.is_finite    = FALSE;
+    loop.next_pending = *pending;
+
+    // En tom plats har ingen text. Den rknas som varning, s att den inte
+    // fr syntax-verifieringen att ge upp.
+    error.text       = NULL;
+    error.is_warning = TRUE;
+    error.source     = tracker->source;
+    error.row        = while_tok->row;
+    error.col        = while_tok->col;
+    error.offset     = while_tok->offset;
+
+    *pending = Array_Length(&tracker->loops);
+
+    Array_AddElem(tracker->errors, &error);
+    Array_AddElem(&tracker->loops, &loop);
+}
+
+/*--------------------------------------
+ * Function: CheckSyntax()
+ * Parameters:
+ *   tokenizer  Tokeniseraren som lser kllkoden.
+ *   tracker    Loop-kontrollen, som fr alla tokens som lses.
+ *   errors     Den array som alla eventuella fel ska lagras i.
+ *   source     Kllkoden.
+ *   node       Noden som satserna ska lggas i, eller NULL om inget syntax-
+ *              trd byggs.
+ *
+ * Description:
+ *   Verifierar syntaxen av satserna fram till END eller RESULT, och lgger
+ *   en nod fr varje sats i node. END lses inte, utan lmnas kvar till den
+ *   som anropade.
+ *------------------------------------*/
+static void CheckSyntax(P_Tokenizer* tokenizer, Loop_Tracker* tracker,
+                        Array* errors, const char* source, AST_Node* node)
+{
+    P_Token tok;
+
     while (TRUE) {
         // Om det genererats fr mnga fel s ger vi upp och avslutar syntax-
         // verifieringen.
-        int num_errors = Array_Length(errors);
-        if (num_errors >= MAX_ERRORS) {
+        if (Array_Length(errors) >= MAX_ERRORS) {
             // Fel kan ven vara varningar, s vi rknar antalet egentliga fel.
-            int num_actual_errors = 0;
-
-            for (int i = 0; i < num_errors; i++) {
-                Syntax_Error* err = Array_GetElemPtr(errors, i);
-
-                if (!err->is_warning)
-                    num_actual_errors++;
-            }
-
             // Fr mnga fel (varningar ej inrknade), s vi ger upp hr.
-            if (num_actual_errors >= MAX_ERRORS) {
-                *index = num_tokens;
+            if (CountActualErrors(tracker) >= MAX_ERRORS) {
+                tokenizer->at_end = TRUE;
                 return;
             }
         }
 
-        if (*index >= num_tokens) return;
-        P_Token* tok = Array_GetElemPtr(tokens, (*index)++);
+        // END ska lmnas kvar, s vi sparar tokeniseraren innan vi lser.
+        P_Tokenizer stmt_start = *tokenizer;
 
-        switch (tok->type) {
+        if (!NextToken(tokenizer, tracker, &tok)) return;
+
+        switch (tok.type) {
         /*----------------------------------------------------
          * <variabel> := <naturligt-tal>
          * <variabel> := PRED(<variabel>)
          * <variabel> := SUCC(<variabel>)
          *--------------------------------------------------*/
         case PTOK_IDENT: {
-            CheckIdent(errors, source, tok);
+            CheckIdent(errors, source, &tok);
+
+            // Variabeln som tilldelas, och satsens frsta token.
+            P_Token var_tok = tok;
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_ASSIGN);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_ASSIGN);
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken3(errors, source, tok, PTOK_INT, PTOK_PRED, PTOK_SUCC);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken3(errors, source, &tok, PTOK_INT, PTOK_PRED, PTOK_SUCC);
 
-            if (tok->type == PTOK_INT) {
+            if (tok.type == PTOK_INT) {
                 // <variabel> := <naturligt-tal>
 
-                CheckInt(errors, source, tok);
+                CheckInt(errors, source, &tok);
 
-                char* s = tok->value;
-                while (s && *s) {
-                    if (*(s++) != '0') {
-                        // Tilldelning av ngot annat n noll.
-                        WarnAssignNonZero(errors, source, tok);
-                        break;
-                    }
+                if (tok.value != 0 || tok.overflow) {
+                    // Tilldelning av ngot annat n noll.
+                    WarnAssignNonZero(errors, source, &tok);
+                }
+
+                // Vi lgger in variabelindex och tilldelningsvrde.
+                AST_Node* assign_node = AddNode(node, AST_ASSIGN, &var_tok);
+                if (assign_node) {
+                    AST_AddValue(assign_node, var_tok.value);
+                    AST_AddValue(assign_node, tok.value);
                 }
             }
-            else if (tok->type == PTOK_PRED || tok->type == PTOK_SUCC) {
+            else if (tok.type == PTOK_PRED || tok.type == PTOK_SUCC) {
                 // <variabel> := PRED(<variabel>)
                 // <variabel> := SUCC(<variabel>)
 
-                if (*index >= num_tokens) return;
-                tok = Array_GetElemPtr(tokens, (*index)++);
-                ExpectToken(errors, source, tok, PTOK_L_PAREN);
+                AST_Node_Type type = (tok.type == PTOK_PRED) ? AST_PRED
+                                                             : AST_SUCC;
+
+                if (!NextToken(tokenizer, tracker, &tok)) return;
+                ExpectToken(errors, source, &tok, PTOK_L_PAREN);
 
-                if (*index >= num_tokens) return;
-                tok = Array_GetElemPtr(tokens, (*index)++);
-                ExpectToken(errors, source, tok, PTOK_IDENT);
+                if (!NextToken(tokenizer, tracker, &tok)) return;
+                ExpectToken(errors, source, &tok, PTOK_IDENT);
 
-                CheckIdent(errors, source, tok);
+                CheckIdent(errors, source, &tok);
 
-                if (*index >= num_tokens) return;
-                tok = Array_GetElemPtr(tokens, (*index)++);
-                ExpectToken(errors, source, tok, PTOK_R_PAREN);
+                // Vi lgger in variabelindexen fr de tv variablerna i
+                // operationen.
+                AST_Node* pred_succ_node = AddNode(node, type, &var_tok);
+                if (pred_succ_node) {
+                    AST_AddValue(pred_succ_node, var_tok.value);
+                    AST_AddValue(pred_succ_node, tok.value);
+                }
+
+                if (!NextToken(tokenizer, tracker, &tok)) return;
+                ExpectToken(errors, source, &tok, PTOK_R_PAREN);
             }
 
             break;
@@ -649,57 +1027,59 @@ static void CheckSyntax(int* index, const Array* tokens, Array* errors,
          * WHILE <variabel> != 0 DO ... END
          *--------------------------------------------------*/
         case PTOK_WHILE: {
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_IDENT);
+            AST_Node* while_node = AddNode(node, AST_WHILE, &tok);
+
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_IDENT);
 
-            CheckIdent(errors, source, tok);
+            CheckIdent(errors, source, &tok);
+
+            if (while_node)
+                AST_AddValue(while_node, tok.value);
 
             // Vi sparar denna token s att vi kan kontrollera om loop-variabeln
             // modifieras inuti loopen. Annars tar ju loopen aldrig slut.
-            P_Token* while_tok = tok;
+            P_Token while_tok = tok;
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_EQ_TEST);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_EQ_TEST);
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_INT);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_INT);
 
-            CheckInt(errors, source, tok);
+            CheckInt(errors, source, &tok);
 
-            // Se till att vi testar mot vrdet noll.
-            char* s = tok->value;
-            while (s && *s) {
-                if (*(s++) != '0') {
-                    // Ogiltigt frsk att testa mot ngot annat vrde n noll.
-                    ErrLoopTestAgainstNonZero(errors, source, tok);
-                    break;
-                }
+            // Se till att vi testar mot vrdet noll. En variabel r inte heller
+            // noll.
+            if (tok.type == PTOK_IDENT
+             || (tok.type == PTOK_INT && (tok.value != 0 || tok.overflow)))
+            {
+                // Ogiltigt frsk att testa mot ngot annat vrde n noll.
+                ErrLoopTestAgainstNonZero(errors, source, &tok);
             }
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_DO);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_DO);
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, *index);
-            if (tok->type != PTOK_END) {
-                CheckLoopFinite(*index, tokens, errors, source, while_tok);
+            if (!Tok_Peek(tokenizer, &tok)) return;
+            if (tok.type != PTOK_END) {
+                // Loopen stngs nr dess END lses, och d vet vi om loop-
+                // variabeln modifieras inuti loopen.
+                OpenLoop(tracker, &while_tok);
 
                 // Hr gr vi igenom loopens innehll med hjlp av rekursion.
-                CheckSyntax(index, tokens, errors, source);
+                // Loopens satser lggs i dess egen barn-array, s while_node
+                // pekar fortfarande rtt nr vi kommer tillbaka.
+                CheckSyntax(tokenizer, tracker, errors, source, while_node);
 
-                if (*index >= num_tokens) return;
-                tok = Array_GetElemPtr(tokens, (*index)++);
-                ExpectToken(errors, source, tok, PTOK_END);
+                if (!NextToken(tokenizer, tracker, &tok)) return;
+                ExpectToken(errors, source, &tok, PTOK_END);
             }
             else {
                 // Loopen r tom, vilket ju r syntaktiskt ok, men den kommer
                 // aldrig bli klar, s vi genererar en varning om det.
-                WarnEmptyLoop(errors, source, tok);
-                (*index)++;
+                WarnEmptyLoop(errors, source, &tok);
+                NextToken(tokenizer, tracker, &tok);
             }
 
             break;
@@ -710,7 +1090,7 @@ static void CheckSyntax(int* index, const Array* tokens, Array* errors,
          *--------------------------------------------------*/
         case PTOK_END: {
             // Detta r slutet p en while-loop.
-            (*index)--;
+            *tokenizer = stmt_start;
             return;
         }
 
@@ -718,30 +1098,32 @@ static void CheckSyntax(int* index, const Array* tokens, Array* errors,
          * RESULT (<variabel>)
          *--------------------------------------------------*/
         case PTOK_RESULT: {
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_L_PAREN);
+            AST_Node* result_node = AddNode(node, AST_RESULT, &tok);
+
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_L_PAREN);
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_IDENT);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_IDENT);
 
-            CheckIdent(errors, source, tok);
+            CheckIdent(errors, source, &tok);
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, (*index)++);
-            ExpectToken(errors, source, tok, PTOK_R_PAREN);
+            // Vi lgger in index p den variabel som ska vara output.
+            if (result_node)
+                AST_AddValue(result_node, tok.value);
 
-            if (*index >= num_tokens) return;
-            tok = Array_GetElemPtr(tokens, *index);
-            ExpectToken(errors, source, tok, PTOK_EOF);
+            if (!NextToken(tokenizer, tracker, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_R_PAREN);
+
+            if (!Tok_Peek(tokenizer, &tok)) return;
+            ExpectToken(errors, source, &tok, PTOK_EOF);
         
             // Hr r vi klara med verifieringen!
             return;
         }
 
         default:
-            ErrUnexpectedToken(errors, source, tok);
+            ErrUnexpectedToken(errors, source, &tok);
         }
     }
 
@@ -752,51 +1134,97 @@ static void CheckSyntax(int* index, const Array* tokens, Array* errors,
 /*--------------------------------------
  * Function: Syn_CheckSyntax()
  * Parameters:
- *   tokens  En array av P-tokens vars syntax ska verifieras.
+ *   source  Kllkoden vars syntax ska verifieras.
  *   errors  Den array som alla eventuella fel ska lagras i.
- *   source  Kllkoden, eller NULL.
  *
  * Description:
- *   Verifierar syntaxen av angivna P-tokens. Returnerar noll om syntaxen r
- *   korrekt, annars kan fel lsas ut ur errors-arrayen.
+ *   Verifierar syntaxen av kllkoden utan att bygga ngot syntax-trd, se
+ *   Syn_Parse(). Returnerar sant om syntaxen r korrekt, annars kan fel
+ *   lsas ut ur errors-arrayen.
  *------------------------------------*/
-Bool Syn_CheckSyntax(const Array* tokens, Array* errors, const char* source) {
-    int index      = 0;
-    int num_tokens = Array_Length(tokens);
+Bool Syn_CheckSyntax(const char* source, Array* errors) {
+    return Syn_Parse(source, errors, NULL, NULL);
+}
+
+/*--------------------------------------
+ * Function: Syn_Parse()
+ * Parameters:
+ *   source  Kllkoden som ska verifieras och gras om till ett syntax-trd.
+ *   errors  Den array som alla eventuella fel ska lagras i, eller NULL om
+ *           felen inte behvs.
+ *   tree    Noden som syntax-trdet ska lagras i, eller NULL om bara
+ *           syntaxen ska verifieras.
+ *   arena   Arenan som syntax-trdet ska allokeras ur, eller NULL fr
+ *           malloc().
+ *
+ * Description:
+ *   Verifierar syntaxen av kllkoden och bygger samtidigt syntax-trdet, i
+ *   ett enda pass dr kllkoden delas upp i tokens en i taget. Returnerar
+ *   sant om syntaxen r korrekt. Annars kan fel lsas ut ur errors-arrayen,
+ *   och trdet har redan slppts ur minnet.
+ *
+ *   Felmeddelandena allokeras i samma arena som errors-arrayen, se
+ *   Array_InitSized(), och slpps d med den. Om errors inte ligger i ngon
+ *   arena ska varje felmeddelande slppas med free().
+ *------------------------------------*/
+Bool Syn_Parse(const char* source, Array* errors, AST_Node* tree,
+               Arena* arena)
+{
+    P_Tokenizer  tokenizer;
+    Loop_Tracker tracker;
+    P_Token      tok;
+    Bool         is_valid = FALSE;
+
+    // Felen behvs fr att veta nr vi ska ge upp, ven om den som anropade
+    // inte vill ha dem.
+    Array own_errors;
+    if (!errors) {
+        Array_InitSized(&own_errors, sizeof(Syntax_Error), 0, arena);
+        errors = &own_errors;
+    }
+
+    if (tree)
+        *tree = AST_CreateNode(AST_PROGRAM, arena);
+
+    Tok_Init(&tokenizer, source);
+    InitTracker(&tracker, errors, source);
 
     /*----------------------------------------------------
      * Alla program brjar med fljande sekvens:
      *   PROGRAM (<variabel>[, <variabel>])
      *--------------------------------------------------*/
 
-    if (index >= num_tokens) return FALSE;
-    P_Token* tok = Array_GetElemPtr(tokens, index++);
-    ExpectToken(errors, source, tok, PTOK_PROGRAM);
+    if (!NextToken(&tokenizer, &tracker, &tok)) goto done;
+    ExpectToken(errors, source, &tok, PTOK_PROGRAM);
 
-    if (index >= num_tokens) return FALSE;
-    tok = Array_GetElemPtr(tokens, index++);
-    ExpectToken(errors, source, tok, PTOK_L_PAREN);
+    if (!NextToken(&tokenizer, &tracker, &tok)) goto done;
+    ExpectToken(errors, source, &tok, PTOK_L_PAREN);
 
     while (TRUE) {
-        if (index >= num_tokens) return FALSE;
-        tok = Array_GetElemPtr(tokens, index++);
-        ExpectToken(errors, source, tok, PTOK_IDENT);
+        if (!NextToken(&tokenizer, &tracker, &tok)) goto done;
+        ExpectToken(errors, source, &tok, PTOK_IDENT);
+
+        CheckIdent(errors, source, &tok);
 
-        CheckIdent(errors, source, tok);
+        // Vi lgger till variabelindexet som input-vrde.
+        if (tree)
+            AST_AddValue(tree, tok.value);
 
-        if (index >= num_tokens) return FALSE;
-        tok = Array_GetElemPtr(tokens, index);
-        if (tok->type != PTOK_COMMA)
+        if (!Tok_Peek(&tokenizer, &tok)) goto done;
+        if (tok.type != PTOK_COMMA)
             break;
-        index++;
+        NextToken(&tokenizer, &tracker, &tok);
     }
 
-    if (index >= num_tokens) return FALSE;
-    tok = Array_GetElemPtr(tokens, index++);
-    ExpectToken2(errors, source, tok, PTOK_COMMA, PTOK_R_PAREN);
+    if (!NextToken(&tokenizer, &tracker, &tok)) goto done;
+    ExpectToken2(errors, source, &tok, PTOK_COMMA, PTOK_R_PAREN);
 
     // Vi fortstter djupare in i programmet och verifierar syntaxen dr.
-    CheckSyntax(&index, tokens, errors, source);
+    CheckSyntax(&tokenizer, &tracker, errors, source, tree);
+    is_valid = TRUE;
+
+done:
+    FinishTracker(&tracker, tokenizer);
 
     int num_errors = Array_Length(errors);
     for (int i = 0; i < num_errors; i++) {
@@ -804,11 +1232,31 @@ Bool Syn_CheckSyntax(const Array* tokens, Array* errors, const char* source) {
 
         // Varningar gr inte s mycket, men fel kan vi inte acceptera.
         if (!err->is_warning)
-            return FALSE;
+            is_valid = FALSE;
+    }
+
+    if (errors == &own_errors) {
+        for (int i = 0; i < num_errors && !arena; i++) {
+            Syntax_Error* err = Array_GetElemPtr(errors, i);
+            Str_Free(err->text);
+        }
+
+        Array_Free(&own_errors);
+    }
+
+    if (tree) {
+        if (is_valid) {
+            // Barn-arrayerna kan ha flyttats nr de vxte, s frldra-
+            // lnkarna mste sttas om.
+            AST_Repair(tree);
+        }
+        else {
+            AST_FreeNode(tree);
+        }
     }
 
     // Allt gick som det skulle! :-)
-    return TRUE;
+    return is_valid;
 }
 
 /*--------------------------------------
@@ -823,13 +1271,11 @@ void Syn_PrintError(const Syntax_Error* err) {
     if (err->is_warning) printf("Warning on line %d:\n", err->row);
     else                 printf("Error on line %d:\n"  , err->row);
 
-    // "Spola fram" till rtt rad i kllkoden.
-    const char* source = err->source;
-    int row = err->row-1;
-    while (row > 0) {
-        if (*(source++) == '\n')
-            row--;
-    }
+    // Backa till brjan av raden dr felet uppstod. Att rkna rader frn
+    // brjan av kllkoden skulle ta kvadratisk tid med mnga fel.
+    const char* source = err->source + err->offset;
+    while (source > err->source && source[-1] != '\n')
+        source--;
 
     // Fult hack fr att skriva ut textraden, men det fungerar fint.
     while (TRUE) {
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: syntax.h
  * Created: January 3, 2015
- * Last changed: January 4, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -9,7 +9,10 @@
  *   Funktioner fr syntax-analys av P-tokens.
  *
  * Changes:
- *
+ *   * Syn_CheckSyntax() tar kllkoden och delar sjlv upp den i tokens.
+ *   * Lade till Syn_Parse(), som ven bygger syntax-trdet.
+ *   * Syn_Parse() tar en arena som syntax-trdet allokeras ur.
+ *   * Syntax_Error.offset, felets position i kllkoden.
  *----------------------------------------------------------------------------*/
 
 #ifndef SYNTAX_H_
@@ -19,7 +22,9 @@
  * INCLUDES
  *----------------------------------------------*/
 
+#include "arena.h"
 #include "array.h"
+#include "ast.h"
 #include "common.h"
 
 /*------------------------------------------------
@@ -30,7 +35,8 @@
  * Type: Syntax_Error
  *
  * Description:
- *   Representerar ett fel i syntaxen hos ett P-program.
+ *   Representerar ett fel i syntaxen hos ett P-program. offset r antalet
+ *   tecken frn brjan av source till den token dr felet uppstod.
  *------------------------------------*/
 typedef struct {
     char*       text;
@@ -38,6 +44,7 @@ typedef struct {
     const char* source;
     int         row;
     int         col;
+    int         offset;
 } Syntax_Error;
 
 /*------------------------------------------------
@@ -47,15 +54,39 @@ typedef struct {
 /*--------------------------------------
  * Function: Syn_CheckSyntax()
  * Parameters:
- *   tokens  En array av P-tokens vars syntax ska verifieras.
+ *   source  Kllkoden vars syntax ska verifieras.
  *   errors  Den array som alla eventuella fel ska lagras i.
- *   source  Kllkoden, eller NULL.
  *
  * Description:
- *   Verifierar syntaxen av angivna P-tokens. Returnerar noll om syntaxen r
- *   korrekt, annars kan fel lsas ut ur errors-arrayen.
+ *   Verifierar syntaxen av kllkoden utan att bygga ngot syntax-trd, se
+ *   Syn_Parse(). Returnerar sant om syntaxen r korrekt, annars kan fel
+ *   lsas ut ur errors-arrayen.
+ *------------------------------------*/
+Bool Syn_CheckSyntax(const char* source, Array* errors);
+
+/*--------------------------------------
+ * Function: Syn_Parse()
+ * Parameters:
+ *   source  Kllkoden som ska verifieras och gras om till ett syntax-trd.
+ *   errors  Den array som alla eventuella fel ska lagras i, eller NULL om
+ *           felen inte behvs.
+ *   tree    Noden som syntax-trdet ska lagras i, eller NULL om bara
+ *           syntaxen ska verifieras.
+ *   arena   Arenan som syntax-trdet ska allokeras ur, eller NULL fr
+ *           malloc().
+ *
+ * Description:
+ *   Verifierar syntaxen av kllkoden och bygger samtidigt syntax-trdet, i
+ *   ett enda pass dr kllkoden delas upp i tokens en i taget. Returnerar
+ *   sant om syntaxen r korrekt. Annars kan fel lsas ut ur errors-arrayen,
+ *   och trdet har redan slppts ur minnet.
+ *
+ *   Felmeddelandena allokeras i samma arena som errors-arrayen, se
+ *   Array_InitSized(), och slpps d med den. Om errors inte ligger i ngon
+ *   arena ska varje felmeddelande slppas med free().
  *------------------------------------*/
-Bool Syn_CheckSyntax(const Array* tokens, Array* errors, const char* source);
+Bool Syn_Parse(const char* source, Array* errors, AST_Node* tree,
+               Arena* arena);
 
 /*--------------------------------------
  * Function: Syn_PrintError()
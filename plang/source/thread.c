@@ -0,0 +1,344 @@
+/*------------------------------------------------------------------------------
+ * File: thread.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Trdar, mutexar och villkorsvariabler, med samma grnssnitt p Windows
+ *   och p system med pthreads.
+ *
+ * Changes:
+ *   * Cond_TimedWait() fr trdar som ska vakna med jmna mellanrum.
+ *   * Thread_WallTimeNs() fr mtningar med nanosekundsupplsning.
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+#include "thread.h"
+
+#include <stdlib.h>
+
+#ifndef _WIN32
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Thread_Start
+ *
+ * Description:
+ *   Funktionen och argumentet som en ny trd ska kra. Allokeras av
+ *   Thread_Create() och slpps av den nya trden.
+ *------------------------------------*/
+typedef struct {
+    Thread_Func func;
+    void*       arg;
+} Thread_Start;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: ThreadMain()
+ * Parameters:
+ *   arg  Pekare till trdens Thread_Start.
+ *
+ * Description:
+ *   Trdarnas startfunktion. Windows och pthreads vill ha olika signaturer,
+ *   s vi gr via den hr funktionen istllet fr att starta func direkt.
+ *------------------------------------*/
+#ifdef _WIN32
+static DWORD WINAPI ThreadMain(LPVOID arg) {
+#else
+static void* ThreadMain(void* arg) {
+#endif
+    Thread_Start start = *(Thread_Start*)arg;
+    free(arg);
+
+    start.func(start.arg);
+
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/*--------------------------------------
+ * Function: Cond_Broadcast()
+ * Parameters:
+ *   cond  Villkorsvariabeln.
+ *
+ * Description:
+ *   Vcker alla trdar som vntar p villkorsvariabeln.
+ *------------------------------------*/
+void Cond_Broadcast(Cond* cond) {
+#ifdef _WIN32
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Cond_Free()
+ * Parameters:
+ *   cond  Villkorsvariabeln som ska slppas.
+ *
+ * Description:
+ *   Slpper en villkorsvariabel. Ingen trd fr vnta p den.
+ *------------------------------------*/
+void Cond_Free(Cond* cond) {
+#ifdef _WIN32
+    // Villkorsvariabler i Windows behver inte slppas.
+#else
+    pthread_cond_destroy(cond);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Cond_Init()
+ * Parameters:
+ *   cond  Villkorsvariabeln som ska initieras.
+ *
+ * Description:
+ *   Initierar en villkorsvariabel.
+ *------------------------------------*/
+void Cond_Init(Cond* cond) {
+#ifdef _WIN32
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Cond_Wait()
+ * Parameters:
+ *   cond   Villkorsvariabeln.
+ *   mutex  Lset, som den anropande trden mste hlla.
+ *
+ * Description:
+ *   Slpper lset och vntar tills villkorsvariabeln vcks, och tar sedan
+ *   lset igen. Trden kan vakna utan att ha vckts, s villkoret mste
+ *   alltid kontrolleras i en loop.
+ *------------------------------------*/
+void Cond_Wait(Cond* cond, Mutex* mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Cond_TimedWait()
+ * Parameters:
+ *   cond   Villkorsvariabeln.
+ *   mutex  Lset, som den anropande trden mste hlla.
+ *   ms     Den lngsta tiden att vnta, i millisekunder.
+ *
+ * Description:
+ *   Som Cond_Wait(), men vntar hgst ms millisekunder.
+ *------------------------------------*/
+void Cond_TimedWait(Cond* cond, Mutex* mutex, double ms) {
+#ifdef _WIN32
+    SleepConditionVariableCS(cond, mutex, (DWORD)ms);
+#else
+    // pthreads vill ha en absolut tidpunkt, och rknar med CLOCK_REALTIME.
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    long long ns = ts.tv_nsec + (long long)(ms * 1000000.0);
+    ts.tv_sec  += (time_t)(ns / 1000000000);
+    ts.tv_nsec  = (long)(ns % 1000000000);
+
+    pthread_cond_timedwait(cond, mutex, &ts);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Mutex_Free()
+ * Parameters:
+ *   mutex  Lset som ska slppas.
+ *
+ * Description:
+ *   Slpper ett ls. Ingen trd fr hlla det.
+ *------------------------------------*/
+void Mutex_Free(Mutex* mutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Mutex_Init()
+ * Parameters:
+ *   mutex  Lset som ska initieras.
+ *
+ * Description:
+ *   Initierar ett ls.
+ *------------------------------------*/
+void Mutex_Init(Mutex* mutex) {
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Mutex_Lock()
+ * Parameters:
+ *   mutex  Lset.
+ *
+ * Description:
+ *   Vntar tills lset r ledigt och tar det.
+ *------------------------------------*/
+void Mutex_Lock(Mutex* mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Mutex_Unlock()
+ * Parameters:
+ *   mutex  Lset.
+ *
+ * Description:
+ *   Slpper lset.
+ *------------------------------------*/
+void Mutex_Unlock(Mutex* mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Thread_Create()
+ * Parameters:
+ *   thread  Trden som ska skapas.
+ *   func    Funktionen som ska kras i trden.
+ *   arg     Argumentet till func.
+ *
+ * Description:
+ *   Startar en ny trd. Returnerar falskt om det inte gick. Glm inte anropa
+ *   Thread_Join()!
+ *------------------------------------*/
+Bool Thread_Create(Thread* thread, Thread_Func func, void* arg) {
+    Thread_Start* start = malloc(sizeof(Thread_Start));
+    start->func = func;
+    start->arg  = arg;
+
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, ThreadMain, start, 0, NULL);
+    if (*thread != NULL)
+        return TRUE;
+#else
+    if (pthread_create(thread, NULL, ThreadMain, start) == 0)
+        return TRUE;
+#endif
+
+    free(start);
+    return FALSE;
+}
+
+/*--------------------------------------
+ * Function: Thread_Join()
+ * Parameters:
+ *   thread  Trden.
+ *
+ * Description:
+ *   Vntar tills trden r klar.
+ *------------------------------------*/
+void Thread_Join(Thread* thread) {
+#ifdef _WIN32
+    WaitForSingleObject(*thread, INFINITE);
+    CloseHandle(*thread);
+#else
+    pthread_join(*thread, NULL);
+#endif
+}
+
+/*--------------------------------------
+ * Function: Thread_NumCPUs()
+ * Parameters:
+ *
+ * Description:
+ *   Returnerar antalet processorer, men alltid minst ett.
+ *------------------------------------*/
+int Thread_NumCPUs() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int num_cpus = (int)info.dwNumberOfProcessors;
+#else
+    int num_cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return (num_cpus > 0) ? num_cpus : 1;
+}
+
+/*--------------------------------------
+ * Function: Thread_WallTimeMs()
+ * Parameters:
+ *
+ * Description:
+ *   Returnerar tiden i millisekunder frn en godtycklig startpunkt. Till
+ *   skillnad frn clock() rknas verklig tid, och inte processortid summerad
+ *   ver alla trdar.
+ *------------------------------------*/
+double Thread_WallTimeMs() {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (1000.0 * count.QuadPart) / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1000.0 * ts.tv_sec + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+/*--------------------------------------
+ * Function: Thread_WallTimeNs()
+ * Parameters:
+ *
+ * Description:
+ *   Som Thread_WallTimeMs(), men i hela nanosekunder.
+ *------------------------------------*/
+long long Thread_WallTimeNs() {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+
+    // Sekunderna och resten rknas om var fr sig, s att det inte blir
+    // overflow.
+    long long secs = count.QuadPart / freq.QuadPart;
+    long long rest = count.QuadPart % freq.QuadPart;
+    return 1000000000LL * secs + (1000000000LL * rest) / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1000000000LL * ts.tv_sec + ts.tv_nsec;
+#endif
+}
@@ -0,0 +1,232 @@
+/*------------------------------------------------------------------------------
+ * File: thread.h
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Trdar, mutexar och villkorsvariabler, med samma grnssnitt p Windows
+ *   och p system med pthreads.
+ *
+ * Changes:
+ *   * Cond_TimedWait().
+ *   * Thread_WallTimeNs().
+ *----------------------------------------------------------------------------*/
+
+#ifndef THREAD_H_
+#define THREAD_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+// windows.h definierar TRUE och FALSE som makron, s common.h mste
+// inkluderas frst fr att Bool ska fungera.
+#ifdef _WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <pthread.h>
+#endif
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Thread_Func
+ *
+ * Description:
+ *   En funktion som krs i en egen trd.
+ *------------------------------------*/
+typedef void (*Thread_Func)(void* arg);
+
+#ifdef _WIN32
+
+/*--------------------------------------
+ * Type: Thread
+ *
+ * Description:
+ *   En trd.
+ *------------------------------------*/
+typedef HANDLE Thread;
+
+/*--------------------------------------
+ * Type: Mutex
+ *
+ * Description:
+ *   Ett ls som bara en trd i taget kan hlla.
+ *------------------------------------*/
+typedef CRITICAL_SECTION Mutex;
+
+/*--------------------------------------
+ * Type: Cond
+ *
+ * Description:
+ *   En villkorsvariabel som trdar kan vnta p.
+ *------------------------------------*/
+typedef CONDITION_VARIABLE Cond;
+
+#else
+
+typedef pthread_t       Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t  Cond;
+
+#endif
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Cond_Broadcast()
+ * Parameters:
+ *   cond  Villkorsvariabeln.
+ *
+ * Description:
+ *   Vcker alla trdar som vntar p villkorsvariabeln.
+ *------------------------------------*/
+void Cond_Broadcast(Cond* cond);
+
+/*--------------------------------------
+ * Function: Cond_Free()
+ * Parameters:
+ *   cond  Villkorsvariabeln som ska slppas.
+ *
+ * Description:
+ *   Slpper en villkorsvariabel. Ingen trd fr vnta p den.
+ *------------------------------------*/
+void Cond_Free(Cond* cond);
+
+/*--------------------------------------
+ * Function: Cond_Init()
+ * Parameters:
+ *   cond  Villkorsvariabeln som ska initieras.
+ *
+ * Description:
+ *   Initierar en villkorsvariabel.
+ *------------------------------------*/
+void Cond_Init(Cond* cond);
+
+/*--------------------------------------
+ * Function: Cond_Wait()
+ * Parameters:
+ *   cond   Villkorsvariabeln.
+ *   mutex  Lset, som den anropande trden mste hlla.
+ *
+ * Description:
+ *   Slpper lset och vntar tills villkorsvariabeln vcks, och tar sedan
+ *   lset igen. Trden kan vakna utan att ha vckts, s villkoret mste
+ *   alltid kontrolleras i en loop.
+ *------------------------------------*/
+void Cond_Wait(Cond* cond, Mutex* mutex);
+
+/*--------------------------------------
+ * Function: Cond_TimedWait()
+ * Parameters:
+ *   cond   Villkorsvariabeln.
+ *   mutex  Lset, som den anropande trden mste hlla.
+ *   ms     Den lngsta tiden att vnta, i millisekunder.
+ *
+ * Description:
+ *   Som Cond_Wait(), men vntar hgst ms millisekunder.
+ *------------------------------------*/
+void Cond_TimedWait(Cond* cond, Mutex* mutex, double ms);
+
+/*--------------------------------------
+ * Function: Mutex_Free()
+ * Parameters:
+ *   mutex  Lset som ska slppas.
+ *
+ * Description:
+ *   Slpper ett ls. Ingen trd fr hlla det.
+ *------------------------------------*/
+void Mutex_Free(Mutex* mutex);
+
+/*--------------------------------------
+ * Function: Mutex_Init()
+ * Parameters:
+ *   mutex  Lset som ska initieras.
+ *
+ * Description:
+ *   Initierar ett ls.
+ *------------------------------------*/
+void Mutex_Init(Mutex* mutex);
+
+/*--------------------------------------
+ * Function: Mutex_Lock()
+ * Parameters:
+ *   mutex  Lset.
+ *
+ * Description:
+ *   Vntar tills lset r ledigt och tar det.
+ *------------------------------------*/
+void Mutex_Lock(Mutex* mutex);
+
+/*--------------------------------------
+ * Function: Mutex_Unlock()
+ * Parameters:
+ *   mutex  Lset.
+ *
+ * Description:
+ *   Slpper lset.
+ *------------------------------------*/
+void Mutex_Unlock(Mutex* mutex);
+
+/*--------------------------------------
+ * Function: Thread_Create()
+ * Parameters:
+ *   thread  Trden som ska skapas.
+ *   func    Funktionen som ska kras i trden.
+ *   arg     Argumentet till func.
+ *
+ * Description:
+ *   Startar en ny trd. Returnerar falskt om det inte gick. Glm inte anropa
+ *   Thread_Join()!
+ *------------------------------------*/
+Bool Thread_Create(Thread* thread, Thread_Func func, void* arg);
+
+/*--------------------------------------
+ * Function: Thread_Join()
+ * Parameters:
+ *   thread  Trden.
+ *
+ * Description:
+ *   Vntar tills trden r klar.
+ *------------------------------------*/
+void Thread_Join(Thread* thread);
+
+/*--------------------------------------
+ * Function: Thread_NumCPUs()
+ * Parameters:
+ *
+ * Description:
+ *   Returnerar antalet processorer, men alltid minst ett.
+ *------------------------------------*/
+int Thread_NumCPUs();
+
+/*--------------------------------------
+ * Function: Thread_WallTimeMs()
+ * Parameters:
+ *
+ * Description:
+ *   Returnerar tiden i millisekunder frn en godtycklig startpunkt. Till
+ *   skillnad frn clock() rknas verklig tid, och inte processortid summerad
+ *   ver alla trdar.
+ *------------------------------------*/
+double Thread_WallTimeMs();
+
+/*--------------------------------------
+ * Function: Thread_WallTimeNs()
+ * Parameters:
+ *
+ * Description:
+ *   Som Thread_WallTimeMs(), men i hela nanosekunder.
+ *------------------------------------*/
+long long Thread_WallTimeNs();
+
+#endif // THREAD_H_
@@ -0,0 +1,291 @@
+/*------------------------------------------------------------------------------
+ * File: timing.c
+ * Created: October 17, 2026
+ * Last changed: October 17, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Tidtagning och minnesrkning fr kompilatorns faser, se timing.h.
+ *
+ * Changes:
+ *   * Timing_Disable() och Timing_PeakBytes().
+ *----------------------------------------------------------------------------*/
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+#include "thread.h"
+#include "timing.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: MAX_PHASES
+ *
+ * Description:
+ *   Det strsta antalet faser med olika namn. Fler n s rknas inte.
+ *------------------------------------*/
+#define MAX_PHASES 16
+
+/*------------------------------------------------
+ * TYPES
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Type: Phase
+ *
+ * Description:
+ *   Rknarna fr en fas. peak_bytes r det strsta antalet levande byte
+ *   under fasen, inklusive minne som allokerats i tidigare faser.
+ *------------------------------------*/
+typedef struct {
+    const char* name;
+    long long   ns;
+    long long   num_allocs;
+    long long   num_bytes;
+    long long   peak_bytes;
+} Phase;
+
+/*--------------------------------------
+ * Type: Timing_State
+ *
+ * Description:
+ *   Tidtagningens tillstnd. Allokeringarna grs lngt ifrn plang.c, i ex.
+ *   Array_AddElem(), s tillstndet kan inte skickas med som parameter.
+ *------------------------------------*/
+typedef struct {
+    Bool      is_enabled;
+    Bool      count_allocs;
+    int       num_phases;
+    Phase     phases[MAX_PHASES];
+    Phase*    current;
+    long long start_ns;
+    long long live_bytes;
+} Timing_State;
+
+/*------------------------------------------------
+ * GLOBALS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Global: timing
+ *
+ * Description:
+ *   Tidtagningens tillstnd, se Timing_State.
+ *------------------------------------*/
+static Timing_State timing;
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: FindPhase()
+ * Parameters:
+ *   name  Fasens namn.
+ *
+ * Description:
+ *   Returnerar fasen med det angivna namnet, och lgger till den om den inte
+ *   finns. Returnerar NULL om det inte finns plats fr fler faser.
+ *------------------------------------*/
+static Phase* FindPhase(const char* name) {
+    for (int i = 0; i < timing.num_phases; i++) {
+        if (strcmp(timing.phases[i].name, name) == 0)
+            return &timing.phases[i];
+    }
+
+    if (timing.num_phases == MAX_PHASES)
+        return NULL;
+
+    Phase* phase = &timing.phases[timing.num_phases++];
+
+    phase->name       = name;
+    phase->ns         = 0;
+    phase->num_allocs = 0;
+    phase->num_bytes  = 0;
+    phase->peak_bytes = 0;
+
+    return phase;
+}
+
+/*--------------------------------------
+ * Function: Timing_Begin()
+ * Parameters:
+ *   phase         Fasens namn, ex. "Tokenize". Strngen mste finnas kvar
+ *                 tills Timing_Report() anropats.
+ *   count_allocs  Sant om allokeringarna i fasen ska rknas. Mste vara
+ *                 falskt om fasen anvnder flera trdar.
+ *
+ * Description:
+ *   Avslutar den pgende fasen, om det finns ngon, och startar en ny.
+ *------------------------------------*/
+void Timing_Begin(const char* phase, Bool count_allocs) {
+    if (!timing.is_enabled)
+        return;
+
+    Timing_End();
+
+    Phase* current = FindPhase(phase);
+    if (current != NULL && timing.live_bytes > current->peak_bytes)
+        current->peak_bytes = timing.live_bytes;
+
+    timing.current      = current;
+    timing.count_allocs = count_allocs && (current != NULL);
+
+    // Klockan lses sist, s att inget av ovanstende rknas till fasen.
+    timing.start_ns = Thread_WallTimeNs();
+}
+
+/*--------------------------------------
+ * Function: Timing_CountAlloc()
+ * Parameters:
+ *   num_bytes  Antalet byte som allokerats.
+ *
+ * Description:
+ *   Rknar en allokering i den pgende fasen.
+ *------------------------------------*/
+void Timing_CountAlloc(size_t num_bytes) {
+    if (!timing.count_allocs)
+        return;
+
+    Phase* phase = timing.current;
+
+    timing.live_bytes += num_bytes;
+    phase->num_allocs++;
+    phase->num_bytes  += num_bytes;
+
+    if (timing.live_bytes > phase->peak_bytes)
+        phase->peak_bytes = timing.live_bytes;
+}
+
+/*--------------------------------------
+ * Function: Timing_CountFree()
+ * Parameters:
+ *   num_bytes  Antalet byte som slppts.
+ *
+ * Description:
+ *   Rknar bort minne som slppts, se Timing_CountAlloc().
+ *------------------------------------*/
+void Timing_CountFree(size_t num_bytes) {
+    if (!timing.count_allocs)
+        return;
+
+    timing.live_bytes -= num_bytes;
+}
+
+/*--------------------------------------
+ * Function: Timing_Disable()
+ * Parameters:
+ *
+ * Description:
+ *   Avslutar den pgende fasen och stnger av tidtagningen, utan att skriva
+ *   ut ngot.
+ *------------------------------------*/
+void Timing_Disable() {
+    Timing_End();
+    timing.is_enabled = FALSE;
+}
+
+/*--------------------------------------
+ * Function: Timing_Enable()
+ * Parameters:
+ *
+ * Description:
+ *   Startar tidtagningen och minnesrkningen. Anropas innan den frsta fasen.
+ *------------------------------------*/
+void Timing_Enable() {
+    timing.is_enabled   = TRUE;
+    timing.count_allocs = FALSE;
+    timing.num_phases   = 0;
+    timing.current      = NULL;
+    timing.start_ns     = 0;
+    timing.live_bytes   = 0;
+}
+
+/*--------------------------------------
+ * Function: Timing_End()
+ * Parameters:
+ *
+ * Description:
+ *   Avslutar den pgende fasen. Tiden fram till nsta Timing_Begin(), ex.
+ *   nr anvndaren skriver in vrden, rknas inte.
+ *------------------------------------*/
+void Timing_End() {
+    if (!timing.is_enabled)
+        return;
+
+    if (timing.current != NULL)
+        timing.current->ns += Thread_WallTimeNs() - timing.start_ns;
+
+    timing.current      = NULL;
+    timing.count_allocs = FALSE;
+}
+
+/*--------------------------------------
+ * Function: Timing_PeakBytes()
+ * Parameters:
+ *
+ * Description:
+ *   Returnerar det strsta minnesbehovet hittills, rknat frn
+ *   Timing_Enable().
+ *------------------------------------*/
+long long Timing_PeakBytes() {
+    long long peak_bytes = timing.live_bytes;
+
+    for (int i = 0; i < timing.num_phases; i++) {
+        if (timing.phases[i].peak_bytes > peak_bytes)
+            peak_bytes = timing.phases[i].peak_bytes;
+    }
+
+    return peak_bytes;
+}
+
+/*--------------------------------------
+ * Function: Timing_Report()
+ * Parameters:
+ *
+ * Description:
+ *   Avslutar den pgende fasen och skriver ut tiden, antalet allokeringar,
+ *   antalet allokerade byte och det strsta minnesbehovet fr varje fas.
+ *   Stnger sedan av tidtagningen. Gr ingenting om Timing_Enable() inte
+ *   anropats.
+ *------------------------------------*/
+void Timing_Report() {
+    if (!timing.is_enabled)
+        return;
+
+    Timing_End();
+
+    printf("Timings:\n\n");
+    printf("  %-16s %16s %12s %14s %14s\n", "Phase", "Time (ns)", "Allocs",
+           "Alloc bytes", "Peak bytes");
+
+    Phase total = { "Total", 0, 0, 0, 0 };
+
+    for (int i = 0; i < timing.num_phases; i++) {
+        const Phase* phase = &timing.phases[i];
+
+        printf("  %-16s %16lld %12lld %14lld %14lld\n", phase->name,
+               phase->ns, phase->num_allocs, phase->num_bytes,
+               phase->peak_bytes);
+
+        total.ns         += phase->ns;
+        total.num_allocs += phase->num_allocs;
+        total.num_bytes  += phase->num_bytes;
+        if (phase->peak_bytes > total.peak_bytes)
+            total.peak_bytes = phase->peak_bytes;
+    }
+
+    printf("  %-16s %16lld %12lld %14lld %14lld\n", total.name, total.ns,
+           total.num_allocs, total.num_bytes, total.peak_bytes);
+
+    Timing_Disable();
+}
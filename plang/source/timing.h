@@ -0,0 +1,127 @@
+/*------------------------------------------------------------------------------
+ * File: timing.h
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Tidtagning och minnesrkning fr kompilatorns faser, ex. uppdelningen i
+ *   tokens och syntax-kontrollen. Varje fas tidtas i nanosekunder, och
+ *   array.c, arena.c och Str_Duplicate() rapporterar sina allokeringar hit
+ *   s att de kan rknas per fas. En arena rknas block fr block, inte per
+ *   allokering ur den.
+ *
+ *   Allt r avstngt tills Timing_Enable() anropas, och d kostar anropen
+ *   nstan ingenting. Rknarna r gemensamma fr hela programmet och
+ *   skyddas inte av ngot ls, s de rknas bara i faser som krs i en
+ *   enda trd.
+ *
+ *   Strngar frn Str_Duplicate() rknas bort igen av Str_Free().
+ *
+ * Changes:
+ *   * Timing_Disable() och Timing_PeakBytes().
+ *   * Arenor rapporterar ocks sina allokeringar.
+ *   * Str_Free() rknar bort strngar frn Str_Duplicate().
+ *----------------------------------------------------------------------------*/
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+/*------------------------------------------------
+ * INCLUDES
+ *----------------------------------------------*/
+
+#include "common.h"
+
+#include <stddef.h>
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Function: Timing_Begin()
+ * Parameters:
+ *   phase         Fasens namn, ex. "Tokenize". Strngen mste finnas kvar
+ *                 tills Timing_Report() anropats.
+ *   count_allocs  Sant om allokeringarna i fasen ska rknas. Mste vara
+ *                 falskt om fasen anvnder flera trdar.
+ *
+ * Description:
+ *   Avslutar den pgende fasen, om det finns ngon, och startar en ny.
+ *------------------------------------*/
+void Timing_Begin(const char* phase, Bool count_allocs);
+
+/*--------------------------------------
+ * Function: Timing_CountAlloc()
+ * Parameters:
+ *   num_bytes  Antalet byte som allokerats.
+ *
+ * Description:
+ *   Rknar en allokering i den pgende fasen.
+ *------------------------------------*/
+void Timing_CountAlloc(size_t num_bytes);
+
+/*--------------------------------------
+ * Function: Timing_CountFree()
+ * Parameters:
+ *   num_bytes  Antalet byte som slppts.
+ *
+ * Description:
+ *   Rknar bort minne som slppts, se Timing_CountAlloc().
+ *------------------------------------*/
+void Timing_CountFree(size_t num_bytes);
+
+/*--------------------------------------
+ * Function: Timing_Disable()
+ * Parameters:
+ *
+ * Description:
+ *   Avslutar den pgende fasen och stnger av tidtagningen, utan att skriva
+ *   ut ngot.
+ *------------------------------------*/
+void Timing_Disable();
+
+/*--------------------------------------
+ * Function: Timing_Enable()
+ * Parameters:
+ *
+ * Description:
+ *   Startar tidtagningen och minnesrkningen. Anropas innan den frsta fasen.
+ *------------------------------------*/
+void Timing_Enable();
+
+/*--------------------------------------
+ * Function: Timing_End()
+ * Parameters:
+ *
+ * Description:
+ *   Avslutar den pgende fasen. Tiden fram till nsta Timing_Begin(), ex.
+ *   nr anvndaren skriver in vrden, rknas inte.
+ *------------------------------------*/
+void Timing_End();
+
+/*--------------------------------------
+ * Function: Timing_PeakBytes()
+ * Parameters:
+ *
+ * Description:
+ *   Returnerar det strsta minnesbehovet hittills, rknat frn
+ *   Timing_Enable().
+ *------------------------------------*/
+long long Timing_PeakBytes();
+
+/*--------------------------------------
+ * Function: Timing_Report()
+ * Parameters:
+ *
+ * Description:
+ *   Avslutar den pgende fasen och skriver ut tiden, antalet allokeringar,
+ *   antalet allokerade byte och det strsta minnesbehovet fr varje fas.
+ *   Stnger sedan av tidtagningen. Gr ingenting om Timing_Enable() inte
+ *   anropats.
+ *------------------------------------*/
+void Timing_Report();
+
+#endif // TIMING_H_
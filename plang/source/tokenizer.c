@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: tokenizer.c
  * Created: January 2, 2015
- * Last changed: February 19, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -12,7 +12,13 @@
  * Changes:
  *   * Tokeniseraren skiljer inte lngre p gemener och versaler.
  *   * Anvnder Str_CompareI() fr att hitta nyckelord istllet fr case-satser.
- *
+ *   * Tokens pekar in i kllkoden istllet fr att kopiera sina strngar, och
+ *     variabelnummer och heltal avkodas redan hr.
+ *   * Nyckelord sls upp med en perfekt hashning istllet fr Str_CompareI(),
+ *     och tecken klassas med en tabell istllet fr Chr_IsAlphaNum().
+ *   * Mellanslag och kommentarer hoppas ver 16 tecken t gngen med SSE2.
+ *   * Tok_Next() delar upp kllkoden en token i taget, s att syntax-
+ *     kontrollen och syntax-trdet inte behver ngon token-array.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
@@ -24,10 +30,419 @@
 #include "string.h"
 #include "tokenizer.h"
 
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+/*------------------------------------------------
+ * CONSTANTS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Constant: MIN_CHARS_PER_TOKEN
+ *
+ * Description:
+ *   Det minsta genomsnittliga antalet tecken per token, inklusive mellanslag
+ *   och kommentarer, som Tok_Tokenize() rknar med nr den reserverar plats.
+ *   Exempelprogrammen och de som gen.h genererar har runt fem.
+ *------------------------------------*/
+#define MIN_CHARS_PER_TOKEN 4
+
+/*--------------------------------------
+ * Constant: SSE2_SUPPORTED
+ *
+ * Description:
+ *   Definieras om processorn har SSE2, vilket alla x86-64-processorer har.
+ *   Annars hoppas mellanslag och kommentarer ver ett tecken t gngen.
+ *------------------------------------*/
+#if defined(__SSE2__) || defined(_M_X64) \
+ || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SSE2_SUPPORTED
+#endif
+
+#ifdef SSE2_SUPPORTED
+#    include <emmintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#endif
+
+/*--------------------------------------
+ * Constant: CHR_ALPHA
+ *
+ * Description:
+ *   Klassen fr bokstverna A-Z och a-z i char_classes.
+ *------------------------------------*/
+#define CHR_ALPHA 0x01
+
+/*--------------------------------------
+ * Constant: CHR_DIGIT
+ *
+ * Description:
+ *   Klassen fr siffrorna 0-9 i char_classes.
+ *------------------------------------*/
+#define CHR_DIGIT 0x02
+
+/*--------------------------------------
+ * Constant: CHR_BLANK
+ *
+ * Description:
+ *   Klassen fr mellanslag, tab och CR i char_classes. Radbrytningar r inte
+ *   med, eftersom de ndrar raden.
+ *------------------------------------*/
+#define CHR_BLANK 0x04
+
+/*--------------------------------------
+ * Constant: CHR_ALNUM
+ *
+ * Description:
+ *   De tecken som kan ing i ett ord: nyckelord, variabler och heltal.
+ *------------------------------------*/
+#define CHR_ALNUM (CHR_ALPHA | CHR_DIGIT)
+
+/*------------------------------------------------
+ * MACROS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Macro: CHAR_CLASS
+ *
+ * Description:
+ *   Slr upp ett teckens klass i char_classes.
+ *------------------------------------*/
+#define CHAR_CLASS(c) (char_classes[(unsigned char)(c)])
+
+/*--------------------------------------
+ * Macro: KEYWORD_HASH
+ *
+ * Description:
+ *   Hashar ett ord p dess frsta tecken och lngd, s att alla nyckelord
+ *   hamnar p olika vrden mellan noll och sju. Biten som skiljer gemener
+ *   frn versaler frsvinner nr tecknet skiftas och maskas, s hashen r
+ *   densamma oavsett hur ordet r skrivet.
+ *------------------------------------*/
+#define KEYWORD_HASH(first, len) ((((first) >> 1) - (len)) & 7)
+
+/*--------------------------------------
+ * Macro: KEYWORDS
+ *
+ * Description:
+ *   Alla nyckelord i P, med token-typ, frsta bokstav och stavning med
+ *   versaler. Bde LookupKeyword() och Tok_GetString() byggs av listan, s
+ *   ett nytt nyckelord behver bara lggas till hr. Den frsta bokstaven
+ *   str fr sig eftersom KEYWORD_HASH() mste f en konstant. Om tv
+ *   nyckelord fr samma hash blir det tv likadana case-etiketter i
+ *   LookupKeyword(), och d gr programmet inte att kompilera.
+ *------------------------------------*/
+#define KEYWORDS(X)                   \
+    X(PTOK_DO     , 'D', "DO"     ) \
+    X(PTOK_END    , 'E', "END"    ) \
+    X(PTOK_PRED   , 'P', "PRED"   ) \
+    X(PTOK_PROGRAM, 'P', "PROGRAM") \
+    X(PTOK_RESULT , 'R', "RESULT" ) \
+    X(PTOK_SUCC   , 'S', "SUCC"   ) \
+    X(PTOK_WHILE  , 'W', "WHILE"  )
+
+/*------------------------------------------------
+ * GLOBALS
+ *----------------------------------------------*/
+
+/*--------------------------------------
+ * Global: char_classes
+ *
+ * Description:
+ *   Klassen fr varje tecken. Tecken ver 0x7f r inte med, och har drmed
+ *   ingen klass.
+ *------------------------------------*/
+#define NON 0
+#define ALP CHR_ALPHA
+#define BLK CHR_BLANK
+#define DIG CHR_DIGIT
+
+static const unsigned char char_classes[256] = {
+    NON,NON,NON,NON,NON,NON,NON,NON,NON,BLK,NON,NON,NON,BLK,NON,NON, // 0x00
+    NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON, // 0x10
+    BLK,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON,NON, // 0x20
+    DIG,DIG,DIG,DIG,DIG,DIG,DIG,DIG,DIG,DIG,NON,NON,NON,NON,NON,NON, // 0x30
+    NON,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP, // 0x40
+    ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,NON,NON,NON,NON,NON, // 0x50
+    NON,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP, // 0x60
+    ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,ALP,NON,NON,NON,NON,NON  // 0x70
+};
+
+#undef NON
+#undef ALP
+#undef BLK
+#undef DIG
+
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
+#ifdef SSE2_SUPPORTED
+
+/*--------------------------------------
+ * Function: CountBits()
+ * Parameters:
+ *   mask  En bitmask.
+ *
+ * Description:
+ *   Returnerar antalet ettor i masken. Den anvnds fr tab-tecken, som r
+ *   ovanliga, s varje etta tar ett varv.
+ *------------------------------------*/
+static int CountBits(unsigned int mask) {
+    int num_bits = 0;
+
+    while (mask) {
+        mask &= mask - 1;
+        num_bits++;
+    }
+
+    return num_bits;
+}
+
+/*--------------------------------------
+ * Function: FirstBit()
+ * Parameters:
+ *   mask  En bitmask som inte r noll.
+ *
+ * Description:
+ *   Returnerar index fr den lgsta ettan i masken.
+ *------------------------------------*/
+static int FirstBit(unsigned int mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/*--------------------------------------
+ * Function: LoadBlock()
+ * Parameters:
+ *   s     Ett tecken i kllkoden.
+ *   skip  Pekare till dr en mask fr tecknen fre s i blocket ska lagras.
+ *
+ * Description:
+ *   Returnerar brjan p det block om 16 tecken som s ligger i. Blocken
+ *   brjar p adresser delbara med 16, s ett block strcker sig aldrig in
+ *   p en minnessida efter kllkodens slut, ven om det lser frbi det
+ *   avslutande NUL-tecknet.
+ *------------------------------------*/
+static const char* LoadBlock(const char* s, unsigned int* skip) {
+    const char* block = (const char*)((uintptr_t)s & ~(uintptr_t)15);
+
+    *skip = (1u << (s - block)) - 1;
+    return block;
+}
+
+#endif // SSE2_SUPPORTED
+
+/*--------------------------------------
+ * Function: DecodeNumber()
+ * Parameters:
+ *   tok     Den token som talet ska lagras i.
+ *   digits  Talets frsta siffra.
+ *   len     Antalet tecken i talet.
+ *
+ * Description:
+ *   Lagrar talet i tokenens value, och stter overflow om det inte ryms i en
+ *   int. Returnerar falskt om ngot av tecknen inte r en siffra.
+ *------------------------------------*/
+static Bool DecodeNumber(P_Token* tok, const char* digits, int len) {
+    int  value    = 0;
+    Bool overflow = FALSE;
+
+    for (int i = 0; i < len; i++) {
+        if (!(CHAR_CLASS(digits[i]) & CHR_DIGIT))
+            return FALSE;
+
+        int digit = digits[i] - '0';
+        if (value > (INT_MAX - digit) / 10)
+            overflow = TRUE;
+        else
+            value = 10*value + digit;
+    }
+
+    tok->value    = value;
+    tok->overflow = overflow;
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: IsKeyword()
+ * Parameters:
+ *   word     Ordets frsta tecken i kllkoden.
+ *   keyword  Nyckelordet, med versaler. Ordet mste vara lika lngt.
+ *
+ * Description:
+ *   Returnerar sant om ordet r nyckelordet, oavsett gemener och versaler.
+ *   Ordet bestr bara av bokstver och siffror, s det rcker att nolla
+ *   biten som skiljer gemener frn versaler. En siffra blir d ett tecken
+ *   som inte finns i ngot nyckelord.
+ *------------------------------------*/
+static Bool IsKeyword(const char* word, const char* keyword) {
+    for (int i = 0; keyword[i]; i++) {
+        if ((word[i] & ~0x20) != keyword[i])
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: LookupKeyword()
+ * Parameters:
+ *   word  Ordets frsta tecken i kllkoden.
+ *   len   Antalet tecken i ordet.
+ *
+ * Description:
+ *   Returnerar nyckelordets token-typ, eller PTOK_UNKNOWN om ordet inte r
+ *   ett nyckelord. Hashen pekar ut det enda nyckelord som ordet kan vara,
+ *   s det jmfrs med hgst ett.
+ *------------------------------------*/
+static P_Token_Type LookupKeyword(const char* word, int len) {
+#define KEYWORD_CASE(type, first, keyword)                       \
+    case KEYWORD_HASH(first, sizeof(keyword)-1):                \
+        if (len == sizeof(keyword)-1 && IsKeyword(word, keyword)) \
+            return type;                                         \
+        break;
+
+    switch (KEYWORD_HASH(word[0], len)) {
+        KEYWORDS(KEYWORD_CASE)
+    }
+
+#undef KEYWORD_CASE
+
+    return PTOK_UNKNOWN;
+}
+
+/*--------------------------------------
+ * Function: SkipBlanks()
+ * Parameters:
+ *   s    Tecknet efter ett mellanslag, en tab eller en CR.
+ *   col  Pekare till kolumnen fr s, som rknas upp.
+ *
+ * Description:
+ *   Hoppar ver alla mellanslag, tab-tecken och CR som fljer, och returnerar
+ *   det frsta tecknet efter dem. Tab rknas som tta kolumner, precis som i
+ *   Tok_Tokenize().
+ *------------------------------------*/
+static const char* SkipBlanks(const char* s, int* col) {
+    const char* start    = s;
+    int         num_tabs = 0;
+
+    // De flesta mellanslag str ensamma mellan tv tokens, och d lnar det
+    // sig inte att lsa ett helt block.
+    if (!(CHAR_CLASS(*s) & CHR_BLANK))
+        return s;
+
+#ifdef SSE2_SUPPORTED
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i tabs   = _mm_set1_epi8('\t');
+    const __m128i crs    = _mm_set1_epi8('\r');
+
+    // Tecknen fre s i det frsta blocket rknas som mellanslag, men inte
+    // som tab-tecken.
+    unsigned int skip;
+    const char*  block = LoadBlock(s, &skip);
+
+    while (TRUE) {
+        __m128i v      = _mm_load_si128((const __m128i*)block);
+        __m128i is_tab = _mm_cmpeq_epi8(v, tabs);
+        __m128i blank  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, spaces),
+                                                   _mm_cmpeq_epi8(v, crs)),
+                                      is_tab);
+
+        unsigned int tab_mask = _mm_movemask_epi8(is_tab) & ~skip;
+        unsigned int stop     = ~(_mm_movemask_epi8(blank) | skip) & 0xffff;
+
+        if (stop) {
+            int i = FirstBit(stop);
+
+            num_tabs += CountBits(tab_mask & ((1u << i) - 1));
+            s         = block + i;
+            break;
+        }
+
+        num_tabs += CountBits(tab_mask);
+        block    += 16;
+        skip      = 0;
+    }
+#else
+    while (CHAR_CLASS(*s) & CHR_BLANK) {
+        if (*s == '\t')
+            num_tabs++;
+        s++;
+    }
+#endif
+
+    *col += (int)(s - start) + 7*num_tabs;
+    return s;
+}
+
+/*--------------------------------------
+ * Function: SkipComment()
+ * Parameters:
+ *   s  Tecknet efter #.
+ *
+ * Description:
+ *   Returnerar radbrytningen efter kommentaren, eller NUL-tecknet i slutet
+ *   av kllkoden.
+ *------------------------------------*/
+static const char* SkipComment(const char* s) {
+#ifdef SSE2_SUPPORTED
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i zeros    = _mm_setzero_si128();
+
+    unsigned int skip;
+    const char*  block = LoadBlock(s, &skip);
+
+    while (TRUE) {
+        __m128i v   = _mm_load_si128((const __m128i*)block);
+        __m128i end = _mm_or_si128(_mm_cmpeq_epi8(v, newlines),
+                                   _mm_cmpeq_epi8(v, zeros));
+
+        unsigned int stop = _mm_movemask_epi8(end) & ~skip;
+        if (stop)
+            return block + FirstBit(stop);
+
+        block += 16;
+        skip   = 0;
+    }
+#else
+    while (*s && *s != '\n')
+        s++;
+
+    return s;
+#endif
+}
+
+/*--------------------------------------
+ * Function: Tok_CopyText()
+ * Parameters:
+ *   tok       Den token vars text ska kopieras.
+ *   src       Kllkoden som token kommer ifrn.
+ *   buf       Bufferten som texten ska kopieras till.
+ *   buf_size  Buffertens storlek. Lngre text kortas av.
+ *
+ * Description:
+ *   Kopierar tokenens text, s som den str i kllkoden, till buf och
+ *   returnerar buf.
+ *------------------------------------*/
+char* Tok_CopyText(const P_Token* tok, const char* src, char* buf,
+                   int buf_size)
+{
+    int len = (tok->length < buf_size) ? tok->length : buf_size-1;
+
+    memcpy(buf, src + tok->offset, len);
+    buf[len] = '\0';
+
+    return buf;
+}
+
 /*--------------------------------------
  * Function: Tok_GetString()
  * Parameters:
@@ -37,101 +452,126 @@
  *   Den hr funktionen gr om en token till en strng som gr att lsa.
  *------------------------------------*/
 const char* Tok_GetString(const P_Token* tok) {
-    // Variabler och heltal returnerar vi som strngar, s att man kan se deras
-    // innehll direkt.
-    if (tok->type == PTOK_IDENT || tok->type == PTOK_INT)
-        return tok->value;
+#define KEYWORD_CASE(type, first, keyword) case type: return keyword;
 
     switch (tok->type) {
         case PTOK_ASSIGN : return ":=";
         case PTOK_COMMA  : return ",";
-        case PTOK_DO     : return "DO";
-        case PTOK_END    : return "END";
         case PTOK_EOF    : return "<eof>";
         case PTOK_EQ_TEST: return "!=";
+        case PTOK_IDENT  : return "identifier";
+        case PTOK_INT    : return "integer";
         case PTOK_L_PAREN: return "(";
-        case PTOK_PRED   : return "PRED";
-        case PTOK_PROGRAM: return "PROGRAM";
-        case PTOK_RESULT : return "RESULT";
         case PTOK_R_PAREN: return ")";
-        case PTOK_SUCC   : return "SUCC";
         case PTOK_UNKNOWN: return "<unknown>";
-        case PTOK_WHILE  : return "WHILE";
+        KEYWORDS(KEYWORD_CASE)
     }
 
+#undef KEYWORD_CASE
+
     return "<invalid>";
 }
 
 /*--------------------------------------
- * Function: Tok_Tokenize()
+ * Function: Tok_Init()
  * Parameters:
- *   src     En strng som innehller kllkoden till ett program i
- *           programsprket P.
- *   tokens  Den array som alla s.k. tokens ska lagras i.
+ *   tokenizer  Tokeniseraren som ska initieras.
+ *   src        En strng som innehller kllkoden till ett program i
+ *              programsprket P.
  *
  * Description:
- *   Den hr funktionen lser av kllkod skriven i programsprket P och delar
- *   upp den i en array av tokens.
+ *   Gr tokeniseraren redo att dela upp kllkoden med Tok_Next(). Kllkoden
+ *   kopieras inte, s den mste finnas kvar s lnge tokeniseraren anvnds.
  *------------------------------------*/
-void Tok_Tokenize(const char* src, Array* tokens) {
-    int row = 1;
-    int col = 1;
+void Tok_Init(P_Tokenizer* tokenizer, const char* src) {
+    tokenizer->start  = src;
+    tokenizer->src    = src;
+    tokenizer->row    = 1;
+    tokenizer->col    = 1;
+    tokenizer->at_end = FALSE;
+}
+
+/*--------------------------------------
+ * Function: Tok_Next()
+ * Parameters:
+ *   tokenizer  Tokeniseraren som ska lsa nsta token.
+ *   tok        Den token som ska fyllas i.
+ *
+ * Description:
+ *   Lser nsta token ur kllkoden. Den sista r alltid en EOF-token, och
+ *   efter den returnerar funktionen falskt utan att fylla i tok.
+ *------------------------------------*/
+Bool Tok_Next(P_Tokenizer* tokenizer, P_Token* tok) {
+    if (tokenizer->at_end)
+        return FALSE;
+
+    const char* start = tokenizer->start;
+    const char* src   = tokenizer->src;
+    int         row   = tokenizer->row;
+    int         col   = tokenizer->col;
 
     while (TRUE) {
-        char    c   = *(src++);
-        P_Token tok = { .type  = PTOK_UNKNOWN,
-                        .value = NULL,
-                        .col   = col++,
-                        .row   = row };
+        const char* tok_start = src;
+        char        c         = *(src++);
+
+        tok->type     = PTOK_UNKNOWN;
+        tok->col      = col++;
+        tok->row      = row;
+        tok->offset   = (int)(tok_start - start);
+        tok->length   = 1;
+        tok->value    = 0;
+        tok->overflow = FALSE;
 
         if (c == '\0') {
-            tok.type = PTOK_EOF;
-            Array_AddElem(tokens, &tok);
+            tok->type         = PTOK_EOF;
+            tok->length       = 0;
+            tokenizer->at_end = TRUE;
             break;
         }
-
         switch (c) {
         /*----------------------------------------------------
          * Ignorera mellanslag, nya rader osv.
          *--------------------------------------------------*/
-        case '\r':
-        case ' ':
-            continue;
         case '\n':
             row++;
             col = 1;
             continue;
         case '\t':
             // Vi antar att tab r 8 tecken bred, men adderar endast 7 eftersom
-            // vi har col++ ovan. (tok.col = col++).
+            // vi har col++ ovan. (tok->col = col++).
             col += 7;
+            /* fall through */
+        case '\r':
+        case ' ':
+            // Resten av mellanslagen hoppas ver i ett svep.
+            src = SkipBlanks(src, &col);
             continue;
 
         /*----------------------------------------------------
          * Kommentar.
          *--------------------------------------------------*/
         case '#':
-            while (*src && *src != '\n')
-                src++;
+            src = SkipComment(src);
             continue;
 
         /*----------------------------------------------------
          * Komma.
          *--------------------------------------------------*/
-        case ',': tok.type = PTOK_COMMA; break;
+        case ',': tok->type = PTOK_COMMA; break;
 
         /*----------------------------------------------------
          * Parenteser.
          *--------------------------------------------------*/
-        case '(': tok.type = PTOK_L_PAREN; break;
-        case ')': tok.type = PTOK_R_PAREN; break;
+        case '(': tok->type = PTOK_L_PAREN; break;
+        case ')': tok->type = PTOK_R_PAREN; break;
         
         /*----------------------------------------------------
          * Frmodligen tilldelning. (:=)
          *--------------------------------------------------*/
         case ':':
             if (*src == '=') {
-                tok.type = PTOK_ASSIGN;
+                tok->type   = PTOK_ASSIGN;
+                tok->length = 2;
                 src++; col++;
             }
             break;
@@ -141,7 +581,8 @@ void Tok_Tokenize(const char* src, Array* tokens) {
          *--------------------------------------------------*/
         case '!':
             if (*src == '=') {
-                tok.type = PTOK_EQ_TEST;
+                tok->type   = PTOK_EQ_TEST;
+                tok->length = 2;
                 src++; col++;
             }
             break;
@@ -150,37 +591,80 @@ void Tok_Tokenize(const char* src, Array* tokens) {
          * Nyckelord, variabel, heltal...
          *--------------------------------------------------*/
         default:
-            if (!Chr_IsAlphaNum(c)) break;
+            if (!(CHAR_CLASS(c) & CHR_ALNUM)) break;
 
-            char buf[1024];
-            int  i = 1;
-
-            buf[0] = c;
-            while ((c = *src) && Chr_IsAlphaNum(c)) {
+            while (CHAR_CLASS(*src) & CHR_ALNUM) {
                 src++; col++;
-                if (i < (sizeof(buf)-1))
-                    buf[i++] = c;
             }
 
-            buf[i] = '\0';
-
-                 if (Str_CompareI(buf, "DO"     )==0) tok.type = PTOK_DO;
-            else if (Str_CompareI(buf, "END"    )==0) tok.type = PTOK_END;
-            else if (Str_CompareI(buf, "PRED"   )==0) tok.type = PTOK_PRED;
-            else if (Str_CompareI(buf, "PROGRAM")==0) tok.type = PTOK_PROGRAM;
-            else if (Str_CompareI(buf, "RESULT" )==0) tok.type = PTOK_RESULT;
-            else if (Str_CompareI(buf, "SUCC"   )==0) tok.type = PTOK_SUCC;
-            else if (Str_CompareI(buf, "WHILE"  )==0) tok.type = PTOK_WHILE;
-            else if (Chr_ToLower(buf[0])=='x') {
-                tok.type  = PTOK_IDENT;
-                tok.value = Str_Duplicate(buf);
+            const char* word = tok_start;
+            int         len  = (int)(src - word);
+
+            tok->length = len;
+
+            // Inget nyckelord brjar med X eller en siffra, s de orden
+            // behver inte sls upp.
+            if (CHAR_CLASS(c) & CHR_DIGIT) {
+                if (DecodeNumber(tok, word, len))
+                    tok->type = PTOK_INT;
             }
-            else if (Str_IsNumeric(buf)) {
-                tok.type  = PTOK_INT;
-                tok.value = Str_Duplicate(buf);
+            else if (c == 'X' || c == 'x') {
+                // Variabelns nummer avkodas hr, s att senare steg slipper
+                // anropa atoi().
+                tok->type = PTOK_IDENT;
+                if (len < 2 || !DecodeNumber(tok, word+1, len-1))
+                    tok->value = -1;
+            }
+            else {
+                tok->type = LookupKeyword(word, len);
             }
         }
 
-        Array_AddElem(tokens, &tok);
+        break;
     } // while (TRUE)
+
+    tokenizer->src = src;
+    tokenizer->row = row;
+    tokenizer->col = col;
+
+    return TRUE;
+}
+
+/*--------------------------------------
+ * Function: Tok_Peek()
+ * Parameters:
+ *   tokenizer  Tokeniseraren vars nsta token ska lsas.
+ *   tok        Den token som ska fyllas i.
+ *
+ * Description:
+ *   Lser nsta token utan att tokeniseraren gr vidare, s att samma token
+ *   lses igen av nsta Tok_Next(). Returnerar falskt efter EOF-token.
+ *------------------------------------*/
+Bool Tok_Peek(const P_Tokenizer* tokenizer, P_Token* tok) {
+    P_Tokenizer copy = *tokenizer;
+    return Tok_Next(&copy, tok);
+}
+
+/*--------------------------------------
+ * Function: Tok_Tokenize()
+ * Parameters:
+ *   src     En strng som innehller kllkoden till ett program i
+ *           programsprket P.
+ *   tokens  Den array som alla s.k. tokens ska lagras i.
+ *
+ * Description:
+ *   Den hr funktionen lser av kllkod skriven i programsprket P och delar
+ *   upp den i en array av tokens. Plats fr alla tokens reserveras i frvg
+ *   utifrn kllkodens lngd, s arrayen behver sllan vxa.
+ *------------------------------------*/
+void Tok_Tokenize(const char* src, Array* tokens) {
+    P_Tokenizer tokenizer;
+    P_Token     tok;
+
+    Array_Reserve(tokens, Array_Length(tokens)
+                        + Str_Length(src) / MIN_CHARS_PER_TOKEN + 1);
+
+    Tok_Init(&tokenizer, src);
+    while (Tok_Next(&tokenizer, &tok))
+        Array_AddElem(tokens, &tok);
 }
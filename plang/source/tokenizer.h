@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: tokenizer.h
  * Created: January 2, 2015
- * Last changed: January 4, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -10,7 +10,10 @@
  *   fr programsprket P.
  *
  * Changes:
- *
+ *   * Tokens pekar in i kllkoden istllet fr att kopiera sina strngar, och
+ *     variabelnummer och heltal avkodas redan i Tok_Tokenize().
+ *   * Tok_Init(), Tok_Next() och Tok_Peek() delar upp kllkoden en token i
+ *     taget, utan ngon token-array.
  *----------------------------------------------------------------------------*/
 
 #ifndef TOKENIZER_H_
@@ -21,6 +24,7 @@
  *----------------------------------------------*/
 
 #include "array.h"
+#include "common.h"
 
 /*------------------------------------------------
  * TYPES
@@ -56,19 +60,59 @@ typedef enum {
  * Type: P_Token
  *
  * Description:
- *   Den hr typen beskriver en s.k. token i programsprket P.
+ *   Den hr typen beskriver en s.k. token i programsprket P. Tokenens text
+ *   r de length tecknen frn offset i kllkoden, se Tok_CopyText().
+ *
+ *   Fr heltal r value heltalets vrde, och fr variabler talet efter X,
+ *   eller -1 om det inte bara r siffror dr. overflow r sant om talet inte
+ *   ryms i en int, och value r d odefinierat.
  *------------------------------------*/
 typedef struct {
     P_Token_Type type;
     int          row;
     int          col;
-    char*        value;
+    int          offset;
+    int          length;
+    int          value;
+    Bool         overflow;
 } P_Token;
 
+/*--------------------------------------
+ * Type: P_Tokenizer
+ *
+ * Description:
+ *   En tokeniserare som delar upp kllkoden en token i taget, se Tok_Next().
+ *   Den r liten och pekar bara in i kllkoden, s en kopia kan lsa tokens
+ *   i frvg utan att originalet pverkas. Om at_end stts till sant fr
+ *   man inga fler tokens.
+ *------------------------------------*/
+typedef struct {
+    const char* start;
+    const char* src;
+    int         row;
+    int         col;
+    Bool        at_end;
+} P_Tokenizer;
+
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
+/*--------------------------------------
+ * Function: Tok_CopyText()
+ * Parameters:
+ *   tok       Den token vars text ska kopieras.
+ *   src       Kllkoden som token kommer ifrn.
+ *   buf       Bufferten som texten ska kopieras till.
+ *   buf_size  Buffertens storlek. Lngre text kortas av.
+ *
+ * Description:
+ *   Kopierar tokenens text, s som den str i kllkoden, till buf och
+ *   returnerar buf.
+ *------------------------------------*/
+char* Tok_CopyText(const P_Token* tok, const char* src, char* buf,
+                   int buf_size);
+
 /*--------------------------------------
  * Function: Tok_GetString()
  * Parameters:
@@ -76,9 +120,48 @@ typedef struct {
  *
  * Description:
  *   Den hr funktionen gr om en token till en strng som gr att lsa.
+ *   Variabler och heltal blir "identifier" respektive "integer", eftersom
+ *   deras text bara finns i kllkoden, se Tok_CopyText().
  *------------------------------------*/
 const char* Tok_GetString(const P_Token* tok);
 
+/*--------------------------------------
+ * Function: Tok_Init()
+ * Parameters:
+ *   tokenizer  Tokeniseraren som ska initieras.
+ *   src        En strng som innehller kllkoden till ett program i
+ *              programsprket P.
+ *
+ * Description:
+ *   Gr tokeniseraren redo att dela upp kllkoden med Tok_Next(). Kllkoden
+ *   kopieras inte, s den mste finnas kvar s lnge tokeniseraren anvnds.
+ *------------------------------------*/
+void Tok_Init(P_Tokenizer* tokenizer, const char* src);
+
+/*--------------------------------------
+ * Function: Tok_Next()
+ * Parameters:
+ *   tokenizer  Tokeniseraren som ska lsa nsta token.
+ *   tok        Den token som ska fyllas i.
+ *
+ * Description:
+ *   Lser nsta token ur kllkoden. Den sista r alltid en EOF-token, och
+ *   efter den returnerar funktionen falskt utan att fylla i tok.
+ *------------------------------------*/
+Bool Tok_Next(P_Tokenizer* tokenizer, P_Token* tok);
+
+/*--------------------------------------
+ * Function: Tok_Peek()
+ * Parameters:
+ *   tokenizer  Tokeniseraren vars nsta token ska lsas.
+ *   tok        Den token som ska fyllas i.
+ *
+ * Description:
+ *   Lser nsta token utan att tokeniseraren gr vidare, s att samma token
+ *   lses igen av nsta Tok_Next(). Returnerar falskt efter EOF-token.
+ *------------------------------------*/
+Bool Tok_Peek(const P_Tokenizer* tokenizer, P_Token* tok);
+
 /*--------------------------------------
  * Function: Tok_Tokenize()
  * Parameters:
@@ -88,7 +171,8 @@ const char* Tok_GetString(const P_Token* tok);
  *
  * Description:
  *   Den hr funktionen lser av kllkod skriven i programsprket P och delar
- *   upp den i en array av tokens.
+ *   upp den i en array av tokens. Plats fr alla tokens reserveras i frvg
+ *   utifrn kllkodens lngd, s arrayen behver sllan vxa.
  *------------------------------------*/
 void Tok_Tokenize(const char* src, Array* tokens);
 
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: vm.c
  * Created: January 3, 2015
- * Last changed: January 11, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -15,6 +15,33 @@
  *     under noll .
  *   * Std fr VM_Config.
  *   * Felkod fr overflow.
+ *   * VM_ExecBytecode() kr bytekod i en platt loop istllet fr rekursion.
+ *   * Std fr AST_ADD_CLEAR- och AST_COPY-noder.
+ *   * Sammanfattade loopar krs i konstant tid om sammanfattningen gller.
+ *   * NO_RESULT har flyttats till vm.h som VM_NO_RESULT.
+ *   * Variablerna ligger i en tt array, och skrivs ut med sina ursprungliga
+ *     namn av VM_StateDump().
+ *   * VM_ExecBignum() kr bytekod med godtyckligt stora variabler.
+ *   * Bytekodsloopen genereras frn vmexec.h, i en variant fr int, en fr
+ *     long long och en fr int med mttnad istllet fr overflow.
+ *   * VM_ExecLanes() kr programmet med VM_LANES uppsttningar variabler
+ *     samtidigt.
+ *   * Den avstngda kontrollen av ondliga loopar har ersatts av grnser fr
+ *     antalet loop-varv och krtiden, som kontrolleras nr loopar hoppar
+ *     tillbaka till brjan.
+ *   * Med detect_loops upptcks ondliga loopar med Brents algoritm.
+ *   * Debug-lget stannar bara vid brytpunkter, eller vid varje sats om
+ *     anvndaren stegar, istllet fr vid varje loop-varv.
+ *   * Noder med profileringsrknare rknas och tidtas av VM_ExecAST().
+ *   * VM_CheckLimits() rapporterar hur lngt krningen kommit via
+ *     VM_Config.progress.
+ *   * VM_ExecAST() rknar antalet satser som krs.
+ *   * VM_CheckLimits() fr loopens nod ven frn bytekoden, och rapporterar
+ *     den istllet fr loopens variabel.
+ *   * VM_CountStatements() och VM_CountStatements64() rknar satserna i
+ *     bytekoden.
+ *   * VM_CheckLimits() sparar noden fr loopen som ndde en grns i
+ *     VM_Config.limit_loop.
  *----------------------------------------------------------------------------*/
 
 /*------------------------------------------------
@@ -23,71 +50,145 @@
 
 #include "array.h"
 #include "ast.h"
+#include "bignum.h"
+#include "breakpoint.h"
+#include "bytecode.h"
 #include "common.h"
 #include "debug.h"
 #include "io.h"
+#include "profile.h"
+#include "string.h"
+#include "summary.h"
+#include "thread.h"
 #include "vm.h"
 
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
 /*------------------------------------------------
  * CONSTANTS
  *----------------------------------------------*/
 
 /*--------------------------------------
- * Constant: NO_RESULT
+ * Constant: DEADLINE_INTERVAL
  *
  * Description:
- *   Indikerar att inget resultat finns.
+ *   Antalet hopp tillbaka mellan varje gng klockan lses av, nr krningen
+ *   har en tidsgrns. Att lsa av klockan tar betydligt lngre tid n ett
+ *   loop-varv, s vi gr det inte oftare n s hr.
  *------------------------------------*/
-#define NO_RESULT -1
+#define DEADLINE_INTERVAL 65536
 
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
 /*--------------------------------------
- * Function: IsLastNode()
+ * Function: PrintValue()
+ * Parameters:
+ *   vm   Den virtuella maskinens konfiguration.
+ *   var  Variabeln vars vrde ska skrivas ut.
+ *
+ * Description:
+ *   Skriver ut ett mellanslag fljt av variabelns vrde, frn vars64 eller
+ *   big_vars om programmet krs med VM_ExecBytecode64() eller VM_ExecBignum().
+ *------------------------------------*/
+static void PrintValue(const VM_Config* vm, int var) {
+    if (vm->big_vars != NULL) {
+        char* s = Big_ToStr(&vm->big_vars[var]);
+        printf(" %s", s);
+        free(s);
+    }
+    else if (vm->vars64 != NULL) {
+        printf(" %lld", vm->vars64[var]);
+    }
+    else {
+        printf(" %d", vm->vars[var]);
+    }
+}
+
+/*--------------------------------------
+ * Function: DebugStop()
  * Parameters:
- *   node  Noden som ska kontrolleras.
+ *   node  Satsen som ska kras hrnst.
+ *   vm    Den virtuella maskinens konfiguration.
  *
  * Description:
- *   Kontrollerar om den specificerade noden r den sista i sitt trd.
+ *   Anropas i debug-lge fre satser som har brytpunkter, och fre alla
+ *   satser om vm->single_step r sant. Om ngon brytpunkt trffas, eller om
+ *   vi stegar, skrivs kllkod och variabelvrden ut och anvndaren fr
+ *   vlja hur krningen ska fortstta.
  *------------------------------------*/
-static Bool IsLastNode(const AST_Node* node) {
-    // Om den angivna noden har ngra barn kan vi g en niv nedt, varfr den
-    // omjligt kan vara den sista i trdet.
-    int num_children = Array_Length(&node->children);
-    if (num_children > 0)
-        return FALSE;
+static void DebugStop(AST_Node* node, VM_Config* vm) {
+    const Break_Point* bp = Break_Check(node->breakpoints, vm->vars);
+    if (bp == NULL && !vm->single_step)
+        return;
 
-    AST_Node* parent = node->parent;
-    if (parent) {
-        int       num_siblings = Array_Length(&parent->children);
-        AST_Node* last_sibling = Array_GetElemPtr(&parent->children, num_siblings-1);
+    printf("\n");
+    VM_StateDump(AST_FindRoot(node), 0, vm);
 
-        // Om den specificerade noden inte r den sista i syskonskaran s r det
-        // inte heller den sista noden i sitt trd.
-        if (node != last_sibling)
-            return FALSE;
+    if (bp != NULL) {
+        printf("\nBreakpoint hit at ");
+        Break_Print(bp);
+        printf(".\n");
+    }
+    else {
+        printf("\nStopped at line %d.\n", node->row);
     }
 
-    return TRUE;
+    while (TRUE) {
+        printf("\nENTER: continue, S: step, B <line> [if X<n> op <value>]: "
+               "add breakpoint\n> ");
+
+        char* cmd = IO_GetStrFromUser();
+        char  c   = (char)tolower((unsigned char)cmd[0]);
+
+        if (c == '\0' || (c == 's' && cmd[1] == '\0')) {
+            // Vid ENTER kr vi till nsta brytpunkt, och vid S till nsta
+            // sats.
+            vm->single_step = (c == 's');
+            Str_Free(cmd);
+            return;
+        }
+
+        Break_Point new_bp;
+        if (c != 'b' || !Break_Parse(cmd+1, &new_bp)) {
+            printf("Invalid command.\n");
+        }
+        else {
+            int row = Break_Add(AST_FindRoot(node), &new_bp, vm->var_names,
+                                vm->num_vars);
+            if (row == 0)
+                printf("No statement on or after line %d.\n", new_bp.row);
+            else
+                printf("Breakpoint set at line %d.\n", row);
+        }
+
+        Str_Free(cmd);
+    }
 }
 
+// ExecStmt() och ExecNode() anropar varandra.
+static void ExecNode(AST_Node* node, VM_Config* vm, VM_Limits* limits,
+                     int* result);
+
 /*--------------------------------------
- * Function: ExecNode()
+ * Function: ExecStmt()
  * Parameters:
  *   node    Den nod som ska kras.
  *   vm      Den virtuella maskinens konfiguration.
+ *   limits  Krningens grnser, se VM_StartLimits().
  *   result  Pekare till den int som resultatet till slut ska sparas i.
  *
  * Description:
- *   Exekverar den specificerade AST-noden.
+ *   Exekverar den specificerade AST-noden. Barn-noderna krs med
+ *   ExecNode().
  *------------------------------------*/
-static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
-    // Om ett resultat lagrats avbryter vi exekveringen.
-    if (*result != NO_RESULT)
-        return;
-
+static void ExecStmt(AST_Node* node, VM_Config* vm, VM_Limits* limits,
+                     int* result)
+{
     switch (node->type) {
     /*----------------------------------------------------
      * PROGRAM (<variabel>[, <variabel>])
@@ -98,13 +199,54 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
 
         int num_children = Array_Length(&node->children);
         for (int i = 0; i < num_children; i++) {
-            if (*result != NO_RESULT)
+            if (*result != VM_NO_RESULT)
                 return;
 
             AST_Node* child = Array_GetElemPtr(&node->children, i);
-            ExecNode(child, vm, result);
+            ExecNode(child, vm, limits, result);
+        }
+
+        break;
+    }
+
+    /*----------------------------------------------------
+     * X<src> * faktor lggs till andra variabler, X<src> := 0
+     *--------------------------------------------------*/
+    case AST_ADD_CLEAR: {
+        // Erstter en hel loop, se Opt_OptimizeTree(). Vi rknar med long
+        // long s att vi kan upptcka overflow innan vi skriver tillbaka.
+
+        int src = *(int*)Array_GetElemPtr(&node->values, 0);
+        if (src < 0 || src >= vm->num_vars) {
+            *result = VM_ERR_INVALID_VAR;
+            return;
+        }
+
+        int*      vars   = vm->vars;
+        long long amount = vars[src];
+
+        int num_values = Array_Length(&node->values);
+        for (int i = 1; i < num_values; i += 2) {
+            int var    = *(int*)Array_GetElemPtr(&node->values, i);
+            int factor = *(int*)Array_GetElemPtr(&node->values, i+1);
+            if (var < 0 || var >= vm->num_vars) {
+                *result = VM_ERR_INVALID_VAR;
+                return;
+            }
+
+            long long val = vars[var] + factor*amount;
+            if (val < 0)
+                val = 0; // Negativa faktorer motsvarar PRED.
+
+            if (val > INT_MAX) {
+                *result = VM_ERR_OVERFLOW;
+                return;
+            }
+
+            vars[var] = (int)val;
         }
 
+        vars[src] = 0;
         break;
     }
 
@@ -116,7 +258,7 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
         // arrayen.
 
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
-        if (var < 0 || var >= PLANG_NUM_VARS) {
+        if (var < 0 || var >= vm->num_vars) {
             *result = VM_ERR_INVALID_VAR;
             return;
         }
@@ -129,6 +271,32 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
         break;
     }
 
+    /*----------------------------------------------------
+     * X<dst> := X<src>
+     *--------------------------------------------------*/
+    case AST_COPY: {
+        // Erstter X<dst> := SUCC(X<src>) fljt av X<dst> := PRED(X<dst>), s
+        // vi mste ge overflow p samma stt som SUCC.
+
+        int dst = *(int*)Array_GetElemPtr(&node->values, 0);
+        int src = *(int*)Array_GetElemPtr(&node->values, 1);
+        if (dst < 0 || dst >= vm->num_vars
+         || src < 0 || src >= vm->num_vars)
+        {
+            *result = VM_ERR_INVALID_VAR;
+            return;
+        }
+
+        if (vm->vars[src] == INT_MAX) {
+            vm->vars[dst] = INT_MIN;
+            *result = VM_ERR_OVERFLOW;
+            return;
+        }
+
+        vm->vars[dst] = vm->vars[src];
+        break;
+    }
+
     /*----------------------------------------------------
      * <variabel> := PRED(<variabel>)
      * <variabel> := SUCC(<variabel>)
@@ -141,8 +309,8 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
 
         int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
         int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
-        if (var0 < 0 || var0 >= PLANG_NUM_VARS
-         || var1 < 0 || var1 >= PLANG_NUM_VARS)
+        if (var0 < 0 || var0 >= vm->num_vars
+         || var1 < 0 || var1 >= vm->num_vars)
         {
             *result = VM_ERR_INVALID_VAR;
             return;
@@ -182,45 +350,44 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
         // igen tills variabeln i loop-villkoret nr vrdet noll.
 
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
-        if (var < 0 || var >= PLANG_NUM_VARS) {
+        if (var < 0 || var >= vm->num_vars) {
             *result = VM_ERR_INVALID_VAR;
             return;
         }
 
-        if (vm->enable_debug) {
-            VM_StateDump(AST_FindRoot(node), 0, vm);
-            IO_Pause();
-        }
-
-        int val = vm->vars[var]; // Vi anvnder val fr att motverka ondliga
-                                 // loopar.
+        // Om loopen har sammanfattats, och sammanfattningen gller fr de
+        // nuvarande vrdena, behver vi inte kra loopen alls.
+        if (node->summary != NULL && Sum_Apply(node->summary, vm->vars))
+            break;
 
         int num_children = Array_Length(&node->children);
         while (vm->vars[var]) {
             for (int i = 0; i < num_children; i++) {
-                if (*result != NO_RESULT)
+                if (*result != VM_NO_RESULT)
                     return;
 
                 AST_Node* child = Array_GetElemPtr(&node->children, i);
-                ExecNode(child, vm, result);
+                ExecNode(child, vm, limits, result);
             }
 
-            if (vm->vars[var] == val) {
-                // Variabeln i loop-villkoret har inte frndats efter en hel
-                // iteration, vilket mste innebra att den hr loopen r
-                // ondlig. Vi kan likvl hoppa hur den hr, annars kommer
-                // programmet att hnga sig.
-                // TODO: Den hr kontrollen gr inte att lita p, hitta p en
-                //         bttre.
-                //*result = VM_ERR_INF_LOOP;
-                //return;
+            // Ondliga loopar gr inte att upptcka i allmnhet, s istllet
+            // avbryter vi loopen om den nr ngon av grnserna i vm.
+            if (*result == VM_NO_RESULT && vm->vars[var] != 0
+             && --limits->budget == 0)
+            {
+                long long budget = VM_CheckLimits(limits, node, var);
+                if (budget < 0) {
+                    *result = (int)budget;
+                    return;
+                }
             }
 
-            if (vm->enable_debug) {
-                // I debug-lge pausar vi loopen och skriver ut kllkod samt
-                // variabelvrden.
-                VM_StateDump(AST_FindRoot(node), 0, vm);
-                IO_Pause();
+            // Villkoret prvas igen, s brytpunkter p loopen gller fr
+            // varje varv.
+            if (vm->enable_debug
+             && (vm->single_step || node->breakpoints != NULL))
+            {
+                DebugStop(node, vm);
             }
         }
 
@@ -236,13 +403,13 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
 
         // TODO: Undersk om det r lmpligare att spara index till variabeln.
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
-        if (var < 0 || var >= PLANG_NUM_VARS) {
+        if (var < 0 || var >= vm->num_vars) {
             *result = VM_ERR_INVALID_VAR;
             return;
         }
 
-        *result = IsLastNode(node) ? vm->vars[var]
-                                   : VM_ERR_PREMATURE_RESULT;
+        *result = AST_IsLastNode(node) ? vm->vars[var]
+                                       : VM_ERR_PREMATURE_RESULT;
 
         break;
     }
@@ -253,6 +420,317 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
     }
 }
 
+/*--------------------------------------
+ * Function: ExecNode()
+ * Parameters:
+ *   node    Den nod som ska kras.
+ *   vm      Den virtuella maskinens konfiguration.
+ *   limits  Krningens grnser, se VM_StartLimits().
+ *   result  Pekare till den int som resultatet till slut ska sparas i.
+ *
+ * Description:
+ *   Exekverar den specificerade AST-noden, och stannar vid brytpunkter samt
+ *   rknar upp nodens profileringsrknare, se profile.h.
+ *------------------------------------*/
+static void ExecNode(AST_Node* node, VM_Config* vm, VM_Limits* limits,
+                     int* result)
+{
+    // Om ett resultat lagrats avbryter vi exekveringen.
+    if (*result != VM_NO_RESULT)
+        return;
+
+    vm->num_stmts++;
+
+    // I debug-lge behver vi bara titta nrmare p satser med brytpunkter,
+    // s mellan trffarna krs programmet i full fart.
+    if (vm->enable_debug && node->type != AST_PROGRAM
+     && (vm->single_step || node->breakpoints != NULL))
+    {
+        DebugStop(node, vm);
+    }
+
+    if (node->profile == NULL) {
+        ExecStmt(node, vm, limits, result);
+        return;
+    }
+
+    // Tiden rknas inklusive barn-noderna. Prof_Report() drar av deras tid.
+    double start = Thread_WallTimeMs();
+    ExecStmt(node, vm, limits, result);
+    node->profile->total_ms += Thread_WallTimeMs() - start;
+    node->profile->count++;
+}
+
+/*--------------------------------------
+ * Function: NextInterval()
+ * Parameters:
+ *   limits  Krningens grnser.
+ *
+ * Description:
+ *   Returnerar antalet hopp tillbaka till nsta gng grnserna behver
+ *   kontrolleras. Utan grnser blir det s mnga att det aldrig hnder.
+ *------------------------------------*/
+static long long NextInterval(const VM_Limits* limits) {
+    long long interval = LLONG_MAX;
+
+    if (limits->max_steps > 0)
+        interval = limits->max_steps - limits->num_steps + 1;
+
+    if (limits->deadline > 0.0 && interval > DEADLINE_INTERVAL)
+        interval = DEADLINE_INTERVAL;
+
+    if (limits->config->progress != NULL && interval > VM_PROGRESS_INTERVAL)
+        interval = VM_PROGRESS_INTERVAL;
+
+    // Variablerna mste jmfras vid varje hopp, annars kan vi missa en
+    // upprepning.
+    if (limits->state != NULL)
+        interval = 1;
+
+    return interval;
+}
+
+/*--------------------------------------
+ * Function: IsRepeated()
+ * Parameters:
+ *   limits  Krningens grnser.
+ *   loop    Loopen som ska hoppa tillbaka, se VM_CheckLimits().
+ *
+ * Description:
+ *   Avgr om loopen hoppar tillbaka med exakt samma variabelvrden som vid
+ *   ett tidigare hopp tillbaka. Programmet r deterministiskt, s i s fall
+ *   kommer samma hopp att upprepas fr alltid.
+ *------------------------------------*/
+static Bool IsRepeated(VM_Limits* limits, const AST_Node* loop) {
+    // Brents algoritm: Vi sparar en kopia av tillstndet efter 1, 2, 4, 8...
+    // hopp tillbaka, och jmfr varje nytt tillstnd med den senaste kopian.
+    // Om hoppen hamnat i en cykel hittar vi den inom ett par varv till, utan
+    // att behva spara mer n en kopia.
+    //
+    // Vi jmfr hela tillstndet direkt istllet fr med en hash-summa. Med
+    // bara en kopia skulle en hash-summa inte spara ngot arbete, och s
+    // slipper vi fundera p kollisioner.
+
+    if (limits->saved_loop == loop
+     && memcmp(limits->saved_state, limits->state, limits->state_size) == 0)
+    {
+        return TRUE;
+    }
+
+    limits->length++;
+    if (limits->length == limits->power) {
+        memcpy(limits->saved_state, limits->state, limits->state_size);
+        limits->saved_loop = loop;
+        limits->power     *= 2;
+        limits->length     = 0;
+    }
+
+    return FALSE;
+}
+
+/*--------------------------------------
+ * Function: FinishLanes()
+ * Parameters:
+ *   done     Masken fr de banor som r klara.
+ *   result   Banornas resultat eller felkod.
+ *   mask     Masken fr de banor som kr just nu.
+ *   alive    Bitmask med de banor som inte r klara n.
+ *   results  Arrayen som banornas resultat ska lagras i.
+ *
+ * Description:
+ *   Avslutar banorna som r markerade i done, se VM_ExecLanes(). done fr
+ *   vara samma array som mask.
+ *------------------------------------*/
+static void FinishLanes(const int* done, int result, int* mask,
+                        unsigned* alive, int* results)
+{
+    for (int i = 0; i < VM_LANES; i++) {
+        if (done[i]) {
+            results[i] = result;
+            *alive    &= ~(1u << i);
+            mask[i]    = 0;
+        }
+    }
+}
+
+/*--------------------------------------
+ * Function: InitLimits()
+ * Parameters:
+ *   config        Den virtuella maskinens konfiguration.
+ *   limits        Grnserna som ska initieras.
+ *   max_steps     Det strsta antalet hopp tillbaka, eller noll.
+ *   detect_loops  Sant om ondliga loopar ska upptckas.
+ *
+ * Description:
+ *   Som VM_StartLimits(), men med max_steps och detect_loops angivna
+ *   separat, s att VM_ExecLanes() kan rkna hoppen fr varje bana sjlv.
+ *------------------------------------*/
+static long long InitLimits(VM_Config* config, VM_Limits* limits,
+                            long long max_steps, Bool detect_loops)
+{
+    limits->num_steps  = 0;
+    limits->max_steps  = max_steps;
+    limits->deadline   = 0.0;
+    limits->config     = config;
+    limits->state      = NULL;
+    limits->state_size = 0;
+    limits->saved_loop = NULL;
+    limits->power      = 1;
+    limits->length     = 0;
+
+    if (config->timeout_ms > 0.0)
+        limits->deadline = Thread_WallTimeMs() + config->timeout_ms;
+
+    // Variablerna vljs i samma ordning som i PrintValue(). Godtyckligt stora
+    // tal fr inte plats i saved_state, s med big_vars jmfr vi ingenting.
+    if (detect_loops && config->big_vars == NULL) {
+        ASSERT(config->num_vars <= PLANG_NUM_VARS);
+
+        if (config->vars64 != NULL) {
+            limits->state      = config->vars64;
+            limits->state_size = config->num_vars * sizeof(long long);
+        }
+        else {
+            limits->state      = config->vars;
+            limits->state_size = config->num_vars * sizeof(int);
+        }
+    }
+
+    config->num_steps = 0;
+    config->limit_var  = -1;
+    config->limit_loop = NULL;
+
+    limits->interval = NextInterval(limits);
+    limits->budget   = limits->interval;
+
+    return limits->budget;
+}
+
+/*--------------------------------------
+ * Function: LaneBits()
+ * Parameters:
+ *   mask  Masken som ska omvandlas.
+ *
+ * Description:
+ *   Returnerar en bitmask med en bit fr varje bana som r satt i mask.
+ *------------------------------------*/
+static unsigned LaneBits(const int* mask) {
+    unsigned bits = 0;
+    for (int i = 0; i < VM_LANES; i++)
+        bits |= ((unsigned)mask[i] & 1u) << i;
+
+    return bits;
+}
+
+/*--------------------------------------
+ * Function: SelectLane()
+ * Parameters:
+ *   m  Noll, eller -1 om a ska vljas.
+ *   a  Vrdet som vljs om m r -1.
+ *   b  Vrdet som vljs om m r noll.
+ *
+ * Description:
+ *   Vljer ett av tv vrden utan villkorligt hopp, s att looparna ver
+ *   banorna i VM_ExecLanes() kan vektoriseras.
+ *------------------------------------*/
+static int SelectLane(int m, int a, int b) {
+    return (a & m) | (b & ~m);
+}
+
+/*--------------------------------------
+ * Function: SetLaneMask()
+ * Parameters:
+ *   mask  Masken som ska sttas.
+ *   bits  Bitmask med en bit fr varje bana, se LaneBits().
+ *
+ * Description:
+ *   Stter masken till -1 fr banorna i bits och noll fr vriga.
+ *------------------------------------*/
+static void SetLaneMask(int* mask, unsigned bits) {
+    for (int i = 0; i < VM_LANES; i++)
+        mask[i] = -(int)((bits >> i) & 1u);
+}
+
+/*--------------------------------------
+ * Function: VM_CheckLimits()
+ * Parameters:
+ *   limits  Krningens grnser, se VM_StartLimits().
+ *   loop    Noden fr loopen som ska hoppa tillbaka.
+ *   var     Variabeln i villkoret fr loopen som ska hoppa tillbaka.
+ *
+ * Description:
+ *   Anropas nr budget har rknats ner till noll. Returnerar en ny budget,
+ *   eller VM_ERR_LIMIT eller VM_ERR_INF_LOOP om krningen ska avbrytas.
+ *------------------------------------*/
+long long VM_CheckLimits(VM_Limits* limits, const AST_Node* loop, int var) {
+    // Hela den frra budgeten har gtt t, s nu vet vi exakt hur mnga hopp
+    // som gjorts, inklusive det som loopen str i begrepp att gra.
+    limits->num_steps += limits->interval;
+
+    long long err = 0;
+    if (limits->state != NULL && IsRepeated(limits, loop))
+        err = VM_ERR_INF_LOOP;
+    else if (limits->max_steps > 0 && limits->num_steps > limits->max_steps)
+        err = VM_ERR_LIMIT;
+    else if (limits->deadline > 0.0 && Thread_WallTimeMs() >= limits->deadline)
+        err = VM_ERR_LIMIT;
+
+    if (err != 0) {
+        limits->config->num_steps  = limits->num_steps - 1;
+        limits->config->limit_var  = var;
+        limits->config->limit_loop = loop;
+        limits->budget             = err;
+        return err;
+    }
+
+    VM_Progress* progress = limits->config->progress;
+    if (progress != NULL) {
+        progress->num_steps = limits->num_steps;
+        progress->loop      = loop;
+    }
+
+    limits->interval = NextInterval(limits);
+    limits->budget   = limits->interval;
+
+    return limits->budget;
+}
+
+/*--------------------------------------
+ * Function: VM_CountStatements()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_ExecBytecode(), men rknar satserna som krs i config->num_stmts.
+ *   Fr att f antalet satser i programmet som det r skrivet mste prog ha
+ *   versatts frn ett syntax-trd som inte optimerats.
+ *------------------------------------*/
+#define EXEC_FUNC      VM_CountStatements
+#define EXEC_TYPE      int
+#define EXEC_MAX       INT_MAX
+#define EXEC_VARS      vars
+#define EXEC_SATURATE  0
+#define EXEC_COUNT     1
+#include "vmexec.h"
+
+/*--------------------------------------
+ * Function: VM_CountStatements64()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_CountStatements(), men med 64-bitars variabler i config->vars64.
+ *------------------------------------*/
+#define EXEC_FUNC      VM_CountStatements64
+#define EXEC_TYPE      long long
+#define EXEC_MAX       LLONG_MAX
+#define EXEC_VARS      vars64
+#define EXEC_SATURATE  0
+#define EXEC_COUNT     1
+#include "vmexec.h"
+
 /*--------------------------------------
  * Function: VM_ExecAST()
  * Parameters:
@@ -265,13 +743,465 @@ static void ExecNode(AST_Node* node, VM_Config* vm, int* result) {
 int VM_ExecAST(AST_Node* ast, VM_Config* conf) {
     ASSERT(ast->type == AST_PROGRAM);
 
-    int result = NO_RESULT;
+    int result = VM_NO_RESULT;
 
-    ExecNode(ast, conf, &result);
+    VM_Limits limits;
+    VM_StartLimits(conf, &limits);
+
+    // Programnoden rknas inte som en sats.
+    conf->num_stmts = -1;
+
+    ExecNode(ast, conf, &limits, &result);
 
     return result;
 }
 
+/*--------------------------------------
+ * Function: VM_ExecBignum()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *   result  Talet som resultatet ska lagras i.
+ *
+ * Description:
+ *   Exekverar det specificerade bytekodsprogrammet med variablerna i
+ *   config->big_vars, som kan bli godtyckligt stora. Returnerar noll och
+ *   lagrar resultatet i result, eller en negativ felkod p samma stt som
+ *   VM_ExecBytecode(). Loop-sammanfattningar anvnds inte hr.
+ *------------------------------------*/
+int VM_ExecBignum(const BC_Program* prog, VM_Config* conf, Big_Num* result) {
+    // Samma instruktioner som i VM_ExecBytecode(), men utan overflow.
+    // Sammanfattningarna rknar med int, s BC_SUMMARY hoppas helt enkelt
+    // ver och loopen krs som vanligt.
+
+    const BC_Instr*        code  = prog->instrs.elems;
+    const AST_Node* const* nodes = prog->nodes.elems;
+    const BC_Instr*        ip    = code;
+          Big_Num*         vars  = conf->big_vars;
+
+    VM_Limits limits;
+    long long budget = VM_StartLimits(conf, &limits);
+
+    while (TRUE) {
+        switch (ip->op) {
+        case BC_ADD:
+            Big_Add(&vars[ip->a], &vars[ip->b]);
+            break;
+
+        case BC_ASSIGN:
+            Big_Set(&vars[ip->a], ip->b);
+            break;
+
+        case BC_COPY:
+            Big_Copy(&vars[ip->a], &vars[ip->b]);
+            break;
+
+        case BC_DEC:
+            Big_Dec(&vars[ip->a]);
+            break;
+
+        case BC_ERROR:
+            return ip->a;
+
+        case BC_HALT:
+            return VM_NO_RESULT;
+
+        case BC_INC:
+            Big_Inc(&vars[ip->a]);
+            break;
+
+        case BC_JNZ:
+            if (!Big_IsZero(&vars[ip->a])) {
+                if (--budget == 0) {
+                    budget = VM_CheckLimits(&limits, nodes[ip - code],
+                                            ip->a);
+                    if (budget < 0)
+                        return (int)budget;
+                }
+
+                ip = code + ip->b;
+                continue;
+            }
+            break;
+
+        case BC_JZ:
+            if (Big_IsZero(&vars[ip->a])) {
+                ip = code + ip->b;
+                continue;
+            }
+            break;
+
+        case BC_PRED:
+            Big_Copy(&vars[ip->a], &vars[ip->b]);
+            Big_Dec(&vars[ip->a]);
+            break;
+
+        case BC_RESULT:
+            Big_Copy(result, &vars[ip->a]);
+            return 0;
+
+        case BC_SUB:
+            Big_Sub(&vars[ip->a], &vars[ip->b]);
+            break;
+
+        case BC_SUCC:
+            Big_Copy(&vars[ip->a], &vars[ip->b]);
+            Big_Inc(&vars[ip->a]);
+            break;
+
+        case BC_SUMMARY:
+            break;
+
+        default:
+            // Det hr ska inte hnda.
+            FAIL();
+        }
+
+        ip++;
+    }
+}
+
+/*--------------------------------------
+ * Function: VM_ExecBytecode()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Exekverar det specificerade bytekodsprogrammet i en virtuell maskin.
+ *   Returnerar samma resultat och felkoder som VM_ExecAST(), men gr betydligt
+ *   snabbare. Debug-lget stds inte hr.
+ *------------------------------------*/
+#define EXEC_FUNC      VM_ExecBytecode
+#define EXEC_TYPE      int
+#define EXEC_MAX       INT_MAX
+#define EXEC_VARS      vars
+#define EXEC_SATURATE  0
+#define EXEC_SUM_APPLY Sum_Apply
+#define EXEC_COUNT     0
+#include "vmexec.h"
+
+/*--------------------------------------
+ * Function: VM_ExecBytecode64()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_ExecBytecode(), men med 64-bitars variabler i config->vars64.
+ *   Overflow intrffar frst nr ett vrde verstiger LLONG_MAX.
+ *------------------------------------*/
+#define EXEC_FUNC      VM_ExecBytecode64
+#define EXEC_TYPE      long long
+#define EXEC_MAX       LLONG_MAX
+#define EXEC_VARS      vars64
+#define EXEC_SATURATE  0
+#define EXEC_SUM_APPLY Sum_Apply64
+#define EXEC_COUNT     0
+#include "vmexec.h"
+
+/*--------------------------------------
+ * Function: VM_ExecLanes()
+ * Parameters:
+ *   prog       Det bytekodsprogram som ska exekveras.
+ *   config     Den virtuella maskinens konfiguration.
+ *   num_lanes  Antalet banor som ska kras, hgst VM_LANES.
+ *   results    Arrayen som banornas resultat ska lagras i.
+ *
+ * Description:
+ *   Kr programmet fr num_lanes uppsttningar variabler samtidigt. Variabel
+ *   i i bana j ligger i config->vars[i*VM_LANES + j]. Varje bana fr samma
+ *   resultat eller felkod som VM_ExecBytecode() hade gett.
+ *------------------------------------*/
+void VM_ExecLanes(const BC_Program* prog, VM_Config* conf, int num_lanes,
+                  int* results)
+{
+    // Alla banor kr samma instruktion samtidigt, men bara banorna i mask
+    // pverkas av den. Nr en loop brjar lggs masken p en stack, och banor
+    // vars loop-variabel r noll tas bort ur masken. Hoppet tillbaka grs s
+    // lnge ngon bana r kvar, och nr den sista lmnat loopen tas masken
+    // frn stacken igen. Varje instruktion krs som en loop ver banorna utan
+    // villkorliga hopp, s att kompilatorn kan gra SIMD-instruktioner av den.
+    //
+    // Hoppen tillbaka rknas fr varje bana fr sig, s att max_steps ger
+    // samma resultat som i VM_ExecBytecode(). Tidsgrnsen gller dremot
+    // hela krningen.
+
+    ASSERT(num_lanes >= 0 && num_lanes <= VM_LANES);
+
+    const BC_Instr*        code     = prog->instrs.elems;
+    const AST_Node* const* nodes    = prog->nodes.elems;
+    const BC_Instr*        ip       = code;
+          int*             vars     = conf->vars;
+          int*             sum_vars = NULL;
+          unsigned         alive    = (1u << num_lanes) - 1u;
+          unsigned*        stack    = malloc((prog->max_depth + 1)
+                                             * sizeof(unsigned));
+          int              depth    = 0;
+
+    long long max_steps = (conf->max_steps > 0) ? conf->max_steps
+                                                : LLONG_MAX;
+    long long steps[VM_LANES] = { 0 };
+    VM_Limits limits;
+    long long budget = InitLimits(conf, &limits, 0, FALSE);
+
+    int mask[VM_LANES];
+    int next[VM_LANES];
+    int over[VM_LANES];
+
+    SetLaneMask(mask, alive);
+
+    if (Array_Length(&prog->summaries) > 0)
+        sum_vars = malloc(conf->num_vars * sizeof(int));
+
+    while (alive != 0) {
+        int any_next = 0;
+
+        switch (ip->op) {
+        case BC_ADD: {
+                  int* x = &vars[ip->a * VM_LANES];
+            const int* y = &vars[ip->b * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                next[i]   = mask[i] & -(x[i] > INT_MAX - y[i]);
+                any_next |= next[i];
+                x[i]      = SelectLane(mask[i] & ~next[i],
+                                       (int)((unsigned)x[i] + y[i]), x[i]);
+            }
+
+            if (any_next)
+                FinishLanes(next, VM_ERR_OVERFLOW, mask, &alive, results);
+            break;
+        }
+
+        case BC_ASSIGN: {
+            int* x = &vars[ip->a * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++)
+                x[i] = SelectLane(mask[i], ip->b, x[i]);
+            break;
+        }
+
+        case BC_COPY: {
+                  int* x = &vars[ip->a * VM_LANES];
+            const int* y = &vars[ip->b * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                next[i]   = mask[i] & -(y[i] == INT_MAX);
+                any_next |= next[i];
+                x[i]      = SelectLane(mask[i] & ~next[i], y[i], x[i]);
+            }
+
+            if (any_next)
+                FinishLanes(next, VM_ERR_OVERFLOW, mask, &alive, results);
+            break;
+        }
+
+        case BC_DEC: {
+            int* x = &vars[ip->a * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++)
+                x[i] = SelectLane(mask[i], x[i] - (x[i] > 0), x[i]);
+            break;
+        }
+
+        case BC_ERROR:
+            FinishLanes(mask, ip->a, mask, &alive, results);
+            break;
+
+        case BC_HALT:
+            FinishLanes(mask, VM_NO_RESULT, mask, &alive, results);
+            break;
+
+        case BC_INC: {
+            int* x = &vars[ip->a * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                int val   = (int)((unsigned)x[i] + 1u);
+                next[i]   = mask[i] & -(val < 0);
+                any_next |= next[i];
+                x[i]      = SelectLane(mask[i] & ~next[i], val, x[i]);
+            }
+
+            if (any_next)
+                FinishLanes(next, VM_ERR_OVERFLOW, mask, &alive, results);
+            break;
+        }
+
+        case BC_JNZ: {
+            const int* x        = &vars[ip->a * VM_LANES];
+                  int  any_over = 0;
+
+            for (int i = 0; i < VM_LANES; i++) {
+                next[i]   = mask[i] & -(x[i] != 0);
+                steps[i] += next[i] & 1;
+                over[i]   = next[i] & -(steps[i] > max_steps);
+                next[i]  &= ~over[i];
+                any_next |= next[i];
+                any_over |= over[i];
+            }
+
+            if (any_over)
+                FinishLanes(over, VM_ERR_LIMIT, mask, &alive, results);
+
+            if (any_next && --budget == 0) {
+                budget = VM_CheckLimits(&limits, nodes[ip - code], ip->a);
+                if (budget < 0) {
+                    SetLaneMask(over, alive);
+                    FinishLanes(over, VM_ERR_LIMIT, mask, &alive, results);
+                    break;
+                }
+            }
+
+            if (any_next) {
+                for (int i = 0; i < VM_LANES; i++)
+                    mask[i] = next[i];
+                ip = code + ip->b;
+                continue;
+            }
+
+            // Sista banan har lmnat loopen, s nu fortstter alla banor som
+            // var med nr loopen brjade.
+            SetLaneMask(mask, stack[--depth] & alive);
+            break;
+        }
+
+        case BC_JZ: {
+            const int* x = &vars[ip->a * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                next[i]   = mask[i] & -(x[i] != 0);
+                any_next |= next[i];
+            }
+
+            if (!any_next) {
+                ip = code + ip->b;
+                continue;
+            }
+
+            stack[depth++] = LaneBits(mask);
+            for (int i = 0; i < VM_LANES; i++)
+                mask[i] = next[i];
+            break;
+        }
+
+        case BC_PRED: {
+                  int* x = &vars[ip->a * VM_LANES];
+            const int* y = &vars[ip->b * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++)
+                x[i] = SelectLane(mask[i], y[i] - (y[i] > 0), x[i]);
+            break;
+        }
+
+        case BC_RESULT: {
+            const int* x = &vars[ip->a * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                if (mask[i])
+                    results[i] = x[i];
+            }
+
+            alive &= ~LaneBits(mask);
+            SetLaneMask(mask, 0);
+            break;
+        }
+
+        case BC_SUB: {
+                  int* x = &vars[ip->a * VM_LANES];
+            const int* y = &vars[ip->b * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                int val = x[i] - y[i];
+                x[i] = SelectLane(mask[i], (val < 0) ? 0 : val, x[i]);
+            }
+            break;
+        }
+
+        case BC_SUCC: {
+                  int* x = &vars[ip->a * VM_LANES];
+            const int* y = &vars[ip->b * VM_LANES];
+
+            for (int i = 0; i < VM_LANES; i++) {
+                int val   = (int)((unsigned)y[i] + 1u);
+                next[i]   = mask[i] & -(val < 0);
+                any_next |= next[i];
+                x[i]      = SelectLane(mask[i] & ~next[i], val, x[i]);
+            }
+
+            if (any_next)
+                FinishLanes(next, VM_ERR_OVERFLOW, mask, &alive, results);
+            break;
+        }
+
+        case BC_SUMMARY: {
+            // Sammanfattningen krs fr en bana i taget. Den stter alltid
+            // loop-variabeln till noll, s banor dr den gick att kra tas
+            // bort ur masken av BC_JZ-instruktionen som kommer efter.
+            Sum_Loop* sum = *(Sum_Loop**)Array_GetElemPtr(&prog->summaries,
+                                                          ip->a);
+            for (int i = 0; i < VM_LANES; i++) {
+                if (!mask[i])
+                    continue;
+
+                for (int j = 0; j < conf->num_vars; j++)
+                    sum_vars[j] = vars[j*VM_LANES + i];
+
+                if (Sum_Apply(sum, sum_vars)) {
+                    for (int j = 0; j < conf->num_vars; j++)
+                        vars[j*VM_LANES + i] = sum_vars[j];
+                }
+            }
+            break;
+        }
+
+        default:
+            // Det hr ska inte hnda.
+            FAIL();
+        }
+
+        ip++;
+    }
+
+    free(stack);
+    free(sum_vars);
+}
+
+/*--------------------------------------
+ * Function: VM_ExecSaturating()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_ExecBytecode(), men variabler som nr INT_MAX stannar dr istllet
+ *   fr att ge overflow. VM_ERR_OVERFLOW returneras allts aldrig.
+ *------------------------------------*/
+#define EXEC_FUNC      VM_ExecSaturating
+#define EXEC_TYPE      int
+#define EXEC_MAX       INT_MAX
+#define EXEC_VARS      vars
+#define EXEC_SATURATE  1
+#define EXEC_SUM_APPLY Sum_Apply
+#define EXEC_COUNT     0
+#include "vmexec.h"
+
+/*--------------------------------------
+ * Function: VM_StartLimits()
+ * Parameters:
+ *   config  Den virtuella maskinens konfiguration.
+ *   limits  Grnserna som ska initieras.
+ *
+ * Description:
+ *   Initierar grnserna infr en krning och returnerar den frsta budgeten.
+ *   Varje gng en loop hoppar tillbaka till brjan rknas budgeten ner, och
+ *   nr den nr noll anropas VM_CheckLimits().
+ *------------------------------------*/
+long long VM_StartLimits(VM_Config* config, VM_Limits* limits) {
+    return InitLimits(config, limits, config->max_steps,
+                      config->detect_loops);
+}
+
 /*--------------------------------------
  * Function: VM_StateDump()
  * Parameters:
@@ -284,23 +1214,65 @@ int VM_ExecAST(AST_Node* ast, VM_Config* conf) {
  *   form av kllkod och variabelvrden.
  *------------------------------------*/
 void VM_StateDump(AST_Node* node, int indent, const VM_Config* vm) {
+    // Variablerna i trdet r platser i vm->vars, men vi skriver ut dem med
+    // sina ursprungliga namn.
+    const int* names = vm->var_names;
+
     if (node->type != AST_RESULT) {
         for (int i = 0; i < indent; i++)
             printf(" ");
     }
 
     switch (node->type) {
+    case AST_ADD_CLEAR: {
+        // Den hr noden finns inte i P, s vi skriver ut den som en kommentar
+        // fljd av vrdena p de inblandade variablerna.
+        int src = *(int*)Array_GetElemPtr(&node->values, 0);
+        printf("# ");
+
+        int num_values = Array_Length(&node->values);
+        for (int i = 1; i < num_values; i += 2) {
+            int var    = *(int*)Array_GetElemPtr(&node->values, i);
+            int factor = *(int*)Array_GetElemPtr(&node->values, i+1);
+            printf("X%d %c= %d*X%d, ", names[var], (factor < 0) ? '-' : '+',
+                   (factor < 0) ? -factor : factor, names[src]);
+        }
+
+        printf("X%d := 0 #", names[src]);
+        for (int i = 1; i < num_values; i += 2) {
+            int var = *(int*)Array_GetElemPtr(&node->values, i);
+            PrintValue(vm, var);
+        }
+
+        PrintValue(vm, src);
+        printf("\n");
+        break;
+    }
+
     case AST_ASSIGN: {
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
         int val = *(int*)Array_GetElemPtr(&node->values, 1);
-        printf("X%d := %d # %d\n", var, val, vm->vars[var]);
+        printf("X%d := %d #", names[var], val);
+        PrintValue(vm, var);
+        printf("\n");
+        break;
+    }
+
+    case AST_COPY: {
+        int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
+        int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
+        printf("# X%d := X%d #", names[var0], names[var1]);
+        PrintValue(vm, var0);
+        printf("\n");
         break;
     }
 
     case AST_PRED: {
         int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
         int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
-        printf("X%d := PRED(X%d) # %d\n", var0, var1, vm->vars[var0]);
+        printf("X%d := PRED(X%d) #", names[var0], names[var1]);
+        PrintValue(vm, var0);
+        printf("\n");
         break;
     }
 
@@ -312,7 +1284,7 @@ void VM_StateDump(AST_Node* node, int indent, const VM_Config* vm) {
             int var = *(int*)Array_GetElemPtr(&node->values, i);
             if (i > 0)
                 printf(", ");
-            printf("X%d", var);
+            printf("X%d", names[var]);
         }
 
         printf(")\n");
@@ -328,21 +1300,23 @@ void VM_StateDump(AST_Node* node, int indent, const VM_Config* vm) {
 
     case AST_RESULT: {
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
-        printf("RESULT (X%d)\n", var);
+        printf("RESULT (X%d)\n", names[var]);
         break;
     }
 
     case AST_SUCC: {
         int var0 = *(int*)Array_GetElemPtr(&node->values, 0);
         int var1 = *(int*)Array_GetElemPtr(&node->values, 1);
-        printf("X%d := SUCC(X%d) # %d\n", var0, var1, vm->vars[var0]);
+        printf("X%d := SUCC(X%d) #", names[var0], names[var1]);
+        PrintValue(vm, var0);
+        printf("\n");
         break;
     }
 
     case AST_WHILE: {
         int var = *(int*)Array_GetElemPtr(&node->values, 0);
 
-        printf("WHILE X%d != 0 DO\n", var);
+        printf("WHILE X%d != 0 DO\n", names[var]);
 
         int num_children = Array_Length(&node->children);
         for (int i = 0; i < num_children; i++) {
@@ -1,7 +1,7 @@
 /*------------------------------------------------------------------------------
  * File: vm.h
  * Created: January 3, 2015
- * Last changed: January 11, 2015
+ * Last changed: October 18, 2026
  *
  * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
  *
@@ -12,7 +12,25 @@
  * Changes:
  *   * Lade till typen VM_Config fr att mjliggra konfigurering av den
  *     virtuella maskinen.
- *
+ *   * VM_ExecBytecode() fr exekvering av bytekod.
+ *   * VM_NO_RESULT (tidigare NO_RESULT i vm.c).
+ *   * VM_Config har en tt variabel-array istllet fr PLANG_NUM_VARS
+ *     variabler.
+ *   * VM_ExecBignum() fr -bignum.
+ *   * VM_ExecBytecode64() och VM_ExecSaturating() fr -int64 och -saturate.
+ *   * VM_ExecLanes() och VM_LANES.
+ *   * Grnser fr antalet loop-varv och krtiden i VM_Config, som ger
+ *     VM_ERR_LIMIT. Se VM_StartLimits() och VM_CheckLimits().
+ *   * detect_loops i VM_Config, som ger VM_ERR_INF_LOOP om variablerna
+ *     upprepar sig.
+ *   * single_step i VM_Config, fr brytpunkter i debug-lget.
+ *   * VM_Progress och progress i VM_Config, fr att flja en krning frn
+ *     en annan trd.
+ *   * num_stmts i VM_Config, med antalet satser som VM_ExecAST() krde.
+ *   * VM_Progress.loop r noden fr loopen istllet fr dess variabel, s
+ *     att loopar med samma variabel gr att skilja t.
+ *   * VM_CountStatements() och VM_CountStatements64() fr -stats.
+ *   * limit_loop i VM_Config, med noden fr loopen som ndde en grns.
  *----------------------------------------------------------------------------*/
 
 #ifndef VM_H_
@@ -23,8 +41,12 @@
  *----------------------------------------------*/
 
 #include "ast.h"
+#include "bignum.h"
+#include "bytecode.h"
 #include "common.h"
 
+#include <stddef.h>
+
 /*------------------------------------------------
  * CONSTANTS
  *----------------------------------------------*/
@@ -62,25 +84,183 @@
  *------------------------------------*/
 #define VM_ERR_PREMATURE_RESULT -5
 
+/*--------------------------------------
+ * Constant: VM_ERR_LIMIT
+ *
+ * Description:
+ *   Indikerar att exekveringen avbrts fr att den ndde max_steps eller
+ *   timeout_ms i VM_Config.
+ *------------------------------------*/
+#define VM_ERR_LIMIT -6
+
+/*--------------------------------------
+ * Constant: VM_LANES
+ *
+ * Description:
+ *   Antalet banor, dvs. uppsttningar variabler, som VM_ExecLanes() kr
+ *   samtidigt. tta 32-bitars vrden fyller ett AVX2-register.
+ *------------------------------------*/
+#define VM_LANES 8
+
+/*--------------------------------------
+ * Constant: VM_NO_RESULT
+ *
+ * Description:
+ *   Indikerar att inget resultat finns.
+ *------------------------------------*/
+#define VM_NO_RESULT -1
+
+/*--------------------------------------
+ * Constant: VM_PROGRESS_INTERVAL
+ *
+ * Description:
+ *   Det strsta antalet hopp tillbaka mellan varje gng VM_Progress
+ *   uppdateras.
+ *------------------------------------*/
+#define VM_PROGRESS_INTERVAL 16384
+
 /*------------------------------------------------
  * TYPES
  *----------------------------------------------*/
 
+/*--------------------------------------
+ * Type: VM_Progress
+ *
+ * Description:
+ *   Hur lngt en krning har kommit, fr en annan trd som vill flja den.
+ *   VM_CheckLimits() skriver till flten, s de uppdateras bara var
+ *   VM_PROGRESS_INTERVAL:e hopp tillbaka och kostar ingenting i sjlva
+ *   loopen. num_steps r antalet hopp tillbaka hittills, och loop noden fr
+ *   loopen som senast hoppade tillbaka, eller NULL. Tv loopar med samma
+ *   villkorsvariabel har olika noder, s loop skiljer dem t.
+ *------------------------------------*/
+typedef struct {
+             volatile long long num_steps;
+    const AST_Node* volatile    loop;
+} VM_Progress;
+
 /*--------------------------------------
  * Type: VM_Config
  *
  * Description:
- *   Beskriver den virtuella maskinens konfiguration.
+ *   Beskriver den virtuella maskinens konfiguration. vars har en plats fr
+ *   varje variabel som programmet anvnder, och var_names anger vilken
+ *   variabel som ligger p varje plats, se AST_ResolveVars(). vars64 och
+ *   big_vars anvnds istllet fr vars av VM_ExecBytecode64() respektive
+ *   VM_ExecBignum(), och r annars NULL.
+ *
+ *   max_steps r det strsta antalet gnger som loopar fr hoppa tillbaka
+ *   till brjan, och timeout_ms den lngsta tid som en krning fr ta. Noll
+ *   betyder ingen grns. Om en grns ns returneras VM_ERR_LIMIT, och d
+ *   anger num_steps hur mnga hopp som hunnit gras, limit_loop noden fr
+ *   loopen som krdes och limit_var variabeln i dess villkor.
+ *
+ *   Om detect_loops r sant jmfrs variablerna varje gng en loop hoppar
+ *   tillbaka, och om de upprepar sig returneras VM_ERR_INF_LOOP, med
+ *   num_steps, limit_loop och limit_var satta p samma stt. Det fungerar
+ *   inte med big_vars eller i VM_ExecLanes().
+ *
+ *   Om enable_debug r sant stannar VM_ExecAST() vid de brytpunkter som
+ *   finns i trdet, se breakpoint.h, och fre varje sats om single_step r
+ *   sant. Vid varje stopp kan anvndaren ndra single_step och lgga till
+ *   brytpunkter.
+ *
+ *   Om progress inte r NULL uppdateras den under krningen, se
+ *   VM_Progress. Det gller alla varianter utom VM_ExecLanes().
+ *
+ *   VM_ExecAST(), VM_CountStatements() och VM_CountStatements64() rknar
+ *   antalet satser som krs i num_stmts. De andra varianterna lmnar fltet
+ *   orrt.
  *------------------------------------*/
 typedef struct {
-    int  vars[PLANG_NUM_VARS];
-    Bool enable_debug;
+          int*         vars;
+          long long*   vars64;
+          Big_Num*     big_vars;
+          int          num_vars;
+    const int*         var_names;
+          Bool         enable_debug;
+          long long    max_steps;
+          double       timeout_ms;
+          long long    num_steps;
+          int          limit_var;
+    const AST_Node*    limit_loop;
+          Bool         detect_loops;
+          Bool         single_step;
+          VM_Progress* progress;
+          long long    num_stmts;
 } VM_Config;
 
+/*--------------------------------------
+ * Type: VM_Limits
+ *
+ * Description:
+ *   Hller reda p hur lngt en krning kommit mot grnserna i VM_Config.
+ *   budget r antalet hopp tillbaka som fr gras innan VM_CheckLimits()
+ *   mste anropas. Maskinkoden frn jit.c lser budget, s fltet mste
+ *   ligga frst.
+ *
+ *   Med detect_loops pekar state p variablerna, och saved_state r en kopia
+ *   av dem frn nr saved_loop hoppade tillbaka, se VM_CheckLimits(). Kopian
+ *   har plats fr alla variabler i alla varianter, s inget behver
+ *   allokeras.
+ *------------------------------------*/
+typedef struct {
+          long long  budget;
+          long long  interval;
+          long long  num_steps;
+          long long  max_steps;
+          double     deadline;
+          VM_Config* config;
+
+    const void*      state;
+          size_t     state_size;
+    const AST_Node*  saved_loop;
+          long long  power;
+          long long  length;
+          long long  saved_state[PLANG_NUM_VARS];
+} VM_Limits;
+
 /*------------------------------------------------
  * FUNCTIONS
  *----------------------------------------------*/
 
+/*--------------------------------------
+ * Function: VM_CheckLimits()
+ * Parameters:
+ *   limits  Krningens grnser, se VM_StartLimits().
+ *   loop    Noden fr loopen som ska hoppa tillbaka.
+ *   var     Variabeln i villkoret fr loopen som ska hoppa tillbaka.
+ *
+ * Description:
+ *   Anropas nr budget har rknats ner till noll. Returnerar en ny budget,
+ *   eller VM_ERR_LIMIT eller VM_ERR_INF_LOOP om krningen ska avbrytas.
+ *------------------------------------*/
+long long VM_CheckLimits(VM_Limits* limits, const AST_Node* loop, int var);
+
+/*--------------------------------------
+ * Function: VM_CountStatements()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_ExecBytecode(), men rknar satserna som krs i config->num_stmts.
+ *   Fr att f antalet satser i programmet som det r skrivet mste prog ha
+ *   versatts frn ett syntax-trd som inte optimerats.
+ *------------------------------------*/
+int VM_CountStatements(const BC_Program* prog, VM_Config* config);
+
+/*--------------------------------------
+ * Function: VM_CountStatements64()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_CountStatements(), men med 64-bitars variabler i config->vars64.
+ *------------------------------------*/
+long long VM_CountStatements64(const BC_Program* prog, VM_Config* config);
+
 /*--------------------------------------
  * Function: VM_ExecAST()
  * Parameters:
@@ -92,6 +272,87 @@ typedef struct {
  *------------------------------------*/
 int VM_ExecAST(AST_Node* ast, VM_Config* config);
 
+/*--------------------------------------
+ * Function: VM_ExecBignum()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *   result  Talet som resultatet ska lagras i.
+ *
+ * Description:
+ *   Exekverar det specificerade bytekodsprogrammet med variablerna i
+ *   config->big_vars, som kan bli godtyckligt stora. Returnerar noll och
+ *   lagrar resultatet i result, eller en negativ felkod p samma stt som
+ *   VM_ExecBytecode(). Loop-sammanfattningar anvnds inte hr.
+ *------------------------------------*/
+int VM_ExecBignum(const BC_Program* prog, VM_Config* config, Big_Num* result);
+
+/*--------------------------------------
+ * Function: VM_ExecBytecode()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Exekverar det specificerade bytekodsprogrammet i en virtuell maskin.
+ *   Returnerar samma resultat och felkoder som VM_ExecAST(), men gr betydligt
+ *   snabbare. Debug-lget stds inte hr.
+ *------------------------------------*/
+int VM_ExecBytecode(const BC_Program* prog, VM_Config* config);
+
+/*--------------------------------------
+ * Function: VM_ExecBytecode64()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_ExecBytecode(), men med 64-bitars variabler i config->vars64.
+ *   Overflow intrffar frst nr ett vrde verstiger LLONG_MAX.
+ *------------------------------------*/
+long long VM_ExecBytecode64(const BC_Program* prog, VM_Config* config);
+
+/*--------------------------------------
+ * Function: VM_ExecLanes()
+ * Parameters:
+ *   prog       Det bytekodsprogram som ska exekveras.
+ *   config     Den virtuella maskinens konfiguration.
+ *   num_lanes  Antalet banor som ska kras, hgst VM_LANES.
+ *   results    Arrayen som banornas resultat ska lagras i.
+ *
+ * Description:
+ *   Kr programmet fr num_lanes uppsttningar variabler samtidigt. Variabel
+ *   i i bana j ligger i config->vars[i*VM_LANES + j]. Varje bana fr samma
+ *   resultat eller felkod som VM_ExecBytecode() hade gett.
+ *------------------------------------*/
+void VM_ExecLanes(const BC_Program* prog, VM_Config* config, int num_lanes,
+                  int* results);
+
+/*--------------------------------------
+ * Function: VM_ExecSaturating()
+ * Parameters:
+ *   prog    Det bytekodsprogram som ska exekveras.
+ *   config  Den virtuella maskinens konfiguration.
+ *
+ * Description:
+ *   Som VM_ExecBytecode(), men variabler som nr INT_MAX stannar dr istllet
+ *   fr att ge overflow. VM_ERR_OVERFLOW returneras allts aldrig.
+ *------------------------------------*/
+int VM_ExecSaturating(const BC_Program* prog, VM_Config* config);
+
+/*--------------------------------------
+ * Function: VM_StartLimits()
+ * Parameters:
+ *   config  Den virtuella maskinens konfiguration.
+ *   limits  Grnserna som ska initieras.
+ *
+ * Description:
+ *   Initierar grnserna infr en krning och returnerar den frsta budgeten.
+ *   Varje gng en loop hoppar tillbaka till brjan rknas budgeten ner, och
+ *   nr den nr noll anropas VM_CheckLimits().
+ *------------------------------------*/
+long long VM_StartLimits(VM_Config* config, VM_Limits* limits);
+
 /*--------------------------------------
  * Function: VM_StateDump()
  * Parameters:
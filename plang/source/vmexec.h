@@ -0,0 +1,193 @@
+/*------------------------------------------------------------------------------
+ * File: vmexec.h
+ * Created: October 17, 2026
+ * Last changed: October 18, 2026
+ *
+ * Author(s): Philip Arvidsson (philip@philiparvidsson.com)
+ *
+ * Description:
+ *   Mall fr bytekodsloopen i vm.c. Filen inkluderas en gng fr varje
+ *   variant av den virtuella maskinen, med fljande makron definierade:
+ *
+ *     EXEC_FUNC       Funktionens namn.
+ *     EXEC_TYPE       Variablernas typ.
+ *     EXEC_MAX        Det strsta vrde som ryms i EXEC_TYPE.
+ *     EXEC_VARS       Fltet i VM_Config dr variablerna ligger.
+ *     EXEC_SATURATE   1 om vrdena ska stanna vid EXEC_MAX istllet fr att
+ *                     ge overflow, annars 0.
+ *     EXEC_SUM_APPLY  Funktionen som kr en loop-sammanfattning. Om makrot
+ *                     inte definieras krs loopen alltid som vanligt.
+ *     EXEC_COUNT      1 om satserna ska rknas i num_stmts, annars 0.
+ *
+ *   Allt som skiljer varianterna t avgrs allts nr vm.c kompileras, och
+ *   inte i sjlva loopen. Makrona avdefinieras i slutet av filen.
+ *
+ * Changes:
+ *   * VM_CheckLimits() fr loopens nod frn BC_Program.nodes.
+ *   * EXEC_COUNT fr att rkna satserna, se VM_CountStatements().
+ *----------------------------------------------------------------------------*/
+
+// Den hr filen ska inkluderas flera gnger, s den har ingen include guard.
+
+/*------------------------------------------------
+ * FUNCTIONS
+ *----------------------------------------------*/
+
+EXEC_TYPE EXEC_FUNC(const BC_Program* prog, VM_Config* conf) {
+    // Alla operander r redan kontrollerade av BC_Compile(), s hr behver vi
+    // inte gra ngot annat n att kra instruktionerna. Variablerna r
+    // alltid naturliga tal, s de kan bara bli fr stora, aldrig fr sm.
+
+    const BC_Instr*        code  = prog->instrs.elems;
+    const AST_Node* const* nodes = prog->nodes.elems;
+    const BC_Instr*        ip    = code;
+          EXEC_TYPE*       vars  = conf->EXEC_VARS;
+
+    VM_Limits limits;
+    long long budget = VM_StartLimits(conf, &limits);
+
+#   if EXEC_COUNT
+    conf->num_stmts = 0;
+#   endif
+
+    while (TRUE) {
+#   if EXEC_COUNT
+        // Varje WHILE-sats brjar med ett BC_JZ, och BC_JNZ och BC_HALT hr
+        // inte till ngon sats. vriga instruktioner r en sats var.
+        if (ip->op != BC_JNZ && ip->op != BC_HALT)
+            conf->num_stmts++;
+#   endif
+
+        switch (ip->op) {
+        case BC_ADD:
+            if (vars[ip->a] > EXEC_MAX - vars[ip->b]) {
+#           if EXEC_SATURATE
+                vars[ip->a] = EXEC_MAX;
+                break;
+#           else
+                return VM_ERR_OVERFLOW;
+#           endif
+            }
+            vars[ip->a] += vars[ip->b];
+            break;
+
+        case BC_ASSIGN:
+            vars[ip->a] = ip->b;
+            break;
+
+        case BC_COPY:
+            // Erstter SUCC fljt av PRED, s vrdet mste bli detsamma som
+            // om de tv instruktionerna krts var fr sig.
+            if (vars[ip->b] == EXEC_MAX) {
+#           if EXEC_SATURATE
+                vars[ip->a] = EXEC_MAX - 1;
+                break;
+#           else
+                vars[ip->a] = -EXEC_MAX - 1;
+                return VM_ERR_OVERFLOW;
+#           endif
+            }
+            vars[ip->a] = vars[ip->b];
+            break;
+
+        case BC_DEC:
+            if (vars[ip->a] > 0)
+                vars[ip->a]--;
+            break;
+
+        case BC_ERROR:
+            return ip->a;
+
+        case BC_HALT:
+            return VM_NO_RESULT;
+
+        case BC_INC:
+#       if EXEC_SATURATE
+            if (vars[ip->a] < EXEC_MAX)
+                vars[ip->a]++;
+#       else
+            // Vi rknar med unsigned fr att f samma wrap-around som i
+            // VM_ExecAST(), utan att frlita oss p odefinierat beteende.
+            vars[ip->a] = (EXEC_TYPE)((unsigned EXEC_TYPE)vars[ip->a] + 1u);
+            if (vars[ip->a] < 0)
+                return VM_ERR_OVERFLOW;
+#       endif
+            break;
+
+        case BC_JNZ:
+            if (vars[ip->a] != 0) {
+                // Grnserna kontrolleras bara nr loopar hoppar tillbaka, och
+                // nstan alltid rcker det att rkna ner budget.
+                if (--budget == 0) {
+                    budget = VM_CheckLimits(&limits, nodes[ip - code],
+                                            ip->a);
+                    if (budget < 0)
+                        return (EXEC_TYPE)budget;
+                }
+
+                ip = code + ip->b;
+                continue;
+            }
+            break;
+
+        case BC_JZ:
+            if (vars[ip->a] == 0) {
+                ip = code + ip->b;
+                continue;
+            }
+            break;
+
+        case BC_PRED: {
+            EXEC_TYPE val = vars[ip->b] - 1;
+            vars[ip->a] = (val < 0) ? 0 : val;
+            break;
+        }
+
+        case BC_RESULT:
+            return vars[ip->a];
+
+        case BC_SUB: {
+            EXEC_TYPE val = vars[ip->a] - vars[ip->b];
+            vars[ip->a] = (val < 0) ? 0 : val;
+            break;
+        }
+
+        case BC_SUCC:
+#       if EXEC_SATURATE
+            vars[ip->a] = (vars[ip->b] < EXEC_MAX) ? vars[ip->b] + 1
+                                                   : EXEC_MAX;
+#       else
+            vars[ip->a] = (EXEC_TYPE)((unsigned EXEC_TYPE)vars[ip->b] + 1u);
+            if (vars[ip->a] < 0)
+                return VM_ERR_OVERFLOW;
+#       endif
+            break;
+
+        case BC_SUMMARY: {
+#       ifdef EXEC_SUM_APPLY
+            Sum_Loop* sum = *(Sum_Loop**)Array_GetElemPtr(&prog->summaries,
+                                                          ip->a);
+            if (EXEC_SUM_APPLY(sum, vars)) {
+                ip = code + ip->b;
+                continue;
+            }
+#       endif
+            break;
+        }
+
+        default:
+            // Det hr ska inte hnda.
+            FAIL();
+        }
+
+        ip++;
+    }
+}
+
+#undef EXEC_FUNC
+#undef EXEC_TYPE
+#undef EXEC_MAX
+#undef EXEC_VARS
+#undef EXEC_SATURATE
+#undef EXEC_SUM_APPLY
+#undef EXEC_COUNT